@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../BBE/BarnesHutTree.h"
+#include "../BBE/ThreadPool.h"
+#include "../BBE/LinearCongruentialGenerator.h"
+#include "../BBE/StopWatch.h"
+#include "../BBE/List.h"
+#include "../BBE/Math.h"
+#include <iostream>
+
+namespace bbe
+{
+	namespace test
+	{
+		void barnesHutPrintSpeedAndAccuracy()
+		{
+			//Same force law as ExampleParticleGravity: inverse square attraction plus a short range repulsion.
+			auto force = [](const Vector3 &dir, float distanceSq, float mass)
+			{
+				const float distance = Math::sqrt(distanceSq);
+				return dir * (mass * (1 / (distanceSq * distance) - 1 / (distanceSq * distanceSq)) / 10);
+			};
+
+			auto bruteForce = [&](const List<Vector3> &positions, size_t index)
+			{
+				Vector3 sum;
+				for (size_t k = 0; k < positions.getLength(); k++)
+				{
+					const Vector3 dir = positions[k] - positions[index];
+					const float distanceSq = dir.getLengthSq();
+					if (distanceSq != 0)
+					{
+						sum = sum + force(dir, distanceSq, 1);
+					}
+				}
+				return sum;
+			};
+
+			ThreadPool pool;
+			LCG32 lcg;
+			lcg.setSeed((uint64_t)1);
+			const size_t amounts[] = { 1000, 10000, 100000 };
+			const float thetas[] = { 0.3f, 0.5f, 0.8f };
+			for (size_t amount : amounts)
+			{
+				List<Vector3> positions;
+				for (size_t i = 0; i < amount; i++)
+				{
+					positions.add(Vector3(lcg.next() % 100000 / 1000.0f, lcg.next() % 100000 / 1000.0f, lcg.next() % 100000 / 1000.0f));
+				}
+				List<Vector3> forces;
+				forces.resizeCapacityAndLength(amount);
+
+				//The accuracy is measured on a sample, because the exact result for all bodies is too slow for large n.
+				const size_t sampleStep = amount / 1000;
+				List<Vector3> exact;
+				for (size_t i = 0; i < amount; i += sampleStep)
+				{
+					exact.add(bruteForce(positions, i));
+				}
+
+				if (amount <= 10000)
+				{
+					StopWatch watch;
+					for (size_t i = 0; i < amount; i++)
+					{
+						forces[i] = bruteForce(positions, i);
+					}
+					std::cout << "Brute force n=" << amount << ": " << watch.getTimeExpiredMicroseconds() / 1000.0 << "ms" << std::endl;
+				}
+
+				for (float theta : thetas)
+				{
+					for (int threaded = 0; threaded < 2; threaded++)
+					{
+						ThreadPool* threadPool = threaded ? &pool : nullptr;
+						BarnesHutTree tree(theta);
+
+						StopWatch buildWatch;
+						tree.build(positions.getRaw(), nullptr, amount, threadPool);
+						const double buildTime = buildWatch.getTimeExpiredMicroseconds() / 1000.0;
+
+						StopWatch forceWatch;
+						tree.calculateForces(positions.getRaw(), forces.getRaw(), amount, force, threadPool);
+						const double forceTime = forceWatch.getTimeExpiredMicroseconds() / 1000.0;
+
+						double errorSq = 0;
+						double exactSq = 0;
+						float maxError = 0;
+						for (size_t i = 0; i < exact.getLength(); i++)
+						{
+							const float error = (forces[i * sampleStep] - exact[i]).getLength();
+							errorSq += error * error;
+							exactSq += exact[i].getLengthSq();
+							maxError = Math::max(maxError, error / exact[i].getLength());
+						}
+
+						std::cout << "Barnes-Hut n=" << amount << " theta=" << theta << " threads=" << (threaded ? pool.getAmountOfThreads() + 1 : 1)
+							<< ": build " << buildTime << "ms, forces " << forceTime << "ms, "
+							<< "rms error " << Math::sqrt((float)(errorSq / exactSq)) * 100 << "%, max error " << maxError * 100 << "%" << std::endl;
+					}
+				}
+			}
+		}
+	}
+}
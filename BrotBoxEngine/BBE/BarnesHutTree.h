@@ -0,0 +1,143 @@
+#pragma once
+
+#include "../BBE/List.h"
+#include "../BBE/Vector3.h"
+#include "../BBE/Math.h"
+#include "../BBE/ThreadPool.h"
+#include <cstdint>
+
+namespace bbe
+{
+	class BarnesHutTree
+	{
+	private:
+		struct Node
+		{
+			Vector3  centerOfMass;
+			float    mass;
+			Vector3  center;
+			float    halfSize;
+			uint32_t bodyBegin;
+			uint32_t bodyEnd;
+			uint32_t skip;        //Index of the first node after this subtree.
+			bool     leaf;
+		};
+
+		struct MortonBody
+		{
+			uint64_t code;
+			uint32_t index;
+
+			bool operator<(const MortonBody &other) const
+			{
+				return code < other.code || (code == other.code && index < other.index);
+			}
+		};
+
+		float m_theta;
+		float m_thetaSq;
+		size_t m_maxBodiesPerLeaf;
+
+		List<Node>       m_nodes;
+		List<MortonBody> m_bodies;
+		List<Vector3>    m_sortedPositions;
+		List<float>      m_sortedMasses;
+
+		Vector3 m_boundsCenter;
+		float   m_boundsHalfSize = 0;
+
+		struct Cell
+		{
+			uint32_t begin;
+			uint32_t end;
+			uint32_t depth;
+			Vector3  center;
+			float    halfSize;
+		};
+
+		void buildFromArrays(const float* xs, const float* ys, const float* zs, size_t stride, const float* masses, size_t amount, ThreadPool* threadPool);
+		void sortBodies(ThreadPool* threadPool);
+		size_t splitCell(const Cell &cell, Cell* outChildren) const;
+		bool isSubtreeCell(const Cell &cell) const;
+		void collectSubtreeCells(const Cell &cell, List<Cell> &outCells) const;
+		uint32_t buildNode(List<Node> &nodes, const Cell &cell) const;
+		uint32_t buildTopNode(const Cell &cell, List<List<Node>> &subtrees, size_t &subtreeIndex);
+		void aggregate(List<Node> &nodes, uint32_t index, const uint32_t* children, size_t amountOfChildren) const;
+
+	public:
+		explicit BarnesHutTree(float theta = 0.5f, size_t maxBodiesPerLeaf = 8);
+
+		//theta is the opening angle: a node of size s at distance d is treated as a single body if s / d < theta.
+		//0 gives the exact (but slow) result.
+		void setTheta(float theta);
+		float getTheta() const;
+
+		//masses may be nullptr, every body then has a mass of 1.
+		void build(const Vector3* positions, const float* masses, size_t amount, ThreadPool* threadPool = nullptr);
+		void build(const float* xs, const float* ys, const float* zs, const float* masses, size_t amount, ThreadPool* threadPool = nullptr);
+		void clear();
+
+		size_t getAmountOfBodies() const;
+		size_t getAmountOfNodes() const;
+		float getTotalMass() const;
+		Vector3 getCenterOfMass() const;
+
+		//forceFunc(const Vector3 &dir, float distanceSq, float mass) returns the force a body of the given mass
+		//exerts on pos, where dir points from pos to that body. Bodies exactly at pos are skipped.
+		template <typename ForceFunc>
+		Vector3 calculateForce(const Vector3 &pos, ForceFunc forceFunc) const
+		{
+			Vector3 force;
+			const uint32_t amountOfNodes = (uint32_t)m_nodes.getLength();
+			uint32_t i = 0;
+			while (i < amountOfNodes)
+			{
+				const Node &node = m_nodes[i];
+				const Vector3 dir = node.centerOfMass - pos;
+				const float distanceSq = dir.getLengthSq();
+				const float size = node.halfSize * 2;
+
+				const bool posInside = Math::abs(pos.x - node.center.x) <= node.halfSize
+					&& Math::abs(pos.y - node.center.y) <= node.halfSize
+					&& Math::abs(pos.z - node.center.z) <= node.halfSize;
+
+				if (!posInside && size * size < m_thetaSq * distanceSq)
+				{
+					force = force + forceFunc(dir, distanceSq, node.mass);
+					i = node.skip;
+				}
+				else if (node.leaf)
+				{
+					for (uint32_t k = node.bodyBegin; k < node.bodyEnd; k++)
+					{
+						const Vector3 bodyDir = m_sortedPositions[k] - pos;
+						const float bodyDistanceSq = bodyDir.getLengthSq();
+						if (bodyDistanceSq == 0)
+						{
+							continue;
+						}
+						force = force + forceFunc(bodyDir, bodyDistanceSq, m_sortedMasses[k]);
+					}
+					i = node.skip;
+				}
+				else
+				{
+					i++;
+				}
+			}
+			return force;
+		}
+
+		template <typename ForceFunc>
+		void calculateForces(const Vector3* positions, Vector3* outForces, size_t amount, ForceFunc forceFunc, ThreadPool* threadPool = nullptr) const
+		{
+			ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					outForces[i] = calculateForce(positions[i], forceFunc);
+				}
+			}, 256);
+		}
+	};
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include <stdint.h>
+#include "../BBE/List.h"
+#include "../BBE/Vector2.h"
+#include "../BBE/Color.h"
+#include "../BBE/Rectangle.h"
+#include "../BBE/Circle.h"
+
+namespace bbe
+{
+	//The vertex input of the batched 2D pipeline. m_pos is already in normalized device coordinates.
+	class Vertex2D
+	{
+	public:
+		Vector2 m_pos;
+		Vector2 m_uvCoord;
+		Color   m_color;
+
+		Vertex2D(const Vector2 &pos, const Vector2 &uvCoord, const Color &color)
+			: m_pos(pos), m_uvCoord(uvCoord), m_color(color)
+		{
+		}
+	};
+
+	//Collects the vertices and indices of many 2D primitives in the order they are added. Consecutive primitives
+	//with the same texture end up in the same Draw, so a frame only needs one draw call per texture change.
+	class Batch2D
+	{
+	public:
+		class Draw
+		{
+		public:
+			VkDescriptorSet m_texture;
+			uint32_t        m_firstIndex;
+			uint32_t        m_amountOfIndices;
+		};
+
+	private:
+		List<Vertex2D> m_vertices;
+		List<uint32_t> m_indices;
+		List<Draw>     m_draws;
+		List<Vector2>  m_circleVertices;
+		float m_scaleX = 1;
+		float m_scaleY = 1;
+
+		Vector2 toDeviceCoordinates(float x, float y) const;
+		void addDraw(VkDescriptorSet texture, uint32_t amountOfIndices);
+
+	public:
+		Batch2D();
+
+		//Removes everything. Positions are given in pixels of a screen of the given size.
+		void begin(int screenWidth, int screenHeight);
+
+		void addRectangle(const Rectangle &rect, const Color &color, VkDescriptorSet texture);
+		void addCircle(const Circle &circle, const Color &color, VkDescriptorSet texture);
+		//uvRect is the part of the texture that is mapped onto the primitive, for example the place of an image
+		//in a TextureAtlas.
+		void addRectangle(const Rectangle &rect, const Color &color, VkDescriptorSet texture, const Rectangle &uvRect);
+		void addCircle(const Circle &circle, const Color &color, VkDescriptorSet texture, const Rectangle &uvRect);
+
+		bool isEmpty() const;
+		const List<Vertex2D>& getVertices() const;
+		const List<uint32_t>& getIndices() const;
+		const List<Draw>& getDraws() const;
+	};
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../BBE/Batch2D.h"
+#include "../BBE/StopWatch.h"
+#include <iostream>
+
+namespace bbe
+{
+	namespace test
+	{
+		void batch2DPrintSpeed()
+		{
+			const int amountOfRectangles = 100000;
+			const int amountOfCircles = 10000;
+			const VkDescriptorSet white = (VkDescriptorSet)1;
+			Batch2D batch;
+
+			//The second frame reuses the capacity of the first one, like every frame after the first one does.
+			for (int frame = 0; frame < 2; frame++)
+			{
+				StopWatch watch;
+				batch.begin(1280, 720);
+				for (int i = 0; i < amountOfRectangles; i++)
+				{
+					batch.addRectangle(Rectangle((float)(i % 1280), (float)(i % 720), 4, 4), Color(1, 0.5f, 0.25f, 1), white);
+				}
+				for (int i = 0; i < amountOfCircles; i++)
+				{
+					batch.addCircle(Circle((float)(i % 1280), (float)(i % 720), 8, 8), Color(0.25f, 0.5f, 1, 1), white);
+				}
+				std::cout << "Batch2D " << amountOfRectangles << " rectangles and " << amountOfCircles << " circles, frame " << frame << ": "
+					<< watch.getTimeExpiredMicroseconds() / 1000.0 << " ms, " << batch.getDraws().getLength() << " draw calls, "
+					<< batch.getVertices().getLength() << " vertices" << std::endl;
+			}
+		}
+	}
+}
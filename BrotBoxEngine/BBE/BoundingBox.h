@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../BBE/Vector3.h"
+#include "../BBE/Matrix4.h"
+
+namespace bbe
+{
+	class BoundingBox
+	{
+	private:
+		Vector3 m_min;
+		Vector3 m_max;
+
+	public:
+		BoundingBox();
+		BoundingBox(const Vector3 &min, const Vector3 &max);
+
+		static BoundingBox createFromCenterAndExtents(const Vector3 &center, const Vector3 &extents);
+
+		Vector3 getMin() const;
+		Vector3 getMax() const;
+		Vector3 getCenter() const;
+		Vector3 getExtents() const;
+		Vector3 getDim() const;
+		float getSurfaceArea() const;
+
+		void set(const Vector3 &min, const Vector3 &max);
+
+		BoundingBox transform(const Matrix4 &transform) const;
+		BoundingBox merge(const BoundingBox &other) const;
+		BoundingBox merge(const Vector3 &point) const;
+
+		bool contains(const Vector3 &point) const;
+		bool intersects(const BoundingBox &other) const;
+	};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../BBE/Vector3.h"
+#include "../BBE/BoundingBox.h"
+
+namespace bbe
+{
+	class BoundingSphere
+	{
+	private:
+		Vector3 m_center;
+		float m_radius;
+
+	public:
+		BoundingSphere();
+		BoundingSphere(const Vector3 &center, float radius);
+
+		Vector3 getCenter() const;
+		float getRadius() const;
+
+		void set(const Vector3 &center, float radius);
+
+		BoundingBox getBoundingBox() const;
+
+		bool contains(const Vector3 &point) const;
+		bool intersects(const BoundingSphere &other) const;
+		bool intersects(const BoundingBox &box) const;
+	};
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "../BBE/List.h"
+#include "../BBE/Vector3.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/BoundingSphere.h"
+#include "../BBE/Ray.h"
+#include "../BBE/Math.h"
+#include "../BBE/Exceptions.h"
+#include <xmmintrin.h>
+#include <cstdint>
+
+namespace bbe
+{
+	//A four wide BVH over axis aligned boxes. The hierarchy only knows the boxes, exact tests against
+	//the primitives inside of them are done by the callbacks that are passed to the queries.
+	class BoundingVolumeHierarchy
+	{
+	private:
+		//Child slot i is a leaf if m_counts[i] > 0, in that case m_children[i] is the first entry in
+		//m_indices. Bit i of m_usedSlots tells whether the slot is used at all.
+		struct Node
+		{
+			float    m_minX[4];
+			float    m_minY[4];
+			float    m_minZ[4];
+			float    m_maxX[4];
+			float    m_maxY[4];
+			float    m_maxZ[4];
+			uint32_t m_children[4];
+			uint32_t m_counts[4];
+			int      m_usedSlots;
+		};
+
+		struct BuildNode
+		{
+			BoundingBox m_box;
+			uint32_t    m_begin;
+			uint32_t    m_end;
+			int32_t     m_left = -1;
+			int32_t     m_right = -1;
+		};
+
+		static const size_t MAX_STACK_SIZE = 128;
+
+		//The traversal stack. Lives on the stack of the query for the usual trees and only spills into a List
+		//for the rest if a degenerate tree is deeper than that.
+		template <typename T>
+		class TraversalStack
+		{
+		private:
+			T       m_fixed[MAX_STACK_SIZE];
+			List<T> m_overflow;
+			size_t  m_size = 0;
+
+		public:
+			void push(const T &value)
+			{
+				if (m_size < MAX_STACK_SIZE)
+				{
+					m_fixed[m_size] = value;
+				}
+				else
+				{
+					m_overflow.add(value);
+				}
+				m_size++;
+			}
+
+			T pop()
+			{
+				m_size--;
+				if (m_size < MAX_STACK_SIZE)
+				{
+					return m_fixed[m_size];
+				}
+				const T value = m_overflow.last();
+				m_overflow.popBack();
+				return value;
+			}
+
+			bool isEmpty() const
+			{
+				return m_size == 0;
+			}
+		};
+
+		struct TraversalEntry
+		{
+			uint32_t m_node;
+			float    m_tNear;
+		};
+
+		List<Node>        m_nodes;
+		List<uint32_t>    m_indices;
+		List<BoundingBox> m_boxes;
+		size_t            m_maxPrimitivesPerLeaf;
+
+		int32_t buildBinary(List<BuildNode> &buildNodes, List<Vector3> &centroids, uint32_t begin, uint32_t end);
+		uint32_t collapse(const List<BuildNode> &buildNodes, int32_t buildNodeIndex);
+		void setSlot(Node &node, size_t slot, const BoundingBox &box) const;
+		void clearSlot(Node &node, size_t slot) const;
+		BoundingBox getNodeBox(const Node &node) const;
+
+		//Returns a bit mask of the child slots the ray hits within [0, maxT], and writes the entry distances.
+		static int intersectSlots(const Node &node, const __m128 origin[3], const __m128 invDir[3], float maxT, float* outTNear)
+		{
+			const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minX), origin[0]), invDir[0]);
+			const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_maxX), origin[0]), invDir[0]);
+			const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minY), origin[1]), invDir[1]);
+			const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_maxY), origin[1]), invDir[1]);
+			const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minZ), origin[2]), invDir[2]);
+			const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.m_maxZ), origin[2]), invDir[2]);
+
+			__m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_max_ps(_mm_min_ps(tz1, tz2), _mm_setzero_ps()));
+			__m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_min_ps(_mm_max_ps(tz1, tz2), _mm_set1_ps(maxT)));
+
+			_mm_storeu_ps(outTNear, tNear);
+			return _mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) & node.m_usedSlots;
+		}
+
+		static void prepareRay(const Ray &ray, __m128 outOrigin[3], __m128 outInvDir[3])
+		{
+			const Vector3 origin = ray.getOrigin();
+			const Vector3 direction = ray.getDirection();
+			for (int i = 0; i < 3; i++)
+			{
+				//A tiny direction instead of 0 keeps inf * 0 = NaN out of the slab test.
+				const float dir = direction[i] != 0 ? direction[i] : 1e-30f;
+				outOrigin[i] = _mm_set1_ps(origin[i]);
+				outInvDir[i] = _mm_set1_ps(1 / dir);
+			}
+		}
+
+		template <bool anyHit, typename IntersectFunc>
+		bool traverse(const Ray &ray, float maxT, IntersectFunc intersectFunc, size_t &outIndex, float &outT) const
+		{
+			if (m_nodes.getLength() == 0)
+			{
+				return false;
+			}
+
+			__m128 origin[3];
+			__m128 invDir[3];
+			prepareRay(ray, origin, invDir);
+
+			TraversalStack<TraversalEntry> stack;
+			stack.push({ 0, 0 });
+
+			bool hit = false;
+			float bestT = maxT;
+			while (!stack.isEmpty())
+			{
+				const TraversalEntry entry = stack.pop();
+				if (entry.m_tNear > bestT)
+				{
+					continue;
+				}
+				const Node &node = m_nodes[entry.m_node];
+
+				float tNear[4];
+				int mask = intersectSlots(node, origin, invDir, bestT, tNear);
+				if (mask == 0)
+				{
+					continue;
+				}
+
+				//Visit the slots front to back, so that close hits shrink bestT as early as possible.
+				int order[4];
+				int amountOfSlots = 0;
+				for (int i = 0; i < 4; i++)
+				{
+					if (mask & (1 << i))
+					{
+						int k = amountOfSlots;
+						while (k > 0 && tNear[order[k - 1]] > tNear[i])
+						{
+							order[k] = order[k - 1];
+							k--;
+						}
+						order[k] = i;
+						amountOfSlots++;
+					}
+				}
+
+				int innerSlots[4];
+				int amountOfInnerSlots = 0;
+				for (int k = 0; k < amountOfSlots; k++)
+				{
+					const int slot = order[k];
+					if (tNear[slot] > bestT)
+					{
+						break;
+					}
+					if (node.m_counts[slot] == 0)
+					{
+						innerSlots[amountOfInnerSlots] = slot;
+						amountOfInnerSlots++;
+						continue;
+					}
+
+					const uint32_t first = node.m_children[slot];
+					const uint32_t last = first + node.m_counts[slot];
+					for (uint32_t i = first; i < last; i++)
+					{
+						float t;
+						if (intersectFunc((size_t)m_indices[i], bestT, t) && t <= bestT)
+						{
+							hit = true;
+							bestT = t;
+							outIndex = m_indices[i];
+							outT = t;
+							if (anyHit)
+							{
+								return true;
+							}
+						}
+					}
+				}
+
+				//Pushed far to near, so that the nearest child is popped first.
+				for (int k = amountOfInnerSlots - 1; k >= 0; k--)
+				{
+					const int slot = innerSlots[k];
+					stack.push({ node.m_children[slot], tNear[slot] });
+				}
+			}
+			return hit;
+		}
+
+	public:
+		explicit BoundingVolumeHierarchy(size_t maxPrimitivesPerLeaf = 4);
+
+		//Builds the hierarchy with the surface area heuristic. The index of a box is the id of the primitive.
+		void build(const BoundingBox* boxes, size_t amount);
+		//Keeps the topology and only updates the boxes. Much cheaper than build, but the quality
+		//degrades if the primitives move far from where they were during the build.
+		void refit(const BoundingBox* boxes, size_t amount);
+		void clear();
+
+		size_t getAmountOfPrimitives() const;
+		size_t getAmountOfNodes() const;
+		BoundingBox getBoundingBox() const;
+		BoundingBox getPrimitiveBoundingBox(size_t index) const;
+
+		//intersectFunc(size_t index, float maxT, float &outT) returns whether the ray hits primitive index
+		//within [0, maxT] and writes the t of the hit. Returns the closest hit.
+		template <typename IntersectFunc>
+		bool raycast(const Ray &ray, IntersectFunc intersectFunc, size_t &outIndex, float &outT, float maxT = Math::INFINITY_POSITIVE) const
+		{
+			return traverse<false>(ray, maxT, intersectFunc, outIndex, outT);
+		}
+
+		//Like raycast, but against the boxes of the primitives themselves.
+		bool raycast(const Ray &ray, size_t &outIndex, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+
+		//Returns whether anything is hit between from and to and stops at the first hit found, which is
+		//not necessarily the closest one. This is the right query for line of sight checks.
+		template <typename IntersectFunc>
+		bool intersectsSegment(const Vector3 &from, const Vector3 &to, IntersectFunc intersectFunc) const
+		{
+			size_t index;
+			float t;
+			return traverse<true>(Ray::createFromPoints(from, to), 1, intersectFunc, index, t);
+		}
+
+		bool intersectsSegment(const Vector3 &from, const Vector3 &to) const;
+
+		//Collects every primitive whose box overlaps the sphere.
+		void querySphere(const BoundingSphere &sphere, List<size_t> &outIndices) const;
+	};
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "../BBE/Array.h"
+#include "../BBE/BarnesHutTree.h"
 #include "../BBE/DynamicArray.h"
 #include "../BBE/Hash.h"
 #include "../BBE/HashMap.h"
 #include "../BBE/List.h"
+#include "../BBE/SkylinePacker.h"
+#include "../BBE/SpatialHashGrid.h"
 #include "../BBE/Stack.h"
 
 #include "../BBE/ExceptionHelper.h"
@@ -23,6 +26,8 @@
 #include "../BBE/PrimitiveBrush2D.h"
 #include "../BBE/PrimitiveBrush3D.h"
 #include "../BBE/VertexWithNormal.h"
+#include "../BBE/TerrainVertex.h"
+#include "../BBE/InstanceData3D.h"
 #include "../BBE/Window.h"
 
 #include "../BBE/VWDepthImage.h"
@@ -32,40 +37,61 @@
 #include "../BBE/VulkanDescriptorPool.h"
 #include "../BBE/VulkanDevice.h"
 #include "../BBE/VulkanFence.h"
+#include "../BBE/VulkanFrame.h"
 #include "../BBE/VulkanHelper.h"
 #include "../BBE/VulkanInstance.h"
 #include "../BBE/VulkanManager.h"
+#include "../BBE/VulkanMemoryAllocator.h"
+#include "../BBE/VulkanObjectCounter.h"
+#include "../BBE/VulkanOffscreenTarget.h"
 #include "../BBE/VulkanPhysicalDevices.h"
 #include "../BBE/VulkanPipeline.h"
+#include "../BBE/VulkanPipelineCache.h"
 #include "../BBE/VulkanRenderPass.h"
 #include "../BBE/VulkanSemaphore.h"
 #include "../BBE/VulkanShader.h"
 #include "../BBE/VulkanSurface.h"
 #include "../BBE/VulkanSwapchain.h"
+#include "../BBE/VulkanUniformRing.h"
+#include "../BBE/VulkanUploadBatcher.h"
 
 #include "../BBE/CameraControlNoClip.h"
 #include "../BBE/Keyboard.h"
 #include "../BBE/KeyboardKeys.h"
 #include "../BBE/Mouse.h"
 
+#include "../BBE/BoundingBox.h"
+#include "../BBE/BoundingSphere.h"
+#include "../BBE/Frustum.h"
+#include "../BBE/Ray.h"
+#include "../BBE/BoundingVolumeHierarchy.h"
 #include "../BBE/Math.h"
 #include "../BBE/Matrix4.h"
 #include "../BBE/ValueNoise2D.h"
+#include "../BBE/Heightfield.h"
+#include "../BBE/GradientNoise.h"
+#include "../BBE/FractalNoise.h"
 #include "../BBE/Vector2.h"
 #include "../BBE/Vector3.h"
 #include "../BBE/Vector4.h"
 
 #include "../BBE/DefaultDestroyer.h"
 #include "../BBE/DefragmentationAllocator.h"
+#include "../BBE/FreeListAllocator.h"
 #include "../BBE/GeneralPurposeAllocator.h"
 #include "../BBE/NewDeleteAllocator.h"
 #include "../BBE/PoolAllocator.h"
+#include "../BBE/RingAllocator.h"
 #include "../BBE/StackAllocator.h"
 #include "../BBE/STLAllocator.h"
 #include "../BBE/UniquePointer.h"
 
 #include "../BBE/LinearCongruentialGenerator.h"
 #include "../BBE/MersenneTwister.h"
+#include "../BBE/SplitMix64.h"
+#include "../BBE/PCG32.h"
+#include "../BBE/Xoshiro256.h"
+#include "../BBE/Philox.h"
 #include "../BBE/Random.h"
 
 #include "../BBE/Circle.h"
@@ -73,6 +99,8 @@
 #include "../BBE/IcoSphere.h"
 #include "../BBE/Rectangle.h"
 #include "../BBE/Terrain.h"
+#include "../BBE/StreamingTerrain.h"
+#include "../BBE/TextureAtlas.h"
 
 #include "../BBE/CPUWatch.h"
 #include "../BBE/GameTime.h"
@@ -81,6 +109,7 @@
 #include "../BBE/DataType.h"
 #include "../BBE/EmptyClass.h"
 #include "../BBE/STLCapsule.h"
+#include "../BBE/ThreadPool.h"
 #include "../BBE/Unconstructed.h"
 #include "../BBE/UtilDebug.h"
 #include "../BBE/UtilTest.h"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../BBE/Vector3.h"
+#include "../BBE/Ray.h"
 
 namespace bbe
 {
@@ -21,5 +22,7 @@ namespace bbe
 		void update(float timeSinceLastFrame);
 		Vector3 getCameraPos();
 		Vector3 getCameraTarget();
+		//The ray through the center of the screen, for picking while the cursor is disabled.
+		Ray getCameraRay();
 	};
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace bbe
 	class Circle
 	{
 		friend class PrimitiveBrush2D;
+		friend class Batch2D;
 		friend class INTERNAL::vulkan::VulkanManager;
 	private:
 		float m_x;
@@ -3,6 +3,8 @@
 #include "../BBE/VulkanBuffer.h"
 #include "../BBE/Matrix4.h"
 #include "../BBE/Vector3.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/Ray.h"
 
 namespace bbe
 {
@@ -46,5 +48,8 @@ namespace bbe
 		float getDepth() const;
 
 		Matrix4 getTransform() const;
+		BoundingBox getBoundingBox() const;
+
+		bool intersects(const Ray &ray, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../BBE/String.h"
 
 namespace bbe
 {
@@ -9,6 +10,21 @@ namespace bbe
 
 		int getAmountOfLightSources();
 		void setAmountOfLightSources(int amount);
+
+		//The amount of frames the CPU may record while the GPU still renders the previous ones. More frames let
+		//the CPU and the GPU overlap better but add latency. Between 1 and 4, default 2.
+		int getAmountOfFramesInFlight();
+		void setAmountOfFramesInFlight(int amount);
+
+		//The file the compiled pipelines are kept in between runs. An empty path disables it. Default
+		//"pipelineCache.bin".
+		const String& getPipelineCachePath();
+		void setPipelineCachePath(const String &path);
+
+		//Renders into offscreen images instead of a window, so neither a display nor a surface is needed. The
+		//frames can be read back with Game::captureFrame. Default false.
+		bool isHeadless();
+		void setHeadless(bool headless);
 	}
 
 }
\ No newline at end of file
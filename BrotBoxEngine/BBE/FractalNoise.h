@@ -0,0 +1,338 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../BBE/GradientNoise.h"
+#include "../BBE/Exceptions.h"
+#include "../BBE/ThreadPool.h"
+
+namespace bbe
+{
+	enum class FractalType
+	{
+		//Sum of octaves, roughly in [-1, 1].
+		FBM,
+		//Sharp crests where the noise crosses zero, in [0, 1].
+		RIDGED,
+		//FBM sampled at positions displaced by two further FBM lookups (Quilez, "Domain warping").
+		WARPED,
+	};
+
+	//Layers octaves of a point evaluable noise (PerlinNoise or SimplexNoise). Like the noise itself every
+	//point can be evaluated on its own, so getRegion can generate any part of an unbounded world on demand.
+	template <typename Noise>
+	class FractalNoise
+	{
+	private:
+		static constexpr size_t BATCH_SIZE = 256;
+		//Shifts every octave, so that the lattice points of the octaves do not line up.
+		static constexpr float OCTAVE_OFFSET = 19.19f;
+		static constexpr float WARP_OFFSET_X = 5.2f;
+		static constexpr float WARP_OFFSET_Y = 1.3f;
+		static constexpr float WARP_OFFSET_Z = 7.9f;
+
+		Noise       m_noise;
+		FractalType m_type         = FractalType::FBM;
+		int         m_octaves      = 5;
+		float       m_frequency    = 1;
+		float       m_lacunarity   = 2;
+		float       m_gain         = 0.5f;
+		float       m_warpStrength = 1;
+
+		float getAmplitudeNormalization() const
+		{
+			float sum = 0;
+			float amplitude = 1;
+			for (int octave = 0; octave < m_octaves; octave++)
+			{
+				sum += amplitude;
+				amplitude *= m_gain;
+			}
+			return 1 / sum;
+		}
+
+		float combine(float value) const
+		{
+			if (m_type == FractalType::RIDGED)
+			{
+				const float ridge = 1 - (value < 0 ? -value : value);
+				return ridge * ridge;
+			}
+			return value;
+		}
+
+		float accumulate(float x, float y) const
+		{
+			float sum = 0;
+			float amplitude = 1;
+			float frequency = m_frequency;
+			for (int octave = 0; octave < m_octaves; octave++)
+			{
+				const float offset = octave * OCTAVE_OFFSET;
+				sum += combine(m_noise.get(x * frequency + offset, y * frequency + offset)) * amplitude;
+				frequency *= m_lacunarity;
+				amplitude *= m_gain;
+			}
+			return sum * getAmplitudeNormalization();
+		}
+
+		float accumulate(float x, float y, float z) const
+		{
+			float sum = 0;
+			float amplitude = 1;
+			float frequency = m_frequency;
+			for (int octave = 0; octave < m_octaves; octave++)
+			{
+				const float offset = octave * OCTAVE_OFFSET;
+				sum += combine(m_noise.get(x * frequency + offset, y * frequency + offset, z * frequency + offset)) * amplitude;
+				frequency *= m_lacunarity;
+				amplitude *= m_gain;
+			}
+			return sum * getAmplitudeNormalization();
+		}
+
+		//Same as accumulate for up to BATCH_SIZE points, using the batch functions of the noise.
+		//z may be nullptr for 2D.
+		void accumulate(const float* x, const float* y, const float* z, float* out, size_t amount) const
+		{
+			float scaledX[BATCH_SIZE];
+			float scaledY[BATCH_SIZE];
+			float scaledZ[BATCH_SIZE];
+			float values[BATCH_SIZE];
+			for (size_t i = 0; i < amount; i++)
+			{
+				out[i] = 0;
+			}
+
+			float amplitude = 1;
+			float frequency = m_frequency;
+			for (int octave = 0; octave < m_octaves; octave++)
+			{
+				const float offset = octave * OCTAVE_OFFSET;
+				for (size_t i = 0; i < amount; i++)
+				{
+					scaledX[i] = x[i] * frequency + offset;
+					scaledY[i] = y[i] * frequency + offset;
+				}
+				if (z != nullptr)
+				{
+					for (size_t i = 0; i < amount; i++)
+					{
+						scaledZ[i] = z[i] * frequency + offset;
+					}
+					m_noise.get(scaledX, scaledY, scaledZ, values, amount);
+				}
+				else
+				{
+					m_noise.get(scaledX, scaledY, values, amount);
+				}
+				for (size_t i = 0; i < amount; i++)
+				{
+					out[i] += combine(values[i]) * amplitude;
+				}
+				frequency *= m_lacunarity;
+				amplitude *= m_gain;
+			}
+
+			const float normalization = getAmplitudeNormalization();
+			for (size_t i = 0; i < amount; i++)
+			{
+				out[i] *= normalization;
+			}
+		}
+
+		void getBatch(const float* x, const float* y, const float* z, float* out, size_t amount) const
+		{
+			if (m_type != FractalType::WARPED)
+			{
+				accumulate(x, y, z, out, amount);
+				return;
+			}
+
+			float warpX[BATCH_SIZE];
+			float warpY[BATCH_SIZE];
+			float warpZ[BATCH_SIZE];
+			float shifted[BATCH_SIZE];
+			accumulate(x, y, z, warpX, amount);
+			for (size_t i = 0; i < amount; i++)
+			{
+				shifted[i] = x[i] + WARP_OFFSET_X;
+			}
+			accumulate(shifted, y, z, warpY, amount);
+			if (z != nullptr)
+			{
+				for (size_t i = 0; i < amount; i++)
+				{
+					shifted[i] = y[i] + WARP_OFFSET_Y;
+				}
+				accumulate(x, shifted, z, warpZ, amount);
+			}
+
+			for (size_t i = 0; i < amount; i++)
+			{
+				warpX[i] = x[i] + m_warpStrength * warpX[i];
+				warpY[i] = y[i] + m_warpStrength * warpY[i];
+			}
+			if (z != nullptr)
+			{
+				for (size_t i = 0; i < amount; i++)
+				{
+					warpZ[i] = z[i] + m_warpStrength * warpZ[i];
+				}
+			}
+			accumulate(warpX, warpY, z != nullptr ? warpZ : nullptr, out, amount);
+		}
+
+	public:
+		explicit FractalNoise(uint64_t seed = 0)
+			: m_noise(seed)
+		{
+			//DO NOTHING
+		}
+
+		void setSeed(uint64_t seed)
+		{
+			m_noise.setSeed(seed);
+		}
+
+		void setType(FractalType type)
+		{
+			m_type = type;
+		}
+
+		void setOctaves(int octaves)
+		{
+			if (octaves < 1)
+			{
+				throw IllegalArgumentException();
+			}
+			m_octaves = octaves;
+		}
+
+		//Frequency of the first octave.
+		void setFrequency(float frequency)
+		{
+			m_frequency = frequency;
+		}
+
+		//Factor from the frequency of one octave to the next.
+		void setLacunarity(float lacunarity)
+		{
+			m_lacunarity = lacunarity;
+		}
+
+		//Factor from the amplitude of one octave to the next.
+		void setGain(float gain)
+		{
+			m_gain = gain;
+		}
+
+		//Displacement of WARPED in input coordinates.
+		void setWarpStrength(float warpStrength)
+		{
+			m_warpStrength = warpStrength;
+		}
+
+		FractalType getType() const
+		{
+			return m_type;
+		}
+
+		int getOctaves() const
+		{
+			return m_octaves;
+		}
+
+		float getFrequency() const
+		{
+			return m_frequency;
+		}
+
+		float getLacunarity() const
+		{
+			return m_lacunarity;
+		}
+
+		float getGain() const
+		{
+			return m_gain;
+		}
+
+		float getWarpStrength() const
+		{
+			return m_warpStrength;
+		}
+
+		float get(float x, float y) const
+		{
+			if (m_type != FractalType::WARPED)
+			{
+				return accumulate(x, y);
+			}
+			const float warpX = accumulate(x, y);
+			const float warpY = accumulate(x + WARP_OFFSET_X, y);
+			return accumulate(x + m_warpStrength * warpX, y + m_warpStrength * warpY);
+		}
+
+		float get(float x, float y, float z) const
+		{
+			if (m_type != FractalType::WARPED)
+			{
+				return accumulate(x, y, z);
+			}
+			const float warpX = accumulate(x, y, z);
+			const float warpY = accumulate(x + WARP_OFFSET_X, y, z);
+			const float warpZ = accumulate(x, y + WARP_OFFSET_Y, z);
+			return accumulate(x + m_warpStrength * warpX, y + m_warpStrength * warpY, z + m_warpStrength * warpZ);
+		}
+
+		//out[i] = get(x[i], y[i]), evaluated with the SIMD batch functions of the noise.
+		void get(const float* x, const float* y, float* out, size_t amount) const
+		{
+			for (size_t start = 0; start < amount; start += BATCH_SIZE)
+			{
+				const size_t count = amount - start < BATCH_SIZE ? amount - start : BATCH_SIZE;
+				getBatch(x + start, y + start, nullptr, out + start, count);
+			}
+		}
+
+		void get(const float* x, const float* y, const float* z, float* out, size_t amount) const
+		{
+			for (size_t start = 0; start < amount; start += BATCH_SIZE)
+			{
+				const size_t count = amount - start < BATCH_SIZE ? amount - start : BATCH_SIZE;
+				getBatch(x + start, y + start, z + start, out + start, count);
+			}
+		}
+
+		//out[row * width + column] = get((startX + column) * spacing, (startY + row) * spacing). The sample
+		//position is computed from the integer index, so neighbouring regions agree exactly on shared edges.
+		void getRegion(float* out, int startX, int startY, int width, int height, float spacing, ThreadPool* threadPool = nullptr) const
+		{
+			if (width < 0 || height < 0)
+			{
+				throw IllegalArgumentException();
+			}
+
+			ThreadPool::parallelFor(threadPool, 0, (size_t)height, [&](size_t begin, size_t end)
+			{
+				float x[BATCH_SIZE];
+				float y[BATCH_SIZE];
+				for (size_t row = begin; row < end; row++)
+				{
+					const float rowY = (float)(startY + (int)row) * spacing;
+					for (int start = 0; start < width; start += (int)BATCH_SIZE)
+					{
+						const int count = width - start < (int)BATCH_SIZE ? width - start : (int)BATCH_SIZE;
+						for (int i = 0; i < count; i++)
+						{
+							x[i] = (float)(startX + start + i) * spacing;
+							y[i] = rowY;
+						}
+						getBatch(x, y, nullptr, out + row * width + start, count);
+					}
+				}
+			}, 4);
+		}
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include "../BBE/List.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		class FreeListAllocatorRange
+		{
+		public:
+			uint64_t m_offset;
+			uint64_t m_size;
+
+			FreeListAllocatorRange();
+			FreeListAllocatorRange(uint64_t offset, uint64_t size);
+
+			bool operator> (const FreeListAllocatorRange& other) const;
+			bool operator>=(const FreeListAllocatorRange& other) const;
+			bool operator< (const FreeListAllocatorRange& other) const;
+			bool operator<=(const FreeListAllocatorRange& other) const;
+			bool operator==(const FreeListAllocatorRange& other) const;
+		};
+	}
+
+	//Hands out offsets into an area of a fixed size, for example a block of device memory, and frees them in any
+	//order. The free ranges are kept sorted by their offset, so neighbouring ranges are merged again on free.
+	//Allocations take the smallest free range they fit in.
+	class FreeListAllocator
+	{
+	private:
+		uint64_t m_size     = 0;
+		uint64_t m_freeSize = 0;
+		size_t   m_amountOfAllocations = 0;
+		List<INTERNAL::FreeListAllocatorRange, true> m_freeRanges;
+
+	public:
+		FreeListAllocator();
+		explicit FreeListAllocator(uint64_t size);
+
+		//Frees everything.
+		void reset(uint64_t size);
+
+		//alignment must be a power of two. Returns false if there is no free range that is big enough.
+		bool allocate(uint64_t size, uint64_t alignment, uint64_t &outOffset);
+		//offset and size must be the ones of an allocation.
+		void free(uint64_t offset, uint64_t size);
+
+		uint64_t getSize() const;
+		uint64_t getFreeSize() const;
+		uint64_t getUsedSize() const;
+		//The biggest allocation that would currently succeed without alignment.
+		uint64_t getLargestFreeRange() const;
+		size_t getAmountOfFreeRanges() const;
+		size_t getAmountOfAllocations() const;
+		bool isEmpty() const;
+	};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../BBE/Vector4.h"
+#include "../BBE/Matrix4.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/BoundingSphere.h"
+
+namespace bbe
+{
+	class Frustum
+	{
+	private:
+		//xyz is the normal pointing into the frustum, w the distance. Order: left, right, bottom, top, near, far.
+		Vector4 m_planes[6];
+
+	public:
+		Frustum();
+		Frustum(const Matrix4 &viewProjection);
+
+		void set(const Matrix4 &viewProjection);
+		Vector4 getPlane(int index) const;
+
+		bool isVisible(const Vector3 &point) const;
+		bool isVisible(const BoundingBox &box) const;
+		bool isVisible(const BoundingSphere &sphere) const;
+
+		//Tests four boxes per iteration with SSE. Returns the amount of visible boxes.
+		size_t isVisible(const BoundingBox *boxes, bool *outVisible, size_t amount) const;
+	};
+}
@@ -10,6 +10,7 @@ namespace bbe
 	class Window;
 	class PrimitiveBrush2D;
 	class PrimitiveBrush3D;
+	class Image;
 
 	class Game
 	{
@@ -52,5 +53,11 @@ namespace bbe
 		float getMouseYDelta();
 
 		void setCursorMode(bbe::CursorMode cm);
+
+		//Ends the loop of start after the current frame.
+		void closeWindow();
+		//Copies the last submitted frame, which is the one drawn before the current call of update, into outImage.
+		//Only available if Settings::isHeadless().
+		void captureFrame(bbe::Image &outImage);
 	};
 }
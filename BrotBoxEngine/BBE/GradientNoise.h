@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace bbe
+{
+	//Base of the lattice noises. Unlike ValueNoise2D nothing is stored per point, so every point of an
+	//unbounded world can be evaluated on its own, in any order and on any thread.
+	class GradientNoise
+	{
+	protected:
+		//Two copies of a shuffled 0..255, so that hashes of neighbouring cells need no wrap around.
+		int m_permutation[512];
+
+	public:
+		explicit GradientNoise(uint64_t seed = 0);
+
+		void setSeed(uint64_t seed);
+	};
+
+	//Improved gradient noise (Perlin, "Improving Noise"). Roughly in [-1, 1] and 0 on the integer lattice.
+	class PerlinNoise : public GradientNoise
+	{
+	public:
+		explicit PerlinNoise(uint64_t seed = 0);
+
+		float get(float x, float y) const;
+		float get(float x, float y, float z) const;
+
+		//out[i] = get(x[i], y[i]), four points at a time.
+		void get(const float* x, const float* y, float* out, size_t amount) const;
+		void get(const float* x, const float* y, const float* z, float* out, size_t amount) const;
+	};
+
+	//Simplex noise (Perlin 2001, after Gustavson, "Simplex noise demystified"). Roughly in [-1, 1].
+	//Cheaper than PerlinNoise in 3D and without its axis aligned artifacts.
+	class SimplexNoise : public GradientNoise
+	{
+	public:
+		explicit SimplexNoise(uint64_t seed = 0);
+
+		float get(float x, float y) const;
+		float get(float x, float y, float z) const;
+
+		//out[i] = get(x[i], y[i]), four points at a time.
+		void get(const float* x, const float* y, float* out, size_t amount) const;
+		void get(const float* x, const float* y, const float* z, float* out, size_t amount) const;
+	};
+}
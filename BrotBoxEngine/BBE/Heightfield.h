@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+
+namespace bbe
+{
+	class ThreadPool;
+	class Vector3;
+
+	//Processes row major heightfields in place, such as the ones of ValueNoise2D. The heightfield is split into
+	//square tiles that run on the threadPool, if there is one. Every tile iterates on a copy of itself and a halo
+	//of its neighbours, so the threads only exchange their borders every HALO_SIZE iterations. The result does
+	//not depend on the threadPool or on the tile size.
+	class Heightfield
+	{
+	private:
+		//One iteration over all cells of a buffer, from the src planes to the dst planes. Cells outside of
+		//the buffer count as missing.
+		typedef std::function<void(const float* const* src, float* const* dst, int width, int height)> StencilStep;
+
+		int   m_tileSize            = 128;
+		int   m_thermalIterations   = 0;
+		int   m_hydraulicIterations = 0;
+		float m_talus               = 0.005f;
+		float m_thermalStrength     = 0.2f;
+		float m_rain                = 0.01f;
+		float m_solubility          = 0.01f;
+		float m_evaporation         = 0.5f;
+		float m_sedimentCapacity    = 0.01f;
+
+		void runStencil(float** planes, int amountOfPlanes, int width, int height, int iterations, ThreadPool* threadPool, const StencilStep &step) const;
+
+	public:
+		//The amount of iterations a tile runs before it exchanges its borders.
+		static const int HALO_SIZE;
+
+		Heightfield();
+
+		//Writes the normal of every sample, from central differences and one sided differences on the borders.
+		//spacing is the distance between two samples, heightScale is multiplied with every height.
+		static void computeNormals(const float* heights, int width, int height, float spacing, float heightScale, Vector3* outNormals, ThreadPool* threadPool = nullptr);
+
+		//Runs the configured amount of hydraulic and then thermal erosion iterations.
+		void erode(float* heights, int width, int height, ThreadPool* threadPool = nullptr) const;
+		//Material slides to lower neighbours as long as the slope is steeper than the talus.
+		void erodeThermal(float* heights, int width, int height, int iterations, ThreadPool* threadPool = nullptr) const;
+		//Rain dissolves material, the water carries it downhill and deposits it once it evaporates.
+		void erodeHydraulic(float* heights, int width, int height, int iterations, ThreadPool* threadPool = nullptr) const;
+
+		void setTileSize(int tileSize);
+		void setThermalIterations(int iterations);
+		void setHydraulicIterations(int iterations);
+		void setTalus(float talus);
+		//The share of the height difference above the talus that moves per iteration, at most 0.25.
+		void setThermalStrength(float strength);
+		void setRain(float rain);
+		void setSolubility(float solubility);
+		//The share of the water that evaporates per iteration.
+		void setEvaporation(float evaporation);
+		void setSedimentCapacity(float capacity);
+
+		int getTileSize() const;
+		int getThermalIterations() const;
+		int getHydraulicIterations() const;
+		float getTalus() const;
+		float getThermalStrength() const;
+		float getRain() const;
+		float getSolubility() const;
+		float getEvaporation() const;
+		float getSedimentCapacity() const;
+	};
+}
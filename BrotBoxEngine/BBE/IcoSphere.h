@@ -3,6 +3,9 @@
 #include "../BBE/VulkanBuffer.h"
 #include "../BBE/Matrix4.h"
 #include "../BBE/Vector3.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/BoundingSphere.h"
+#include "../BBE/Ray.h"
 
 namespace bbe
 {
@@ -51,5 +54,10 @@ namespace bbe
 		float getDepth() const;
 
 		Matrix4 getTransform() const;
+		BoundingSphere getBoundingSphere() const;
+		BoundingBox getBoundingBox() const;
+
+		//Tests against the ideal (scaled) sphere, not against the triangles of the mesh.
+		bool intersects(const Ray &ray, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
 	};
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "../BBE/Color.h"
 #include "../BBE/String.h"
 #include "../BBE/VulkanDescriptorSet.h"
+#include "../BBE/Rectangle.h"
+#include <stdint.h>
 
 namespace bbe
 {
@@ -16,23 +18,26 @@ namespace bbe
 			class VulkanCommandPool;
 			class VulkanManager;
 			class VulkanDescriptorSet;
+			class VulkanUploadBatcher;
 		}
 	}
 
 	class PrimitiveBrush2D;
+	class TextureAtlas;
 
 	class Image
 	{
 		friend class INTERNAL::vulkan::VulkanManager;
 		friend class INTERNAL::vulkan::VulkanDescriptorSet;
 		friend class PrimitiveBrush2D;
+		friend class TextureAtlas;
 	private:
 		ColorByte *m_pdata  = nullptr;
 		int    m_width  = 0;
 		int    m_height = 0;
 
 		mutable VkImage        m_image       = VK_NULL_HANDLE;
-		mutable VkDeviceMemory m_imageMemory = VK_NULL_HANDLE;
+		mutable INTERNAL::vulkan::VulkanMemoryAllocation m_imageMemory;
 		mutable VkImageView    m_imageView   = VK_NULL_HANDLE;
 		mutable VkImageLayout  m_imageLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
 		mutable VkDevice       m_device      = VK_NULL_HANDLE;
@@ -40,9 +45,12 @@ namespace bbe
 		mutable INTERNAL::vulkan::VulkanDescriptorSet m_descriptorSet;
 
 		mutable bool wasUploadedToVulkan = false;
-		void createAndUpload(const INTERNAL::vulkan::VulkanDevice &device, const INTERNAL::vulkan::VulkanCommandPool &commandPool, const INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout &setLayout) const;
-		void changeLayout(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkImageLayout layout) const;
-		void writeBufferToImage(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkBuffer buffer) const;
+
+		//The TextureAtlas this image was added to and its place there, empty if it did not fit.
+		mutable uint64_t  m_atlasId = 0;
+		mutable Rectangle m_atlasUvRect;
+
+		void createAndUpload(INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher, const INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout &setLayout) const;
 
 		VkSampler getSampler() const;
 		VkImageView getImageView() const;
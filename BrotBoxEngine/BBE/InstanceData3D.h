@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../BBE/Matrix4.h"
+#include "../BBE/Color.h"
+
+namespace bbe
+{
+	//The per instance vertex input of the instanced 3D pipeline. The columns of the model matrix take the
+	//locations 2 to 5, the color location 6.
+	class InstanceData3D
+	{
+	public:
+		Matrix4 m_transform;
+		Color   m_color;
+
+		InstanceData3D(const Matrix4 &transform, const Color &color)
+			: m_transform(transform), m_color(color)
+		{
+		}
+	};
+}
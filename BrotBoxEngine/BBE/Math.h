@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+#include <stdint.h>
 
 namespace bbe
 {
@@ -9,14 +11,14 @@ namespace bbe
 
 	namespace Math
 	{
-		extern const float PI;
-		extern const float TAU;
-		extern const float E;
-		extern const float SQRT2;
-		extern const float SQRT2INV;
-		extern const float INFINITY_POSITIVE;
-		extern const float INFINITY_NEGATIVE;
-		extern const float NaN;
+		constexpr float PI = 3.14159265359f;
+		constexpr float TAU = 6.28318530718f;
+		constexpr float E = 2.71828182845f;
+		constexpr float SQRT2 = 1.41421356237f;
+		constexpr float SQRT2INV = 0.70710678118f;
+		constexpr float INFINITY_POSITIVE = std::numeric_limits<float>::infinity();
+		constexpr float INFINITY_NEGATIVE = -std::numeric_limits<float>::infinity();
+		constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
 
 		float cos(float val);
 		float acos(float val);
@@ -27,6 +29,9 @@ namespace bbe
 		float sqrt(float val);
 		float mod(float val, float mod);
 		float pingpong(float val, float border);
+		//IEEE 754 half precision, rounded to nearest even. Values too large for a half become infinity.
+		uint16_t floatToHalf(float val);
+		float halfToFloat(uint16_t val);
 
 		constexpr float toRadians(float val)
 		{
@@ -38,33 +43,149 @@ namespace bbe
 			return val * 57.295779513f;
 		}
 
-		float floor(float val);
-		float ceil(float val);
-		float round(float val);
-		float square(float val);
-		float clamp(float val, float min, float max);
-		float clamp01(float val);
-		bool  isInRange(float val, float min, float max);
-		bool  isInRangeStrict(float val, float min, float max);
-		bool  isInRange01(float val);
-		bool  isInRange01Strict(float val);
-		float abs(float val);
-		float max(float val1, float val2);
-		float max(float val1, float val2, float val3);
-		float max(float val1, float val2, float val3, float val4);
-		float min(float val1, float val2);
-		float min(float val1, float val2, float val3);
-		float min(float val1, float val2, float val3, float val4);
-		float maxAbs(float val1, float val2);
-		float maxAbs(float val1, float val2, float val3);
-		float minAbs(float val1, float val2);
-		float minAbs(float val1, float val2, float val3);
-		float maxAbsKeepSign(float val1, float val2);
-		float maxAbsKeepSign(float val1, float val2, float val3);
-		float minAbsKeepSign(float val1, float val2);
-		float minAbsKeepSign(float val1, float val2, float val3);
-		bool floatEquals(float val1, float val2, float epsilon);
-		float isNaN(float val);
+		constexpr float floor(float val)
+		{
+			int iVal = (int)val;
+			if (val >= 0 || iVal == val)
+			{
+				return (float)iVal;
+			}
+			else
+			{
+				return (float)(iVal - 1);
+			}
+		}
+
+		constexpr float ceil(float val)
+		{
+			return -floor(-val);
+		}
+
+		constexpr float round(float val)
+		{
+			return val < 0 ? (float)(int)(val - 0.5) : (float)(int)(val + 0.5);
+		}
+
+		constexpr float square(float val)
+		{
+			return val * val;
+		}
+
+		constexpr float clamp(float val, float min, float max)
+		{
+			return val < min ? min : (val > max ? max : val);
+		}
+
+		constexpr float clamp01(float val)
+		{
+			return (val < 0) ? 0 : (val > 1 ? 1 : val);
+		}
+
+		constexpr bool isInRange(float val, float min, float max)
+		{
+			return val >= min && val <= max;
+		}
+
+		constexpr bool isInRangeStrict(float val, float min, float max)
+		{
+			return val > min && val < max;
+		}
+
+		constexpr bool isInRange01(float val)
+		{
+			return val >= 0 && val <= 1;
+		}
+
+		constexpr bool isInRange01Strict(float val)
+		{
+			return val > 0 && val < 1;
+		}
+
+		constexpr float abs(float val)
+		{
+			return val < 0 ? -val : val;
+		}
+
+		constexpr float max(float val1, float val2)
+		{
+			return val1 > val2 ? val1 : val2;
+		}
+
+		constexpr float max(float val1, float val2, float val3)
+		{
+			return max(max(val1, val2), val3);
+		}
+
+		constexpr float max(float val1, float val2, float val3, float val4)
+		{
+			return max(max(val1, val2), max(val3, val4));
+		}
+
+		constexpr float min(float val1, float val2)
+		{
+			return val1 < val2 ? val1 : val2;
+		}
+
+		constexpr float min(float val1, float val2, float val3)
+		{
+			return min(min(val1, val2), val3);
+		}
+
+		constexpr float min(float val1, float val2, float val3, float val4)
+		{
+			return min(min(val1, val2), min(val3, val4));
+		}
+
+		constexpr float maxAbs(float val1, float val2)
+		{
+			return max(abs(val1), abs(val2));
+		}
+
+		constexpr float maxAbs(float val1, float val2, float val3)
+		{
+			return max(abs(val1), abs(val2), abs(val3));
+		}
+
+		constexpr float minAbs(float val1, float val2)
+		{
+			return min(abs(val1), abs(val2));
+		}
+
+		constexpr float minAbs(float val1, float val2, float val3)
+		{
+			return min(abs(val1), abs(val2), abs(val3));
+		}
+
+		constexpr float maxAbsKeepSign(float val1, float val2)
+		{
+			return abs(val1) > abs(val2) ? val1 : val2;
+		}
+
+		constexpr float maxAbsKeepSign(float val1, float val2, float val3)
+		{
+			return maxAbsKeepSign(maxAbsKeepSign(val1, val2), val3);
+		}
+
+		constexpr float minAbsKeepSign(float val1, float val2)
+		{
+			return abs(val1) < abs(val2) ? val1 : val2;
+		}
+
+		constexpr float minAbsKeepSign(float val1, float val2, float val3)
+		{
+			return minAbsKeepSign(minAbsKeepSign(val1, val2), val3);
+		}
+
+		constexpr bool floatEquals(float val1, float val2, float epsilon)
+		{
+			return (val1 - val2) > epsilon ? false : ((val1 - val2) < -epsilon ? false : true);
+		}
+
+		constexpr float isNaN(float val)
+		{
+			return val != val;
+		}
+
 		float isInfinity(float val);
 		float isPositiveInfinity(float val);
 		float isNegativeInfinity(float val);
@@ -74,14 +195,48 @@ namespace bbe
 			return (value + multipleOf - 1) - ((value + multipleOf - 1) % multipleOf);
 		}
 
-		bool isOdd(int val);
-		bool isEven(int val);
+		constexpr bool isOdd(int val)
+		{
+			return (val & 1) == 1;
+		}
+
+		constexpr bool isEven(int val)
+		{
+			return (val & 1) == 0;
+		}
+
+		constexpr float interpolateLinear(float a, float b, float t)
+		{
+			return a == b ? a : a * (1 - t) + b * t;
+		}
+
+		constexpr float interpolateBool(float a, float b, float t)
+		{
+			return t >= 0.5 ? b : a;
+		}
 
-		float interpolateLinear(float a, float b, float t);
-		float interpolateBool(float a, float b, float t);
 		float interpolateCosine(float a, float b, float t);
-		float interpolateCubic(float preA, float a, float b, float postB, float t);
-		float interpolateBezier(float a, float b, float t, float control);
+
+		constexpr float interpolateCubic(float preA, float a, float b, float postB, float t)
+		{
+			//UNTESTED
+			if (a == preA && a == b && a == postB) return a;
+			float t2 = t * t;
+			float w0 = postB - b - preA + a;
+			float w1 = preA - a - w0;
+			float w2 = b - preA;
+			float w3 = a;
+
+			return (w0*t*t2 + w1*t2 + w2*t + w3);
+		}
+
+		constexpr float interpolateBezier(float a, float b, float t, float control)
+		{
+			//UNTESTED
+			if (a == b && a == control) return a;
+			float t2 = t * t;
+			return b*t2 + 2 * control * t - 2 * control*t2 + a - 2 * a*t + a*t2;
+		}
 
 		Vector2 interpolateLinear(Vector2 a, Vector2 b, float t);
 		Vector2 interpolateBool(Vector2 a, Vector2 b, float t);
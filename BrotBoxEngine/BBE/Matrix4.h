@@ -2,6 +2,7 @@
 
 #include "../BBE/Vector4.h"
 #include "../BBE/Vector3.h"
+#include "../BBE/Exceptions.h"
 
 namespace bbe
 {
@@ -11,30 +12,152 @@ namespace bbe
 		Vector4 m_cols[4];
 
 	public:
-		Matrix4();
-		Matrix4(const Vector4 &col0, const Vector4 &col1, const Vector4 &col2, const Vector4 &col3);
+		constexpr Matrix4();
+		constexpr Matrix4(const Vector4 &col0, const Vector4 &col1, const Vector4 &col2, const Vector4 &col3);
 		
-		static Matrix4 createTranslationMatrix(const Vector3 &translation);
+		static constexpr Matrix4 createTranslationMatrix(const Vector3 &translation);
 		static Matrix4 createRotationMatrix(float radians, const Vector3 &rotationAxis);
-		static Matrix4 createScaleMatrix(const Vector3 &scale);
+		static constexpr Matrix4 createScaleMatrix(const Vector3 &scale);
 		static Matrix4 createPerspectiveMatrix(float fieldOfView, float aspectRatio, float nearClipPlane, float farClipPlane);
 		static Matrix4 createViewMatrix(const Vector3 &cameraPos, const Vector3 &lookTarget, const Vector3 &upDirection);
 		static Matrix4 createTransform(const Vector3 &pos, const Vector3 &scale, const Vector3 &rotationVector, float radians);
 
-		float get(int row, int col) const;
-		void set(int row, int col, float val);
+		constexpr float get(int row, int col) const;
+		constexpr void set(int row, int col, float val);
 
-		float& operator[](int index);
-		const float& operator[](int index) const;
-		Matrix4 operator*(const Matrix4 &other) const;
-		Vector3 operator*(const Vector3 &other) const;
-		Vector4 operator*(const Vector4 &other) const;
+		constexpr float& operator[](int index);
+		constexpr const float& operator[](int index) const;
+		constexpr Matrix4 operator*(const Matrix4 &other) const;
+		constexpr Vector3 operator*(const Vector3 &other) const;
+		constexpr Vector4 operator*(const Vector4 &other) const;
 
-		Vector4 getColumn(int colIndex) const;
-		Vector4 getRow(int rowIndex) const;
+		constexpr Vector4 getColumn(int colIndex) const;
+		constexpr Vector4 getRow(int rowIndex) const;
 
 		Vector3 extractTranslation() const;
 		Vector3 extractScale() const;
 		Matrix4 extractRotation() const;
+
+		Matrix4 inverse() const;
 	};
+
+	static_assert(sizeof(Matrix4) == sizeof(float) * 16, "The size of a Matrix4 must be sizeof(float) * 16!");
+}
+
+constexpr bbe::Matrix4::Matrix4()
+	: m_cols{ Vector4(1, 0, 0, 0), Vector4(0, 1, 0, 0), Vector4(0, 0, 1, 0), Vector4(0, 0, 0, 1) }
+{
+}
+
+constexpr bbe::Matrix4::Matrix4(const Vector4 & col0, const Vector4 & col1, const Vector4 & col2, const Vector4 & col3)
+	: m_cols{ col0, col1, col2, col3 }
+{
+}
+
+constexpr bbe::Matrix4 bbe::Matrix4::createTranslationMatrix(const Vector3 & translation)
+{
+	Matrix4 retVal;
+	retVal.set(0, 3, translation.x);
+	retVal.set(1, 3, translation.y);
+	retVal.set(2, 3, translation.z);
+	return retVal;
+}
+
+constexpr bbe::Matrix4 bbe::Matrix4::createScaleMatrix(const Vector3 & scale)
+{
+	Matrix4 retVal;
+	retVal.set(0, 0, scale.x);
+	retVal.set(1, 1, scale.y);
+	retVal.set(2, 2, scale.z);
+	return retVal;
+}
+
+constexpr float bbe::Matrix4::get(int row, int col) const
+{
+	if (row < 0 || row > 3 || col < 0 || col > 3)
+	{
+		throw IllegalIndexException();
+	}
+
+	return m_cols[col][row];
+}
+
+constexpr void bbe::Matrix4::set(int row, int col, float val)
+{
+	if (row < 0 || row > 3 || col < 0 || col > 3)
+	{
+		throw IllegalIndexException();
+	}
+
+	m_cols[col][row] = val;
+}
+
+constexpr float & bbe::Matrix4::operator[](int index)
+{
+	if (index < 0 || index > 15)
+	{
+		throw IllegalIndexException();
+	}
+
+	return m_cols[index / 4][index % 4];
+}
+
+constexpr const float & bbe::Matrix4::operator[](int index) const
+{
+	if (index < 0 || index > 15)
+	{
+		throw IllegalIndexException();
+	}
+
+	return m_cols[index / 4][index % 4];
+}
+
+constexpr bbe::Matrix4 bbe::Matrix4::operator*(const Matrix4 &other) const
+{
+	Matrix4 retVal;
+	for (int row = 0; row < 4; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			retVal.m_cols[col][row] = m_cols[0][row] * other.m_cols[col][0]
+			                        + m_cols[1][row] * other.m_cols[col][1]
+			                        + m_cols[2][row] * other.m_cols[col][2]
+			                        + m_cols[3][row] * other.m_cols[col][3];
+		}
+	}
+	return retVal;
+}
+
+constexpr bbe::Vector3 bbe::Matrix4::operator*(const Vector3 & other) const
+{
+	Vector4 retVal = operator*(Vector4(other, 1));
+	return Vector3(retVal.x / retVal.w, retVal.y / retVal.w, retVal.z / retVal.w);
+}
+
+constexpr bbe::Vector4 bbe::Matrix4::operator*(const Vector4 & other) const
+{
+	return Vector4(
+		get(0, 0) * other.x + get(0, 1) * other.y + get(0, 2) * other.z + get(0, 3) * other.w,
+		get(1, 0) * other.x + get(1, 1) * other.y + get(1, 2) * other.z + get(1, 3) * other.w,
+		get(2, 0) * other.x + get(2, 1) * other.y + get(2, 2) * other.z + get(2, 3) * other.w,
+		get(3, 0) * other.x + get(3, 1) * other.y + get(3, 2) * other.z + get(3, 3) * other.w
+	);
+}
+
+constexpr bbe::Vector4 bbe::Matrix4::getColumn(int colIndex) const
+{
+	if (colIndex < 0 || colIndex > 3)
+	{
+		throw IllegalIndexException();
+	}
+	return Vector4(m_cols[colIndex]);
+}
+
+constexpr bbe::Vector4 bbe::Matrix4::getRow(int rowIndex) const
+{
+	if (rowIndex < 0 || rowIndex > 3)
+	{
+		throw IllegalIndexException();
+	}
+	return Vector4(m_cols[0][rowIndex], m_cols[1][rowIndex], m_cols[2][rowIndex], m_cols[3][rowIndex]);
 }
\ No newline at end of file
@@ -2,34 +2,61 @@
 
 #include <stdint.h>
 #include <ctime>
+#include <type_traits>
+#include <emmintrin.h>
+#include "../BBE/List.h"
+#include "../BBE/Exceptions.h"
 
 namespace bbe
 {
-	template<typename FieldType, uint16_t N, int M, int R, int A, int F, int U, int S, int B, int T, int C, int L>
+	template<typename FieldType, uint16_t N, int M, int R, FieldType A, FieldType F, int U, int S, FieldType B, int T, FieldType C, int L>
 	class MersenneTwisterBase
 	{
 	private:
-		const uint64_t MASK_LOWER = (1ull << R) - 1;
-		const uint64_t MASK_UPPER = (1ull << R);
+		static constexpr int       WORD_SIZE        = sizeof(FieldType) * 8;
+		static constexpr FieldType MASK_LOWER       = (FieldType(1) << R) - 1;
+		static constexpr FieldType MASK_UPPER       = ~MASK_LOWER;
+		//The lower R bits of the oldest word are never used, so the state has N * WORD_SIZE - R bits.
+		//This is also the degree of the characteristic polynomial.
+		static constexpr size_t    DEGREE           = (size_t)N * WORD_SIZE - R;
+		static constexpr size_t    POLYNOMIAL_WORDS = DEGREE / 64 + 2;
+		//Below this amount discard simply regenerates the state block by block, which is cheaper than a jump.
+		static constexpr uint64_t  JUMP_THRESHOLD   = 1ull << 28;
+
+		using Simd = std::integral_constant<bool, std::is_same<FieldType, uint32_t>::value>;
 
 		uint16_t  m_index;
 		FieldType m_mt[N];
 
-		inline void twistIteration(uint32_t i)
+		static FieldType twistWord(FieldType current, FieldType next, FieldType far)
 		{
-			uint32_t x = (m_mt[i] & MASK_UPPER) + (m_mt[(i + 1) % N] & MASK_LOWER);
+			const FieldType x = (current & MASK_UPPER) | (next & MASK_LOWER);
 
-			uint32_t xA = x >> 1;
+			FieldType xA = x >> 1;
 
 			if (x & 1)
 			{
 				xA ^= A;
 			}
 
-			m_mt[i] = m_mt[(i + M) % N] ^ xA;
+			return far ^ xA;
 		}
 
-		void twist()
+		static FieldType temper(FieldType x)
+		{
+			x ^= (x >> U);
+			x ^= (x << S) & B;
+			x ^= (x << T) & C;
+			x ^= (x >> L);
+			return x;
+		}
+
+		inline void twistIteration(uint32_t i)
+		{
+			m_mt[i] = twistWord(m_mt[i], m_mt[(i + 1) % N], m_mt[(i + M) % N]);
+		}
+
+		void twist(std::false_type)
 		{
 			for (uint32_t i = 0; i < N - 1; i++)
 			{
@@ -37,10 +64,310 @@ namespace bbe
 			}
 
 			twistIteration(N - 1);	//Helps the compiler to calculate % N
+		}
+
+		static __m128i twistWord4(__m128i current, __m128i next, __m128i far)
+		{
+			const __m128i x = _mm_or_si128(_mm_and_si128(current, _mm_set1_epi32((int)MASK_UPPER)), _mm_and_si128(next, _mm_set1_epi32((int)MASK_LOWER)));
+			const __m128i oddMask = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, _mm_set1_epi32(1)));
+			const __m128i xA = _mm_xor_si128(_mm_srli_epi32(x, 1), _mm_and_si128(oddMask, _mm_set1_epi32((int)A)));
+			return _mm_xor_si128(far, xA);
+		}
+
+		//Four words at once. This is possible because a word only depends on words that are at least
+		//N - M positions away, which are either untouched or already regenerated in this pass.
+		void twist(std::true_type)
+		{
+			uint32_t i = 0;
+			for (; i + 4 <= N - M; i += 4)
+			{
+				const __m128i current = _mm_loadu_si128((const __m128i*)(m_mt + i));
+				const __m128i next = _mm_loadu_si128((const __m128i*)(m_mt + i + 1));
+				const __m128i far = _mm_loadu_si128((const __m128i*)(m_mt + i + M));
+				_mm_storeu_si128((__m128i*)(m_mt + i), twistWord4(current, next, far));
+			}
+			for (; i < N - M; i++)
+			{
+				m_mt[i] = twistWord(m_mt[i], m_mt[i + 1], m_mt[i + M]);
+			}
+			for (; i + 4 <= N - 1; i += 4)
+			{
+				const __m128i current = _mm_loadu_si128((const __m128i*)(m_mt + i));
+				const __m128i next = _mm_loadu_si128((const __m128i*)(m_mt + i + 1));
+				const __m128i far = _mm_loadu_si128((const __m128i*)(m_mt + i + M - N));
+				_mm_storeu_si128((__m128i*)(m_mt + i), twistWord4(current, next, far));
+			}
+			for (; i < N - 1; i++)
+			{
+				m_mt[i] = twistWord(m_mt[i], m_mt[i + 1], m_mt[i + M - N]);
+			}
+			m_mt[N - 1] = twistWord(m_mt[N - 1], m_mt[0], m_mt[M - 1]);
+		}
 
+		void twist()
+		{
+			twist(Simd());
 			m_index = 0;
 		}
 
+		static void temper(const FieldType* in, FieldType* out, size_t amount, std::false_type)
+		{
+			for (size_t i = 0; i < amount; i++)
+			{
+				out[i] = temper(in[i]);
+			}
+		}
+
+		static void temper(const FieldType* in, FieldType* out, size_t amount, std::true_type)
+		{
+			size_t i = 0;
+			for (; i + 4 <= amount; i += 4)
+			{
+				__m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+				x = _mm_xor_si128(x, _mm_srli_epi32(x, U));
+				x = _mm_xor_si128(x, _mm_and_si128(_mm_slli_epi32(x, S), _mm_set1_epi32((int)B)));
+				x = _mm_xor_si128(x, _mm_and_si128(_mm_slli_epi32(x, T), _mm_set1_epi32((int)C)));
+				x = _mm_xor_si128(x, _mm_srli_epi32(x, L));
+				_mm_storeu_si128((__m128i*)(out + i), x);
+			}
+			for (; i < amount; i++)
+			{
+				out[i] = temper(in[i]);
+			}
+		}
+
+		static bool getBit(const List<uint64_t> &bits, size_t index)
+		{
+			return (bits[index / 64] >> (index % 64)) & 1;
+		}
+
+		static void flipBit(List<uint64_t> &bits, size_t index)
+		{
+			bits[index / 64] ^= 1ull << (index % 64);
+		}
+
+		//bits[0 .. amountOfWords) ^= other << shift
+		static void xorShifted(List<uint64_t> &bits, const List<uint64_t> &other, size_t amountOfWords, size_t shift)
+		{
+			const size_t wordShift = shift / 64;
+			const size_t bitShift = shift % 64;
+			for (size_t i = 0; i + wordShift < bits.getLength() && i < amountOfWords; i++)
+			{
+				bits[i + wordShift] ^= other[i] << bitShift;
+				if (bitShift != 0 && i + wordShift + 1 < bits.getLength())
+				{
+					bits[i + wordShift + 1] ^= other[i] >> (64 - bitShift);
+				}
+			}
+		}
+
+		static List<uint64_t> createZeroBits(size_t amountOfWords)
+		{
+			List<uint64_t> bits;
+			bits.resizeCapacityAndLength(amountOfWords);
+			for (size_t i = 0; i < amountOfWords; i++)
+			{
+				bits[i] = 0;
+			}
+			return bits;
+		}
+
+		//Finds the characteristic polynomial with Berlekamp-Massey from the lowest output bit. Because the
+		//polynomial is primitive, every non zero bit sequence of the generator has it as minimal polynomial.
+		static List<uint64_t> calculateCharacteristicPolynomial()
+		{
+			MersenneTwisterBase generator(1);
+			const size_t length = 2 * DEGREE;
+
+			//Stored in reverse, so that the discrepancy becomes a dot product of two bit strings.
+			List<uint64_t> sequence = createZeroBits(length / 64 + 4);
+			for (size_t i = 0; i < length; i++)
+			{
+				if (generator.next() & 1)
+				{
+					flipBit(sequence, length - 1 - i);
+				}
+			}
+
+			List<uint64_t> connection = createZeroBits(POLYNOMIAL_WORDS);
+			List<uint64_t> previous = createZeroBits(POLYNOMIAL_WORDS);
+			flipBit(connection, 0);
+			flipBit(previous, 0);
+			size_t degree = 0;
+			size_t shift = 1;
+
+			for (size_t n = 0; n < length; n++)
+			{
+				//The coefficient i of the connection polynomial meets the sequence element n - i.
+				const size_t offset = length - 1 - n;
+				uint64_t discrepancy = 0;
+				for (size_t w = 0; w <= degree / 64; w++)
+				{
+					const size_t position = offset + w * 64;
+					const size_t word = position / 64;
+					const size_t bit = position % 64;
+					uint64_t window = sequence[word] >> bit;
+					if (bit != 0)
+					{
+						window |= sequence[word + 1] << (64 - bit);
+					}
+					discrepancy ^= connection[w] & window;
+				}
+				discrepancy ^= discrepancy >> 32;
+				discrepancy ^= discrepancy >> 16;
+				discrepancy ^= discrepancy >> 8;
+				discrepancy ^= discrepancy >> 4;
+				discrepancy ^= discrepancy >> 2;
+				discrepancy ^= discrepancy >> 1;
+
+				if ((discrepancy & 1) == 0)
+				{
+					shift++;
+				}
+				else if (2 * degree <= n)
+				{
+					List<uint64_t> temp = connection;
+					xorShifted(connection, previous, POLYNOMIAL_WORDS, shift);
+					degree = n + 1 - degree;
+					previous = std::move(temp);
+					shift = 1;
+				}
+				else
+				{
+					xorShifted(connection, previous, POLYNOMIAL_WORDS, shift);
+					shift++;
+				}
+			}
+
+			if (degree != DEGREE)
+			{
+				throw IllegalStateException();
+			}
+
+			//The connection polynomial is the reciprocal of the characteristic polynomial.
+			List<uint64_t> characteristic = createZeroBits(POLYNOMIAL_WORDS);
+			for (size_t i = 0; i <= DEGREE; i++)
+			{
+				if (getBit(connection, i))
+				{
+					flipBit(characteristic, DEGREE - i);
+				}
+			}
+			return characteristic;
+		}
+
+		static const List<uint64_t>& getCharacteristicPolynomial()
+		{
+			static const List<uint64_t> characteristic = calculateCharacteristicPolynomial();
+			return characteristic;
+		}
+
+		//Reduces a polynomial of degree up to 2 * DEGREE - 2 modulo the characteristic polynomial.
+		static void reduce(List<uint64_t> &polynomial, const List<uint64_t> &characteristic)
+		{
+			for (size_t i = 2 * DEGREE - 2; i >= DEGREE; i--)
+			{
+				if (getBit(polynomial, i))
+				{
+					xorShifted(polynomial, characteristic, POLYNOMIAL_WORDS, i - DEGREE);
+				}
+			}
+		}
+
+		static uint64_t spreadBits(uint64_t x)
+		{
+			x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+			x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+			x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+			x = (x | (x << 2)) & 0x3333333333333333ull;
+			x = (x | (x << 1)) & 0x5555555555555555ull;
+			return x;
+		}
+
+		//x^exponent mod the characteristic polynomial, by square and multiply.
+		static List<uint64_t> powerOfXMod(uint64_t exponent)
+		{
+			const List<uint64_t> &characteristic = getCharacteristicPolynomial();
+			List<uint64_t> result = createZeroBits(POLYNOMIAL_WORDS);
+			flipBit(result, 0);
+			List<uint64_t> square = createZeroBits(2 * POLYNOMIAL_WORDS);
+
+			int topBit = 63;
+			while (((exponent >> topBit) & 1) == 0)
+			{
+				topBit--;
+			}
+
+			for (int bit = topBit; bit >= 0; bit--)
+			{
+				//Squaring over GF(2) only spreads the bits, all mixed terms cancel out.
+				for (size_t i = 0; i < POLYNOMIAL_WORDS; i++)
+				{
+					square[2 * i] = spreadBits(result[i] & 0xFFFFFFFF);
+					square[2 * i + 1] = spreadBits(result[i] >> 32);
+				}
+				reduce(square, characteristic);
+				for (size_t i = 0; i < POLYNOMIAL_WORDS; i++)
+				{
+					result[i] = square[i];
+				}
+
+				if ((exponent >> bit) & 1)
+				{
+					for (size_t i = POLYNOMIAL_WORDS - 1; i > 0; i--)
+					{
+						result[i] = (result[i] << 1) | (result[i - 1] >> 63);
+					}
+					result[0] <<= 1;
+					if (getBit(result, DEGREE))
+					{
+						xorShifted(result, characteristic, POLYNOMIAL_WORDS, 0);
+					}
+				}
+			}
+			return result;
+		}
+
+		//Expects m_index == N, so that m_mt holds exactly the last N words. The state after amount steps is
+		//p(A) * state with p = x^amount mod the characteristic polynomial, where A steps the generator by one word.
+		void jump(uint64_t amount)
+		{
+			const List<uint64_t> polynomial = powerOfXMod(amount);
+
+			FieldType ring[N];
+			FieldType result[N];
+			for (uint32_t i = 0; i < N; i++)
+			{
+				ring[i] = m_mt[i];
+				result[i] = 0;
+			}
+
+			uint32_t position = 0;
+			for (size_t i = 0; i < DEGREE; i++)
+			{
+				if (getBit(polynomial, i))
+				{
+					for (uint32_t k = 0; k < N - position; k++)
+					{
+						result[k] ^= ring[position + k];
+					}
+					for (uint32_t k = N - position; k < N; k++)
+					{
+						result[k] ^= ring[position + k - N];
+					}
+				}
+
+				ring[position] = twistWord(ring[position], ring[(position + 1) % N], ring[(position + M) % N]);
+				position = (position + 1) % N;
+			}
+
+			for (uint32_t i = 0; i < N; i++)
+			{
+				m_mt[i] = result[i];
+			}
+			m_index = N;
+		}
+
 	public:
 		MersenneTwisterBase()
 		{
@@ -48,24 +375,92 @@ namespace bbe
 			setSeed((FieldType)timeStamp);
 		}
 
+		explicit MersenneTwisterBase(FieldType seed)
+		{
+			setSeed(seed);
+		}
+
+		//Produces the same sequence as the std::mersenne_twister_engine with the same parameters and seed.
 		void setSeed(FieldType seed)
 		{
 			m_mt[0] = seed;
 
 			for (uint32_t i = 1; i < N; i++)
 			{
-				m_mt[i] = (F * (m_mt[i - 1] ^ (m_mt[i - 1] >> 30)) + i);
+				m_mt[i] = (F * (m_mt[i - 1] ^ (m_mt[i - 1] >> (WORD_SIZE - 2))) + i);
 			}
 
-			//obscurity magic number, decreases the predictability of the MT a little.
-			m_mt[28] ^= 0xBBEBBEBB;
-
 			m_index = N;
+		}
+
+		//Initializes the whole state from several seed values, in the same way as std::seed_seq does. Use
+		//this if a single seed value is not enough, e.g. to derive many independent generators.
+		void setSeed(const uint32_t* seeds, size_t amountOfSeeds)
+		{
+			const size_t wordsPerField = (WORD_SIZE + 31) / 32;
+			const size_t n = N * wordsPerField;
+			List<uint32_t> b;
+			b.resizeCapacityAndLength(n);
+			for (size_t i = 0; i < n; i++)
+			{
+				b[i] = 0x8b8b8b8b;
+			}
+
+			const size_t t = (n >= 623) ? 11 : (n >= 68) ? 7 : (n >= 39) ? 5 : (n >= 7) ? 3 : (n - 1) / 2;
+			const size_t p = (n - t) / 2;
+			const size_t q = p + t;
+			const size_t m = amountOfSeeds + 1 > n ? amountOfSeeds + 1 : n;
+			auto mix = [](uint32_t x) { return x ^ (x >> 27); };
+
+			for (size_t k = 0; k < m; k++)
+			{
+				const uint32_t r1 = 1664525u * mix(b[k % n] ^ b[(k + p) % n] ^ b[(k + n - 1) % n]);
+				uint32_t r2 = r1;
+				if (k == 0)
+				{
+					r2 += (uint32_t)amountOfSeeds;
+				}
+				else if (k <= amountOfSeeds)
+				{
+					r2 += (uint32_t)(k % n) + seeds[k - 1];
+				}
+				else
+				{
+					r2 += (uint32_t)(k % n);
+				}
+				b[(k + p) % n] += r1;
+				b[(k + q) % n] += r2;
+				b[k % n] = r2;
+			}
+			for (size_t k = m; k < m + n; k++)
+			{
+				const uint32_t r3 = 1566083941u * mix(b[k % n] + b[(k + p) % n] + b[(k + n - 1) % n]);
+				const uint32_t r4 = r3 - (uint32_t)(k % n);
+				b[(k + p) % n] ^= r3;
+				b[(k + q) % n] ^= r4;
+				b[k % n] = r4;
+			}
 
-			for (uint32_t i = 0; i < 1000 * 1000 * 9; i++)
+			bool allZero = true;
+			for (uint32_t i = 0; i < N; i++)
+			{
+				FieldType value = 0;
+				for (size_t k = 0; k < wordsPerField; k++)
+				{
+					value |= (FieldType)((uint64_t)b[i * wordsPerField + k] << (32 * k));
+				}
+				m_mt[i] = value;
+				if ((i == 0 && (value & MASK_UPPER) != 0) || (i != 0 && value != 0))
+				{
+					allZero = false;
+				}
+			}
+			if (allZero)
 			{
-				next();
+				m_mt[0] = FieldType(1) << (WORD_SIZE - 1);
 			}
+
+			m_index = N;
 		}
 
 		FieldType next()
@@ -78,12 +473,61 @@ namespace bbe
 			FieldType x = m_mt[m_index];
 			m_index++;
 
-			x ^= (x >> U);
-			x ^= (x << S) & B;
-			x ^= (x << T) & C;
-			x ^= (x >> L);
+			return temper(x);
+		}
+
+		//Writes the next amount values of the sequence, just like calling next() amount times but much faster.
+		void fill(FieldType* out, size_t amount)
+		{
+			size_t written = 0;
+			while (written < amount)
+			{
+				if (m_index >= N)
+				{
+					twist();
+				}
 
-			return y;
+				size_t count = N - m_index;
+				if (count > amount - written)
+				{
+					count = amount - written;
+				}
+
+				temper(m_mt + m_index, out + written, count, Simd());
+				m_index += (uint16_t)count;
+				written += count;
+			}
+		}
+
+		//Skips amount values. Large distances are jumped over in time logarithmic in the distance.
+		void discard(uint64_t amount)
+		{
+			const uint64_t restOfBlock = N - m_index;
+			if (amount <= restOfBlock)
+			{
+				m_index += (uint16_t)amount;
+				return;
+			}
+			amount -= restOfBlock;
+			m_index = N;
+
+			if (amount >= JUMP_THRESHOLD)
+			{
+				jump(amount);
+				return;
+			}
+
+			while (amount >= N)
+			{
+				twist();
+				amount -= N;
+			}
+			m_index = N;
+			if (amount > 0)
+			{
+				twist();
+				m_index = (uint16_t)amount;
+			}
 		}
 	};
 
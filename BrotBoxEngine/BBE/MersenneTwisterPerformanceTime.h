@@ -2,7 +2,10 @@
 
 #include "../BBE/MersenneTwister.h"
 #include "../BBE/CPUWatch.h"
+#include "../BBE/StopWatch.h"
+#include "../BBE/List.h"
 #include <iostream>
+#include <random>
 
 namespace bbe
 {
@@ -36,5 +39,76 @@ namespace bbe
 			std::cout << "Mersenne Twister STL Time: " << watch.getTimeExpiredSeconds() << std::endl;
 
 		}
+
+		void mersenneTwisterPrintStartupAndThroughput()
+		{
+			const int amountOfGenerators = 10000;
+			uint32_t val = 0;
+			{
+				StopWatch watch;
+				for (int i = 0; i < amountOfGenerators; i++)
+				{
+					mt19937 mt(i);
+					val += mt.next();
+				}
+				std::cout << "Mersenne Twister BBE startup: " << watch.getTimeExpiredMicroseconds() / amountOfGenerators << "us" << std::endl;
+			}
+			{
+				StopWatch watch;
+				for (int i = 0; i < amountOfGenerators; i++)
+				{
+					std::mt19937 mt(i);
+					val += mt();
+				}
+				std::cout << "Mersenne Twister STL startup: " << watch.getTimeExpiredMicroseconds() / amountOfGenerators << "us" << std::endl;
+			}
+
+			const size_t amount = 1000 * 1000 * 100;
+			mt19937 mt(1);
+			std::mt19937 reference(1);
+			{
+				StopWatch watch;
+				for (size_t i = 0; i < amount; i++)
+				{
+					val += mt.next();
+				}
+				std::cout << "Mersenne Twister BBE next: " << amount / (double)watch.getTimeExpiredMicroseconds() << " million values/s" << std::endl;
+			}
+			{
+				StopWatch watch;
+				for (size_t i = 0; i < amount; i++)
+				{
+					val += reference();
+				}
+				std::cout << "Mersenne Twister STL next: " << amount / (double)watch.getTimeExpiredMicroseconds() << " million values/s" << std::endl;
+			}
+			{
+				List<uint32_t> values;
+				values.resizeCapacityAndLength(1024 * 16);
+				StopWatch watch;
+				for (size_t i = 0; i < amount; i += values.getLength())
+				{
+					mt.fill(values.getRaw(), values.getLength());
+					val += values[0];
+				}
+				std::cout << "Mersenne Twister BBE fill: " << amount / (double)watch.getTimeExpiredMicroseconds() << " million values/s" << std::endl;
+			}
+
+			const uint64_t distances[] = { 1000ull * 1000ull, 1ull << 25, 1000ull * 1000ull * 1000ull, 1ull << 50 };
+			for (uint64_t distance : distances)
+			{
+				StopWatch watch;
+				mt.discard(distance);
+				std::cout << "Mersenne Twister BBE discard(" << distance << "): " << watch.getTimeExpiredMicroseconds() / 1000.0 << "ms";
+				if (distance <= 1000ull * 1000ull * 1000ull)
+				{
+					StopWatch referenceWatch;
+					reference.discard(distance);
+					std::cout << ", STL: " << referenceWatch.getTimeExpiredMicroseconds() / 1000.0 << "ms";
+				}
+				std::cout << std::endl;
+			}
+			std::cout << "(" << val << ")" << std::endl;
+		}
 	}
-}
\ No newline at end of file
+}
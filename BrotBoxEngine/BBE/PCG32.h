@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <ctime>
+
+namespace bbe
+{
+	//PCG-XSH-RR with 64 bit state. Every odd increment gives a different sequence, so every stream
+	//index selects its own generator instead of a window of a shared one.
+	class PCG32
+	{
+	private:
+		static constexpr uint64_t MULTIPLIER = 6364136223846793005ull;
+
+		uint64_t m_state;
+		uint64_t m_increment;
+
+	public:
+		PCG32()
+		{
+			std::time_t timeStamp = std::time(nullptr);
+			setSeed((uint64_t)timeStamp);
+		}
+
+		explicit PCG32(uint64_t seed, uint64_t stream = 0)
+		{
+			setSeed(seed, stream);
+		}
+
+		void setSeed(uint64_t seed, uint64_t stream = 0)
+		{
+			m_state = 0;
+			m_increment = (stream << 1) | 1;
+			next();
+			m_state += seed;
+			next();
+		}
+
+		uint32_t next()
+		{
+			const uint64_t oldState = m_state;
+			m_state = oldState * MULTIPLIER + m_increment;
+			const uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+			const uint32_t rotation = (uint32_t)(oldState >> 59);
+			return (xorShifted >> rotation) | (xorShifted << ((0 - rotation) & 31));
+		}
+
+		void fill(uint32_t* out, size_t amount)
+		{
+			for (size_t i = 0; i < amount; i++)
+			{
+				out[i] = next();
+			}
+		}
+	};
+}
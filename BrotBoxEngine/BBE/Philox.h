@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stdint.h>
+#include <ctime>
+#include <emmintrin.h>
+
+namespace bbe
+{
+	//Counter based generator (Philox4x32-10, Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+	//Every block of four values is a pure function of (seed, stream, counter), so a job can compute the
+	//values of element i directly, on any thread and in any order, without sharing a generator.
+	class Philox4x32
+	{
+	private:
+		static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+		static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+		static constexpr uint32_t WEYL_0       = 0x9E3779B9;
+		static constexpr uint32_t WEYL_1       = 0xBB67AE85;
+		static constexpr int      ROUNDS       = 10;
+
+		uint32_t m_key[2];
+		uint64_t m_stream;
+		uint64_t m_counter;
+		uint32_t m_block[4];
+		int      m_usedInBlock;
+
+		static void mulHiLo(uint32_t a, uint32_t b, uint32_t &outHi, uint32_t &outLo)
+		{
+			const uint64_t product = (uint64_t)a * b;
+			outHi = (uint32_t)(product >> 32);
+			outLo = (uint32_t)product;
+		}
+
+		static void mulHiLo(__m128i a, uint32_t b, __m128i &outHi, __m128i &outLo)
+		{
+			const __m128i multiplier = _mm_set1_epi32((int)b);
+			//_mm_mul_epu32 only multiplies the even lanes, so the odd lanes are shifted down for a second multiply.
+			const __m128i even = _mm_shuffle_epi32(_mm_mul_epu32(a, multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+			const __m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(a, 32), multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+			outLo = _mm_unpacklo_epi32(even, odd);
+			outHi = _mm_unpackhi_epi32(even, odd);
+		}
+
+		//Four consecutive blocks at once, written in the same order as four calls of generateBlock.
+		void generateBlocks4(uint64_t firstCounter, uint32_t* out) const
+		{
+			__m128i c0 = _mm_set_epi32((int)(uint32_t)(firstCounter + 3), (int)(uint32_t)(firstCounter + 2), (int)(uint32_t)(firstCounter + 1), (int)(uint32_t)firstCounter);
+			__m128i c1 = _mm_set_epi32((int)(uint32_t)((firstCounter + 3) >> 32), (int)(uint32_t)((firstCounter + 2) >> 32), (int)(uint32_t)((firstCounter + 1) >> 32), (int)(uint32_t)(firstCounter >> 32));
+			__m128i c2 = _mm_set1_epi32((int)(uint32_t)m_stream);
+			__m128i c3 = _mm_set1_epi32((int)(uint32_t)(m_stream >> 32));
+			uint32_t k0 = m_key[0];
+			uint32_t k1 = m_key[1];
+
+			for (int round = 0; round < ROUNDS; round++)
+			{
+				__m128i hi0, lo0, hi1, lo1;
+				mulHiLo(c0, MULTIPLIER_0, hi0, lo0);
+				mulHiLo(c2, MULTIPLIER_1, hi1, lo1);
+				const __m128i n0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+				const __m128i n2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+				c0 = n0;
+				c1 = lo1;
+				c2 = n2;
+				c3 = lo0;
+				k0 += WEYL_0;
+				k1 += WEYL_1;
+			}
+
+			//Transposes from one register per word to one register per block.
+			const __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+			const __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+			const __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+			const __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+			_mm_storeu_si128((__m128i*)(out + 0), _mm_unpacklo_epi64(t0, t1));
+			_mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi64(t0, t1));
+			_mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi64(t2, t3));
+			_mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi64(t2, t3));
+		}
+
+	public:
+		Philox4x32()
+		{
+			std::time_t timeStamp = std::time(nullptr);
+			setSeed((uint64_t)timeStamp);
+		}
+
+		explicit Philox4x32(uint64_t seed, uint64_t stream = 0)
+		{
+			setSeed(seed, stream);
+		}
+
+		//The raw bijection: ten rounds over a 128 bit counter with a 64 bit key.
+		static void generate(const uint32_t key[2], const uint32_t counter[4], uint32_t out[4])
+		{
+			uint32_t c0 = counter[0];
+			uint32_t c1 = counter[1];
+			uint32_t c2 = counter[2];
+			uint32_t c3 = counter[3];
+			uint32_t k0 = key[0];
+			uint32_t k1 = key[1];
+
+			for (int round = 0; round < ROUNDS; round++)
+			{
+				uint32_t hi0, lo0, hi1, lo1;
+				mulHiLo(MULTIPLIER_0, c0, hi0, lo0);
+				mulHiLo(MULTIPLIER_1, c2, hi1, lo1);
+				c0 = hi1 ^ c1 ^ k0;
+				c1 = lo1;
+				c2 = hi0 ^ c3 ^ k1;
+				c3 = lo0;
+				k0 += WEYL_0;
+				k1 += WEYL_1;
+			}
+
+			out[0] = c0;
+			out[1] = c1;
+			out[2] = c2;
+			out[3] = c3;
+		}
+
+		//Every (seed, stream) pair is its own sequence of 2^64 blocks. Selecting a stream costs nothing,
+		//so the index of an element can be used as stream.
+		void setSeed(uint64_t seed, uint64_t stream = 0)
+		{
+			m_key[0] = (uint32_t)seed;
+			m_key[1] = (uint32_t)(seed >> 32);
+			m_stream = stream;
+			seek(0);
+		}
+
+		void generateBlock(uint64_t counter, uint32_t out[4]) const
+		{
+			const uint32_t fullCounter[4] = { (uint32_t)counter, (uint32_t)(counter >> 32), (uint32_t)m_stream, (uint32_t)(m_stream >> 32) };
+			generate(m_key, fullCounter, out);
+		}
+
+		//The value at position index of the stream, independent of the position of next.
+		uint32_t getUInt(uint64_t index) const
+		{
+			uint32_t block[4];
+			generateBlock(index / 4, block);
+			return block[index % 4];
+		}
+
+		//[0, 1) with 24 bits of randomness, same mapping as Random::randomFloat.
+		float getFloat(uint64_t index) const
+		{
+			return (getUInt(index) >> 8) * (1.0f / 16777216.0f);
+		}
+
+		//Moves next to position index of the stream.
+		void seek(uint64_t index)
+		{
+			m_counter = index / 4;
+			generateBlock(m_counter, m_block);
+			m_counter++;
+			m_usedInBlock = (int)(index % 4);
+		}
+
+		uint32_t next()
+		{
+			if (m_usedInBlock == 4)
+			{
+				generateBlock(m_counter, m_block);
+				m_counter++;
+				m_usedInBlock = 0;
+			}
+			return m_block[m_usedInBlock++];
+		}
+
+		//Same values as calling next amount times.
+		void fill(uint32_t* out, size_t amount)
+		{
+			size_t i = 0;
+			while (i < amount && m_usedInBlock < 4)
+			{
+				out[i++] = m_block[m_usedInBlock++];
+			}
+			for (; i + 16 <= amount; i += 16)
+			{
+				generateBlocks4(m_counter, out + i);
+				m_counter += 4;
+			}
+			while (i < amount)
+			{
+				out[i++] = next();
+			}
+		}
+	};
+}
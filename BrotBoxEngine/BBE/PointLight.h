@@ -59,12 +59,15 @@ namespace bbe
 	private:
 		int m_index;
 
-		static void s_init(VkDevice device, VkPhysicalDevice physicalDevice);
+		static void s_init();
 		static bool s_staticIniCalled;
 		static void s_destroy();
-		static bbe::INTERNAL::vulkan::VulkanBuffer s_bufferVertexData;
+		//The lights live in CPU memory and are copied into the uniform slots of a frame right before it is
+		//submitted, so changing a light never races a frame that the GPU still renders.
+		static void s_writeBuffers(void* vertexData, void* fragmentData);
+		static size_t s_getVertexDataSize();
+		static size_t s_getFragmentDataSize();
 		static INTERNAL::PointLightVertexData *s_dataVertex;
-		static bbe::INTERNAL::vulkan::VulkanBuffer s_bufferFragmentData;
 		static INTERNAL::PointLightFragmentData *s_dataFragment;
 		static Stack<int> s_indexStack;
 		static List<INTERNAL::PointLightWithPos> s_earlyPointLights;
@@ -6,10 +6,12 @@
 #include "../BBE/Rectangle.h"
 #include "../BBE/Circle.h"
 #include "../BBE/Color.h"
+#include "../BBE/Batch2D.h"
 
 namespace bbe
 {
 	class Image;
+	class TextureAtlas;
 
 	namespace INTERNAL
 	{
@@ -17,16 +19,17 @@ namespace bbe
 		{
 			class VulkanDevice;
 			class VulkanManager;
-			class VulkanCommandPool;
+			class VulkanUploadBatcher;
 			class VulkanDescriptorPool;
 			class VulkanDescriptorSetLayout;
 			class VulkanPipeline;
+			class VulkanBuffer;
 		}
 	}
 
 	enum class PipelineRecord2D
 	{
-		NONE, PRIMITIVE, IMAGE
+		NONE, PRIMITIVE, IMAGE, BATCHED
 	};
 
 	class PrimitiveBrush2D
@@ -34,7 +37,7 @@ namespace bbe
 		friend class INTERNAL::vulkan::VulkanManager;
 	private:
 		INTERNAL::vulkan::VulkanDevice              *m_pdevice              = nullptr;
-		INTERNAL::vulkan::VulkanCommandPool         *m_pcommandPool         = nullptr;
+		INTERNAL::vulkan::VulkanUploadBatcher       *m_puploadBatcher       = nullptr;
 		INTERNAL::vulkan::VulkanDescriptorPool      *m_pdescriptorPool      = nullptr;
 		INTERNAL::vulkan::VulkanDescriptorSetLayout *m_pdescriptorSetLayout = nullptr;
 		VkCommandBuffer    m_currentCommandBuffer = VK_NULL_HANDLE;
@@ -42,24 +45,44 @@ namespace bbe
 		VkPipeline         m_pipelinePrimitive    = VK_NULL_HANDLE;
 		VkPipelineLayout   m_layoutImage          = VK_NULL_HANDLE;
 		VkPipeline         m_pipelineImage        = VK_NULL_HANDLE;
+		VkPipelineLayout   m_layoutBatched        = VK_NULL_HANDLE;
+		VkPipeline         m_pipelineBatched      = VK_NULL_HANDLE;
 		VkDescriptorSet    m_descriptorSet        = VK_NULL_HANDLE;
 		int                m_screenWidth;
 		int                m_screenHeight;
 
 		PipelineRecord2D   m_pipelineRecord = PipelineRecord2D::NONE;
+		Color              m_color;
 
+		//Everything of a frame is collected in m_batch and written into the vertex and index buffer of the frame
+		//by INTERNAL_flush. Rectangles, circles and small images are drawn from the texture atlas, so they only
+		//need a new draw call if an image that did not fit into the atlas was drawn in between. Without the
+		//batched pipeline every primitive gets its own draw call.
+		Batch2D                         m_batch;
+		TextureAtlas                   *m_patlas        = nullptr;
+		INTERNAL::vulkan::VulkanBuffer *m_pvertexBuffer = nullptr;
+		INTERNAL::vulkan::VulkanBuffer *m_pindexBuffer  = nullptr;
+
+		VkDescriptorSet INTERNAL_getTexture(const Image &image);
+		VkDescriptorSet INTERNAL_getAtlasTexture();
+		//Must only be called once per frame, because the buffers of the frame are overwritten.
+		void INTERNAL_flush();
 		void INTERNAL_fillRect(const Rectangle &rect);
 		void INTERNAL_drawImage(const Rectangle &rect, const Image &image);
 		void INTERNAL_fillCircle(const Circle &circle);
 		void INTERNAL_setColor(float r, float g, float b, float a);
 		void INTERNAL_beginDraw(
 			INTERNAL::vulkan::VulkanDevice &device,
-			INTERNAL::vulkan::VulkanCommandPool &commandPool,
+			INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher,
 			INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool,
 			INTERNAL::vulkan::VulkanDescriptorSetLayout &descriptorSetLayout,
 			VkCommandBuffer commandBuffer,
 			INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive,
 			INTERNAL::vulkan::VulkanPipeline &pipelineImage,
+			INTERNAL::vulkan::VulkanPipeline *pipelineBatched,
+			TextureAtlas &atlas,
+			INTERNAL::vulkan::VulkanBuffer &vertexBuffer,
+			INTERNAL::vulkan::VulkanBuffer &indexBuffer,
 			int screenWidth, int screenHeight);
 
 	public:
@@ -7,10 +7,15 @@
 #include "../BBE/Cube.h"
 #include "../BBE/IcoSphere.h"
 #include "../BBE/Terrain.h"
+#include "../BBE/StreamingTerrain.h"
+#include "../BBE/Frustum.h"
+#include "../BBE/Color.h"
+#include "../BBE/Ray.h"
+#include "../BBE/InstanceData3D.h"
+#include "../BBE/List.h"
 
 namespace bbe
 {
-	class Color;
 	namespace INTERNAL
 	{
 		namespace vulkan
@@ -19,6 +24,8 @@ namespace bbe
 			class VulkanManager;
 			class VulkanBuffer;
 			class VulkanDescriptorPool;
+			class VulkanDescriptorSet;
+			class VulkanUniformRing;
 			class VulkanPipeline;
 		}
 	}
@@ -30,7 +37,7 @@ namespace bbe
 
 	enum class PipelineRecord3D
 	{
-		NONE, PRIMITIVE, TERRAIN
+		NONE, PRIMITIVE, TERRAIN, INSTANCED
 	};
 
 	class PrimitiveBrush3D
@@ -44,6 +51,7 @@ namespace bbe
 		VkPipeline                              m_pipelinePrimitive    = VK_NULL_HANDLE;
 		VkPipelineLayout                        m_layoutTerrain        = VK_NULL_HANDLE;
 		VkPipeline                              m_pipelineTerrain      = VK_NULL_HANDLE;
+		VkPipeline                              m_pipelineInstanced    = VK_NULL_HANDLE;
 		INTERNAL::vulkan::VulkanDescriptorPool *m_pdescriptorPool      = nullptr;
 		int                                     m_screenWidth;
 		int                                     m_screenHeight;
@@ -53,16 +61,44 @@ namespace bbe
 
 		Matrix4 m_modelMatrix;
 		Matrix4 m_viewProjectionMatrix;
+		Frustum m_frustum;
 
 		Vector3 m_cameraPos;
 
-		INTERNAL::vulkan::VulkanBuffer m_uboMatrices;
+		Color m_color;
+		bool  m_colorDirty = true;
+
+		bool m_frustumCullingEnabled = true;
+		float m_terrainLodDistance   = 128;
+		int  m_amountOfDrawnObjects  = 0;
+		int  m_amountOfCulledObjects = 0;
+
+		//Every setCamera writes the view and projection matrices to a new slot of the uniform ring, so the camera
+		//can change between draws of the same frame.
+		INTERNAL::vulkan::VulkanUniformRing *m_puniformRing           = nullptr;
+		VkDescriptorSet                      m_setViewProjectionMatrix = VK_NULL_HANDLE;
+		uint32_t                             m_cameraOffset            = 0;
+		//Set while the 3D descriptor sets are bound to the command buffer.
+		bool                                 m_cameraBound             = false;
+
+		//Cubes and icospheres are collected and drawn with one instanced draw call per type once the brush
+		//flushes them. Without the instanced pipeline every object gets its own draw call.
+		INTERNAL::vulkan::VulkanBuffer *m_pinstanceBuffer      = nullptr;
+		VkDeviceSize                    m_instanceBufferOffset = 0;
+		List<InstanceData3D>            m_cubeInstances;
+		List<InstanceData3D>            m_icoSphereInstances;
 
 		void INTERNAL_setColor(float r, float g, float b, float a);
-		void INTERNAL_beginDraw(bbe::INTERNAL::vulkan::VulkanDevice &device, VkCommandBuffer commandBuffer, INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive, INTERNAL::vulkan::VulkanPipeline &pipelineTerrain, int screenWidth, int screenHeight);
-		
-		void create(const INTERNAL::vulkan::VulkanDevice &vulkanDevice);
-		void destroy();
+		void INTERNAL_flushColor();
+		bool INTERNAL_isVisible(const BoundingBox &box);
+		bool INTERNAL_isVisible(const BoundingSphere &sphere);
+		void INTERNAL_drawTerrainPatches(const List<const TerrainPatch*> &patches);
+		void INTERNAL_drawInstances(List<InstanceData3D> &instances, const INTERNAL::vulkan::VulkanBuffer &vertexBuffer, const INTERNAL::vulkan::VulkanBuffer &indexBuffer, uint32_t amountOfIndices, DrawRecord drawRecord);
+		void INTERNAL_flushInstances();
+		void INTERNAL_bindCamera();
+		void INTERNAL_endDraw3D();
+		//pipelineInstanced may be nullptr.
+		void INTERNAL_beginDraw(bbe::INTERNAL::vulkan::VulkanDevice &device, VkCommandBuffer commandBuffer, INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive, INTERNAL::vulkan::VulkanPipeline &pipelineTerrain, INTERNAL::vulkan::VulkanPipeline *pipelineInstanced, INTERNAL::vulkan::VulkanUniformRing &uniformRing, const INTERNAL::vulkan::VulkanDescriptorSet &setViewProjectionMatrix, INTERNAL::vulkan::VulkanBuffer &instanceBuffer, int screenWidth, int screenHeight);
 
 	public:
 		void fillCube(const Cube &cube);
@@ -70,11 +106,28 @@ namespace bbe
 
 		void drawTerrain(const Terrain &terrain);
 		void drawTerrain(const Terrain &terrain, int lod);
+		//Streams the patches around the camera of the last setCamera call. Patches that are not generated or
+		//uploaded yet are skipped.
+		void drawTerrain(StreamingTerrain &terrain);
 
 		void setColor(float r, float g, float b, float a);
 		void setColor(float r, float g, float b);
 		void setColor(const Color &c);
 
 		void setCamera(const Vector3 &cameraPos, const Vector3 &cameraTarget, const Vector3 &cameraUpVector = Vector3(0, 0, 1.0f));
+
+		void setFrustumCullingEnabled(bool enabled);
+		bool isFrustumCullingEnabled() const;
+		const Frustum& getFrustum() const;
+		int getAmountOfDrawnObjects() const;
+		int getAmountOfCulledObjects() const;
+
+		//Terrain patches closer than this use the full resolution. Every doubling of the distance halves it.
+		//The vertices morph into the next level over the last quarter of the distance before each switch.
+		void setTerrainLodDistance(float lodDistance);
+		float getTerrainLodDistance() const;
+
+		//The ray from the camera through a point on the screen (in pixels), with a normalized direction.
+		Ray getScreenRay(float x, float y) const;
 	};
 }
\ No newline at end of file
@@ -1,54 +1,131 @@
 #pragma once
 
 #include <random>
+#include <emmintrin.h>
 #include "../BBE/DataType.h"
 #include "../BBE/List.h"
 #include "../BBE/Vector2.h"
 #include "../BBE/Vector3.h"
 #include "../BBE/Vector4.h"
+#include "../BBE/Exceptions.h"
+#include "../BBE/SplitMix64.h"
+#include "../BBE/PCG32.h"
+#include "../BBE/Xoshiro256.h"
+#include "../BBE/Philox.h"
 
 namespace bbe {
-	class Random
+	//Generator needs a constructor (uint64_t seed, uint64_t stream), next() returning uint32_t or uint64_t
+	//and fill(uint32_t* out, size_t amount).
+	template <typename Generator>
+	class RandomBase
 	{
 	private:
-		std::random_device m_ranDev;
-		std::mt19937       m_mt;
-		
+		static constexpr size_t FILL_CHUNK_SIZE = 1024;
+
+		Generator m_generator;
+
+		static uint64_t createSeedFromDevice()
+		{
+			std::random_device ranDev;
+			return ((uint64_t)ranDev() << 32) | ranDev();
+		}
+
+		static uint32_t toBits32(uint32_t value)
+		{
+			return value;
+		}
+
+		static uint32_t toBits32(uint64_t value)
+		{
+			return (uint32_t)(value >> 32);
+		}
+
+		uint64_t toBits64(uint32_t high)
+		{
+			return ((uint64_t)high << 32) | m_generator.next();
+		}
+
+		uint64_t toBits64(uint64_t value)
+		{
+			return value;
+		}
+
+		uint32_t nextBits32()
+		{
+			return toBits32(m_generator.next());
+		}
+
+		uint64_t nextBits64()
+		{
+			return toBits64(m_generator.next());
+		}
+
+		//Uniform in [0, max) without any bias, see Lemire, "Fast Random Integer Generation in an Interval".
+		uint64_t randomBelow(uint64_t max)
+		{
+			if (max > 0xFFFFFFFFull)
+			{
+				uint64_t mask = max - 1;
+				mask |= mask >> 1;
+				mask |= mask >> 2;
+				mask |= mask >> 4;
+				mask |= mask >> 8;
+				mask |= mask >> 16;
+				mask |= mask >> 32;
+				while (true)
+				{
+					const uint64_t value = nextBits64() & mask;
+					if (value < max)
+					{
+						return value;
+					}
+				}
+			}
+
+			const uint32_t max32 = (uint32_t)max;
+			uint64_t product = (uint64_t)nextBits32() * max32;
+			if ((uint32_t)product < max32)
+			{
+				const uint32_t threshold = (0 - max32) % max32;
+				while ((uint32_t)product < threshold)
+				{
+					product = (uint64_t)nextBits32() * max32;
+				}
+			}
+			return product >> 32;
+		}
+
 		template<typename T>
 		T randomInteger()
 		{
-			//UNTESTED
-			std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
-			return dist(m_mt);
+			return (T)(sizeof(T) > 4 ? nextBits64() : nextBits32());
 		}
 
 		template<typename T>
 		T randomInteger(T max)
 		{
-			//UNTESTED
-			std::uniform_int_distribution<T> dist(0, max - 1);
-			return dist(m_mt);
+			if (max <= 0)
+			{
+				throw IllegalArgumentException();
+			}
+			return (T)randomBelow((uint64_t)max);
 		}
 
-		template<typename T>
-		T randomFloat()
+		static __m128 toFloats(__m128i bits, __m128 scale)
 		{
-			//UNTESTED
-			std::uniform_real_distribution<T> dist(0.0, 1.0);
-			return dist(m_mt);
+			return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), scale);
 		}
 
-		template<typename T>
-		T randomFloat(T max)
+	public:
+		explicit RandomBase()
+			: m_generator(createSeedFromDevice(), 0)
 		{
-			//UNTESTED
-			std::uniform_real_distribution<T> dist(0.0, max);
-			return dist(m_mt);
+			//DO NOTHING
 		}
 
-	public:
-		explicit Random()
-			: m_ranDev(), m_mt(m_ranDev())
+		//Generators with the same seed and different streams produce independent sequences, e.g. one per worker thread.
+		explicit RandomBase(uint64_t seed, uint64_t stream = 0)
+			: m_generator(seed, stream)
 		{
 			//DO NOTHING
 		}
@@ -107,19 +184,19 @@ namespace bbe {
 		byte randomByte()
 		{
 			//UNTESTED
-			return (byte)(randomInteger<unsigned short>() & 0xff);
+			return (byte)(nextBits32() & 0xff);
 		}
 
 		byte randomByte(byte max)
 		{
 			//UNTESTED
-			return (byte)(randomInteger<unsigned short>(max) & 0xff);
+			return (byte)randomInteger<unsigned short>(max);
 		}
 
 		char randomChar()
 		{
 			//UNTESTED
-			return (char)(randomInteger<short>() & 0xff);
+			return (char)(nextBits32() & 0xff);
 		}
 
 		short randomShort()
@@ -148,25 +225,21 @@ namespace bbe {
 
 		int randomInt()
 		{
-			//UNTESTED
 			return randomInteger<int>();
 		}
 
 		int randomInt(int max)
 		{
-			//UNTESTED
 			return randomInteger<int>(max);
 		}
 
 		unsigned int randomUInt()
 		{
-			//UNTESTED
 			return randomInteger<unsigned int>();
 		}
 
 		unsigned int randomUInt(unsigned int max)
 		{
-			//UNTESTED
 			return randomInteger<unsigned int>(max);
 		}
 
@@ -193,40 +266,89 @@ namespace bbe {
 			//UNTESTED
 			return randomInteger<unsigned long>(max);
 		}
-		
+
+		//[0, 1) with 24 bits of randomness.
 		float randomFloat()
 		{
-			//UNTESTED
-			return randomFloat<float>();
+			return (nextBits32() >> 8) * (1.0f / 16777216.0f);
 		}
 
 		float randomFloat(float max)
 		{
-			//UNTESTED
-			return randomFloat<float>(max);
+			return randomFloat() * max;
 		}
 
+		//[0, 1) with 53 bits of randomness.
 		double randomDouble()
 		{
-			//UNTESTED
-			return randomFloat<double>();
+			return (nextBits64() >> 11) * (1.0 / 9007199254740992.0);
 		}
 
 		double randomDouble(double max)
 		{
 			//UNTESTED
-			return randomFloat<double>(max);
+			return randomDouble() * max;
 		}
 
 		bool randomBool()
 		{
-			//UNTESTED
-			return randomFloat() > 0.5f;
+			return (nextBits32() >> 31) != 0;
+		}
+
+		void setSeed(uint64_t seed, uint64_t stream = 0)
+		{
+			m_generator.setSeed(seed, stream);
 		}
 
-		void setSeed(unsigned int seed)
+		//The bulk functions use the SIMD path of the generator where it has one. Their values come from
+		//a different part of the sequence than the single value functions.
+		void fillUInt(uint32_t* out, size_t amount)
 		{
-			m_mt.seed(seed);
+			m_generator.fill(out, amount);
+		}
+
+		//[0, max) by a multiply and shift, which is biased by at most max / 2^32.
+		void fillUInt(uint32_t* out, size_t amount, uint32_t max)
+		{
+			m_generator.fill(out, amount);
+			for (size_t i = 0; i < amount; i++)
+			{
+				out[i] = (uint32_t)(((uint64_t)out[i] * max) >> 32);
+			}
+		}
+
+		//[0, max), same distribution as randomFloat.
+		void fillFloat(float* out, size_t amount, float max = 1)
+		{
+			const __m128 scale = _mm_set1_ps(max / 16777216.0f);
+			uint32_t bits[FILL_CHUNK_SIZE];
+			for (size_t start = 0; start < amount; start += FILL_CHUNK_SIZE)
+			{
+				const size_t count = amount - start < FILL_CHUNK_SIZE ? amount - start : FILL_CHUNK_SIZE;
+				m_generator.fill(bits, count);
+
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+				{
+					_mm_storeu_ps(out + start + i, toFloats(_mm_loadu_si128((const __m128i*)(bits + i)), scale));
+				}
+				for (; i < count; i++)
+				{
+					out[start + i] = (bits[i] >> 8) * (max / 16777216.0f);
+				}
+			}
+		}
+
+		//Every component in [0, max).
+		void fillVector3(Vector3* out, size_t amount, float max = 1)
+		{
+			static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be three tightly packed floats");
+			fillFloat(reinterpret_cast<float*>(out), amount * 3, max);
 		}
 	};
+
+	typedef RandomBase<Xoshiro256StarStar> Random;
+	typedef RandomBase<PCG32>              RandomPCG32;
+	typedef RandomBase<SplitMix64>         RandomSplitMix64;
+	typedef RandomBase<Philox4x32>         RandomPhilox;
 }
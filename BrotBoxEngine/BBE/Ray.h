@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../BBE/Vector3.h"
+#include "../BBE/Math.h"
+#include "../BBE/Matrix4.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/BoundingSphere.h"
+
+namespace bbe
+{
+	//A ray is the set of points origin + direction * t with t >= 0. The direction is not normalized,
+	//so every t reported by the intersection functions is in multiples of the direction's length.
+	class Ray
+	{
+	private:
+		Vector3 m_origin;
+		Vector3 m_direction;
+
+	public:
+		Ray();
+		Ray(const Vector3 &origin, const Vector3 &direction);
+
+		static Ray createFromPoints(const Vector3 &from, const Vector3 &to);
+
+		Vector3 getOrigin() const;
+		Vector3 getDirection() const;
+		Vector3 getPoint(float t) const;
+
+		void set(const Vector3 &origin, const Vector3 &direction);
+
+		//Keeps t stable: the point at t of the transformed ray is the transformed point at t of this ray.
+		Ray transform(const Matrix4 &transform) const;
+
+		bool intersects(const BoundingBox &box, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+		bool intersects(const BoundingSphere &sphere, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+		bool intersectsTriangle(const Vector3 &a, const Vector3 &b, const Vector3 &c, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+	};
+}
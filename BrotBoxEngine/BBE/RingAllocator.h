@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace bbe
+{
+	//Hands out offsets into an area of a fixed size, for example a staging buffer, and frees them in the order
+	//they were handed out. Positions only ever grow, the offset of a position is the position modulo the
+	//capacity. An allocation never wraps around the end of the area, the rest of the area is skipped instead.
+	class RingAllocator
+	{
+	private:
+		size_t   m_capacity  = 0;
+		uint64_t m_allocated = 0;
+		uint64_t m_freed     = 0;
+
+	public:
+		RingAllocator();
+		explicit RingAllocator(size_t capacity);
+
+		//Frees everything.
+		void reset(size_t capacity);
+
+		//alignment must be a power of two. Returns false if there is not enough free space in one piece.
+		bool allocate(size_t size, size_t alignment, size_t &outOffset);
+		//Everything that was allocated before the returned position is freed by freeUpTo(position).
+		uint64_t getHead() const;
+		void freeUpTo(uint64_t position);
+
+		size_t getCapacity() const;
+		//Includes the space that was skipped for alignment or at the end of the area.
+		size_t getUsed() const;
+		bool isEmpty() const;
+	};
+}
@@ -3,11 +3,67 @@
 #include "../BBE/List.h"
 #include "../BBE/String.h"
 #include <fstream>
+#include <string>
 
 namespace bbe
 {
 	namespace simpleFile
 	{
 		bbe::List<char> readBinaryFile(const bbe::String &filepath);
+		bool doesFileExist(const bbe::String &filepath);
+		//Returns false if the file did not exist or could not be deleted.
+		bool deleteFile(const bbe::String &filepath);
+		//The paths of all files in the directory of prefix whose path starts with prefix.
+		bbe::List<bbe::String> findFilesWithPrefix(const bbe::String &prefix);
+
+		//Writes into a temporary file next to filepath that only replaces filepath in commit(), so readers
+		//never see a half written file. The temporary file is removed if commit() is never called.
+		class BinaryFileWriter
+		{
+		private:
+			std::ofstream m_file;
+			std::wstring m_path;
+			std::wstring m_tempPath;
+			bool m_committed = false;
+
+		public:
+			explicit BinaryFileWriter(const bbe::String &filepath);
+			~BinaryFileWriter();
+
+			BinaryFileWriter(const BinaryFileWriter& other) = delete;
+			BinaryFileWriter(BinaryFileWriter&& other) = delete;
+			BinaryFileWriter& operator=(const BinaryFileWriter& other) = delete;
+			BinaryFileWriter& operator=(BinaryFileWriter&& other) = delete;
+
+			void write(const void* data, size_t size);
+			//Returns false if anything could not be written. filepath is left untouched in that case.
+			bool commit();
+		};
+
+		//Read only view of a whole file. The OS loads the pages on their first access, so opening a big
+		//file is cheap and untouched parts of it are never read.
+		class MappedFile
+		{
+		private:
+			const char* m_pdata = nullptr;
+			size_t m_size = 0;
+
+		public:
+			MappedFile();
+			~MappedFile();
+
+			MappedFile(const MappedFile& other) = delete;
+			MappedFile(MappedFile&& other) = delete;
+			MappedFile& operator=(const MappedFile& other) = delete;
+			MappedFile& operator=(MappedFile&& other) = delete;
+
+			//Returns false if the file does not exist, is empty or could not be mapped.
+			bool open(const bbe::String &filepath);
+			void close();
+
+			bool isOpen() const;
+			const char* getData() const;
+			size_t getSize() const;
+		};
 	}
 }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../BBE/List.h"
+
+namespace bbe
+{
+	//Packs rectangles into a fixed area. The packer only remembers the skyline, the upper outline of everything
+	//that was inserted so far, and puts every rectangle at the position where its top ends up lowest.
+	class SkylinePacker
+	{
+	private:
+		class SkylineNode
+		{
+		public:
+			int m_x;
+			int m_y;
+			int m_width;
+		};
+
+		int m_width  = 0;
+		int m_height = 0;
+		int m_usedArea = 0;
+		List<SkylineNode> m_skyline;
+
+		//The y at which a rectangle starting at the node would rest, or -1 if it does not fit there.
+		int getFittingY(size_t nodeIndex, int width, int height) const;
+		static void addMerged(List<SkylineNode> &skyline, const SkylineNode &node);
+
+	public:
+		SkylinePacker();
+		SkylinePacker(int width, int height);
+
+		void reset(int width, int height);
+
+		//Returns false and leaves the packer untouched if the rectangle does not fit anymore.
+		bool insert(int width, int height, int &outX, int &outY);
+
+		int getWidth() const;
+		int getHeight() const;
+		//The area of all inserted rectangles.
+		int getUsedArea() const;
+	};
+}
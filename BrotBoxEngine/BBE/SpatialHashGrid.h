@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include "../BBE/List.h"
+#include "../BBE/Vector3.h"
+#include "../BBE/Math.h"
+
+namespace bbe
+{
+	//Uniform grid over Vector3 positions, stored in a fixed amount of hash buckets.
+	//Every point is identified by the index it was added with. Meant for short range
+	//queries where the radius is in the order of the cell size.
+	class SpatialHashGrid
+	{
+	private:
+		struct Cell
+		{
+			int32_t x;
+			int32_t y;
+			int32_t z;
+
+			bool operator==(const Cell &other) const
+			{
+				return x == other.x && y == other.y && z == other.z;
+			}
+		};
+
+		float m_cellSize;
+		float m_cellSizeInv;
+		size_t m_bucketMask;
+
+		List<List<uint32_t>> m_buckets;
+		List<Vector3> m_positions;
+		List<Cell> m_cells;
+
+		Vector3 m_boundsMin;
+		Vector3 m_boundsMax;
+
+		Cell getCell(const Vector3 &pos) const;
+		size_t getBucket(const Cell &cell) const;
+		void insertIntoBucket(uint32_t index);
+		void removeFromBucket(uint32_t index);
+		void growBounds(const Vector3 &pos);
+
+	public:
+		SpatialHashGrid(float cellSize, size_t amountOfBuckets = 4096);
+
+		void clear();
+
+		size_t add(const Vector3 &pos);
+		void addAll(const Vector3 *positions, size_t amount);
+		void addAll(const float *xs, const float *ys, const float *zs, size_t amount);
+
+		void set(size_t index, const Vector3 &pos);
+		void setAll(const Vector3 *positions, size_t amount);
+		void setAll(const float *xs, const float *ys, const float *zs, size_t amount);
+
+		Vector3 getPosition(size_t index) const;
+		size_t getLength() const;
+		float getCellSize() const;
+
+		void queryRadius(const Vector3 &center, float radius, List<size_t> &outIndices) const;
+		void queryKNearest(const Vector3 &pos, size_t k, List<size_t> &outIndices, float maxDistance = Math::INFINITY_POSITIVE) const;
+		int64_t queryNearest(const Vector3 &pos, float maxDistance = Math::INFINITY_POSITIVE) const;
+
+		template<typename Callback>
+		void forEachInRadius(const Vector3 &center, float radius, Callback callback) const
+		{
+			//callback(size_t index, const Vector3 &pos, float distanceSq)
+			const float radiusSq = radius * radius;
+			const float cellsPerAxis = 2 * radius * m_cellSizeInv + 2;
+
+			if (cellsPerAxis * cellsPerAxis * cellsPerAxis > (float)m_positions.getLength())
+			{
+				//Visiting the cells would be slower than looking at every point.
+				for (size_t i = 0; i < m_positions.getLength(); i++)
+				{
+					float distanceSq = (m_positions[i] - center).getLengthSq();
+					if (distanceSq <= radiusSq)
+					{
+						callback(i, m_positions[i], distanceSq);
+					}
+				}
+				return;
+			}
+
+			const Cell minCell = getCell(center - Vector3(radius));
+			const Cell maxCell = getCell(center + Vector3(radius));
+			Cell cell;
+			for (cell.z = minCell.z; cell.z <= maxCell.z; cell.z++)
+			{
+				for (cell.y = minCell.y; cell.y <= maxCell.y; cell.y++)
+				{
+					for (cell.x = minCell.x; cell.x <= maxCell.x; cell.x++)
+					{
+						const List<uint32_t> &bucket = m_buckets[getBucket(cell)];
+						for (size_t i = 0; i < bucket.getLength(); i++)
+						{
+							const uint32_t index = bucket[i];
+							if (!(m_cells[index] == cell))
+							{
+								//Different cell that landed in the same bucket.
+								continue;
+							}
+							float distanceSq = (m_positions[index] - center).getLengthSq();
+							if (distanceSq <= radiusSq)
+							{
+								callback((size_t)index, m_positions[index], distanceSq);
+							}
+						}
+					}
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <ctime>
+
+namespace bbe
+{
+	//Tiny 64 bit generator. Mostly used to expand a single seed into the state of bigger generators.
+	class SplitMix64
+	{
+	private:
+		static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ull;
+		//Every stream owns a window of 2^40 values of the single 2^64 cycle.
+		static constexpr uint64_t STREAM_DISTANCE = 1ull << 40;
+
+		uint64_t m_state;
+
+	public:
+		SplitMix64()
+		{
+			std::time_t timeStamp = std::time(nullptr);
+			setSeed((uint64_t)timeStamp);
+		}
+
+		explicit SplitMix64(uint64_t seed, uint64_t stream = 0)
+		{
+			setSeed(seed, stream);
+		}
+
+		void setSeed(uint64_t seed, uint64_t stream = 0)
+		{
+			m_state = seed + stream * STREAM_DISTANCE * GAMMA;
+		}
+
+		static uint64_t mix(uint64_t x)
+		{
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+
+		uint64_t next()
+		{
+			m_state += GAMMA;
+			return mix(m_state);
+		}
+
+		void fill(uint32_t* out, size_t amount)
+		{
+			size_t i = 0;
+			for (; i + 2 <= amount; i += 2)
+			{
+				const uint64_t value = next();
+				out[i] = (uint32_t)(value >> 32);
+				out[i + 1] = (uint32_t)value;
+			}
+			if (i < amount)
+			{
+				out[i] = (uint32_t)(next() >> 32);
+			}
+		}
+	};
+}
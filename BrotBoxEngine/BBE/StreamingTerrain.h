@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "../BBE/Terrain.h"
+#include "../BBE/GradientNoise.h"
+#include "../BBE/FractalNoise.h"
+#include "../BBE/ThreadPool.h"
+#include "../BBE/Matrix4.h"
+#include "../BBE/List.h"
+#include "../BBE/Ray.h"
+
+namespace bbe
+{
+	//An unbounded terrain whose patches are generated, uploaded and evicted around the camera. The heights
+	//are generated on background threads, the main thread only picks up finished patches and uploads at most
+	//a few of them per frame, so moving the camera never waits for generation.
+	class StreamingTerrain
+	{
+		friend class PrimitiveBrush3D;
+	private:
+		struct PatchRequest
+		{
+			int               m_patchX;
+			int               m_patchY;
+			std::atomic<bool> m_cancelled;
+			bool              m_finished = false; //Guarded by m_mutex.
+			float*            m_pdata    = nullptr;
+			float*            m_pborders = nullptr;
+
+			PatchRequest(int patchX, int patchY);
+		};
+
+		struct ResidentPatch
+		{
+			int           m_patchX;
+			int           m_patchY;
+			TerrainPatch* m_ppatch;
+			uint64_t      m_lastUsedFrame;
+			float         m_distance;
+		};
+
+		FractalNoise<SimplexNoise> m_heightNoise;
+		Matrix4  m_transform;
+		Matrix4  m_inverseTransform;
+
+		float  m_loadRadius         = 512;
+		float  m_unloadRadius       = 640;
+		size_t m_maxResidentPatches = 64;
+		int    m_maxUploadsPerFrame = 1;
+
+		uint64_t                    m_frame = 0;
+		List<ResidentPatch>         m_residentPatches;
+		List<PatchRequest*>         m_requests;
+		std::mutex                  m_mutex;
+		std::condition_variable     m_requestFinished;
+		size_t                      m_amountOfRunningRequests = 0; //Guarded by m_mutex.
+		ThreadPool                  m_threadPool;
+
+		float getDistanceToPatch(const Vector2 &localCameraPos, int patchX, int patchY) const;
+		Matrix4 getPatchTransform(int patchX, int patchY) const;
+		void generate(PatchRequest* request);
+		void request(int patchX, int patchY);
+		void collectFinishedRequests();
+		void evict(size_t index);
+		//Creates the GPU buffers of at most m_maxUploadsPerFrame resident patches, nearest first.
+		void uploadPatches();
+
+	public:
+		//Vertices per patch side and their spacing, the same as the patches of Terrain.
+		static const int   PATCH_RESOLUTION;
+		static const float PATCH_SIZE;
+
+		StreamingTerrain();
+		//The same seed always produces the same heights, no matter in which order the patches are generated.
+		explicit StreamingTerrain(uint64_t seed, size_t amountOfThreads = 0);
+		~StreamingTerrain();
+
+		StreamingTerrain(const StreamingTerrain&) = delete;
+		StreamingTerrain(StreamingTerrain&&) = delete;
+		StreamingTerrain& operator=(const StreamingTerrain&) = delete;
+		StreamingTerrain& operator=(StreamingTerrain&&) = delete;
+
+		//Patches closer than the load radius are requested. Resident patches are only evicted once they are
+		//farther than the unload radius, so the camera can move back and forth across the border without
+		//patches being generated again and again.
+		void setLoadRadius(float loadRadius, float unloadRadius);
+		//If more patches are resident, the least recently used ones are evicted first.
+		void setMaxResidentPatches(size_t maxResidentPatches);
+		void setMaxUploadsPerFrame(int maxUploadsPerFrame);
+
+		float getLoadRadius() const;
+		float getUnloadRadius() const;
+		size_t getMaxResidentPatches() const;
+		int getMaxUploadsPerFrame() const;
+
+		Matrix4 getTransform() const;
+		void setTransform(const Vector3 &pos, const Vector3 &scale, const Vector3 &rotationVector, float radians);
+		void setTransform(const Matrix4 &transform);
+
+		//Picks up finished patches, requests missing ones and evicts far away ones. Never blocks. Called by
+		//PrimitiveBrush3D::drawTerrain with the position of the camera.
+		void update(const Vector3 &cameraPos);
+		//Blocks until all requested patches are generated. They become resident with the next update.
+		void waitForRequests();
+
+		size_t getAmountOfResidentPatches() const;
+		size_t getAmountOfRequestedPatches() const;
+		//nullptr if the patch is not resident.
+		const TerrainPatch* getPatch(int patchX, int patchY) const;
+
+		bool intersects(const Ray &ray, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+	};
+}
@@ -6,6 +6,12 @@
 #include "../BBE/Matrix4.h"
 #include "../BBE/VulkanCommandPool.h"
 #include "../BBE/List.h"
+#include "../BBE/BoundingBox.h"
+#include "../BBE/Ray.h"
+#include "../BBE/TerrainVertex.h"
+#include "../BBE/Heightfield.h"
+#include "../BBE/SimpleFile.h"
+#include "../BBE/String.h"
 
 namespace bbe
 {
@@ -15,45 +21,106 @@ namespace bbe
 		namespace vulkan
 		{
 			class VulkanManager;
-			class VulkanCommandPool;
+			class VulkanUploadBatcher;
 		}
 	}
 
 	class Terrain;
+	class StreamingTerrain;
+	class ThreadPool;
 
 	class TerrainPatch
 	{
 		friend class PrimitiveBrush3D;
 		friend class INTERNAL::vulkan::VulkanManager;
 		friend class Terrain;
+		friend class StreamingTerrain;
 	private:
+		//The push constants of the terrain vertex shader. They start behind the Color of the fragment shader.
+		struct PushConstants
+		{
+			Matrix4 m_transform;
+			int32_t m_verticesPerRow;
+			float   m_vertexDistance;
+			float   m_heightScale;
+			int32_t m_coarserEdges;
+			Vector3 m_cameraPos;
+			float   m_padding;
+			//See getMorphRange, the scales are one divided by the length of the range. The coarser range is used
+			//on the edges in m_coarserEdges, so they morph together with the odd vertices of the neighbour.
+			float   m_morphStart;
+			float   m_morphScale;
+			float   m_coarserMorphStart;
+			float   m_coarserMorphScale;
+		};
+
 		Matrix4 m_transform;
+		Matrix4 m_inverseTransform;
 
 		static VkDevice         s_device;
 		static VkPhysicalDevice s_physicalDevice;
-		static VkQueue          s_queue;
-		static INTERNAL::vulkan::VulkanCommandPool *s_pcommandPool;
+		static INTERNAL::vulkan::VulkanUploadBatcher *s_puploadBatcher;
 
+		//Shared by all patches, indexed by lodLevel * AMOUNT_OF_EDGE_MASKS + coarserEdges.
+		static List<bbe::INTERNAL::vulkan::VulkanBuffer> s_indexBuffers;
+		static List<int> s_amountOfIndices;
 
-		static void s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool &commandPool, VkQueue queue);
+
+		static void s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher);
+		static void s_initIndexBuffers();
+		static void s_destroy();
 
 		void init() const;
-		void initIndexBuffer() const;
 		void initVertexBuffer() const;
 		void destroy() const;
-		mutable List<bbe::INTERNAL::vulkan::VulkanBuffer> m_indexBuffers;
+		void destroyAtEndOfFrame() const;
 		mutable List<bbe::INTERNAL::vulkan::VulkanBuffer> m_vertexBuffers;
-		mutable List<int> m_numberOfVertices = 0;
 
 		int m_width;
 		int m_height;
+		int m_patchX;
+		int m_patchY;
 
 		mutable bool m_created = false;
 		mutable bool m_needsDestruction = true;
-		float* m_pdata = nullptr;
+		bool m_ownsData = true;
+		const float* m_pdata = nullptr;
+		//The heights right outside of the patch, see createBorders.
+		const float* m_pborders = nullptr;
+		//All lod levels back to back, if the patch was loaded from the cache file of its terrain.
+		const TerrainVertex* m_plodVertices = nullptr;
+
+		BoundingBox m_localBoundingBox;
+
+		//Points into the cache file of a terrain instead of copying the data.
+		TerrainPatch(const float* data, const float* borders, const TerrainVertex* lodVertices, int patchX, int patchY);
+		void initBoundingBox();
+		//The normals of the full resolution heightfield, including the borders, in the order of m_pdata.
+		List<Vector3> createNormals() const;
+		List<TerrainVertex> createLodVertices(int lodLevel, const List<Vector3> &normals) const;
 
 	public:
-		TerrainPatch(int width, int height, float* data);
+		//Vertices per patch side. Every lod level halves them, so the vertices of a coarser level are a subset
+		//of the vertices of the finer one.
+		static const int PATCH_RESOLUTION;
+		//Bits of the coarserEdges masks. Rows of a patch run along x.
+		static const int EDGE_NEGATIVE_X;
+		static const int EDGE_POSITIVE_X;
+		static const int EDGE_NEGATIVE_Y;
+		static const int EDGE_POSITIVE_Y;
+		static const int AMOUNT_OF_EDGE_MASKS;
+		//Height of a vertex with the height 1 in the heightfield.
+		static const float HEIGHT_SCALE;
+		//Distance between two vertices of the full resolution.
+		static const float VERTEX_DISTANCE;
+
+		//patchX and patchY are the position of the patch in the grid of its terrain. They are used to find the
+		//neighbours of a patch when the lod levels are selected. The heights outside of the patch are
+		//extrapolated from its edges.
+		TerrainPatch(int width, int height, float* data, int patchX, int patchY);
+		//borders holds the heights of the neighbouring patches along the edges, see createBorders, so the
+		//normals on the edges are the same as the ones of the neighbours.
+		TerrainPatch(int width, int height, float* data, const float* borders, int patchX, int patchY);
 		~TerrainPatch();
 
 		TerrainPatch(const TerrainPatch& other) = delete;
@@ -64,6 +131,37 @@ namespace bbe
 		Matrix4 getTransform() const;
 		void setTransform(const Vector3 &pos, const Vector3 &scale, const Vector3 &rotationVector, float radians);
 		void setTransform(const Matrix4 &transform);
+
+		BoundingBox getBoundingBox() const;
+
+		//Walks the cells of the full resolution heightfield along the ray.
+		bool intersects(const Ray &ray, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
+
+		//The vertices of a lod level as they are uploaded. Every lod level uses the normals of the full
+		//resolution heightfield, including the heights behind the edges of the patch, so neither switching the
+		//level nor the edge between two patches changes the lighting. The morph height of a vertex that the
+		//next coarser level drops lies on the edge of the coarser triangle that covers it. Even vertices on
+		//the edges of the patch get the morph height of the level after that, which is what a coarser
+		//neighbour morphs its vertex at the same position to.
+		List<TerrainVertex> createLodVertices(int lodLevel) const;
+		static int getAmountOfLodVertices(int lodLevel);
+		//The row before and after the patch followed by the column before and after it, PATCH_RESOLUTION
+		//heights each. Heights that are not known are extrapolated from the edge of data.
+		static void createBorders(const float* data, float* outBorders);
+		static int getAmountOfBorderHeights();
+
+		//The triangle strips of a lod level, separated by primitive restarts. On every edge in coarserEdges the
+		//odd vertices are collapsed onto their even neighbours, so the edge matches the edge of a neighbour that
+		//is one lod level coarser and no cracks appear between them.
+		static List<uint32_t> createLodIndices(int lodLevel, int coarserEdges);
+		//Picks the lod level of every patch from its distance to the camera. Patches closer than lodDistance
+		//get level 0 and every doubling of the distance adds a level. Afterwards patches are refined until
+		//neighbours differ by at most one level, and outCoarserEdges gets the edges that border a coarser patch.
+		static void selectLodLevels(const int* patchXs, const int* patchYs, const float* distances, size_t amount, float lodDistance, int* outLodLevels, int* outCoarserEdges);
+		//The distances over which the vertices of a lod level morph into the next coarser level. outEnd is the
+		//distance at which selectLodLevels switches to the next level, so a patch already looks like the
+		//next level when it switches. The last level does not morph.
+		static void getMorphRange(int lodLevel, float lodDistance, float &outStart, float &outEnd);
 	};
 
 	class Terrain
@@ -72,12 +170,21 @@ namespace bbe
 		friend class INTERNAL::vulkan::VulkanManager;
 	private:
 		Matrix4 m_transform;
+		//Declared before the patches, because they may point into it.
+		simpleFile::MappedFile m_cacheFile;
+		String m_cacheFilePath;
 		List<TerrainPatch> m_patches;
+		bool m_cacheHit = false;
 
 		void init() const;
 		void destroy() const;
 
-		static void s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool &commandPool, VkQueue queue);
+		void createPatches(int width, int height, uint64_t seed, const Heightfield &heightfield, ThreadPool &threadPool);
+		bool loadCache(const String &cacheFilePath, uint64_t key);
+		bool writeCache(const String &cacheFilePath, uint64_t key, ThreadPool &threadPool) const;
+
+		static void s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher);
+		static void s_destroy();
 
 		int m_patchesWidthAmount  = 0; 
 		int m_patchesHeightAmount = 0;
@@ -85,10 +192,30 @@ namespace bbe
 	public:
 		static const int AMOUNT_OF_LOD_LEVELS;
 		Terrain(int width, int height);
+		//The same seed always produces the same terrain.
+		Terrain(int width, int height, uint64_t seed);
+		//Runs the erosion of the heightfield on the generated heights before they are split into patches.
+		Terrain(int width, int height, uint64_t seed, const Heightfield &heightfield);
+		//Maps the cache file of the size, seed and heightfield (see getCacheFilePath) if it exists. Otherwise the
+		//terrain is generated, written to it together with the vertices of all lod levels and mapped afterwards.
+		//The patches of a mapped terrain upload their vertices straight from the file, so it can not be deleted
+		//while the terrain is alive. Writing a new file deletes the files of other keys next to it that no
+		//terrain maps anymore.
+		Terrain(int width, int height, uint64_t seed, const Heightfield &heightfield, const String &cacheFilePath);
 		~Terrain();
 
+		//True if the terrain was loaded from a valid cache file instead of being generated.
+		bool wasCacheHit() const;
+
+		//cacheFilePath followed by a key of everything that changes the terrain, for example
+		//"terrain.0123456789abcdef". Terrains with other parameters use other files, so a file that is still
+		//mapped by a terrain is never replaced.
+		static String getCacheFilePath(int width, int height, uint64_t seed, const Heightfield &heightfield, const String &cacheFilePath);
+
 		Matrix4 getTransform() const;
 		void setTransform(const Vector3 &pos, const Vector3 &scale, const Vector3 &rotationVector, float radians);
 		void setTransform(const Matrix4 &transform);
+
+		bool intersects(const Ray &ray, float &outT, float maxT = Math::INFINITY_POSITIVE) const;
 	};
 }
\ No newline at end of file
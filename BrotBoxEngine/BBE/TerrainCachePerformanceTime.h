@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../BBE/Terrain.h"
+#include "../BBE/Heightfield.h"
+#include "../BBE/StopWatch.h"
+#include <iostream>
+#include <cstdio>
+
+namespace bbe
+{
+	namespace test
+	{
+		void terrainCachePrintSpeed()
+		{
+			const int size = 1024;
+			const char* cacheFilePath = "TerrainCachePerformanceTime.bin";
+			Heightfield heightfield;
+			heightfield.setHydraulicIterations(20);
+			heightfield.setThermalIterations(20);
+			std::remove(cacheFilePath);
+
+			//Without a cache every patch still has to create its lod vertices when it is uploaded.
+			{
+				StopWatch watch;
+				Terrain terrain(size, size, 1, heightfield);
+				std::cout << "Terrain " << size << "x" << size << " uncached: " << watch.getTimeExpiredMicroseconds() / 1000.0 << " ms (without lod vertices)" << std::endl;
+			}
+			{
+				StopWatch watch;
+				Terrain terrain(size, size, 1, heightfield, cacheFilePath);
+				std::cout << "Terrain " << size << "x" << size << " cold cache: " << watch.getTimeExpiredMicroseconds() / 1000.0 << " ms" << std::endl;
+			}
+			{
+				StopWatch watch;
+				Terrain terrain(size, size, 1, heightfield, cacheFilePath);
+				std::cout << "Terrain " << size << "x" << size << " warm cache: " << watch.getTimeExpiredMicroseconds() / 1000.0 << " ms"
+					<< (terrain.wasCacheHit() ? "" : " (MISSED)") << std::endl;
+			}
+
+			std::remove(cacheFilePath);
+		}
+	}
+}
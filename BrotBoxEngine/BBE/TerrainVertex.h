@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include "../BBE/Vector3.h"
+#include "../BBE/Math.h"
+
+namespace bbe
+{
+	//8 instead of the 24 bytes of a VertexWithNormal. Only the heights are stored, as unsigned normalized
+	//shorts, because the x and y position of a vertex follow from its index in the grid of the patch. The
+	//terrain vertex shader derives them from gl_VertexIndex. The normal is stored as signed normalized bytes.
+	//The morph height is the height of the vertex in the next coarser lod level. The shader moves the vertex
+	//towards it with the distance to the camera, so switching the level does not pop.
+	class TerrainVertex
+	{
+	public:
+		uint16_t m_height;
+		uint16_t m_morphHeight;
+		int8_t   m_normal[4];
+
+		//The heights are heights of the heightfield in [0, 1], before they are scaled by the shader.
+		TerrainVertex(float height, float morphHeight, const Vector3 &normal)
+		{
+			m_height = (uint16_t)Math::round(Math::clamp(height, 0, 1) * 65535);
+			m_morphHeight = (uint16_t)Math::round(Math::clamp(morphHeight, 0, 1) * 65535);
+			m_normal[0] = (int8_t)Math::round(Math::clamp(normal.x, -1, 1) * 127);
+			m_normal[1] = (int8_t)Math::round(Math::clamp(normal.y, -1, 1) * 127);
+			m_normal[2] = (int8_t)Math::round(Math::clamp(normal.z, -1, 1) * 127);
+			m_normal[3] = 0;
+		}
+
+		float getHeight() const
+		{
+			return m_height / 65535.0f;
+		}
+
+		float getMorphHeight() const
+		{
+			return m_morphHeight / 65535.0f;
+		}
+
+		Vector3 getNormal() const
+		{
+			return Vector3(m_normal[0] / 127.0f, m_normal[1] / 127.0f, m_normal[2] / 127.0f);
+		}
+	};
+}
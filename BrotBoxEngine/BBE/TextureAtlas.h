@@ -0,0 +1,75 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include "../BBE/Image.h"
+#include "../BBE/Rectangle.h"
+#include "../BBE/SkylinePacker.h"
+#include <stdint.h>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanUploadBatcher;
+			class VulkanDescriptorPool;
+			class VulkanDescriptorSetLayout;
+		}
+	}
+
+	//Copies many small images into one big image, so they share one VkImage, sampler and descriptor set and can
+	//be drawn in the same draw call. Images are packed the first time they are added and keep their place until
+	//the atlas is destroyed, there is no eviction. The atlas also contains a single white pixel for untextured
+	//primitives.
+	class TextureAtlas
+	{
+	private:
+		static uint64_t s_nextId;
+		//Images remember the id of the atlas they were added to. A new id is taken every time the atlas is
+		//initialized, so images never use a place from before a destroy().
+		uint64_t      m_id   = 0;
+		int           m_size = 0;
+		SkylinePacker m_packer;
+		Image         m_image;
+		Rectangle     m_whiteUvRect;
+		//Rows of m_image that changed since the last upload.
+		int           m_dirtyMinY = 0;
+		int           m_dirtyMaxY = 0;
+
+		void init();
+		bool pack(const ColorByte* data, int width, int height, Rectangle &outUvRect);
+
+	public:
+		//Every image keeps a border of its own edge pixels, so sampling at its edges never reads a neighbour.
+		static const int PADDING;
+		static const int DEFAULT_SIZE;
+		//Larger images are not worth the space and keep their own descriptor set.
+		static const int MAX_IMAGE_SIZE;
+
+		TextureAtlas();
+		explicit TextureAtlas(int size);
+
+		TextureAtlas(const TextureAtlas& other) = delete;
+		TextureAtlas(TextureAtlas&& other) = delete;
+		TextureAtlas& operator=(const TextureAtlas& other) = delete;
+		TextureAtlas& operator=(TextureAtlas&& other) = delete;
+
+		//outUvRect gets the place of the image in uv coordinates of the atlas. Returns false if the image is too
+		//big or the atlas is full. Adding the same image again is cheap.
+		bool add(const Image &image, Rectangle &outUvRect);
+		//A zero sized rect in the middle of the white pixel.
+		Rectangle getWhiteUvRect();
+
+		//Creates the VkImage on the first call. Later calls copy the rows that changed since the last one.
+		void upload(INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher, const INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout &setLayout);
+		bool isUploaded() const;
+		VkDescriptorSet getDescriptorSet() const;
+		void destroy();
+
+		int getSize() const;
+		const Image& getImage() const;
+		int getUsedArea() const;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../BBE/List.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace bbe
+{
+	class ThreadPool
+	{
+	private:
+		List<std::thread> m_threads;
+		List<std::function<void()>> m_jobs;
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::condition_variable m_jobFinished;
+		bool m_stopping = false;
+
+		void workerLoop();
+		bool tryRunJob();
+
+	public:
+		//0 means one thread less than the hardware supports, as the calling thread helps out while waiting.
+		explicit ThreadPool(size_t amountOfThreads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		size_t getAmountOfThreads() const;
+
+		//Splits [begin, end) into chunks of at least minChunkSize elements and calls func(chunkBegin, chunkEnd)
+		//for each of them. Blocks until all chunks are done. May be called from inside a job.
+		void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)> &func, size_t minChunkSize = 1);
+
+		//Calls parallelFor on the pool if there is one, otherwise runs func(begin, end) on the calling thread.
+		static void parallelFor(ThreadPool* threadPool, size_t begin, size_t end, const std::function<void(size_t, size_t)> &func, size_t minChunkSize = 1);
+
+		//Runs job on one of the threads without waiting for it. Jobs that were enqueued last run first.
+		//All enqueued jobs are done before the destructor returns.
+		void enqueue(const std::function<void()> &job);
+	};
+}
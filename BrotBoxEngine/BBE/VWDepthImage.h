@@ -16,11 +16,11 @@ namespace bbe
 			class VWDepthImage
 			{
 			private:
-				VkImage        m_image       = VK_NULL_HANDLE;
-				VkDeviceMemory m_imageMemory = VK_NULL_HANDLE;
-				VkImageView    m_imageView   = VK_NULL_HANDLE;
-				VkDevice       m_device      = VK_NULL_HANDLE;
-				bool           m_created     = false;
+				VkImage                m_image       = VK_NULL_HANDLE;
+				VulkanMemoryAllocation m_imageMemory;
+				VkImageView            m_imageView   = VK_NULL_HANDLE;
+				VkDevice               m_device      = VK_NULL_HANDLE;
+				bool                   m_created     = false;
 
 			public:
 				VWDepthImage();
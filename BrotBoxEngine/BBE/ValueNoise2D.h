@@ -1,8 +1,11 @@
 #pragma once
 
+#include <stdint.h>
 
 namespace bbe
 {
+	class ThreadPool;
+
 	class ValueNoise2D
 	{
 	private:
@@ -11,7 +14,14 @@ namespace bbe
 		int    m_height     = 0;
 		bool   m_wasCreated = false;
 
-		void standardize();
+		int   m_octaves         = 3;
+		int   m_startFrequencyX = 8;
+		int   m_startFrequencyY = 8;
+		float m_startAlpha      = 1;
+		float m_alphaChange     = 0.5f;
+		int   m_frequencyChange = 2;
+
+		void standardize(ThreadPool* threadPool);
 
 	public:
 		ValueNoise2D();
@@ -24,9 +34,29 @@ namespace bbe
 		~ValueNoise2D();
 
 		void create(int width, int height);
+		//Rows are split into tiles that run on the threadPool, if there is one. The result does not depend on it.
+		void create(int width, int height, uint64_t seed, ThreadPool* threadPool = nullptr);
 		void destroy();
 
 		float get(int x, int y);
 		void set(int x, int y, float val);
+		//Row major, width * height values.
+		float* getRaw();
+		int getWidth() const;
+		int getHeight() const;
+
+		//The parameters only affect the following calls of create.
+		void setOctaves(int octaves);
+		void setStartFrequency(int frequencyX, int frequencyY);
+		void setStartAlpha(float alpha);
+		void setAlphaChange(float alphaChange);
+		void setFrequencyChange(int frequencyChange);
+
+		int getOctaves() const;
+		int getStartFrequencyX() const;
+		int getStartFrequencyY() const;
+		float getStartAlpha() const;
+		float getAlphaChange() const;
+		int getFrequencyChange() const;
 	};
-}
\ No newline at end of file
+}
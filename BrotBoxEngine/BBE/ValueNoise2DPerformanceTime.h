@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../BBE/ValueNoise2D.h"
+#include "../BBE/ThreadPool.h"
+#include "../BBE/StopWatch.h"
+#include <iostream>
+
+namespace bbe
+{
+	namespace test
+	{
+		void valueNoise2DPrintSpeed()
+		{
+			const int size = 2048;
+			const int amountsOfThreads[] = { 1, 2, 4, 8 };
+			for (int amountOfThreads : amountsOfThreads)
+			{
+				//The calling thread helps out, so the pool needs one thread less.
+				ThreadPool pool(amountOfThreads > 1 ? amountOfThreads - 1 : 1);
+				ThreadPool* threadPool = amountOfThreads > 1 ? &pool : nullptr;
+
+				const int repetitions = 5;
+				StopWatch watch;
+				for (int i = 0; i < repetitions; i++)
+				{
+					ValueNoise2D noise;
+					noise.create(size, size, i, threadPool);
+				}
+				const double seconds = watch.getTimeExpiredMicroseconds() / 1000000.0;
+				std::cout << "ValueNoise2D " << size << "x" << size << " threads=" << amountOfThreads << ": "
+					<< (double)size * size * repetitions / seconds / 1000000.0 << " Mpixels/s" << std::endl;
+			}
+		}
+	}
+}
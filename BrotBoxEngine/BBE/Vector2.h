@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../BBE/Exceptions.h"
 
 namespace bbe
 {
@@ -9,22 +10,22 @@ namespace bbe
 		float x;
 		float y;
 
-		Vector2();
-		Vector2(float x, float y);
-		Vector2(float xy);
+		constexpr Vector2();
+		constexpr Vector2(float x, float y);
+		constexpr Vector2(float xy);
 		static Vector2 createVector2OnUnitCircle(float radians);
 
-		Vector2 operator*(float scalar) const;
-		Vector2 operator/(float scalar) const;
-		float operator*(const Vector2 &other) const;
-		Vector2 operator+(const Vector2 &other) const;
-		Vector2 operator-(const Vector2 &other) const;
-		Vector2 operator-() const;
-		float& operator[](int index);
-		const float& operator[](int index) const;
-
-		bool operator==(const Vector2 &other) const;
-		bool operator!=(const Vector2 &other) const;
+		constexpr Vector2 operator*(float scalar) const;
+		constexpr Vector2 operator/(float scalar) const;
+		constexpr float operator*(const Vector2 &other) const;
+		constexpr Vector2 operator+(const Vector2 &other) const;
+		constexpr Vector2 operator-(const Vector2 &other) const;
+		constexpr Vector2 operator-() const;
+		constexpr float& operator[](int index);
+		constexpr const float& operator[](int index) const;
+
+		constexpr bool operator==(const Vector2 &other) const;
+		constexpr bool operator!=(const Vector2 &other) const;
 		bool operator> (const Vector2 &other) const;
 		bool operator>=(const Vector2 &other) const;
 		bool operator< (const Vector2 &other) const;
@@ -40,12 +41,12 @@ namespace bbe
 		bool isContainingInfinity() const;
 		bool isUnit(float epsilon = 0.001f) const;
 		bool isCloseTo(const Vector2 &other, float maxDistance) const;
-		bool isZero() const;
+		constexpr bool isZero() const;
 
 		Vector2 rotate(float radians) const;
 		Vector2 rotate(float radians, const Vector2 &center) const;
-		Vector2 rotate90Clockwise() const;
-		Vector2 rotate90CounterClockwise() const;
+		constexpr Vector2 rotate90Clockwise() const;
+		constexpr Vector2 rotate90CounterClockwise() const;
 		Vector2 setLenght(float length) const;
 		Vector2 normalize() const;
 		Vector2 abs() const;
@@ -54,7 +55,7 @@ namespace bbe
 		Vector2 reflect(const Vector2 &normal) const;
 
 		float getLength() const;
-		float getLengthSq() const;
+		constexpr float getLengthSq() const;
 		float getDistanceTo(const Vector2 &other) const;
 		float getMax() const;
 		float getMin() const;
@@ -71,3 +72,104 @@ namespace bbe
 		Vector2 yy() const;
 	};
 }
+
+constexpr bbe::Vector2::Vector2()
+	: x(0), y(0)
+{
+}
+
+constexpr bbe::Vector2::Vector2(float x, float y)
+	: x(x), y(y)
+{
+}
+
+constexpr bbe::Vector2::Vector2(float xy)
+	: x(xy), y(xy)
+{
+}
+
+constexpr bbe::Vector2 bbe::Vector2::operator*(float scalar) const
+{
+	return Vector2(x * scalar, y * scalar);
+}
+
+constexpr float bbe::Vector2::operator*(const Vector2 & other) const
+{
+	return x * other.x + y * other.y;
+}
+
+constexpr bbe::Vector2 bbe::Vector2::operator/(float scalar) const
+{
+	return Vector2(x / scalar, y / scalar);
+}
+
+constexpr bbe::Vector2 bbe::Vector2::operator+(const Vector2 & other) const
+{
+	return Vector2(x + other.x, y + other.y);
+}
+
+constexpr bbe::Vector2 bbe::Vector2::operator-(const Vector2 & other) const
+{
+	return Vector2(x - other.x, y - other.y);
+}
+
+constexpr bbe::Vector2 bbe::Vector2::operator-() const
+{
+	return Vector2(-x, -y);
+}
+
+constexpr float & bbe::Vector2::operator[](int index)
+{
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	default:
+		throw IllegalIndexException();
+	}
+}
+
+constexpr const float & bbe::Vector2::operator[](int index) const
+{
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	default:
+		throw IllegalIndexException();
+	}
+}
+
+constexpr bool bbe::Vector2::operator==(const Vector2 & other) const
+{
+	return x == other.x && y == other.y;
+}
+
+constexpr bool bbe::Vector2::operator!=(const Vector2 & other) const
+{
+	return !(operator==(other));
+}
+
+constexpr bool bbe::Vector2::isZero() const
+{
+	return x == 0 && y == 0;
+}
+
+constexpr bbe::Vector2 bbe::Vector2::rotate90Clockwise() const
+{
+	return Vector2(-y, x);
+}
+
+constexpr bbe::Vector2 bbe::Vector2::rotate90CounterClockwise() const
+{
+	return Vector2(y, -x);
+}
+
+constexpr float bbe::Vector2::getLengthSq() const
+{
+	return x * x + y * y;
+}
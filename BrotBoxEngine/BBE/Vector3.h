@@ -1,10 +1,10 @@
 #pragma once
 
+#include "../BBE/Vector2.h"
+#include "../BBE/Exceptions.h"
 
 namespace bbe
 {
-	class Vector2;
-
 	class Vector3
 	{
 	public:
@@ -12,23 +12,23 @@ namespace bbe
 		float y;
 		float z;
 
-		Vector3();
-		Vector3(float xyz);
-		Vector3(float x, float y, float z);
-		Vector3(float x, const Vector2 &yz);
-		Vector3(const Vector2 &xy, float z);
-
-		Vector3 operator*(float scalar) const;
-		Vector3 operator/(float scalar) const;
-		float operator*(const Vector3 &other) const;
-		Vector3 operator+(const Vector3 &other) const;
-		Vector3 operator-(const Vector3 &other) const;
-		Vector3 operator-() const;
-		float& operator[](int index);
-		const float& operator[](int index) const;
-
-		bool operator==(const Vector3 &other) const;
-		bool operator!=(const Vector3 &other) const;
+		constexpr Vector3();
+		constexpr Vector3(float xyz);
+		constexpr Vector3(float x, float y, float z);
+		constexpr Vector3(float x, const Vector2 &yz);
+		constexpr Vector3(const Vector2 &xy, float z);
+
+		constexpr Vector3 operator*(float scalar) const;
+		constexpr Vector3 operator/(float scalar) const;
+		constexpr float operator*(const Vector3 &other) const;
+		constexpr Vector3 operator+(const Vector3 &other) const;
+		constexpr Vector3 operator-(const Vector3 &other) const;
+		constexpr Vector3 operator-() const;
+		constexpr float& operator[](int index);
+		constexpr const float& operator[](int index) const;
+
+		constexpr bool operator==(const Vector3 &other) const;
+		constexpr bool operator!=(const Vector3 &other) const;
 		bool operator> (const Vector3 &other) const;
 		bool operator>=(const Vector3 &other) const;
 		bool operator< (const Vector3 &other) const;
@@ -44,7 +44,7 @@ namespace bbe
 		bool isContainingInfinity() const;
 		bool isUnit(float epsilon = 0.001f) const;
 		bool isCloseTo(const Vector3 &other, float maxDistance) const;
-		bool isZero() const;
+		constexpr bool isZero() const;
 
 		Vector3 rotate(float radians, const Vector3 &axisOfRotation) const;
 		Vector3 rotate(float radians, const Vector3 &axisOfRotation, const Vector3 &center) const;
@@ -54,10 +54,10 @@ namespace bbe
 		Vector3 clampComponents(float min, float max) const;
 		Vector3 project(const Vector3 &other) const;
 		Vector3 reflect(const Vector3 &normal) const;
-		Vector3 cross(const Vector3 &other) const;
+		constexpr Vector3 cross(const Vector3 &other) const;
 
 		float getLength() const;
-		float getLengthSq() const;
+		constexpr float getLengthSq() const;
 		float getDistanceTo(const Vector3 &other) const;
 		float getMax() const;
 		float getMin() const;
@@ -108,4 +108,133 @@ namespace bbe
 		Vector3 zzy() const;
 		Vector3 zzz() const;
 	};
-}
\ No newline at end of file
+}
+
+constexpr bbe::Vector3::Vector3()
+	: x(0), y(0), z(0)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector3::Vector3(float xyz)
+	:x(xyz), y(xyz), z(xyz)
+{
+}
+
+constexpr bbe::Vector3::Vector3(float x, float y, float z)
+	: x(x), y(y), z(z)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector3::Vector3(float x, const Vector2 &yz)
+	: x(x), y(yz.x), z(yz.y)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector3::Vector3(const Vector2 &xy, float z)
+	: x(xy.x), y(xy.y), z(z)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector3 bbe::Vector3::operator+(const Vector3 & other) const
+{
+	//UNTESTED
+	return Vector3(x + other.x, y + other.y, z + other.z);
+}
+
+constexpr bbe::Vector3 bbe::Vector3::operator-(const Vector3 & other) const
+{
+	//UNTESTED
+	return Vector3(x - other.x, y - other.y, z - other.z);
+}
+
+constexpr bbe::Vector3 bbe::Vector3::operator-() const
+{
+	return Vector3(-x, -y, -z);
+}
+
+constexpr bbe::Vector3 bbe::Vector3::operator*(float scalar) const
+{
+	//UNTESTED
+	return Vector3(x * scalar, y * scalar, z * scalar);
+}
+
+constexpr bbe::Vector3 bbe::Vector3::operator/(float scalar) const
+{
+	//UNTESTED
+	return Vector3(x / scalar, y / scalar, z / scalar);
+}
+
+constexpr float bbe::Vector3::operator*(const Vector3 & other) const
+{
+	//UNTESTED
+	return x * other.x + y * other.y + z * other.z;
+}
+
+constexpr float & bbe::Vector3::operator[](int index)
+{
+	//UNTESTED
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	default:
+		throw IllegalIndexException();
+	}
+}
+
+constexpr const float & bbe::Vector3::operator[](int index) const
+{
+	//UNTESTED
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	default:
+		throw IllegalIndexException();
+	}
+}
+
+constexpr bool bbe::Vector3::operator==(const Vector3 & other) const
+{
+	//UNTESTED
+	return x == other.x && y == other.y && z == other.z;
+}
+
+constexpr bool bbe::Vector3::operator!=(const Vector3 & other) const
+{
+	//UNTESTED
+	return !operator==(other);
+}
+
+constexpr bool bbe::Vector3::isZero() const
+{
+	//UNTESTED
+	return x == 0 && y == 0 && z == 0;
+}
+
+constexpr bbe::Vector3 bbe::Vector3::cross(const Vector3 & other) const
+{
+	return Vector3(
+		y * other.z - other.y * z,
+		z * other.x - other.z * x,
+		x * other.y - other.x * y
+	);
+}
+
+constexpr float bbe::Vector3::getLengthSq() const
+{
+	//UNTESTED
+	return x * x + y * y + z * z;
+}
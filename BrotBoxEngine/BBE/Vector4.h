@@ -1,11 +1,11 @@
 #pragma once
 
+#include "../BBE/Vector2.h"
+#include "../BBE/Vector3.h"
+#include "../BBE/Exceptions.h"
 
 namespace bbe
 {
-	class Vector2;
-	class Vector3;
-
 	class Vector4
 	{
 	public:
@@ -14,26 +14,26 @@ namespace bbe
 		float z;
 		float w;
 
-		Vector4();
-		Vector4(float xyzw);
-		Vector4(float xyz, float w);
-		Vector4(float x, float y, float z, float w);
-		Vector4(float x, float y, const Vector2 &zw);
-		Vector4(const Vector2 &xy, float z, float w);
-		Vector4(const Vector2 &xy, const Vector2 &zw);
-		Vector4(float x, const Vector2 &yz, float w);
-		Vector4(const Vector3 &xyz, float w);
-		Vector4(float x, const Vector3 &yzw);
+		constexpr Vector4();
+		constexpr Vector4(float xyzw);
+		constexpr Vector4(float xyz, float w);
+		constexpr Vector4(float x, float y, float z, float w);
+		constexpr Vector4(float x, float y, const Vector2 &zw);
+		constexpr Vector4(const Vector2 &xy, float z, float w);
+		constexpr Vector4(const Vector2 &xy, const Vector2 &zw);
+		constexpr Vector4(float x, const Vector2 &yz, float w);
+		constexpr Vector4(const Vector3 &xyz, float w);
+		constexpr Vector4(float x, const Vector3 &yzw);
 
-		Vector4 operator+(const Vector4 &other) const;
-		Vector4 operator-(const Vector4 &other) const;
-		Vector4 operator-() const;
+		constexpr Vector4 operator+(const Vector4 &other) const;
+		constexpr Vector4 operator-(const Vector4 &other) const;
+		constexpr Vector4 operator-() const;
 
-		Vector4 operator*(float scalar) const;
-		Vector4 operator/(float scalar) const;
+		constexpr Vector4 operator*(float scalar) const;
+		constexpr Vector4 operator/(float scalar) const;
 
-		float& operator[](int index);
-		const float& operator[](int index) const;
+		constexpr float& operator[](int index);
+		constexpr const float& operator[](int index) const;
 
 
 		//Start Swizzles
@@ -377,4 +377,127 @@ namespace bbe
 		Vector4 wwww() const;
 
 	};
-}
\ No newline at end of file
+}
+
+constexpr bbe::Vector4::Vector4()
+	: x(0), y(0), z(0), w(0)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(float xyzw)
+	: x(xyzw), y(xyzw), z(xyzw), w(xyzw)
+{
+}
+
+constexpr bbe::Vector4::Vector4(float xyz, float w)
+	: x(xyz), y(xyz), z(xyz), w(w)
+{
+}
+
+constexpr bbe::Vector4::Vector4(float x, float y, float z, float w)
+	: x(x), y(y), z(z), w(w)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(float x, float y, const bbe::Vector2 &zw)
+	: x(x), y(y), z(zw.x), w(zw.y)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(const bbe::Vector2 &xy, float z, float w)
+	: x(xy.x), y(xy.y), z(z), w(w)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(const bbe::Vector2 &xy, const bbe::Vector2 &zw)
+	: x(xy.x), y(xy.y), z(zw.x), w(zw.y)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(float x, const bbe::Vector2 &yz, float w)
+	: x(x), y(yz.x), z(yz.y), w(w)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(const bbe::Vector3 &xyz, float w)
+	: x(xyz.x), y(xyz.y), z(xyz.z), w(w)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4::Vector4(float x, const bbe::Vector3 &yzw)
+	: x(x), y(yzw.x), z(yzw.y), w(yzw.z)
+{
+	//UNTESTED
+}
+
+constexpr bbe::Vector4 bbe::Vector4::operator+(const bbe::Vector4 & other) const
+{
+	//UNTESTED
+	return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
+}
+
+constexpr bbe::Vector4 bbe::Vector4::operator-(const Vector4 & other) const
+{
+	//UNTESTED
+	return Vector4(x - other.x, y - other.y, z - other.z, w - other.w);
+}
+
+constexpr bbe::Vector4 bbe::Vector4::operator-() const
+{
+	return Vector4(-x, -y, -z, -w);
+}
+
+constexpr bbe::Vector4 bbe::Vector4::operator*(float scalar) const
+{
+	//UNTESTED
+	return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
+}
+
+constexpr bbe::Vector4 bbe::Vector4::operator/(float scalar) const
+{
+	//UNTESTED
+	return Vector4(x / scalar, y / scalar, z / scalar, w / scalar);
+}
+
+constexpr float& bbe::Vector4::operator[](int index)
+{
+	//UNTESTED
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	case 3:
+		return w;
+	default:
+		throw IllegalIndexException();
+	}
+}
+
+constexpr const float& bbe::Vector4::operator[](int index) const
+{
+	//UNTESTED
+	switch (index)
+	{
+	case 0:
+		return x;
+	case 1:
+		return y;
+	case 2:
+		return z;
+	case 3:
+		return w;
+	default:
+		throw IllegalIndexException();
+	}
+}
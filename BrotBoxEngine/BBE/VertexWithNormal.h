@@ -12,6 +12,9 @@ namespace bbe
 		Vector3 m_normal;
 
 	
-		VertexWithNormal(Vector3 pos, Vector3 normal);
+		constexpr VertexWithNormal(Vector3 pos, Vector3 normal)
+			: m_pos(pos), m_normal(normal)
+		{
+		}
 	};
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #define GLFW_INCLUDE_VULKAN
 #include "GLFW\glfw3.h"
+#include "../BBE/VulkanMemoryAllocator.h"
 
 namespace bbe
 {
@@ -11,12 +12,13 @@ namespace bbe
 		{
 			class VulkanDevice;
 			class VulkanCommandPool;
+			class VulkanUploadBatcher;
 
 			class VulkanBuffer
 			{
 			private:
 				VkBuffer m_buffer         = VK_NULL_HANDLE;
-				VkDeviceMemory m_memory   = VK_NULL_HANDLE;
+				VulkanMemoryAllocation m_memory;
 				VkDeviceSize m_bufferSize = 0;
 				
 				VkDevice m_device                 = VK_NULL_HANDLE;
@@ -31,6 +33,10 @@ namespace bbe
 				void create(const VulkanDevice &vulkanDevice, size_t sizeInBytes, VkBufferUsageFlags usage, VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE, uint32_t queueFamilyIndexCount = 0, const uint32_t* p_queueFamilyIndices = nullptr);
 				void create(VkDevice vulkanDevice, VkPhysicalDevice physicalDevice, size_t sizeInBytes, VkBufferUsageFlags usage, VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE, uint32_t queueFamilyIndexCount = 0, const uint32_t* p_queueFamilyIndices = nullptr);
 				void upload(const VulkanCommandPool &commandPool, VkQueue queue, VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE, uint32_t queueFamilyIndexCount = 0, const uint32_t* p_queueFamilyIndices = nullptr);
+				//Creates the buffer in device local memory and records the copy of data into it. Returns the id of
+				//the batch of the copy. The result is the same as create, map, unmap and upload, but the data does
+				//not need its own staging buffer and the queue is not waited for.
+				uint64_t createAndUpload(VulkanUploadBatcher &uploadBatcher, const void* data, size_t sizeInBytes, VkBufferUsageFlags usage);
 				void destroy();
 				void destroyAtEndOfFrame();
 				void* map();
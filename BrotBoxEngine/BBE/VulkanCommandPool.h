@@ -26,7 +26,10 @@ namespace bbe
 			public:
 				VulkanCommandPool();
 
-				void init(const VulkanDevice &device);
+				//Pools with VK_COMMAND_POOL_CREATE_TRANSIENT_BIT are meant to be reset() as a whole every frame.
+				void init(const VulkanDevice &device, VkCommandPoolCreateFlags flags = 0);
+				//For command buffers that are submitted to a queue of another family, like the transfer queue.
+				void init(const VulkanDevice &device, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags);
 
 				void destroy();
 
@@ -34,6 +37,9 @@ namespace bbe
 
 				VkCommandBuffer getCommandBuffer();
 				void freeCommandBuffer(VkCommandBuffer commandBuffer);
+				//Returns every command buffer of the pool to the initial state, so they can be recorded again
+				//without allocating new ones. None of them may still be executing.
+				void reset();
 			};
 		}
 	}
@@ -19,9 +19,10 @@ namespace bbe
 			class AdvancedDescriptorBufferInfo
 			{
 			public:
-				AdvancedDescriptorBufferInfo(VkDescriptorBufferInfo descriptorBufferInfo, uint32_t binding);
+				AdvancedDescriptorBufferInfo(VkDescriptorBufferInfo descriptorBufferInfo, uint32_t binding, VkDescriptorType descriptorType);
 				VkDescriptorBufferInfo m_descriptorBufferInfo;
 				uint32_t m_binding;
+				VkDescriptorType m_descriptorType;
 			};
 
 			class AdvancedDescriptorImageInfo
@@ -41,6 +42,8 @@ namespace bbe
 				List<AdvancedDescriptorImageInfo> m_descriptorImageInfos;
 			public:
 				void addUniformBuffer(const VulkanBuffer &buffer, VkDeviceSize offset, uint32_t binding);
+				//range bytes of the buffer, starting at the dynamic offset that is passed to vkCmdBindDescriptorSets.
+				void addDynamicUniformBuffer(const VulkanBuffer &buffer, VkDeviceSize range, uint32_t binding);
 				void addCombinedImageSampler(const Image& image, uint32_t binding);
 				void create(const VulkanDevice &device, const VulkanDescriptorPool &descriptorPool, const VulkanDescriptorSetLayout &setLayout);
 
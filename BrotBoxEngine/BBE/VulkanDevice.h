@@ -28,6 +28,9 @@ namespace bbe
 				VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
 				List<VkSurfaceFormatKHR> m_formats;
 				uint32_t queueFamilyIndex = 0;
+				//Only differs from m_queue if the device has a dedicated transfer queue family.
+				VkQueue          m_transferQueue            = VK_NULL_HANDLE;
+				uint32_t         m_transferQueueFamilyIndex = 0;
 
 			public:
 				VulkanDevice() {};
@@ -59,6 +62,10 @@ namespace bbe
 				VkQueue getQueue() const;
 
 				uint32_t getQueueFamilyIndex() const;
+
+				bool hasDedicatedTransferQueue() const;
+				VkQueue getTransferQueue() const;
+				uint32_t getTransferQueueFamilyIndex() const;
 			};
 		}
 	}
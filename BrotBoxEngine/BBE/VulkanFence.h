@@ -24,11 +24,17 @@ namespace bbe
 			public:
 				VulkanFence();
 
-				void init(const VulkanDevice &vulkanDevice);
+				//A signaled fence does not block the first wait.
+				void init(const VulkanDevice &vulkanDevice, bool signaled = false);
 				void destroy();
 
+				//Waits and resets the fence.
 				void waitForFence(uint64_t timeout = std::numeric_limits<uint64_t>::max());
+				//Waits without resetting the fence, so others can still wait for it.
+				void wait(uint64_t timeout = std::numeric_limits<uint64_t>::max());
 				void reset();
+				//Returns immediately.
+				bool isSignaled();
 
 				VkFence getFence();
 			};
@@ -0,0 +1,60 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include "../BBE/VulkanSemaphore.h"
+#include "../BBE/VulkanFence.h"
+#include "../BBE/VulkanBuffer.h"
+#include "../BBE/VulkanMemoryAllocator.h"
+#include "../BBE/VulkanCommandPool.h"
+#include "../BBE/Stack.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanDevice;
+
+			//Everything the CPU writes or records for one of the frames in flight. A frame is only recorded again
+			//once its fence signaled, so the GPU is done with all of it by then.
+			class VulkanFrame
+			{
+			public:
+				VulkanSemaphore m_semaphoreImageAvailable;
+				VulkanSemaphore m_semaphoreRenderingDone;
+				VulkanFence     m_fence;
+				//A transient pool per frame, so its command buffer is recycled by resetting the whole pool.
+				VulkanCommandPool m_commandPool;
+				VkCommandBuffer   m_commandBuffer = VK_NULL_HANDLE;
+
+				//The head of the uniform ring when the frame was submitted. Its uniforms are freed up to there.
+				uint64_t            m_uniformRingHead = 0;
+				//The InstanceData3D of the instanced cubes and icospheres. PrimitiveBrush3D grows it if a frame
+				//draws more instances than fit.
+				VulkanBuffer        m_instanceBuffer;
+				//The batched 2D primitives, grown by PrimitiveBrush2D.
+				VulkanBuffer        m_vertexBuffer2D;
+				VulkanBuffer        m_indexBuffer2D;
+
+				//Resources that were released while this frame was the current one.
+				Stack<VkBuffer>               m_pendingDestructionBuffers;
+				Stack<VkImage>                m_pendingDestructionImages;
+				Stack<VkImageView>            m_pendingDestructionImageViews;
+				Stack<VkSampler>              m_pendingDestructionSamplers;
+				Stack<VulkanMemoryAllocation> m_pendingDestructionMemory;
+
+				VulkanFrame();
+
+				void init(const VulkanDevice &device);
+				void destroy(const VulkanDevice &device);
+
+				//Waits until the GPU finished the last submission of this frame, frees what it left behind and
+				//resets the command buffer.
+				void waitUntilReusable(const VulkanDevice &device);
+				void destroyPendingResources(const VulkanDevice &device);
+			};
+		}
+	}
+}
@@ -19,7 +19,8 @@ namespace bbe
 
 				void destroy();
 
-				void init(const char *appName, uint32_t major, uint32_t minor, uint32_t patch);
+				//Without a window the surface extensions of GLFW are not needed, so GLFW does not even have to be initialized.
+				void init(const char *appName, uint32_t major, uint32_t minor, uint32_t patch, bool withWindow = true);
 
 				VulkanInstance(const VulkanInstance& other)            = delete;
 				VulkanInstance(VulkanInstance&& other)                 = delete;
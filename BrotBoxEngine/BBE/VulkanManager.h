@@ -9,19 +9,26 @@
 #include "../BBE/VulkanSurface.h"
 #include "../BBE/VulkanPhysicalDevices.h"
 #include "../BBE/VulkanDevice.h"
+#include "../BBE/VulkanMemoryAllocator.h"
 #include "../BBE/VulkanSwapchain.h"
+#include "../BBE/VulkanOffscreenTarget.h"
 #include "../BBE/VulkanRenderPass.h"
 #include "../BBE/VulkanShader.h"
 #include "../BBE/VulkanPipeline.h"
+#include "../BBE/VulkanPipelineCache.h"
 #include "../BBE/VulkanCommandPool.h"
+#include "../BBE/VulkanUploadBatcher.h"
+#include "../BBE/VulkanUniformRing.h"
 #include "../BBE/VulkanSemaphore.h"
 #include "../BBE/VulkanDescriptorPool.h"
 #include "../BBE/VulkanDescriptorSet.h"
 #include "../BBE/VulkanDescriptorSetLayout.h"
 #include "../BBE/VWDepthImage.h"
 #include "../BBE/VulkanFence.h"
+#include "../BBE/VulkanFrame.h"
 #include "../BBE/Stack.h"
 #include "../BBE/Image.h"
+#include "../BBE/TextureAtlas.h"
 
 namespace bbe
 {
@@ -37,7 +44,13 @@ namespace bbe
 				VulkanSurface           m_surface;
 				PhysicalDeviceContainer m_physicalDeviceContainer;
 				VulkanDevice            m_device;
+				//Every buffer and image below takes its memory from here, so it is destroyed right before the device.
+				VulkanMemoryAllocator   m_memoryAllocator;
+				VulkanPipelineCache     m_pipelineCache;
 				VulkanSwapchain         m_swapchain;
+				//Used instead of the surface and the swapchain if there is no window.
+				VulkanOffscreenTarget   m_offscreenTarget;
+				bool                    m_headless = false;
 				VulkanRenderPass        m_renderPass;
 
 				VulkanShader   m_vertexShader2DPrimitive;
@@ -48,29 +61,46 @@ namespace bbe
 				VulkanShader   m_fragmentShader2DImage;
 				VulkanPipeline m_pipeline2DImage;
 
+				VulkanShader   m_vertexShader2DBatched;
+				VulkanShader   m_fragmentShader2DBatched;
+				VulkanPipeline m_pipeline2DBatched;
+				//Shared by batched images and primitives, allocated the first time something is drawn.
+				TextureAtlas   m_textureAtlas;
+
 				VulkanShader   m_vertexShader3DPrimitive;
 				VulkanShader   m_fragmentShader3DPrimitive;
 				VulkanPipeline m_pipeline3DPrimitive;
+				VulkanShader   m_vertexShader3DTerrain;
 				VulkanPipeline m_pipeline3DTerrain;
 
+				VulkanShader   m_vertexShader3DInstanced;
+				VulkanShader   m_fragmentShader3DInstanced;
+				VulkanPipeline m_pipeline3DInstanced;
 
 				VulkanBuffer   m_uboMatrixViewProjection;
 				VulkanBuffer   m_uboMatrixModel;
 
 				VulkanCommandPool         m_commandPool;
-				VulkanSemaphore           m_semaphoreImageAvailable;
-				VulkanSemaphore           m_semaphoreRenderingDone;
+				VulkanUploadBatcher       m_uploadBatcher;
+				VulkanUniformRing         m_uniformRing;
 				VWDepthImage              m_depthImage;
 				VkCommandBuffer           m_currentFrameDrawCommandBuffer = VK_NULL_HANDLE;
-				VulkanFence               m_presentFence;
+				List<VulkanFrame>         m_frames;
+				size_t                    m_currentFrame = 0;
+				//The fence of the frame that last rendered into a swapchain image, or nullptr.
+				List<VulkanFence*>        m_imagesInFlight;
 				VulkanDescriptorSetLayout m_setLayoutVertexLight;
 				VulkanDescriptorSetLayout m_setLayoutFragmentLight;
 				VulkanDescriptorSetLayout m_setLayoutViewProjectionMatrix;
 				VulkanDescriptorSetLayout m_setLayoutSampler;
 				VulkanDescriptorPool      m_descriptorPool;
+				//Dynamic uniform buffers in m_uniformRing, shared by all frames.
 				VulkanDescriptorSet       m_setVertexLight;
 				VulkanDescriptorSet       m_setFragmentLight;
-				VulkanDescriptorSet       m_setViewProjectionMatrixLight;
+				VulkanDescriptorSet       m_setViewProjectionMatrix;
+				//The light slots of the frame that is currently recorded, filled right before it is submitted.
+				void                     *m_pvertexLightData   = nullptr;
+				void                     *m_pfragmentLightData = nullptr;
 				GLFWwindow               *m_pwindow = nullptr;
 				PrimitiveBrush2D          m_primitiveBrush2D;
 				PrimitiveBrush3D          m_primitiveBrush3D;
@@ -78,10 +108,16 @@ namespace bbe
 				uint32_t m_screenWidth;
 				uint32_t m_screenHeight;
 				uint32_t m_imageIndex;
+				//The image of the last submitted frame, if there was one.
+				uint32_t m_lastImageIndex     = 0;
+				bool     m_frameWasSubmitted  = false;
+
+				long long m_pipelineCreationMicroseconds    = 0;
+				long long m_swapchainRecreationMicroseconds = 0;
 
-				Stack<VkBuffer>       m_pendingDestructionBuffers;
-				Stack<VkDeviceMemory> m_pendingDestructionMemory;
-				void destroyPendingBuffers();
+				void resetImagesInFlight();
+				uint32_t getAmountOfImages() const;
+				VkFramebuffer getFrameBuffer(uint32_t imageIndex) const;
 
 			public:
 				VulkanManager();
@@ -91,6 +127,7 @@ namespace bbe
 				VulkanManager& operator=(const VulkanManager& other) = delete;
 				VulkanManager& operator=(VulkanManager&& other) = delete;
 
+				//Renders into offscreen images instead of a swapchain if window is nullptr.
 				void init(const char *appName, uint32_t major, uint32_t minor, uint32_t patch, GLFWwindow *window, uint32_t initialWindowWidth, uint32_t initialWindowHeight);
 
 				void destroy();
@@ -102,10 +139,21 @@ namespace bbe
 				bbe::PrimitiveBrush2D *getBrush2D();
 				bbe::PrimitiveBrush3D *getBrush3D();
 
-				void addPendingDestructionBuffer(VkBuffer buffer, VkDeviceMemory memory);
+				//Destroyed once the GPU finished every frame that was submitted so far.
+				void addPendingDestructionBuffer(VkBuffer buffer, const VulkanMemoryAllocation &memory);
+				void addPendingDestructionImage(VkImage image, VkImageView imageView, VkSampler sampler, const VulkanMemoryAllocation &memory);
 				void createPipelines();
 				void resize(uint32_t width, uint32_t height);
+				//Only the swapchain, the depth image and the framebuffers depend on the size of the window.
 				void recreateSwapchain();
+
+				bool isHeadless() const;
+				//Copies the last submitted frame into outImage. Waits for the GPU. Only available without a window.
+				void captureFrame(Image &outImage);
+
+				//How long the last createPipelines and recreateSwapchain took.
+				long long getPipelineCreationMicroseconds() const;
+				long long getSwapchainRecreationMicroseconds() const;
 			};
 		}
 	}
@@ -0,0 +1,107 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include <stdint.h>
+#include "../BBE/List.h"
+#include "../BBE/FreeListAllocator.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanDevice;
+
+			class VulkanMemoryAllocation
+			{
+			public:
+				VkDeviceMemory m_memory = VK_NULL_HANDLE;
+				VkDeviceSize   m_offset = 0;
+				VkDeviceSize   m_size   = 0;
+				//Points to m_offset in the memory if it is host visible, otherwise nullptr.
+				void*          m_pmapped   = nullptr;
+				//The allocation owns m_memory instead of being a part of a block.
+				bool           m_dedicated = false;
+			};
+
+			class VulkanMemoryStats
+			{
+			public:
+				size_t       m_amountOfBlocks               = 0;
+				size_t       m_amountOfEmptyBlocks          = 0;
+				size_t       m_amountOfAllocations          = 0;
+				size_t       m_amountOfDedicatedAllocations = 0;
+				VkDeviceSize m_blockBytes                   = 0;
+				VkDeviceSize m_usedBlockBytes               = 0;
+				VkDeviceSize m_dedicatedBytes               = 0;
+				//The biggest free range of all blocks. Far less than the free bytes means the blocks are fragmented.
+				VkDeviceSize m_largestFreeRange             = 0;
+			};
+
+			//Allocates device memory in big blocks per memory type and places buffers and images inside of them, so
+			//a resource usually does not need its own vkAllocateMemory and maxMemoryAllocationCount is not reached.
+			//Host visible blocks stay mapped for their whole life.
+			//
+			//Buffers and optimal tiling images are kept in different blocks if the device has a
+			//bufferImageGranularity, so they never share a page. Resources that are bigger than half a block get
+			//their own memory.
+			class VulkanMemoryAllocator
+			{
+			private:
+				class Block
+				{
+				public:
+					VkDeviceMemory    m_memory          = VK_NULL_HANDLE;
+					uint32_t          m_memoryTypeIndex = 0;
+					bool              m_linear          = true;
+					void*             m_pmapped         = nullptr;
+					FreeListAllocator m_allocator;
+				};
+
+				VkDevice                         m_device         = VK_NULL_HANDLE;
+				VkPhysicalDevice                 m_physicalDevice = VK_NULL_HANDLE;
+				VkPhysicalDeviceMemoryProperties m_memoryProperties;
+				VkDeviceSize                     m_bufferImageGranularity = 1;
+				List<Block>                      m_blocks;
+				size_t                           m_amountOfDedicatedAllocations = 0;
+				VkDeviceSize                     m_dedicatedBytes               = 0;
+
+				VkDeviceSize getBlockSize(uint32_t memoryTypeIndex) const;
+				size_t findBlock(VkDeviceMemory memory) const;
+				void releaseBlock(size_t index);
+
+			public:
+				//Set while an allocator is initialized. Without one every resource gets its own memory.
+				static VulkanMemoryAllocator *s_pinstance;
+				static const VkDeviceSize BLOCK_SIZE;
+
+				VulkanMemoryAllocator();
+
+				VulkanMemoryAllocator(const VulkanMemoryAllocator& other) = delete;
+				VulkanMemoryAllocator(VulkanMemoryAllocator&& other) = delete;
+				VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator& other) = delete;
+				VulkanMemoryAllocator& operator=(VulkanMemoryAllocator&& other) = delete;
+
+				void init(const VulkanDevice &device);
+				//Frees all blocks, the resources in them must be destroyed already.
+				void destroy();
+
+				//linear is true for buffers and images with linear tiling.
+				void allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, bool linear, VulkanMemoryAllocation &outAllocation);
+				void free(VulkanMemoryAllocation &allocation);
+
+				//Blocks are kept when they become empty while they are the only one of their kind. This frees them,
+				//for example after a level was unloaded.
+				void releaseEmptyBlocks();
+				VulkanMemoryStats getStats() const;
+
+				static void allocateDedicated(VkDevice device, VkPhysicalDevice physicalDevice, const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, VulkanMemoryAllocation &outAllocation);
+			};
+
+			//Frees the allocation in the allocator it came from and resets it.
+			void freeMemory(VkDevice device, VulkanMemoryAllocation &allocation);
+		}
+	}
+}
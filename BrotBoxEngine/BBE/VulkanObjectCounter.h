@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			enum class VulkanObjectType
+			{
+				BUFFER, DEVICE_MEMORY, IMAGE, IMAGE_VIEW, SAMPLER, COMMAND_BUFFER, DESCRIPTOR_SET, PIPELINE, AMOUNT_OF_TYPES
+			};
+
+			//Counts the Vulkan objects that are created or allocated. VulkanManager ends a frame in every preDraw,
+			//so the counts of the last frame show whether drawing still allocates something.
+			class VulkanObjectCounter
+			{
+			private:
+				static std::atomic<uint32_t> s_currentFrame[(int)VulkanObjectType::AMOUNT_OF_TYPES];
+				static uint32_t              s_lastFrame[(int)VulkanObjectType::AMOUNT_OF_TYPES];
+				static std::atomic<uint64_t> s_total[(int)VulkanObjectType::AMOUNT_OF_TYPES];
+
+			public:
+				static void count(VulkanObjectType type, uint32_t amount = 1);
+				static void endFrame();
+
+				static uint32_t getAmountLastFrame(VulkanObjectType type);
+				static uint32_t getAmountLastFrame();
+				static uint64_t getTotalAmount(VulkanObjectType type);
+			};
+		}
+	}
+}
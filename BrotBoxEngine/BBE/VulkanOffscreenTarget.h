@@ -0,0 +1,54 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include "../BBE/List.h"
+#include "../BBE/VulkanMemoryAllocator.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VWDepthImage;
+			class VulkanDevice;
+			class VulkanRenderPass;
+
+			//Takes the place of the swapchain when there is no window. The frames are rendered into device local
+			//images that can be copied back to the CPU, so nothing needs a surface or a display.
+			class VulkanOffscreenTarget
+			{
+			private:
+				VkDevice                     m_device = VK_NULL_HANDLE;
+				List<VkImage>                m_images;
+				List<VulkanMemoryAllocation> m_imageMemory;
+				List<VkImageView>            m_imageViews;
+				List<VkFramebuffer>          m_frameBuffers;
+
+				uint32_t m_width  = 0;
+				uint32_t m_height = 0;
+
+			public:
+				VulkanOffscreenTarget();
+
+				VulkanOffscreenTarget(const VulkanOffscreenTarget& other) = delete;
+				VulkanOffscreenTarget(VulkanOffscreenTarget&& other) = delete;
+				VulkanOffscreenTarget& operator=(const VulkanOffscreenTarget& other) = delete;
+				VulkanOffscreenTarget& operator=(VulkanOffscreenTarget&& other) = delete;
+
+				//The images have the format of the device and may be used as the source of a copy.
+				void init(const VulkanDevice &device, uint32_t width, uint32_t height, uint32_t amountOfImages);
+				void destroy();
+
+				void createFramebuffers(const VWDepthImage &depthImage, const VulkanRenderPass &renderPass);
+
+				uint32_t getAmountOfImages() const;
+				VkFramebuffer getFrameBuffer(size_t index) const;
+				VkImage getImage(size_t index) const;
+				uint32_t getWidth() const;
+				uint32_t getHeight() const;
+			};
+		}
+	}
+}
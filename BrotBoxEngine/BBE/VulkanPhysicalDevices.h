@@ -36,6 +36,9 @@ namespace bbe
 
 
 				uint32_t findBestCompleteQueueIndex() const;
+				//A queue family that supports transfers but neither graphics nor compute. Such families usually
+				//belong to a DMA engine that copies while the graphics queue keeps rendering.
+				bool findDedicatedTransferQueueIndex(uint32_t &outIndex) const;
 
 				VkPhysicalDevice getDevice() const;
 			};
@@ -52,7 +52,8 @@ namespace bbe
 
 				void init(VulkanShader vertexShader, VulkanShader fragmentShader, uint32_t width, uint32_t height);
 
-				void create(VkDevice device, VkRenderPass renderPass);
+				//The viewport and the scissor are dynamic, so the pipeline stays valid when the window is resized.
+				void create(VkDevice device, VkRenderPass renderPass, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
 
 				void destroy();
 
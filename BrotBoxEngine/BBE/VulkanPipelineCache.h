@@ -0,0 +1,47 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include "../BBE/String.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanDevice;
+
+			//A VkPipelineCache that is read from a file on init and written back on save, so the driver does not
+			//compile the same pipelines again on every start. The file is only used if it was written by the same
+			//device and driver version, otherwise the cache starts empty and the file is replaced on save.
+			class VulkanPipelineCache
+			{
+			private:
+				VkDevice        m_device        = VK_NULL_HANDLE;
+				VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+				String          m_filePath;
+				VkPhysicalDeviceProperties m_properties;
+				bool            m_loadedFromFile = false;
+
+			public:
+				VulkanPipelineCache();
+
+				VulkanPipelineCache(const VulkanPipelineCache& other) = delete;
+				VulkanPipelineCache(VulkanPipelineCache&& other) = delete;
+				VulkanPipelineCache& operator=(const VulkanPipelineCache& other) = delete;
+				VulkanPipelineCache& operator=(VulkanPipelineCache&& other) = delete;
+
+				//An empty filePath keeps the cache in memory only.
+				void init(const VulkanDevice &device, const String &filePath);
+				void destroy();
+
+				//Returns false if the file could not be written.
+				bool save() const;
+
+				VkPipelineCache getPipelineCache() const;
+				bool wasLoadedFromFile() const;
+			};
+		}
+	}
+}
@@ -22,7 +22,8 @@ namespace bbe
 
 				void destroy();
 
-				void init(const VulkanDevice &device);
+				//finalLayout is the layout the color attachment is left in, the present layout for a swapchain.
+				void init(const VulkanDevice &device, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
 				VkRenderPass getRenderPass() const;
 			};
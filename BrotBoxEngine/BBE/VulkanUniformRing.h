@@ -0,0 +1,52 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include <stdint.h>
+#include "../BBE/RingAllocator.h"
+#include "../BBE/VulkanBuffer.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanDevice;
+
+			//One persistently mapped uniform buffer that the uniforms of all frames in flight are written to. Every
+			//write gets its own slot, which is bound as a dynamic offset of a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			//so uniforms can change several times per frame without mapping or waiting for the GPU. A frame frees
+			//its slots with freeUpTo once its fence signaled.
+			class VulkanUniformRing
+			{
+			private:
+				VulkanBuffer   m_buffer;
+				unsigned char *m_pdata     = nullptr;
+				RingAllocator  m_ring;
+				size_t         m_alignment = 0;
+
+			public:
+				static const size_t BUFFER_SIZE;
+
+				VulkanUniformRing();
+
+				VulkanUniformRing(const VulkanUniformRing& other) = delete;
+				VulkanUniformRing(VulkanUniformRing&& other) = delete;
+				VulkanUniformRing& operator=(const VulkanUniformRing& other) = delete;
+				VulkanUniformRing& operator=(VulkanUniformRing&& other) = delete;
+
+				void init(const VulkanDevice &device);
+				//The GPU must be idle.
+				void destroy();
+
+				//Returns size bytes that may be written until the frame is submitted. outOffset is their dynamic offset.
+				void* allocate(size_t size, uint32_t &outOffset);
+				uint64_t getHead() const;
+				void freeUpTo(uint64_t position);
+
+				const VulkanBuffer& getBuffer() const;
+			};
+		}
+	}
+}
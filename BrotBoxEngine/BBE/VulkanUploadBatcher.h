@@ -0,0 +1,107 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include "GLFW\glfw3.h"
+#include <stdint.h>
+#include "../BBE/List.h"
+#include "../BBE/RingAllocator.h"
+#include "../BBE/VulkanBuffer.h"
+#include "../BBE/VulkanCommandPool.h"
+#include "../BBE/VulkanFence.h"
+#include "../BBE/VulkanSemaphore.h"
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		namespace vulkan
+		{
+			class VulkanDevice;
+
+			//Copies data to the GPU through one persistently mapped staging buffer. The copies are recorded into
+			//batches, so many uploads share a single queue submit instead of waiting for the queue once per
+			//resource. Every upload returns the id of its batch, which can be polled with isComplete().
+			//
+			//If the device has a dedicated transfer queue, new resources are copied there and handed over to the
+			//graphics queue afterwards. Everything that was recorded until submit() is visible to the command
+			//buffers that are submitted to the graphics queue after it, so the VulkanManager submits the batcher
+			//right before every frame.
+			class VulkanUploadBatcher
+			{
+			private:
+				enum class BatchState
+				{
+					FREE, RECORDING, SUBMITTED
+				};
+
+				class Batch
+				{
+				public:
+					BatchState      m_state                 = BatchState::FREE;
+					uint64_t        m_id                    = 0;
+					//The head of the staging ring when the batch was submitted.
+					uint64_t        m_ringHead              = 0;
+					VkCommandBuffer m_commandBuffer         = VK_NULL_HANDLE;
+					VkCommandBuffer m_transferCommandBuffer = VK_NULL_HANDLE;
+					bool            m_usesTransferQueue     = false;
+					VulkanFence     m_fence;
+					VulkanSemaphore m_transferDone;
+				};
+
+				const VulkanDevice *m_pdevice = nullptr;
+				VulkanBuffer        m_stagingBuffer;
+				unsigned char      *m_pstagingData = nullptr;
+				RingAllocator       m_ring;
+				VulkanCommandPool   m_commandPool;
+				VulkanCommandPool   m_transferCommandPool;
+				List<Batch>         m_batches;
+				Batch              *m_precording  = nullptr;
+				uint64_t            m_nextId      = 1;
+				uint64_t            m_completedId = 0;
+
+				Batch& getRecordingBatch();
+				Batch* getOldestSubmittedBatch();
+				void retire(Batch &batch);
+				bool waitForOldestBatch();
+				//Submits and waits for older batches until size bytes are free in the staging ring.
+				size_t allocateStaging(size_t size);
+				//The command buffer that copies into new resources.
+				VkCommandBuffer getCopyCommandBuffer(Batch &batch);
+				void recordOwnershipTransfer(Batch &batch, const VkBufferMemoryBarrier *bufferBarrier, const VkImageMemoryBarrier *imageBarrier);
+
+			public:
+				static const size_t STAGING_BUFFER_SIZE;
+				static const size_t AMOUNT_OF_BATCHES;
+				static const size_t ALIGNMENT;
+
+				VulkanUploadBatcher();
+
+				VulkanUploadBatcher(const VulkanUploadBatcher& other) = delete;
+				VulkanUploadBatcher(VulkanUploadBatcher&& other) = delete;
+				VulkanUploadBatcher& operator=(const VulkanUploadBatcher& other) = delete;
+				VulkanUploadBatcher& operator=(VulkanUploadBatcher&& other) = delete;
+
+				void init(const VulkanDevice &device);
+				//The GPU must be idle.
+				void destroy();
+
+				//Copies size bytes of data to the start of dest. dest must have been created for this upload and
+				//must not be used by the GPU yet.
+				uint64_t uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dest);
+				//Copies whole rows of RGBA8 pixels to the rows beginning at y. The image ends up in
+				//VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. oldLayout is the layout the image is in before, images
+				//that are already in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL are copied on the graphics queue.
+				uint64_t uploadImage(const void* data, VkImage image, uint32_t width, int32_t y, uint32_t height, VkImageLayout oldLayout);
+
+				//Submits everything that was recorded so far and returns the id of the submitted batch.
+				uint64_t submit();
+				//Retires finished batches without waiting.
+				void update();
+				bool isComplete(uint64_t id);
+				void wait(uint64_t id);
+
+				const VulkanDevice& getDevice() const;
+			};
+		}
+	}
+}
@@ -7,6 +7,7 @@
 #include "../BBE/Mouse.h"
 #include "../BBE/Hash.h"
 #include "../BBE/CursorMode.h"
+#include "../BBE/Image.h"
 
 
 namespace bbe
@@ -19,12 +20,15 @@ namespace bbe
 	private:
 		static size_t windowsAliveCounter;
 		
-		GLFWwindow                     *m_pwindow;
+		GLFWwindow                     *m_pwindow = nullptr;
 		INTERNAL::vulkan::VulkanManager m_vulkanManager;
 		int                             m_width;
 		int                             m_height;
+		bool                            m_headless;
+		bool                            m_closeRequested = false;
 		
 	public:
+		//Does not open a GLFW window if Settings::isHeadless().
 		Window(int width, int height, const char* title, uint32_t major = 0, uint32_t minor = 0, uint32_t patch = 0);
 
 		Window(const Window& other) = delete;
@@ -37,9 +41,13 @@ namespace bbe
 		void preDraw();
 		bool keepAlive();
 		void postDraw();
+		void close();
 
 		void setCursorMode(bbe::CursorMode cursorMode);
 
+		bool isHeadless() const;
+		void captureFrame(Image &outImage);
+
 		GLFWwindow *getRaw();
 
 		~Window();
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdint.h>
+#include <ctime>
+#include <emmintrin.h>
+#include "../BBE/SplitMix64.h"
+
+namespace bbe
+{
+	//xoshiro256** by Blackman and Vigna. 256 bits of state, period 2^256 - 1.
+	class Xoshiro256StarStar
+	{
+	private:
+		static constexpr int AMOUNT_OF_LANES = 4;
+
+		uint64_t m_state[4];
+		//State of the SIMD lanes that fill uses, m_lanes[word][lane].
+		uint64_t m_lanes[4][AMOUNT_OF_LANES];
+		bool     m_lanesInitialized;
+
+		static uint64_t rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		static __m128i rotl(__m128i x, int k)
+		{
+			return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+		}
+
+		static uint64_t next(uint64_t* state)
+		{
+			const uint64_t result = rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+
+			return result;
+		}
+
+		static void jump(uint64_t* state, const uint64_t* polynomial)
+		{
+			uint64_t result[4] = { 0, 0, 0, 0 };
+			for (int i = 0; i < 4; i++)
+			{
+				for (int b = 0; b < 64; b++)
+				{
+					if (polynomial[i] & (1ull << b))
+					{
+						for (int k = 0; k < 4; k++)
+						{
+							result[k] ^= state[k];
+						}
+					}
+					next(state);
+				}
+			}
+			for (int k = 0; k < 4; k++)
+			{
+				state[k] = result[k];
+			}
+		}
+
+		static void jump(uint64_t* state)
+		{
+			static const uint64_t polynomial[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+			jump(state, polynomial);
+		}
+
+		static void longJump(uint64_t* state)
+		{
+			static const uint64_t polynomial[] = { 0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull };
+			jump(state, polynomial);
+		}
+
+		//The lanes are long jumps away from the scalar state, so they never meet the scalar sequence or
+		//the sequences of other streams, which are only jumps apart.
+		void initLanes()
+		{
+			uint64_t state[4] = { m_state[0], m_state[1], m_state[2], m_state[3] };
+			for (int lane = 0; lane < AMOUNT_OF_LANES; lane++)
+			{
+				longJump(state);
+				for (int k = 0; k < 4; k++)
+				{
+					m_lanes[k][lane] = state[k];
+				}
+			}
+			m_lanesInitialized = true;
+		}
+
+		//Advances two lanes and returns their results.
+		static __m128i next(__m128i* s0, __m128i* s1, __m128i* s2, __m128i* s3)
+		{
+			const __m128i times5 = _mm_add_epi64(_mm_slli_epi64(*s1, 2), *s1);
+			const __m128i rotated = rotl(times5, 7);
+			const __m128i result = _mm_add_epi64(_mm_slli_epi64(rotated, 3), rotated);
+			const __m128i t = _mm_slli_epi64(*s1, 17);
+
+			*s2 = _mm_xor_si128(*s2, *s0);
+			*s3 = _mm_xor_si128(*s3, *s1);
+			*s1 = _mm_xor_si128(*s1, *s2);
+			*s0 = _mm_xor_si128(*s0, *s3);
+
+			*s2 = _mm_xor_si128(*s2, t);
+			*s3 = rotl(*s3, 45);
+
+			return result;
+		}
+
+	public:
+		Xoshiro256StarStar()
+		{
+			std::time_t timeStamp = std::time(nullptr);
+			setSeed((uint64_t)timeStamp);
+		}
+
+		explicit Xoshiro256StarStar(uint64_t seed, uint64_t stream = 0)
+		{
+			setSeed(seed, stream);
+		}
+
+		//Streams are 2^128 values apart. Selecting stream n costs n jumps, which is meant for small
+		//numbers like one stream per worker thread.
+		void setSeed(uint64_t seed, uint64_t stream = 0)
+		{
+			SplitMix64 splitMix(seed);
+			for (int i = 0; i < 4; i++)
+			{
+				m_state[i] = splitMix.next();
+			}
+			for (uint64_t i = 0; i < stream; i++)
+			{
+				jump(m_state);
+			}
+			m_lanesInitialized = false;
+		}
+
+		uint64_t next()
+		{
+			return next(m_state);
+		}
+
+		//Equivalent to 2^128 calls of next.
+		void jump()
+		{
+			jump(m_state);
+			m_lanesInitialized = false;
+		}
+
+		//Equivalent to 2^192 calls of next.
+		void longJump()
+		{
+			longJump(m_state);
+			m_lanesInitialized = false;
+		}
+
+		//Generates with four independent SIMD lanes. The values do not continue the sequence of next,
+		//but are just as reproducible for a given seed and stream.
+		void fill(uint32_t* out, size_t amount)
+		{
+			if (!m_lanesInitialized)
+			{
+				initLanes();
+			}
+
+			__m128i state[4][2];
+			for (int k = 0; k < 4; k++)
+			{
+				state[k][0] = _mm_loadu_si128((const __m128i*)(m_lanes[k] + 0));
+				state[k][1] = _mm_loadu_si128((const __m128i*)(m_lanes[k] + 2));
+			}
+
+			size_t i = 0;
+			while (i < amount)
+			{
+				__m128i result[2];
+				for (int half = 0; half < 2; half++)
+				{
+					result[half] = next(&state[0][half], &state[1][half], &state[2][half], &state[3][half]);
+				}
+
+				if (i + 8 <= amount)
+				{
+					_mm_storeu_si128((__m128i*)(out + i), result[0]);
+					_mm_storeu_si128((__m128i*)(out + i + 4), result[1]);
+					i += 8;
+				}
+				else
+				{
+					uint32_t rest[8];
+					_mm_storeu_si128((__m128i*)(rest), result[0]);
+					_mm_storeu_si128((__m128i*)(rest + 4), result[1]);
+					for (int k = 0; i < amount; k++, i++)
+					{
+						out[i] = rest[k];
+					}
+				}
+			}
+
+			for (int k = 0; k < 4; k++)
+			{
+				_mm_storeu_si128((__m128i*)(m_lanes[k] + 0), state[k][0]);
+				_mm_storeu_si128((__m128i*)(m_lanes[k] + 2), state[k][1]);
+			}
+		}
+	};
+}
@@ -0,0 +1,389 @@
+#include "stdafx.h"
+#include "BBE/BarnesHutTree.h"
+#include "BBE/Exceptions.h"
+#include <algorithm>
+#include <mutex>
+
+static const uint32_t MAX_DEPTH = 21;
+static const uint32_t MORTON_RESOLUTION = 1u << MAX_DEPTH;
+
+//The top levels of the tree are split into independent subtrees which are built in parallel.
+static const uint32_t SUBTREE_DEPTH = 2;
+static const uint32_t MIN_BODIES_PER_SUBTREE = 1024;
+
+static uint64_t expandBits(uint32_t val)
+{
+	uint64_t x = val & 0x1fffff;
+	x = (x | x << 32) & 0x1f00000000ffffull;
+	x = (x | x << 16) & 0x1f0000ff0000ffull;
+	x = (x | x << 8) & 0x100f00f00f00f00full;
+	x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+	x = (x | x << 2) & 0x1249249249249249ull;
+	return x;
+}
+
+static uint32_t quantize(float val, float min, float scale)
+{
+	const float quantized = (val - min) * scale;
+	if (!(quantized > 0))
+	{
+		return 0;
+	}
+	if (quantized >= MORTON_RESOLUTION - 1)
+	{
+		return MORTON_RESOLUTION - 1;
+	}
+	return (uint32_t)quantized;
+}
+
+void bbe::BarnesHutTree::buildFromArrays(const float * xs, const float * ys, const float * zs, size_t stride, const float * masses, size_t amount, ThreadPool * threadPool)
+{
+	if (amount >= 0xFFFFFFFFu)
+	{
+		throw IllegalArgumentException();
+	}
+
+	clear();
+	if (amount == 0)
+	{
+		return;
+	}
+
+	Vector3 boundsMin(xs[0], ys[0], zs[0]);
+	Vector3 boundsMax = boundsMin;
+	std::mutex boundsMutex;
+	ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
+	{
+		Vector3 localMin(xs[begin * stride], ys[begin * stride], zs[begin * stride]);
+		Vector3 localMax = localMin;
+		for (size_t i = begin; i < end; i++)
+		{
+			const float x = xs[i * stride];
+			const float y = ys[i * stride];
+			const float z = zs[i * stride];
+			localMin = Vector3(Math::min(localMin.x, x), Math::min(localMin.y, y), Math::min(localMin.z, z));
+			localMax = Vector3(Math::max(localMax.x, x), Math::max(localMax.y, y), Math::max(localMax.z, z));
+		}
+		std::lock_guard<std::mutex> lock(boundsMutex);
+		boundsMin = Vector3(Math::min(localMin.x, boundsMin.x), Math::min(localMin.y, boundsMin.y), Math::min(localMin.z, boundsMin.z));
+		boundsMax = Vector3(Math::max(localMax.x, boundsMax.x), Math::max(localMax.y, boundsMax.y), Math::max(localMax.z, boundsMax.z));
+	}, 4096);
+
+	//The root is a cube, so that every level splits all axes evenly.
+	const Vector3 extents = boundsMax - boundsMin;
+	m_boundsCenter = (boundsMin + boundsMax) / 2;
+	m_boundsHalfSize = Math::max(extents.x, extents.y, extents.z) / 2 * 1.001f;
+	if (m_boundsHalfSize <= 0)
+	{
+		m_boundsHalfSize = 1;
+	}
+
+	const Vector3 rootMin = m_boundsCenter - Vector3(m_boundsHalfSize);
+	const float scale = MORTON_RESOLUTION / (m_boundsHalfSize * 2);
+	m_bodies.resizeCapacityAndLength(amount);
+	ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const uint32_t qx = quantize(xs[i * stride], rootMin.x, scale);
+			const uint32_t qy = quantize(ys[i * stride], rootMin.y, scale);
+			const uint32_t qz = quantize(zs[i * stride], rootMin.z, scale);
+			m_bodies[i].code = expandBits(qx) << 2 | expandBits(qy) << 1 | expandBits(qz);
+			m_bodies[i].index = (uint32_t)i;
+		}
+	}, 4096);
+
+	sortBodies(threadPool);
+
+	m_sortedPositions.resizeCapacityAndLength(amount);
+	m_sortedMasses.resizeCapacityAndLength(amount);
+	ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const size_t index = m_bodies[i].index;
+			m_sortedPositions[i] = Vector3(xs[index * stride], ys[index * stride], zs[index * stride]);
+			m_sortedMasses[i] = masses != nullptr ? masses[index] : 1.0f;
+		}
+	}, 4096);
+
+	const Cell root = { 0, (uint32_t)amount, 0, m_boundsCenter, m_boundsHalfSize };
+	if (threadPool == nullptr || isSubtreeCell(root))
+	{
+		buildNode(m_nodes, root);
+		return;
+	}
+
+	List<Cell> subtreeCells;
+	collectSubtreeCells(root, subtreeCells);
+	List<List<Node>> subtrees;
+	subtrees.resizeCapacityAndLength(subtreeCells.getLength());
+	threadPool->parallelFor(0, subtreeCells.getLength(), [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			buildNode(subtrees[i], subtreeCells[i]);
+		}
+	});
+
+	size_t subtreeIndex = 0;
+	buildTopNode(root, subtrees, subtreeIndex);
+}
+
+void bbe::BarnesHutTree::sortBodies(ThreadPool * threadPool)
+{
+	MortonBody* bodies = m_bodies.getRaw();
+	const size_t amount = m_bodies.getLength();
+	const size_t amountOfChunks = threadPool != nullptr && amount >= 4096 ? threadPool->getAmountOfThreads() + 1 : 1;
+	if (amountOfChunks == 1)
+	{
+		std::sort(bodies, bodies + amount);
+		return;
+	}
+
+	List<size_t> bounds;
+	for (size_t i = 0; i <= amountOfChunks; i++)
+	{
+		bounds.add(amount * i / amountOfChunks);
+	}
+
+	threadPool->parallelFor(0, amountOfChunks, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			std::sort(bodies + bounds[i], bodies + bounds[i + 1]);
+		}
+	});
+
+	for (size_t width = 1; width < amountOfChunks; width *= 2)
+	{
+		const size_t amountOfMerges = (amountOfChunks + width * 2 - 1) / (width * 2);
+		threadPool->parallelFor(0, amountOfMerges, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const size_t first = i * width * 2;
+				const size_t middle = std::min(first + width, amountOfChunks);
+				const size_t last = std::min(first + width * 2, amountOfChunks);
+				std::inplace_merge(bodies + bounds[first], bodies + bounds[middle], bodies + bounds[last]);
+			}
+		});
+	}
+}
+
+size_t bbe::BarnesHutTree::splitCell(const Cell & cell, Cell * outChildren) const
+{
+	const uint32_t shift = (MAX_DEPTH - 1 - cell.depth) * 3;
+	const float childHalfSize = cell.halfSize / 2;
+	const MortonBody* bodies = m_bodies.getRaw();
+
+	size_t amountOfChildren = 0;
+	uint32_t begin = cell.begin;
+	for (uint32_t octant = 0; octant < 8 && begin < cell.end; octant++)
+	{
+		const MortonBody* split = std::partition_point(bodies + begin, bodies + cell.end, [&](const MortonBody &body)
+		{
+			return ((body.code >> shift) & 7) <= octant;
+		});
+		const uint32_t end = (uint32_t)(split - bodies);
+		if (end > begin)
+		{
+			const Vector3 offset(
+				(octant & 4) ? childHalfSize : -childHalfSize,
+				(octant & 2) ? childHalfSize : -childHalfSize,
+				(octant & 1) ? childHalfSize : -childHalfSize
+			);
+			outChildren[amountOfChildren] = { begin, end, cell.depth + 1, cell.center + offset, childHalfSize };
+			amountOfChildren++;
+		}
+		begin = end;
+	}
+	return amountOfChildren;
+}
+
+bool bbe::BarnesHutTree::isSubtreeCell(const Cell & cell) const
+{
+	return cell.depth >= SUBTREE_DEPTH || cell.end - cell.begin <= MIN_BODIES_PER_SUBTREE;
+}
+
+void bbe::BarnesHutTree::collectSubtreeCells(const Cell & cell, List<Cell>& outCells) const
+{
+	if (isSubtreeCell(cell))
+	{
+		outCells.add(cell);
+		return;
+	}
+
+	Cell children[8];
+	const size_t amountOfChildren = splitCell(cell, children);
+	for (size_t i = 0; i < amountOfChildren; i++)
+	{
+		collectSubtreeCells(children[i], outCells);
+	}
+}
+
+uint32_t bbe::BarnesHutTree::buildNode(List<Node>& nodes, const Cell & cell) const
+{
+	const uint32_t index = (uint32_t)nodes.getLength();
+	Node node;
+	node.center = cell.center;
+	node.halfSize = cell.halfSize;
+	node.bodyBegin = cell.begin;
+	node.bodyEnd = cell.end;
+	node.leaf = cell.end - cell.begin <= m_maxBodiesPerLeaf || cell.depth >= MAX_DEPTH;
+	nodes.add(node);
+
+	if (nodes[index].leaf)
+	{
+		aggregate(nodes, index, nullptr, 0);
+		return index;
+	}
+
+	Cell children[8];
+	uint32_t childIndices[8];
+	const size_t amountOfChildren = splitCell(cell, children);
+	for (size_t i = 0; i < amountOfChildren; i++)
+	{
+		childIndices[i] = buildNode(nodes, children[i]);
+	}
+	aggregate(nodes, index, childIndices, amountOfChildren);
+	return index;
+}
+
+uint32_t bbe::BarnesHutTree::buildTopNode(const Cell & cell, List<List<Node>>& subtrees, size_t & subtreeIndex)
+{
+	const uint32_t index = (uint32_t)m_nodes.getLength();
+	if (isSubtreeCell(cell))
+	{
+		//The subtree was built with its root at index 0, so all skip indices are shifted by its new position.
+		const List<Node> &subtree = subtrees[subtreeIndex];
+		subtreeIndex++;
+		for (const Node &node : subtree)
+		{
+			m_nodes.add(node);
+			m_nodes.last().skip += index;
+		}
+		return index;
+	}
+
+	Node node;
+	node.center = cell.center;
+	node.halfSize = cell.halfSize;
+	node.bodyBegin = cell.begin;
+	node.bodyEnd = cell.end;
+	node.leaf = false;
+	m_nodes.add(node);
+
+	Cell children[8];
+	uint32_t childIndices[8];
+	const size_t amountOfChildren = splitCell(cell, children);
+	for (size_t i = 0; i < amountOfChildren; i++)
+	{
+		childIndices[i] = buildTopNode(children[i], subtrees, subtreeIndex);
+	}
+	aggregate(m_nodes, index, childIndices, amountOfChildren);
+	return index;
+}
+
+void bbe::BarnesHutTree::aggregate(List<Node>& nodes, uint32_t index, const uint32_t * children, size_t amountOfChildren) const
+{
+	float mass = 0;
+	Vector3 weightedPositions;
+	if (amountOfChildren == 0)
+	{
+		for (uint32_t i = nodes[index].bodyBegin; i < nodes[index].bodyEnd; i++)
+		{
+			mass += m_sortedMasses[i];
+			weightedPositions = weightedPositions + m_sortedPositions[i] * m_sortedMasses[i];
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < amountOfChildren; i++)
+		{
+			const Node &child = nodes[children[i]];
+			mass += child.mass;
+			weightedPositions = weightedPositions + child.centerOfMass * child.mass;
+		}
+	}
+
+	Node &node = nodes[index];
+	node.mass = mass;
+	node.centerOfMass = mass != 0 ? weightedPositions / mass : node.center;
+	node.skip = (uint32_t)nodes.getLength();
+}
+
+bbe::BarnesHutTree::BarnesHutTree(float theta, size_t maxBodiesPerLeaf)
+	: m_maxBodiesPerLeaf(maxBodiesPerLeaf)
+{
+	if (maxBodiesPerLeaf == 0)
+	{
+		throw IllegalArgumentException();
+	}
+	setTheta(theta);
+}
+
+void bbe::BarnesHutTree::setTheta(float theta)
+{
+	if (theta < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_theta = theta;
+	m_thetaSq = theta * theta;
+}
+
+float bbe::BarnesHutTree::getTheta() const
+{
+	return m_theta;
+}
+
+void bbe::BarnesHutTree::build(const Vector3 * positions, const float * masses, size_t amount, ThreadPool * threadPool)
+{
+	static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed!");
+	const float* raw = reinterpret_cast<const float*>(positions);
+	buildFromArrays(raw, raw + 1, raw + 2, 3, masses, amount, threadPool);
+}
+
+void bbe::BarnesHutTree::build(const float * xs, const float * ys, const float * zs, const float * masses, size_t amount, ThreadPool * threadPool)
+{
+	buildFromArrays(xs, ys, zs, 1, masses, amount, threadPool);
+}
+
+void bbe::BarnesHutTree::clear()
+{
+	m_nodes.clear();
+	m_bodies.clear();
+	m_sortedPositions.clear();
+	m_sortedMasses.clear();
+	m_boundsCenter = Vector3();
+	m_boundsHalfSize = 0;
+}
+
+size_t bbe::BarnesHutTree::getAmountOfBodies() const
+{
+	return m_bodies.getLength();
+}
+
+size_t bbe::BarnesHutTree::getAmountOfNodes() const
+{
+	return m_nodes.getLength();
+}
+
+float bbe::BarnesHutTree::getTotalMass() const
+{
+	if (m_nodes.getLength() == 0)
+	{
+		return 0;
+	}
+	return m_nodes[0].mass;
+}
+
+bbe::Vector3 bbe::BarnesHutTree::getCenterOfMass() const
+{
+	if (m_nodes.getLength() == 0)
+	{
+		return Vector3();
+	}
+	return m_nodes[0].centerOfMass;
+}
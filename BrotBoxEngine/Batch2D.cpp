@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "BBE/Batch2D.h"
+#include "BBE/Math.h"
+#include "BBE/Exceptions.h"
+
+bbe::Vector2 bbe::Batch2D::toDeviceCoordinates(float x, float y) const
+{
+	return Vector2(x * m_scaleX - 1.f, y * m_scaleY - 1.f);
+}
+
+void bbe::Batch2D::addDraw(VkDescriptorSet texture, uint32_t amountOfIndices)
+{
+	if (m_draws.getLength() > 0 && m_draws.last().m_texture == texture)
+	{
+		m_draws.last().m_amountOfIndices += amountOfIndices;
+		return;
+	}
+
+	Draw draw;
+	draw.m_texture = texture;
+	draw.m_firstIndex = (uint32_t)m_indices.getLength() - amountOfIndices;
+	draw.m_amountOfIndices = amountOfIndices;
+	m_draws.add(draw);
+}
+
+bbe::Batch2D::Batch2D()
+{
+	//Same circle as the one of Circle::s_initVertexBuffer.
+	for (uint32_t i = 0; i < Circle::AMOUNTOFVERTICES; i++)
+	{
+		m_circleVertices.add(Vector2::createVector2OnUnitCircle((float)i / (float)Circle::AMOUNTOFVERTICES * 2 * Math::PI) / 2 + Vector2(0.5f, 0.5f));
+	}
+}
+
+void bbe::Batch2D::begin(int screenWidth, int screenHeight)
+{
+	if (screenWidth <= 0 || screenHeight <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_scaleX = 2.f / screenWidth;
+	m_scaleY = 2.f / screenHeight;
+	m_vertices.clear();
+	m_indices.clear();
+	m_draws.clear();
+}
+
+void bbe::Batch2D::addRectangle(const Rectangle & rect, const Color & color, VkDescriptorSet texture)
+{
+	addRectangle(rect, color, texture, Rectangle(0, 0, 1, 1));
+}
+
+void bbe::Batch2D::addCircle(const Circle & circle, const Color & color, VkDescriptorSet texture)
+{
+	addCircle(circle, color, texture, Rectangle(0, 0, 1, 1));
+}
+
+void bbe::Batch2D::addRectangle(const Rectangle & rect, const Color & color, VkDescriptorSet texture, const Rectangle & uvRect)
+{
+	const uint32_t firstVertex = (uint32_t)m_vertices.getLength();
+	const float left   = rect.getX();
+	const float top    = rect.getY();
+	const float right  = left + rect.getWidth();
+	const float bottom = top  + rect.getHeight();
+	const float uvLeft   = uvRect.getX();
+	const float uvTop    = uvRect.getY();
+	const float uvRight  = uvLeft + uvRect.getWidth();
+	const float uvBottom = uvTop  + uvRect.getHeight();
+	m_vertices.add(Vertex2D(toDeviceCoordinates(left , top   ), Vector2(uvLeft , uvTop   ), color));
+	m_vertices.add(Vertex2D(toDeviceCoordinates(right, top   ), Vector2(uvRight, uvTop   ), color));
+	m_vertices.add(Vertex2D(toDeviceCoordinates(right, bottom), Vector2(uvRight, uvBottom), color));
+	m_vertices.add(Vertex2D(toDeviceCoordinates(left , bottom), Vector2(uvLeft , uvBottom), color));
+
+	m_indices.add(firstVertex);
+	m_indices.add(firstVertex + 1);
+	m_indices.add(firstVertex + 2);
+	m_indices.add(firstVertex);
+	m_indices.add(firstVertex + 2);
+	m_indices.add(firstVertex + 3);
+	addDraw(texture, 6);
+}
+
+void bbe::Batch2D::addCircle(const Circle & circle, const Color & color, VkDescriptorSet texture, const Rectangle & uvRect)
+{
+	const uint32_t firstVertex = (uint32_t)m_vertices.getLength();
+	for (size_t i = 0; i < m_circleVertices.getLength(); i++)
+	{
+		const Vector2 &unit = m_circleVertices[i];
+		m_vertices.add(Vertex2D(toDeviceCoordinates(circle.getX() + unit.x * circle.getWidth(), circle.getY() + unit.y * circle.getHeight()), Vector2(uvRect.getX() + unit.x * uvRect.getWidth(), uvRect.getY() + unit.y * uvRect.getHeight()), color));
+	}
+
+	//A fan around the first vertex, like the index buffer of Circle.
+	for (uint32_t i = 1; i < Circle::AMOUNTOFVERTICES - 1; i++)
+	{
+		m_indices.add(firstVertex);
+		m_indices.add(firstVertex + i);
+		m_indices.add(firstVertex + i + 1);
+	}
+	addDraw(texture, (Circle::AMOUNTOFVERTICES - 2) * 3);
+}
+
+bool bbe::Batch2D::isEmpty() const
+{
+	return m_draws.getLength() == 0;
+}
+
+const bbe::List<bbe::Vertex2D>& bbe::Batch2D::getVertices() const
+{
+	return m_vertices;
+}
+
+const bbe::List<uint32_t>& bbe::Batch2D::getIndices() const
+{
+	return m_indices;
+}
+
+const bbe::List<bbe::Batch2D::Draw>& bbe::Batch2D::getDraws() const
+{
+	return m_draws;
+}
@@ -0,0 +1,99 @@
+#include "stdafx.h"
+#include "BBE/BoundingBox.h"
+#include "BBE/Math.h"
+
+bbe::BoundingBox::BoundingBox()
+	: m_min(0, 0, 0), m_max(0, 0, 0)
+{
+}
+
+bbe::BoundingBox::BoundingBox(const Vector3 & min, const Vector3 & max)
+	: m_min(min), m_max(max)
+{
+}
+
+bbe::BoundingBox bbe::BoundingBox::createFromCenterAndExtents(const Vector3 & center, const Vector3 & extents)
+{
+	return BoundingBox(center - extents, center + extents);
+}
+
+bbe::Vector3 bbe::BoundingBox::getMin() const
+{
+	return m_min;
+}
+
+bbe::Vector3 bbe::BoundingBox::getMax() const
+{
+	return m_max;
+}
+
+bbe::Vector3 bbe::BoundingBox::getCenter() const
+{
+	return (m_min + m_max) * 0.5f;
+}
+
+bbe::Vector3 bbe::BoundingBox::getExtents() const
+{
+	return (m_max - m_min) * 0.5f;
+}
+
+bbe::Vector3 bbe::BoundingBox::getDim() const
+{
+	return m_max - m_min;
+}
+
+float bbe::BoundingBox::getSurfaceArea() const
+{
+	Vector3 dim = getDim();
+	return 2 * (dim.x * dim.y + dim.y * dim.z + dim.z * dim.x);
+}
+
+void bbe::BoundingBox::set(const Vector3 & min, const Vector3 & max)
+{
+	m_min = min;
+	m_max = max;
+}
+
+bbe::BoundingBox bbe::BoundingBox::transform(const Matrix4 & transform) const
+{
+	//Arvo's method: gives the same box as transforming all eight corners.
+	const Vector3 center = transform * getCenter();
+	const Vector3 extents = getExtents();
+
+	Vector3 newExtents;
+	for (int i = 0; i < 3; i++)
+	{
+		newExtents[i] = Math::abs(transform.get(i, 0)) * extents.x
+		              + Math::abs(transform.get(i, 1)) * extents.y
+		              + Math::abs(transform.get(i, 2)) * extents.z;
+	}
+
+	return createFromCenterAndExtents(center, newExtents);
+}
+
+bbe::BoundingBox bbe::BoundingBox::merge(const BoundingBox & other) const
+{
+	return BoundingBox(
+		Vector3(Math::min(m_min.x, other.m_min.x), Math::min(m_min.y, other.m_min.y), Math::min(m_min.z, other.m_min.z)),
+		Vector3(Math::max(m_max.x, other.m_max.x), Math::max(m_max.y, other.m_max.y), Math::max(m_max.z, other.m_max.z))
+	);
+}
+
+bbe::BoundingBox bbe::BoundingBox::merge(const Vector3 & point) const
+{
+	return merge(BoundingBox(point, point));
+}
+
+bool bbe::BoundingBox::contains(const Vector3 & point) const
+{
+	return Math::isInRange(point.x, m_min.x, m_max.x)
+		&& Math::isInRange(point.y, m_min.y, m_max.y)
+		&& Math::isInRange(point.z, m_min.z, m_max.z);
+}
+
+bool bbe::BoundingBox::intersects(const BoundingBox & other) const
+{
+	return m_min.x <= other.m_max.x && m_max.x >= other.m_min.x
+		&& m_min.y <= other.m_max.y && m_max.y >= other.m_min.y
+		&& m_min.z <= other.m_max.z && m_max.z >= other.m_min.z;
+}
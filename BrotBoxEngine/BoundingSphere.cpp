@@ -0,0 +1,57 @@
+#include "stdafx.h"
+#include "BBE/BoundingSphere.h"
+#include "BBE/Math.h"
+
+bbe::BoundingSphere::BoundingSphere()
+	: m_center(0, 0, 0), m_radius(0)
+{
+}
+
+bbe::BoundingSphere::BoundingSphere(const Vector3 & center, float radius)
+	: m_center(center), m_radius(radius)
+{
+}
+
+bbe::Vector3 bbe::BoundingSphere::getCenter() const
+{
+	return m_center;
+}
+
+float bbe::BoundingSphere::getRadius() const
+{
+	return m_radius;
+}
+
+void bbe::BoundingSphere::set(const Vector3 & center, float radius)
+{
+	m_center = center;
+	m_radius = radius;
+}
+
+bbe::BoundingBox bbe::BoundingSphere::getBoundingBox() const
+{
+	return BoundingBox::createFromCenterAndExtents(m_center, Vector3(m_radius));
+}
+
+bool bbe::BoundingSphere::contains(const Vector3 & point) const
+{
+	return (point - m_center).getLengthSq() <= m_radius * m_radius;
+}
+
+bool bbe::BoundingSphere::intersects(const BoundingSphere & other) const
+{
+	float radiusSum = m_radius + other.m_radius;
+	return (other.m_center - m_center).getLengthSq() <= radiusSum * radiusSum;
+}
+
+bool bbe::BoundingSphere::intersects(const BoundingBox & box) const
+{
+	Vector3 min = box.getMin();
+	Vector3 max = box.getMax();
+	Vector3 closest(
+		Math::clamp(m_center.x, min.x, max.x),
+		Math::clamp(m_center.y, min.y, max.y),
+		Math::clamp(m_center.z, min.z, max.z)
+	);
+	return contains(closest);
+}
@@ -0,0 +1,405 @@
+#include "stdafx.h"
+#include "BBE/BoundingVolumeHierarchy.h"
+#include <algorithm>
+
+static const int AMOUNT_OF_BINS = 16;
+
+int32_t bbe::BoundingVolumeHierarchy::buildBinary(List<BuildNode>& buildNodes, List<Vector3>& centroids, uint32_t begin, uint32_t end)
+{
+	BuildNode buildNode;
+	buildNode.m_begin = begin;
+	buildNode.m_end = end;
+	buildNode.m_box = m_boxes[m_indices[begin]];
+	Vector3 centroidMin = centroids[m_indices[begin]];
+	Vector3 centroidMax = centroidMin;
+	for (uint32_t i = begin + 1; i < end; i++)
+	{
+		buildNode.m_box = buildNode.m_box.merge(m_boxes[m_indices[i]]);
+		const Vector3 &c = centroids[m_indices[i]];
+		centroidMin = Vector3(Math::min(centroidMin.x, c.x), Math::min(centroidMin.y, c.y), Math::min(centroidMin.z, c.z));
+		centroidMax = Vector3(Math::max(centroidMax.x, c.x), Math::max(centroidMax.y, c.y), Math::max(centroidMax.z, c.z));
+	}
+
+	const int32_t index = (int32_t)buildNodes.getLength();
+	buildNodes.add(buildNode);
+
+	const uint32_t amount = end - begin;
+	if (amount <= m_maxPrimitivesPerLeaf)
+	{
+		return index;
+	}
+
+	//Binned SAH: the primitives are sorted into bins along every axis by their centroid and the cheapest
+	//bin boundary is chosen as the split.
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float bestCost = Math::INFINITY_POSITIVE;
+	const Vector3 centroidExtents = centroidMax - centroidMin;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (centroidExtents[axis] <= 0)
+		{
+			continue;
+		}
+
+		int binCounts[AMOUNT_OF_BINS] = {};
+		BoundingBox binBoxes[AMOUNT_OF_BINS];
+		const float binScale = AMOUNT_OF_BINS / centroidExtents[axis] * 0.9999f;
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const uint32_t primitive = m_indices[i];
+			const int bin = (int)((centroids[primitive][axis] - centroidMin[axis]) * binScale);
+			binBoxes[bin] = binCounts[bin] == 0 ? m_boxes[primitive] : binBoxes[bin].merge(m_boxes[primitive]);
+			binCounts[bin]++;
+		}
+
+		float rightAreas[AMOUNT_OF_BINS];
+		int rightCounts[AMOUNT_OF_BINS];
+		BoundingBox rightBox;
+		int rightCount = 0;
+		for (int bin = AMOUNT_OF_BINS - 1; bin > 0; bin--)
+		{
+			if (binCounts[bin] > 0)
+			{
+				rightBox = rightCount == 0 ? binBoxes[bin] : rightBox.merge(binBoxes[bin]);
+				rightCount += binCounts[bin];
+			}
+			rightAreas[bin] = rightCount > 0 ? rightBox.getSurfaceArea() : 0;
+			rightCounts[bin] = rightCount;
+		}
+
+		BoundingBox leftBox;
+		int leftCount = 0;
+		for (int split = 1; split < AMOUNT_OF_BINS; split++)
+		{
+			if (binCounts[split - 1] > 0)
+			{
+				leftBox = leftCount == 0 ? binBoxes[split - 1] : leftBox.merge(binBoxes[split - 1]);
+				leftCount += binCounts[split - 1];
+			}
+			if (leftCount == 0 || rightCounts[split] == 0)
+			{
+				continue;
+			}
+			const float cost = leftCount * leftBox.getSurfaceArea() + rightCounts[split] * rightAreas[split];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = split;
+			}
+		}
+	}
+
+	uint32_t middle = begin + amount / 2;
+	if (bestAxis >= 0)
+	{
+		const float binScale = AMOUNT_OF_BINS / centroidExtents[bestAxis] * 0.9999f;
+		const float axisMin = centroidMin[bestAxis];
+		uint32_t* split = std::partition(m_indices.getRaw() + begin, m_indices.getRaw() + end, [&](uint32_t primitive)
+		{
+			return (int)((centroids[primitive][bestAxis] - axisMin) * binScale) < bestSplit;
+		});
+		middle = (uint32_t)(split - m_indices.getRaw());
+	}
+	if (middle == begin || middle == end)
+	{
+		//All centroids are in the same spot, any split is as good as any other.
+		middle = begin + amount / 2;
+	}
+
+	const int32_t left = buildBinary(buildNodes, centroids, begin, middle);
+	const int32_t right = buildBinary(buildNodes, centroids, middle, end);
+	buildNodes[index].m_left = left;
+	buildNodes[index].m_right = right;
+	return index;
+}
+
+uint32_t bbe::BoundingVolumeHierarchy::collapse(const List<BuildNode>& buildNodes, int32_t buildNodeIndex)
+{
+	//Pulls up grandchildren of the binary tree until all four slots are used, opening the largest inner node first.
+	int32_t slots[4];
+	int amountOfSlots = 0;
+	const BuildNode &buildNode = buildNodes[buildNodeIndex];
+	if (buildNode.m_left < 0)
+	{
+		slots[0] = buildNodeIndex;
+		amountOfSlots = 1;
+	}
+	else
+	{
+		slots[0] = buildNode.m_left;
+		slots[1] = buildNode.m_right;
+		amountOfSlots = 2;
+	}
+
+	while (amountOfSlots < 4)
+	{
+		int largest = -1;
+		float largestArea = -1;
+		for (int i = 0; i < amountOfSlots; i++)
+		{
+			const BuildNode &candidate = buildNodes[slots[i]];
+			if (candidate.m_left >= 0 && candidate.m_box.getSurfaceArea() > largestArea)
+			{
+				largest = i;
+				largestArea = candidate.m_box.getSurfaceArea();
+			}
+		}
+		if (largest < 0)
+		{
+			break;
+		}
+		const BuildNode &opened = buildNodes[slots[largest]];
+		slots[largest] = opened.m_left;
+		slots[amountOfSlots] = opened.m_right;
+		amountOfSlots++;
+	}
+
+	const uint32_t index = (uint32_t)m_nodes.getLength();
+	Node node;
+	node.m_usedSlots = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		clearSlot(node, i);
+	}
+	m_nodes.add(node);
+
+	for (int i = 0; i < amountOfSlots; i++)
+	{
+		const BuildNode &child = buildNodes[slots[i]];
+		uint32_t first = child.m_begin;
+		uint32_t count = child.m_end - child.m_begin;
+		if (child.m_left >= 0)
+		{
+			first = collapse(buildNodes, slots[i]);
+			count = 0;
+		}
+		Node &current = m_nodes[index];
+		setSlot(current, i, child.m_box);
+		current.m_children[i] = first;
+		current.m_counts[i] = count;
+	}
+	return index;
+}
+
+void bbe::BoundingVolumeHierarchy::setSlot(Node & node, size_t slot, const BoundingBox & box) const
+{
+	const Vector3 min = box.getMin();
+	const Vector3 max = box.getMax();
+	node.m_minX[slot] = min.x;
+	node.m_minY[slot] = min.y;
+	node.m_minZ[slot] = min.z;
+	node.m_maxX[slot] = max.x;
+	node.m_maxY[slot] = max.y;
+	node.m_maxZ[slot] = max.z;
+	node.m_usedSlots |= 1 << slot;
+}
+
+void bbe::BoundingVolumeHierarchy::clearSlot(Node & node, size_t slot) const
+{
+	node.m_minX[slot] = node.m_minY[slot] = node.m_minZ[slot] = 0;
+	node.m_maxX[slot] = node.m_maxY[slot] = node.m_maxZ[slot] = 0;
+	node.m_children[slot] = 0;
+	node.m_counts[slot] = 0;
+	node.m_usedSlots &= ~(1 << slot);
+}
+
+bbe::BoundingBox bbe::BoundingVolumeHierarchy::getNodeBox(const Node & node) const
+{
+	Vector3 min(Math::INFINITY_POSITIVE);
+	Vector3 max(Math::INFINITY_NEGATIVE);
+	for (int i = 0; i < 4; i++)
+	{
+		if (node.m_usedSlots & (1 << i))
+		{
+			min = Vector3(Math::min(min.x, node.m_minX[i]), Math::min(min.y, node.m_minY[i]), Math::min(min.z, node.m_minZ[i]));
+			max = Vector3(Math::max(max.x, node.m_maxX[i]), Math::max(max.y, node.m_maxY[i]), Math::max(max.z, node.m_maxZ[i]));
+		}
+	}
+	return BoundingBox(min, max);
+}
+
+bbe::BoundingVolumeHierarchy::BoundingVolumeHierarchy(size_t maxPrimitivesPerLeaf)
+	: m_maxPrimitivesPerLeaf(maxPrimitivesPerLeaf)
+{
+	if (maxPrimitivesPerLeaf == 0)
+	{
+		throw IllegalArgumentException();
+	}
+}
+
+void bbe::BoundingVolumeHierarchy::build(const BoundingBox * boxes, size_t amount)
+{
+	if (amount >= 0xFFFFFFFFu)
+	{
+		throw IllegalArgumentException();
+	}
+
+	clear();
+	if (amount == 0)
+	{
+		return;
+	}
+
+	m_boxes.resizeCapacity(amount);
+	m_indices.resizeCapacity(amount);
+	List<Vector3> centroids;
+	centroids.resizeCapacity(amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		m_boxes.add(boxes[i]);
+		m_indices.add((uint32_t)i);
+		centroids.add(boxes[i].getCenter());
+	}
+
+	List<BuildNode> buildNodes;
+	buildNodes.resizeCapacity(amount * 2);
+	const int32_t root = buildBinary(buildNodes, centroids, 0, (uint32_t)amount);
+	collapse(buildNodes, root);
+}
+
+void bbe::BoundingVolumeHierarchy::refit(const BoundingBox * boxes, size_t amount)
+{
+	if (amount != m_boxes.getLength())
+	{
+		throw IllegalArgumentException();
+	}
+
+	for (size_t i = 0; i < amount; i++)
+	{
+		m_boxes[i] = boxes[i];
+	}
+
+	//Children are always stored after their parents, so going backwards visits them first.
+	for (size_t nodeIndex = m_nodes.getLength(); nodeIndex-- > 0;)
+	{
+		Node &node = m_nodes[nodeIndex];
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (!(node.m_usedSlots & (1 << slot)))
+			{
+				continue;
+			}
+
+			BoundingBox box;
+			if (node.m_counts[slot] == 0)
+			{
+				box = getNodeBox(m_nodes[node.m_children[slot]]);
+			}
+			else
+			{
+				const uint32_t first = node.m_children[slot];
+				const uint32_t last = first + node.m_counts[slot];
+				box = m_boxes[m_indices[first]];
+				for (uint32_t i = first + 1; i < last; i++)
+				{
+					box = box.merge(m_boxes[m_indices[i]]);
+				}
+			}
+			setSlot(node, slot, box);
+		}
+	}
+}
+
+void bbe::BoundingVolumeHierarchy::clear()
+{
+	m_nodes.clear();
+	m_indices.clear();
+	m_boxes.clear();
+}
+
+size_t bbe::BoundingVolumeHierarchy::getAmountOfPrimitives() const
+{
+	return m_boxes.getLength();
+}
+
+size_t bbe::BoundingVolumeHierarchy::getAmountOfNodes() const
+{
+	return m_nodes.getLength();
+}
+
+bbe::BoundingBox bbe::BoundingVolumeHierarchy::getBoundingBox() const
+{
+	if (m_nodes.getLength() == 0)
+	{
+		return BoundingBox();
+	}
+	return getNodeBox(m_nodes[0]);
+}
+
+bbe::BoundingBox bbe::BoundingVolumeHierarchy::getPrimitiveBoundingBox(size_t index) const
+{
+	return m_boxes[index];
+}
+
+bool bbe::BoundingVolumeHierarchy::raycast(const Ray & ray, size_t & outIndex, float & outT, float maxT) const
+{
+	return raycast(ray, [&](size_t index, float currentMaxT, float &t)
+	{
+		return ray.intersects(m_boxes[index], t, currentMaxT);
+	}, outIndex, outT, maxT);
+}
+
+bool bbe::BoundingVolumeHierarchy::intersectsSegment(const Vector3 & from, const Vector3 & to) const
+{
+	const Ray ray = Ray::createFromPoints(from, to);
+	return intersectsSegment(from, to, [&](size_t index, float maxT, float &t)
+	{
+		return ray.intersects(m_boxes[index], t, maxT);
+	});
+}
+
+void bbe::BoundingVolumeHierarchy::querySphere(const BoundingSphere & sphere, List<size_t>& outIndices) const
+{
+	outIndices.clear();
+	if (m_nodes.getLength() == 0)
+	{
+		return;
+	}
+
+	const Vector3 center = sphere.getCenter();
+	const __m128 cx = _mm_set1_ps(center.x);
+	const __m128 cy = _mm_set1_ps(center.y);
+	const __m128 cz = _mm_set1_ps(center.z);
+	const __m128 radiusSq = _mm_set1_ps(sphere.getRadius() * sphere.getRadius());
+	const __m128 zero = _mm_setzero_ps();
+
+	TraversalStack<uint32_t> stack;
+	stack.push(0);
+	while (!stack.isEmpty())
+	{
+		const Node &node = m_nodes[stack.pop()];
+
+		//Distance from the center to the closest point of every child box.
+		const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minX), cx), _mm_sub_ps(cx, _mm_loadu_ps(node.m_maxX))), zero);
+		const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minY), cy), _mm_sub_ps(cy, _mm_loadu_ps(node.m_maxY))), zero);
+		const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.m_minZ), cz), _mm_sub_ps(cz, _mm_loadu_ps(node.m_maxZ))), zero);
+		const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		const int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSq, radiusSq)) & node.m_usedSlots;
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (!(mask & (1 << slot)))
+			{
+				continue;
+			}
+
+			if (node.m_counts[slot] == 0)
+			{
+				stack.push(node.m_children[slot]);
+				continue;
+			}
+
+			const uint32_t first = node.m_children[slot];
+			const uint32_t last = first + node.m_counts[slot];
+			for (uint32_t i = first; i < last; i++)
+			{
+				if (sphere.intersects(m_boxes[m_indices[i]]))
+				{
+					outIndices.add(m_indices[i]);
+				}
+			}
+		}
+	}
+}
@@ -85,3 +85,8 @@ bbe::Vector3 bbe::CameraControlNoClip::getCameraTarget()
 {
 	return m_cameraPos + m_forward;
 }
+
+bbe::Ray bbe::CameraControlNoClip::getCameraRay()
+{
+	return Ray(m_cameraPos, m_forward.normalize());
+}
@@ -14,7 +14,7 @@ void bbe::Cube::s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNA
 
 void bbe::Cube::s_initIndexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool & commandPool, VkQueue queue)
 {
-	uint32_t indices[] = {
+	static constexpr uint32_t indices[] = {
 		0, 1, 3,	//Bottom
 		1, 2, 3,
 		2, 1, 5,	//Back
@@ -40,7 +40,7 @@ void bbe::Cube::s_initIndexBuffer(VkDevice device, VkPhysicalDevice physicalDevi
 
 void bbe::Cube::s_initVertexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool & commandPool, VkQueue queue)
 {
-	VertexWithNormal vertices[] = {
+	static constexpr VertexWithNormal vertices[] = {
 		VertexWithNormal(Vector3(0.5 , -0.5, -0.5), Vector3(0.5 , -0.5, -0.5)),
 		VertexWithNormal(Vector3(0.5 , 0.5 , -0.5), Vector3(0.5 , 0.5 , -0.5)),
 		VertexWithNormal(Vector3(-0.5, 0.5 , -0.5), Vector3(-0.5, 0.5 , -0.5)),
@@ -135,3 +135,15 @@ bbe::Matrix4 bbe::Cube::getTransform() const
 {
 	return m_transform;
 }
+
+bbe::BoundingBox bbe::Cube::getBoundingBox() const
+{
+	return BoundingBox(Vector3(-0.5f), Vector3(0.5f)).transform(m_transform);
+}
+
+bool bbe::Cube::intersects(const Ray & ray, float & outT, float maxT) const
+{
+	//The ray is moved into the space of the untransformed unit cube, t stays the same.
+	const Ray localRay = ray.transform(m_transform.inverse());
+	return localRay.intersects(BoundingBox(Vector3(-0.5f), Vector3(0.5f)), outT, maxT);
+}
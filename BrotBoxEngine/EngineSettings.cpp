@@ -4,6 +4,9 @@
 
 static bool started = false;
 static int amountOfLightSources = 4;
+static int amountOfFramesInFlight = 2;
+static bbe::String pipelineCachePath = "pipelineCache.bin";
+static bool headlessMode = false;
 
 void bbe::Settings::INTERNAL_start()
 {
@@ -24,3 +27,52 @@ void bbe::Settings::setAmountOfLightSources(int amount)
 
 	amountOfLightSources = amount;
 }
+
+int bbe::Settings::getAmountOfFramesInFlight()
+{
+	return amountOfFramesInFlight;
+}
+
+void bbe::Settings::setAmountOfFramesInFlight(int amount)
+{
+	if (started)
+	{
+		throw AlreadyStartedException();
+	}
+	if (amount < 1 || amount > 4)
+	{
+		throw IllegalArgumentException();
+	}
+
+	amountOfFramesInFlight = amount;
+}
+
+const bbe::String & bbe::Settings::getPipelineCachePath()
+{
+	return pipelineCachePath;
+}
+
+void bbe::Settings::setPipelineCachePath(const String & path)
+{
+	if (started)
+	{
+		throw AlreadyStartedException();
+	}
+
+	pipelineCachePath = path;
+}
+
+bool bbe::Settings::isHeadless()
+{
+	return headlessMode;
+}
+
+void bbe::Settings::setHeadless(bool headless)
+{
+	if (started)
+	{
+		throw AlreadyStartedException();
+	}
+
+	headlessMode = headless;
+}
@@ -0,0 +1,210 @@
+#include "stdafx.h"
+#include "BBE/FreeListAllocator.h"
+#include "BBE/Exceptions.h"
+
+bbe::INTERNAL::FreeListAllocatorRange::FreeListAllocatorRange()
+	: m_offset(0), m_size(0)
+{
+	//DO NOTHING
+}
+
+bbe::INTERNAL::FreeListAllocatorRange::FreeListAllocatorRange(uint64_t offset, uint64_t size)
+	: m_offset(offset), m_size(size)
+{
+	//DO NOTHING
+}
+
+bool bbe::INTERNAL::FreeListAllocatorRange::operator>(const FreeListAllocatorRange & other) const
+{
+	return m_offset > other.m_offset;
+}
+
+bool bbe::INTERNAL::FreeListAllocatorRange::operator>=(const FreeListAllocatorRange & other) const
+{
+	return m_offset >= other.m_offset;
+}
+
+bool bbe::INTERNAL::FreeListAllocatorRange::operator<(const FreeListAllocatorRange & other) const
+{
+	return m_offset < other.m_offset;
+}
+
+bool bbe::INTERNAL::FreeListAllocatorRange::operator<=(const FreeListAllocatorRange & other) const
+{
+	return m_offset <= other.m_offset;
+}
+
+bool bbe::INTERNAL::FreeListAllocatorRange::operator==(const FreeListAllocatorRange & other) const
+{
+	return m_offset == other.m_offset;
+}
+
+bbe::FreeListAllocator::FreeListAllocator()
+{
+	//DO NOTHING
+}
+
+bbe::FreeListAllocator::FreeListAllocator(uint64_t size)
+{
+	reset(size);
+}
+
+void bbe::FreeListAllocator::reset(uint64_t size)
+{
+	if (size == 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	m_size = size;
+	m_freeSize = size;
+	m_amountOfAllocations = 0;
+	m_freeRanges.clear();
+	m_freeRanges.add(INTERNAL::FreeListAllocatorRange(0, size));
+}
+
+bool bbe::FreeListAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t & outOffset)
+{
+	if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	size_t bestIndex = m_freeRanges.getLength();
+	uint64_t bestOffset = 0;
+	for (size_t i = 0; i < m_freeRanges.getLength(); i++)
+	{
+		const INTERNAL::FreeListAllocatorRange &range = m_freeRanges[i];
+		const uint64_t alignedOffset = (range.m_offset + alignment - 1) & ~(alignment - 1);
+		if (alignedOffset + size > range.m_offset + range.m_size)
+		{
+			continue;
+		}
+		if (bestIndex == m_freeRanges.getLength() || range.m_size < m_freeRanges[bestIndex].m_size)
+		{
+			bestIndex = i;
+			bestOffset = alignedOffset;
+		}
+	}
+	if (bestIndex == m_freeRanges.getLength())
+	{
+		return false;
+	}
+
+	//The space in front of the aligned offset stays free, so the range may be split in two.
+	INTERNAL::FreeListAllocatorRange &range = m_freeRanges[bestIndex];
+	const INTERNAL::FreeListAllocatorRange front(range.m_offset, bestOffset - range.m_offset);
+	const INTERNAL::FreeListAllocatorRange back(bestOffset + size, range.m_offset + range.m_size - bestOffset - size);
+	if (front.m_size > 0)
+	{
+		range = front;
+		if (back.m_size > 0)
+		{
+			m_freeRanges.add(back);
+		}
+	}
+	else if (back.m_size > 0)
+	{
+		range = back;
+	}
+	else
+	{
+		m_freeRanges.removeIndex(bestIndex);
+	}
+
+	m_freeSize -= size;
+	m_amountOfAllocations++;
+	outOffset = bestOffset;
+	return true;
+}
+
+void bbe::FreeListAllocator::free(uint64_t offset, uint64_t size)
+{
+	if (size == 0 || offset + size > m_size || m_amountOfAllocations == 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	size_t next = 0;
+	while (next < m_freeRanges.getLength() && m_freeRanges[next].m_offset < offset)
+	{
+		next++;
+	}
+	const bool hasPrevious = next > 0;
+	const bool hasNext = next < m_freeRanges.getLength();
+	if (hasPrevious && m_freeRanges[next - 1].m_offset + m_freeRanges[next - 1].m_size > offset)
+	{
+		throw IllegalArgumentException();
+	}
+	if (hasNext && m_freeRanges[next].m_offset < offset + size)
+	{
+		throw IllegalArgumentException();
+	}
+
+	const bool touchesPrevious = hasPrevious && m_freeRanges[next - 1].m_offset + m_freeRanges[next - 1].m_size == offset;
+	const bool touchesNext = hasNext && m_freeRanges[next].m_offset == offset + size;
+	if (touchesPrevious && touchesNext)
+	{
+		m_freeRanges[next - 1].m_size += size + m_freeRanges[next].m_size;
+		m_freeRanges.removeIndex(next);
+	}
+	else if (touchesPrevious)
+	{
+		m_freeRanges[next - 1].m_size += size;
+	}
+	else if (touchesNext)
+	{
+		m_freeRanges[next].m_offset = offset;
+		m_freeRanges[next].m_size += size;
+	}
+	else
+	{
+		m_freeRanges.add(INTERNAL::FreeListAllocatorRange(offset, size));
+	}
+
+	m_freeSize += size;
+	m_amountOfAllocations--;
+}
+
+uint64_t bbe::FreeListAllocator::getSize() const
+{
+	return m_size;
+}
+
+uint64_t bbe::FreeListAllocator::getFreeSize() const
+{
+	return m_freeSize;
+}
+
+uint64_t bbe::FreeListAllocator::getUsedSize() const
+{
+	return m_size - m_freeSize;
+}
+
+uint64_t bbe::FreeListAllocator::getLargestFreeRange() const
+{
+	uint64_t largest = 0;
+	for (size_t i = 0; i < m_freeRanges.getLength(); i++)
+	{
+		if (m_freeRanges[i].m_size > largest)
+		{
+			largest = m_freeRanges[i].m_size;
+		}
+	}
+	return largest;
+}
+
+size_t bbe::FreeListAllocator::getAmountOfFreeRanges() const
+{
+	return m_freeRanges.getLength();
+}
+
+size_t bbe::FreeListAllocator::getAmountOfAllocations() const
+{
+	return m_amountOfAllocations;
+}
+
+bool bbe::FreeListAllocator::isEmpty() const
+{
+	return m_amountOfAllocations == 0;
+}
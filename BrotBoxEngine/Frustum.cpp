@@ -0,0 +1,151 @@
+#include "stdafx.h"
+#include "BBE/Frustum.h"
+#include "BBE/Math.h"
+#include "BBE/Exceptions.h"
+#include <xmmintrin.h>
+
+bbe::Frustum::Frustum()
+{
+	//An empty frustum lets everything through.
+	for (int i = 0; i < 6; i++)
+	{
+		m_planes[i] = Vector4(0, 0, 0, 1);
+	}
+}
+
+bbe::Frustum::Frustum(const Matrix4 & viewProjection)
+{
+	set(viewProjection);
+}
+
+void bbe::Frustum::set(const Matrix4 & viewProjection)
+{
+	//Gribb/Hartmann plane extraction. The projection matrices of the engine map z to [-w, w],
+	//which is at most more conservative than the [0, w] depth range that vulkan clips against.
+	const Vector4 row0 = viewProjection.getRow(0);
+	const Vector4 row1 = viewProjection.getRow(1);
+	const Vector4 row2 = viewProjection.getRow(2);
+	const Vector4 row3 = viewProjection.getRow(3);
+
+	m_planes[0] = row3 + row0;
+	m_planes[1] = row3 - row0;
+	m_planes[2] = row3 + row1;
+	m_planes[3] = row3 - row1;
+	m_planes[4] = row3 + row2;
+	m_planes[5] = row3 - row2;
+
+	for (int i = 0; i < 6; i++)
+	{
+		float length = m_planes[i].xyz().getLength();
+		if (length > 0)
+		{
+			m_planes[i] = m_planes[i] / length;
+		}
+	}
+}
+
+bbe::Vector4 bbe::Frustum::getPlane(int index) const
+{
+	if (index < 0 || index > 5)
+	{
+		throw IllegalIndexException();
+	}
+	return m_planes[index];
+}
+
+bool bbe::Frustum::isVisible(const Vector3 & point) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (m_planes[i].x * point.x + m_planes[i].y * point.y + m_planes[i].z * point.z + m_planes[i].w < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool bbe::Frustum::isVisible(const BoundingBox & box) const
+{
+	const Vector3 center = box.getCenter();
+	const Vector3 extents = box.getExtents();
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4 &plane = m_planes[i];
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = Math::abs(plane.x) * extents.x + Math::abs(plane.y) * extents.y + Math::abs(plane.z) * extents.z;
+		if (distance + radius < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool bbe::Frustum::isVisible(const BoundingSphere & sphere) const
+{
+	const Vector3 center = sphere.getCenter();
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4 &plane = m_planes[i];
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -sphere.getRadius())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t bbe::Frustum::isVisible(const BoundingBox * boxes, bool * outVisible, size_t amount) const
+{
+	size_t amountVisible = 0;
+	size_t i = 0;
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+
+	for (; i + 4 <= amount; i += 4)
+	{
+		Vector3 c0 = boxes[i + 0].getCenter(); Vector3 e0 = boxes[i + 0].getExtents();
+		Vector3 c1 = boxes[i + 1].getCenter(); Vector3 e1 = boxes[i + 1].getExtents();
+		Vector3 c2 = boxes[i + 2].getCenter(); Vector3 e2 = boxes[i + 2].getExtents();
+		Vector3 c3 = boxes[i + 3].getCenter(); Vector3 e3 = boxes[i + 3].getExtents();
+
+		const __m128 cx = _mm_setr_ps(c0.x, c1.x, c2.x, c3.x);
+		const __m128 cy = _mm_setr_ps(c0.y, c1.y, c2.y, c3.y);
+		const __m128 cz = _mm_setr_ps(c0.z, c1.z, c2.z, c3.z);
+		const __m128 ex = _mm_setr_ps(e0.x, e1.x, e2.x, e3.x);
+		const __m128 ey = _mm_setr_ps(e0.y, e1.y, e2.y, e3.y);
+		const __m128 ez = _mm_setr_ps(e0.z, e1.z, e2.z, e3.z);
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; p++)
+		{
+			const __m128 nx = _mm_set1_ps(m_planes[p].x);
+			const __m128 ny = _mm_set1_ps(m_planes[p].y);
+			const __m128 nz = _mm_set1_ps(m_planes[p].z);
+			const __m128 d  = _mm_set1_ps(m_planes[p].w);
+
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), d));
+			__m128 radius = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex), _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+				_mm_mul_ps(_mm_andnot_ps(signMask, nz), ez)
+			);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+		}
+
+		int outsideMask = _mm_movemask_ps(outside);
+		for (int k = 0; k < 4; k++)
+		{
+			bool visible = (outsideMask & (1 << k)) == 0;
+			outVisible[i + k] = visible;
+			if (visible) amountVisible++;
+		}
+	}
+
+	for (; i < amount; i++)
+	{
+		outVisible[i] = isVisible(boxes[i]);
+		if (outVisible[i]) amountVisible++;
+	}
+
+	return amountVisible;
+}
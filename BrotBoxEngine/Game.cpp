@@ -37,10 +37,11 @@ void bbe::Game::start(int windowWidth, int windowHeight, const char* title)
 		update(m_gameTime.tick());
 
 		m_pwindow->preDraw();
-		PrimitiveBrush3D brush3D = *(m_pwindow->getBrush3D());
+		//Not copies, so what the brushes collect is still there when the VulkanManager flushes them.
+		PrimitiveBrush3D &brush3D = *(m_pwindow->getBrush3D());
 		m_pwindow->preDraw3D();
 		draw3D(brush3D);
-		PrimitiveBrush2D brush2D = *(m_pwindow->getBrush2D());
+		PrimitiveBrush2D &brush2D = *(m_pwindow->getBrush2D());
 		m_pwindow->preDraw2D();
 		draw2D(brush2D);
 		m_pwindow->postDraw();
@@ -123,3 +124,13 @@ void bbe::Game::setCursorMode(bbe::CursorMode cm)
 {
 	m_pwindow->setCursorMode(cm);
 }
+
+void bbe::Game::closeWindow()
+{
+	m_pwindow->close();
+}
+
+void bbe::Game::captureFrame(bbe::Image & outImage)
+{
+	m_pwindow->captureFrame(outImage);
+}
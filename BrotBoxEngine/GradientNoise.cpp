@@ -0,0 +1,568 @@
+#include "stdafx.h"
+#include "BBE/GradientNoise.h"
+#include "BBE/Random.h"
+#include <emmintrin.h>
+
+static const float GRADIENTS_2D[8][2] = {
+	{  1,  1 }, { -1,  1 }, {  1, -1 }, { -1, -1 },
+	{  1,  0 }, { -1,  0 }, {  0,  1 }, {  0, -1 },
+};
+
+//The edge midpoints of a cube, as in "Improving Noise".
+static const float GRADIENTS_3D[12][3] = {
+	{  1,  1,  0 }, { -1,  1,  0 }, {  1, -1,  0 }, { -1, -1,  0 },
+	{  1,  0,  1 }, { -1,  0,  1 }, {  1,  0, -1 }, { -1,  0, -1 },
+	{  0,  1,  1 }, {  0, -1,  1 }, {  0,  1, -1 }, {  0, -1, -1 },
+};
+
+static const float SIMPLEX_SKEW_2D   = 0.366025403784f; //(sqrt(3) - 1) / 2
+static const float SIMPLEX_UNSKEW_2D = 0.211324865405f; //(3 - sqrt(3)) / 6
+static const float SIMPLEX_SKEW_3D   = 1.0f / 3.0f;
+static const float SIMPLEX_UNSKEW_3D = 1.0f / 6.0f;
+
+//The SIMD paths below use the same operations in the same order as the scalar ones, so a point gives
+//the same value no matter whether it was evaluated alone or in a batch.
+
+static int floorToInt(float x)
+{
+	int i = (int)x;
+	if ((float)i > x)
+	{
+		i--;
+	}
+	return i;
+}
+
+static __m128i floorToInt(__m128 x)
+{
+	const __m128i truncated = _mm_cvttps_epi32(x);
+	//The comparison mask is -1 where truncation rounded up.
+	return _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x)));
+}
+
+static float fade(float t)
+{
+	return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static __m128 fade(__m128 t)
+{
+	const __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6)), _mm_set1_ps(15))), _mm_set1_ps(10));
+	return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+static float lerp(float a, float b, float t)
+{
+	return a + t * (b - a);
+}
+
+static __m128 lerp(__m128 a, __m128 b, __m128 t)
+{
+	return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+static float gradient2D(int hash, float x, float y)
+{
+	const float* gradient = GRADIENTS_2D[hash & 7];
+	return gradient[0] * x + gradient[1] * y;
+}
+
+static float gradient3D(int hash, float x, float y, float z)
+{
+	const float* gradient = GRADIENTS_3D[hash % 12];
+	return gradient[0] * x + gradient[1] * y + gradient[2] * z;
+}
+
+static __m128 dot(const float* gradientX, const float* gradientY, __m128 x, __m128 y)
+{
+	return _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(gradientX), x), _mm_mul_ps(_mm_loadu_ps(gradientY), y));
+}
+
+static __m128 dot(const float* gradientX, const float* gradientY, const float* gradientZ, __m128 x, __m128 y, __m128 z)
+{
+	return _mm_add_ps(dot(gradientX, gradientY, x, y), _mm_mul_ps(_mm_loadu_ps(gradientZ), z));
+}
+
+static float simplexCorner(float t, float dot)
+{
+	if (t < 0)
+	{
+		return 0;
+	}
+	t *= t;
+	return t * t * dot;
+}
+
+static __m128 simplexCorner(__m128 t, __m128 dot)
+{
+	const __m128 t2 = _mm_mul_ps(t, t);
+	return _mm_andnot_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), _mm_mul_ps(_mm_mul_ps(t2, t2), dot));
+}
+
+static __m128i toInt(__m128 mask)
+{
+	return _mm_srli_epi32(_mm_castps_si128(mask), 31);
+}
+
+static __m128 toFloat(__m128 mask)
+{
+	return _mm_and_ps(mask, _mm_set1_ps(1));
+}
+
+bbe::GradientNoise::GradientNoise(uint64_t seed)
+{
+	setSeed(seed);
+}
+
+void bbe::GradientNoise::setSeed(uint64_t seed)
+{
+	for (int i = 0; i < 256; i++)
+	{
+		m_permutation[i] = i;
+	}
+	Random random(seed);
+	for (int i = 255; i > 0; i--)
+	{
+		const int k = random.randomInt(i + 1);
+		const int temp = m_permutation[i];
+		m_permutation[i] = m_permutation[k];
+		m_permutation[k] = temp;
+	}
+	for (int i = 0; i < 256; i++)
+	{
+		m_permutation[i + 256] = m_permutation[i];
+	}
+}
+
+bbe::PerlinNoise::PerlinNoise(uint64_t seed)
+	: GradientNoise(seed)
+{
+}
+
+float bbe::PerlinNoise::get(float x, float y) const
+{
+	const int cellX = floorToInt(x);
+	const int cellY = floorToInt(y);
+	const float fx = x - (float)cellX;
+	const float fy = y - (float)cellY;
+
+	const int a = m_permutation[cellX & 255] + (cellY & 255);
+	const int b = m_permutation[(cellX & 255) + 1] + (cellY & 255);
+
+	const float u = fade(fx);
+	const float v = fade(fy);
+	const float n00 = gradient2D(m_permutation[a], fx, fy);
+	const float n10 = gradient2D(m_permutation[b], fx - 1, fy);
+	const float n01 = gradient2D(m_permutation[a + 1], fx, fy - 1);
+	const float n11 = gradient2D(m_permutation[b + 1], fx - 1, fy - 1);
+	return lerp(lerp(n00, n10, u), lerp(n01, n11, u), v);
+}
+
+float bbe::PerlinNoise::get(float x, float y, float z) const
+{
+	const int cellX = floorToInt(x);
+	const int cellY = floorToInt(y);
+	const int cellZ = floorToInt(z);
+	const float fx = x - (float)cellX;
+	const float fy = y - (float)cellY;
+	const float fz = z - (float)cellZ;
+
+	const int a = m_permutation[cellX & 255] + (cellY & 255);
+	const int b = m_permutation[(cellX & 255) + 1] + (cellY & 255);
+	const int aa = m_permutation[a] + (cellZ & 255);
+	const int ab = m_permutation[a + 1] + (cellZ & 255);
+	const int ba = m_permutation[b] + (cellZ & 255);
+	const int bb = m_permutation[b + 1] + (cellZ & 255);
+
+	const float u = fade(fx);
+	const float v = fade(fy);
+	const float w = fade(fz);
+	const float n000 = gradient3D(m_permutation[aa], fx, fy, fz);
+	const float n100 = gradient3D(m_permutation[ba], fx - 1, fy, fz);
+	const float n010 = gradient3D(m_permutation[ab], fx, fy - 1, fz);
+	const float n110 = gradient3D(m_permutation[bb], fx - 1, fy - 1, fz);
+	const float n001 = gradient3D(m_permutation[aa + 1], fx, fy, fz - 1);
+	const float n101 = gradient3D(m_permutation[ba + 1], fx - 1, fy, fz - 1);
+	const float n011 = gradient3D(m_permutation[ab + 1], fx, fy - 1, fz - 1);
+	const float n111 = gradient3D(m_permutation[bb + 1], fx - 1, fy - 1, fz - 1);
+	return lerp(
+		lerp(lerp(n000, n100, u), lerp(n010, n110, u), v),
+		lerp(lerp(n001, n101, u), lerp(n011, n111, u), v),
+		w);
+}
+
+void bbe::PerlinNoise::get(const float* x, const float* y, float* out, size_t amount) const
+{
+	const __m128i cellMask = _mm_set1_epi32(255);
+	const __m128 one = _mm_set1_ps(1);
+	size_t i = 0;
+	for (; i + 4 <= amount; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128i cellX = floorToInt(px);
+		const __m128i cellY = floorToInt(py);
+		const __m128 fx = _mm_sub_ps(px, _mm_cvtepi32_ps(cellX));
+		const __m128 fy = _mm_sub_ps(py, _mm_cvtepi32_ps(cellY));
+
+		//SSE2 has no gather, so only the hashing is done per lane.
+		int cellsX[4];
+		int cellsY[4];
+		_mm_storeu_si128((__m128i*)cellsX, _mm_and_si128(cellX, cellMask));
+		_mm_storeu_si128((__m128i*)cellsY, _mm_and_si128(cellY, cellMask));
+		float gradientX[4][4];
+		float gradientY[4][4];
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const int a = m_permutation[cellsX[lane]] + cellsY[lane];
+			const int b = m_permutation[cellsX[lane] + 1] + cellsY[lane];
+			const int hashes[4] = { m_permutation[a], m_permutation[b], m_permutation[a + 1], m_permutation[b + 1] };
+			for (int corner = 0; corner < 4; corner++)
+			{
+				gradientX[corner][lane] = GRADIENTS_2D[hashes[corner] & 7][0];
+				gradientY[corner][lane] = GRADIENTS_2D[hashes[corner] & 7][1];
+			}
+		}
+
+		const __m128 fx1 = _mm_sub_ps(fx, one);
+		const __m128 fy1 = _mm_sub_ps(fy, one);
+		const __m128 u = fade(fx);
+		const __m128 v = fade(fy);
+		const __m128 n00 = dot(gradientX[0], gradientY[0], fx, fy);
+		const __m128 n10 = dot(gradientX[1], gradientY[1], fx1, fy);
+		const __m128 n01 = dot(gradientX[2], gradientY[2], fx, fy1);
+		const __m128 n11 = dot(gradientX[3], gradientY[3], fx1, fy1);
+		_mm_storeu_ps(out + i, lerp(lerp(n00, n10, u), lerp(n01, n11, u), v));
+	}
+	for (; i < amount; i++)
+	{
+		out[i] = get(x[i], y[i]);
+	}
+}
+
+void bbe::PerlinNoise::get(const float* x, const float* y, const float* z, float* out, size_t amount) const
+{
+	const __m128i cellMask = _mm_set1_epi32(255);
+	const __m128 one = _mm_set1_ps(1);
+	size_t i = 0;
+	for (; i + 4 <= amount; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+		const __m128i cellX = floorToInt(px);
+		const __m128i cellY = floorToInt(py);
+		const __m128i cellZ = floorToInt(pz);
+		const __m128 fx = _mm_sub_ps(px, _mm_cvtepi32_ps(cellX));
+		const __m128 fy = _mm_sub_ps(py, _mm_cvtepi32_ps(cellY));
+		const __m128 fz = _mm_sub_ps(pz, _mm_cvtepi32_ps(cellZ));
+
+		int cellsX[4];
+		int cellsY[4];
+		int cellsZ[4];
+		_mm_storeu_si128((__m128i*)cellsX, _mm_and_si128(cellX, cellMask));
+		_mm_storeu_si128((__m128i*)cellsY, _mm_and_si128(cellY, cellMask));
+		_mm_storeu_si128((__m128i*)cellsZ, _mm_and_si128(cellZ, cellMask));
+		//Corner c is offset by (c & 1, (c >> 1) & 1, c >> 2).
+		float gradientX[8][4];
+		float gradientY[8][4];
+		float gradientZ[8][4];
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const int a = m_permutation[cellsX[lane]] + cellsY[lane];
+			const int b = m_permutation[cellsX[lane] + 1] + cellsY[lane];
+			const int aa = m_permutation[a] + cellsZ[lane];
+			const int ab = m_permutation[a + 1] + cellsZ[lane];
+			const int ba = m_permutation[b] + cellsZ[lane];
+			const int bb = m_permutation[b + 1] + cellsZ[lane];
+			const int hashes[8] = {
+				m_permutation[aa],     m_permutation[ba],     m_permutation[ab],     m_permutation[bb],
+				m_permutation[aa + 1], m_permutation[ba + 1], m_permutation[ab + 1], m_permutation[bb + 1],
+			};
+			for (int corner = 0; corner < 8; corner++)
+			{
+				const float* gradient = GRADIENTS_3D[hashes[corner] % 12];
+				gradientX[corner][lane] = gradient[0];
+				gradientY[corner][lane] = gradient[1];
+				gradientZ[corner][lane] = gradient[2];
+			}
+		}
+
+		const __m128 fx1 = _mm_sub_ps(fx, one);
+		const __m128 fy1 = _mm_sub_ps(fy, one);
+		const __m128 fz1 = _mm_sub_ps(fz, one);
+		const __m128 u = fade(fx);
+		const __m128 v = fade(fy);
+		const __m128 w = fade(fz);
+		const __m128 n000 = dot(gradientX[0], gradientY[0], gradientZ[0], fx, fy, fz);
+		const __m128 n100 = dot(gradientX[1], gradientY[1], gradientZ[1], fx1, fy, fz);
+		const __m128 n010 = dot(gradientX[2], gradientY[2], gradientZ[2], fx, fy1, fz);
+		const __m128 n110 = dot(gradientX[3], gradientY[3], gradientZ[3], fx1, fy1, fz);
+		const __m128 n001 = dot(gradientX[4], gradientY[4], gradientZ[4], fx, fy, fz1);
+		const __m128 n101 = dot(gradientX[5], gradientY[5], gradientZ[5], fx1, fy, fz1);
+		const __m128 n011 = dot(gradientX[6], gradientY[6], gradientZ[6], fx, fy1, fz1);
+		const __m128 n111 = dot(gradientX[7], gradientY[7], gradientZ[7], fx1, fy1, fz1);
+		_mm_storeu_ps(out + i, lerp(
+			lerp(lerp(n000, n100, u), lerp(n010, n110, u), v),
+			lerp(lerp(n001, n101, u), lerp(n011, n111, u), v),
+			w));
+	}
+	for (; i < amount; i++)
+	{
+		out[i] = get(x[i], y[i], z[i]);
+	}
+}
+
+bbe::SimplexNoise::SimplexNoise(uint64_t seed)
+	: GradientNoise(seed)
+{
+}
+
+float bbe::SimplexNoise::get(float x, float y) const
+{
+	const float skew = (x + y) * SIMPLEX_SKEW_2D;
+	const int cellX = floorToInt(x + skew);
+	const int cellY = floorToInt(y + skew);
+	const float unskew = (float)(cellX + cellY) * SIMPLEX_UNSKEW_2D;
+	const float x0 = x - ((float)cellX - unskew);
+	const float y0 = y - ((float)cellY - unskew);
+
+	//Upper or lower triangle of the skewed cell.
+	const int offsetX = x0 > y0 ? 1 : 0;
+	const int offsetY = 1 - offsetX;
+
+	const float x1 = x0 - (float)offsetX + SIMPLEX_UNSKEW_2D;
+	const float y1 = y0 - (float)offsetY + SIMPLEX_UNSKEW_2D;
+	const float x2 = x0 - 1 + 2 * SIMPLEX_UNSKEW_2D;
+	const float y2 = y0 - 1 + 2 * SIMPLEX_UNSKEW_2D;
+
+	const int cx = cellX & 255;
+	const int cy = cellY & 255;
+	const int hash0 = m_permutation[cx + m_permutation[cy]];
+	const int hash1 = m_permutation[cx + offsetX + m_permutation[cy + offsetY]];
+	const int hash2 = m_permutation[cx + 1 + m_permutation[cy + 1]];
+
+	const float n0 = simplexCorner(0.5f - x0 * x0 - y0 * y0, gradient2D(hash0, x0, y0));
+	const float n1 = simplexCorner(0.5f - x1 * x1 - y1 * y1, gradient2D(hash1, x1, y1));
+	const float n2 = simplexCorner(0.5f - x2 * x2 - y2 * y2, gradient2D(hash2, x2, y2));
+	return 70 * (n0 + n1 + n2);
+}
+
+float bbe::SimplexNoise::get(float x, float y, float z) const
+{
+	const float skew = (x + y + z) * SIMPLEX_SKEW_3D;
+	const int cellX = floorToInt(x + skew);
+	const int cellY = floorToInt(y + skew);
+	const int cellZ = floorToInt(z + skew);
+	const float unskew = (float)(cellX + cellY + cellZ) * SIMPLEX_UNSKEW_3D;
+	const float x0 = x - ((float)cellX - unskew);
+	const float y0 = y - ((float)cellY - unskew);
+	const float z0 = z - ((float)cellZ - unskew);
+
+	//Which of the six tetrahedra of the cell the point is in, written without branches like the SIMD path.
+	const int offsetX1 = x0 >= y0 && x0 >= z0;
+	const int offsetY1 = y0 > x0 && y0 >= z0;
+	const int offsetZ1 = 1 - offsetX1 - offsetY1;
+	const int offsetX2 = x0 >= y0 || x0 >= z0;
+	const int offsetY2 = y0 > x0 || y0 >= z0;
+	const int offsetZ2 = 2 - offsetX2 - offsetY2;
+
+	const float x1 = x0 - (float)offsetX1 + SIMPLEX_UNSKEW_3D;
+	const float y1 = y0 - (float)offsetY1 + SIMPLEX_UNSKEW_3D;
+	const float z1 = z0 - (float)offsetZ1 + SIMPLEX_UNSKEW_3D;
+	const float x2 = x0 - (float)offsetX2 + 2 * SIMPLEX_UNSKEW_3D;
+	const float y2 = y0 - (float)offsetY2 + 2 * SIMPLEX_UNSKEW_3D;
+	const float z2 = z0 - (float)offsetZ2 + 2 * SIMPLEX_UNSKEW_3D;
+	const float x3 = x0 - 1 + 3 * SIMPLEX_UNSKEW_3D;
+	const float y3 = y0 - 1 + 3 * SIMPLEX_UNSKEW_3D;
+	const float z3 = z0 - 1 + 3 * SIMPLEX_UNSKEW_3D;
+
+	const int cx = cellX & 255;
+	const int cy = cellY & 255;
+	const int cz = cellZ & 255;
+	const int hash0 = m_permutation[cx + m_permutation[cy + m_permutation[cz]]];
+	const int hash1 = m_permutation[cx + offsetX1 + m_permutation[cy + offsetY1 + m_permutation[cz + offsetZ1]]];
+	const int hash2 = m_permutation[cx + offsetX2 + m_permutation[cy + offsetY2 + m_permutation[cz + offsetZ2]]];
+	const int hash3 = m_permutation[cx + 1 + m_permutation[cy + 1 + m_permutation[cz + 1]]];
+
+	//A falloff radius of 0.5 instead of the 0.6 in Gustavson's paper, which leaves small jumps at the borders
+	//of the tetrahedra. 76 scales the result back to about [-1, 1].
+	const float n0 = simplexCorner(0.5f - x0 * x0 - y0 * y0 - z0 * z0, gradient3D(hash0, x0, y0, z0));
+	const float n1 = simplexCorner(0.5f - x1 * x1 - y1 * y1 - z1 * z1, gradient3D(hash1, x1, y1, z1));
+	const float n2 = simplexCorner(0.5f - x2 * x2 - y2 * y2 - z2 * z2, gradient3D(hash2, x2, y2, z2));
+	const float n3 = simplexCorner(0.5f - x3 * x3 - y3 * y3 - z3 * z3, gradient3D(hash3, x3, y3, z3));
+	return 76 * (n0 + n1 + n2 + n3);
+}
+
+void bbe::SimplexNoise::get(const float* x, const float* y, float* out, size_t amount) const
+{
+	const __m128i cellMask = _mm_set1_epi32(255);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 falloff = _mm_set1_ps(0.5f);
+	const __m128 unskew1 = _mm_set1_ps(SIMPLEX_UNSKEW_2D);
+	const __m128 unskew2 = _mm_set1_ps(2 * SIMPLEX_UNSKEW_2D);
+	size_t i = 0;
+	for (; i + 4 <= amount; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 skew = _mm_mul_ps(_mm_add_ps(px, py), _mm_set1_ps(SIMPLEX_SKEW_2D));
+		const __m128i cellX = floorToInt(_mm_add_ps(px, skew));
+		const __m128i cellY = floorToInt(_mm_add_ps(py, skew));
+		const __m128 unskew = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(cellX, cellY)), unskew1);
+		const __m128 x0 = _mm_sub_ps(px, _mm_sub_ps(_mm_cvtepi32_ps(cellX), unskew));
+		const __m128 y0 = _mm_sub_ps(py, _mm_sub_ps(_mm_cvtepi32_ps(cellY), unskew));
+
+		const __m128 lowerTriangle = _mm_cmpgt_ps(x0, y0);
+		const __m128 offsetX = toFloat(lowerTriangle);
+		const __m128 offsetY = _mm_sub_ps(one, offsetX);
+
+		const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, offsetX), unskew1);
+		const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, offsetY), unskew1);
+		const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, one), unskew2);
+		const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, one), unskew2);
+
+		int cellsX[4];
+		int cellsY[4];
+		int offsetsX[4];
+		_mm_storeu_si128((__m128i*)cellsX, _mm_and_si128(cellX, cellMask));
+		_mm_storeu_si128((__m128i*)cellsY, _mm_and_si128(cellY, cellMask));
+		_mm_storeu_si128((__m128i*)offsetsX, toInt(lowerTriangle));
+		float gradientX[3][4];
+		float gradientY[3][4];
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const int cx = cellsX[lane];
+			const int cy = cellsY[lane];
+			const int hashes[3] = {
+				m_permutation[cx + m_permutation[cy]],
+				m_permutation[cx + offsetsX[lane] + m_permutation[cy + 1 - offsetsX[lane]]],
+				m_permutation[cx + 1 + m_permutation[cy + 1]],
+			};
+			for (int corner = 0; corner < 3; corner++)
+			{
+				gradientX[corner][lane] = GRADIENTS_2D[hashes[corner] & 7][0];
+				gradientY[corner][lane] = GRADIENTS_2D[hashes[corner] & 7][1];
+			}
+		}
+
+		const __m128 t0 = _mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+		const __m128 t1 = _mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+		const __m128 t2 = _mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2));
+		const __m128 n0 = simplexCorner(t0, dot(gradientX[0], gradientY[0], x0, y0));
+		const __m128 n1 = simplexCorner(t1, dot(gradientX[1], gradientY[1], x1, y1));
+		const __m128 n2 = simplexCorner(t2, dot(gradientX[2], gradientY[2], x2, y2));
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_set1_ps(70), _mm_add_ps(_mm_add_ps(n0, n1), n2)));
+	}
+	for (; i < amount; i++)
+	{
+		out[i] = get(x[i], y[i]);
+	}
+}
+
+void bbe::SimplexNoise::get(const float* x, const float* y, const float* z, float* out, size_t amount) const
+{
+	const __m128i cellMask = _mm_set1_epi32(255);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 falloff = _mm_set1_ps(0.5f);
+	const __m128 unskew1 = _mm_set1_ps(SIMPLEX_UNSKEW_3D);
+	const __m128 unskew2 = _mm_set1_ps(2 * SIMPLEX_UNSKEW_3D);
+	const __m128 unskew3 = _mm_set1_ps(3 * SIMPLEX_UNSKEW_3D);
+	size_t i = 0;
+	for (; i + 4 <= amount; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+		const __m128 skew = _mm_mul_ps(_mm_add_ps(_mm_add_ps(px, py), pz), _mm_set1_ps(SIMPLEX_SKEW_3D));
+		const __m128i cellX = floorToInt(_mm_add_ps(px, skew));
+		const __m128i cellY = floorToInt(_mm_add_ps(py, skew));
+		const __m128i cellZ = floorToInt(_mm_add_ps(pz, skew));
+		const __m128 unskew = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(cellX, cellY), cellZ)), unskew1);
+		const __m128 x0 = _mm_sub_ps(px, _mm_sub_ps(_mm_cvtepi32_ps(cellX), unskew));
+		const __m128 y0 = _mm_sub_ps(py, _mm_sub_ps(_mm_cvtepi32_ps(cellY), unskew));
+		const __m128 z0 = _mm_sub_ps(pz, _mm_sub_ps(_mm_cvtepi32_ps(cellZ), unskew));
+
+		const __m128 xGreaterEqualY = _mm_cmpge_ps(x0, y0);
+		const __m128 xGreaterEqualZ = _mm_cmpge_ps(x0, z0);
+		const __m128 yGreaterX = _mm_cmpgt_ps(y0, x0);
+		const __m128 yGreaterEqualZ = _mm_cmpge_ps(y0, z0);
+		const __m128 maskX1 = _mm_and_ps(xGreaterEqualY, xGreaterEqualZ);
+		const __m128 maskY1 = _mm_and_ps(yGreaterX, yGreaterEqualZ);
+		const __m128 maskX2 = _mm_or_ps(xGreaterEqualY, xGreaterEqualZ);
+		const __m128 maskY2 = _mm_or_ps(yGreaterX, yGreaterEqualZ);
+		const __m128 offsetX1 = toFloat(maskX1);
+		const __m128 offsetY1 = toFloat(maskY1);
+		const __m128 offsetZ1 = _mm_sub_ps(_mm_sub_ps(one, offsetX1), offsetY1);
+		const __m128 offsetX2 = toFloat(maskX2);
+		const __m128 offsetY2 = toFloat(maskY2);
+		const __m128 offsetZ2 = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(2), offsetX2), offsetY2);
+
+		const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, offsetX1), unskew1);
+		const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, offsetY1), unskew1);
+		const __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, offsetZ1), unskew1);
+		const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, offsetX2), unskew2);
+		const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, offsetY2), unskew2);
+		const __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, offsetZ2), unskew2);
+		const __m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), unskew3);
+		const __m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), unskew3);
+		const __m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), unskew3);
+
+		int cellsX[4];
+		int cellsY[4];
+		int cellsZ[4];
+		int offsetsX1[4];
+		int offsetsY1[4];
+		int offsetsX2[4];
+		int offsetsY2[4];
+		_mm_storeu_si128((__m128i*)cellsX, _mm_and_si128(cellX, cellMask));
+		_mm_storeu_si128((__m128i*)cellsY, _mm_and_si128(cellY, cellMask));
+		_mm_storeu_si128((__m128i*)cellsZ, _mm_and_si128(cellZ, cellMask));
+		_mm_storeu_si128((__m128i*)offsetsX1, toInt(maskX1));
+		_mm_storeu_si128((__m128i*)offsetsY1, toInt(maskY1));
+		_mm_storeu_si128((__m128i*)offsetsX2, toInt(maskX2));
+		_mm_storeu_si128((__m128i*)offsetsY2, toInt(maskY2));
+		float gradientX[4][4];
+		float gradientY[4][4];
+		float gradientZ[4][4];
+		for (int lane = 0; lane < 4; lane++)
+		{
+			const int cx = cellsX[lane];
+			const int cy = cellsY[lane];
+			const int cz = cellsZ[lane];
+			const int ox1 = offsetsX1[lane];
+			const int oy1 = offsetsY1[lane];
+			const int oz1 = 1 - ox1 - oy1;
+			const int ox2 = offsetsX2[lane];
+			const int oy2 = offsetsY2[lane];
+			const int oz2 = 2 - ox2 - oy2;
+			const int hashes[4] = {
+				m_permutation[cx + m_permutation[cy + m_permutation[cz]]],
+				m_permutation[cx + ox1 + m_permutation[cy + oy1 + m_permutation[cz + oz1]]],
+				m_permutation[cx + ox2 + m_permutation[cy + oy2 + m_permutation[cz + oz2]]],
+				m_permutation[cx + 1 + m_permutation[cy + 1 + m_permutation[cz + 1]]],
+			};
+			for (int corner = 0; corner < 4; corner++)
+			{
+				const float* gradient = GRADIENTS_3D[hashes[corner] % 12];
+				gradientX[corner][lane] = gradient[0];
+				gradientY[corner][lane] = gradient[1];
+				gradientZ[corner][lane] = gradient[2];
+			}
+		}
+
+		const __m128 t0 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0)), _mm_mul_ps(z0, z0));
+		const __m128 t1 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1)), _mm_mul_ps(z1, z1));
+		const __m128 t2 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2)), _mm_mul_ps(z2, z2));
+		const __m128 t3 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(falloff, _mm_mul_ps(x3, x3)), _mm_mul_ps(y3, y3)), _mm_mul_ps(z3, z3));
+		const __m128 n0 = simplexCorner(t0, dot(gradientX[0], gradientY[0], gradientZ[0], x0, y0, z0));
+		const __m128 n1 = simplexCorner(t1, dot(gradientX[1], gradientY[1], gradientZ[1], x1, y1, z1));
+		const __m128 n2 = simplexCorner(t2, dot(gradientX[2], gradientY[2], gradientZ[2], x2, y2, z2));
+		const __m128 n3 = simplexCorner(t3, dot(gradientX[3], gradientY[3], gradientZ[3], x3, y3, z3));
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_set1_ps(76), _mm_add_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), n3)));
+	}
+	for (; i < amount; i++)
+	{
+		out[i] = get(x[i], y[i], z[i]);
+	}
+}
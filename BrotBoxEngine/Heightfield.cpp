@@ -0,0 +1,406 @@
+#include "stdafx.h"
+#include "BBE/Heightfield.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/Vector3.h"
+#include "BBE/Math.h"
+#include "BBE/List.h"
+#include "BBE/Exceptions.h"
+
+const int bbe::Heightfield::HALO_SIZE = 8;
+
+static const int MAX_AMOUNT_OF_PLANES = 3;
+
+void bbe::Heightfield::runStencil(float ** planes, int amountOfPlanes, int width, int height, int iterations, ThreadPool * threadPool, const StencilStep & step) const
+{
+	if (iterations <= 0 || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	//The tiles read their halo from src while the inner cells of other tiles are written to dst.
+	const size_t planeSize = (size_t)width * (size_t)height;
+	List<float> buffer;
+	buffer.resizeCapacityAndLength(planeSize * amountOfPlanes);
+	float* src[MAX_AMOUNT_OF_PLANES];
+	float* dst[MAX_AMOUNT_OF_PLANES];
+	for (int p = 0; p < amountOfPlanes; p++)
+	{
+		src[p] = planes[p];
+		dst[p] = buffer.getRaw() + planeSize * p;
+	}
+
+	const int tilesX = (width + m_tileSize - 1) / m_tileSize;
+	const int tilesY = (height + m_tileSize - 1) / m_tileSize;
+	const int maxLocalSide = m_tileSize + 2 * HALO_SIZE;
+	const size_t maxLocalSize = (size_t)maxLocalSide * (size_t)maxLocalSide;
+
+	for (int done = 0; done < iterations;)
+	{
+		const int amount = iterations - done < HALO_SIZE ? iterations - done : HALO_SIZE;
+		ThreadPool::parallelFor(threadPool, 0, (size_t)(tilesX * tilesY), [&](size_t begin, size_t end)
+		{
+			List<float> local;
+			local.resizeCapacityAndLength(maxLocalSize * amountOfPlanes * 2);
+			for (size_t tile = begin; tile < end; tile++)
+			{
+				const int x0 = (int)(tile % tilesX) * m_tileSize;
+				const int y0 = (int)(tile / tilesX) * m_tileSize;
+				const int x1 = x0 + m_tileSize < width  ? x0 + m_tileSize : width;
+				const int y1 = y0 + m_tileSize < height ? y0 + m_tileSize : height;
+				const int haloX0 = x0 - HALO_SIZE > 0 ? x0 - HALO_SIZE : 0;
+				const int haloY0 = y0 - HALO_SIZE > 0 ? y0 - HALO_SIZE : 0;
+				const int haloX1 = x1 + HALO_SIZE < width  ? x1 + HALO_SIZE : width;
+				const int haloY1 = y1 + HALO_SIZE < height ? y1 + HALO_SIZE : height;
+				const int localWidth = haloX1 - haloX0;
+				const int localHeight = haloY1 - haloY0;
+
+				float* localSrc[MAX_AMOUNT_OF_PLANES];
+				float* localDst[MAX_AMOUNT_OF_PLANES];
+				for (int p = 0; p < amountOfPlanes; p++)
+				{
+					localSrc[p] = local.getRaw() + maxLocalSize * p;
+					localDst[p] = local.getRaw() + maxLocalSize * (amountOfPlanes + p);
+					for (int y = haloY0; y < haloY1; y++)
+					{
+						memcpy(localSrc[p] + (y - haloY0) * localWidth, src[p] + (size_t)y * width + haloX0, sizeof(float) * localWidth);
+					}
+				}
+
+				//Cells next to a halo border that is not the border of the heightfield miss neighbours and get
+				//wrong values, but the error only moves by one cell per iteration and never reaches the tile.
+				for (int i = 0; i < amount; i++)
+				{
+					step(localSrc, localDst, localWidth, localHeight);
+					for (int p = 0; p < amountOfPlanes; p++)
+					{
+						float* temp = localSrc[p];
+						localSrc[p] = localDst[p];
+						localDst[p] = temp;
+					}
+				}
+
+				for (int p = 0; p < amountOfPlanes; p++)
+				{
+					for (int y = y0; y < y1; y++)
+					{
+						memcpy(dst[p] + (size_t)y * width + x0, localSrc[p] + (y - haloY0) * localWidth + (x0 - haloX0), sizeof(float) * (x1 - x0));
+					}
+				}
+			}
+		});
+
+		for (int p = 0; p < amountOfPlanes; p++)
+		{
+			float* temp = src[p];
+			src[p] = dst[p];
+			dst[p] = temp;
+		}
+		done += amount;
+	}
+
+	for (int p = 0; p < amountOfPlanes; p++)
+	{
+		if (src[p] != planes[p])
+		{
+			memcpy(planes[p], src[p], sizeof(float) * planeSize);
+		}
+	}
+}
+
+bbe::Heightfield::Heightfield()
+{
+	//DO NOTHING
+}
+
+void bbe::Heightfield::computeNormals(const float * heights, int width, int height, float spacing, float heightScale, Vector3 * outNormals, ThreadPool * threadPool)
+{
+	if (width < 1 || height < 1 || spacing <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	ThreadPool::parallelFor(threadPool, 0, (size_t)height, [&](size_t begin, size_t end)
+	{
+		for (int y = (int)begin; y < (int)end; y++)
+		{
+			const int yBefore = y > 0 ? y - 1 : y;
+			const int yAfter = y < height - 1 ? y + 1 : y;
+			for (int x = 0; x < width; x++)
+			{
+				const int xBefore = x > 0 ? x - 1 : x;
+				const int xAfter = x < width - 1 ? x + 1 : x;
+				const float slopeX = xAfter == xBefore ? 0 : (heights[y * width + xAfter] - heights[y * width + xBefore]) * heightScale / ((xAfter - xBefore) * spacing);
+				const float slopeY = yAfter == yBefore ? 0 : (heights[yAfter * width + x] - heights[yBefore * width + x]) * heightScale / ((yAfter - yBefore) * spacing);
+				outNormals[y * width + x] = Vector3(-slopeX, -slopeY, 1).normalize();
+			}
+		}
+	}, 16);
+}
+
+void bbe::Heightfield::erode(float * heights, int width, int height, ThreadPool * threadPool) const
+{
+	erodeHydraulic(heights, width, height, m_hydraulicIterations, threadPool);
+	erodeThermal(heights, width, height, m_thermalIterations, threadPool);
+}
+
+void bbe::Heightfield::erodeThermal(float * heights, int width, int height, int iterations, ThreadPool * threadPool) const
+{
+	const float talus = m_talus;
+	const float strength = m_thermalStrength;
+	runStencil(&heights, 1, width, height, iterations, threadPool, [talus, strength](const float* const* src, float* const* dst, int width, int height)
+	{
+		const float* terrain = src[0];
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const int i = y * width + x;
+				const float center = terrain[i];
+				//Every pair of cells moves the same amount in opposite directions, so no material is lost.
+				float delta = 0;
+				auto exchange = [&](float neighbour)
+				{
+					const float diff = neighbour - center;
+					if (diff > talus)
+					{
+						delta += strength * (diff - talus);
+					}
+					else if (diff < -talus)
+					{
+						delta += strength * (diff + talus);
+					}
+				};
+				if (x > 0)          exchange(terrain[i - 1]);
+				if (x < width - 1)  exchange(terrain[i + 1]);
+				if (y > 0)          exchange(terrain[i - width]);
+				if (y < height - 1) exchange(terrain[i + width]);
+				dst[0][i] = center + delta;
+			}
+		}
+	});
+}
+
+void bbe::Heightfield::erodeHydraulic(float * heights, int width, int height, int iterations, ThreadPool * threadPool) const
+{
+	if (iterations <= 0 || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	const size_t size = (size_t)width * (size_t)height;
+	List<float> water;
+	List<float> sediment;
+	water.resizeCapacityAndLength(size);
+	sediment.resizeCapacityAndLength(size);
+	for (size_t i = 0; i < size; i++)
+	{
+		water[i] = 0;
+		sediment[i] = 0;
+	}
+
+	const float rain = m_rain;
+	const float solubility = m_solubility;
+	const float evaporation = m_evaporation;
+	const float sedimentCapacity = m_sedimentCapacity;
+	float* planes[] = { heights, water.getRaw(), sediment.getRaw() };
+	runStencil(planes, 3, width, height, iterations, threadPool, [=](const float* const* src, float* const* dst, int width, int height)
+	{
+		//Rain falls and dissolves material. Every cell does this for its neighbours as well, so the water
+		//only has to be exchanged once per iteration.
+		auto prepare = [&](int i, float &outTerrain, float &outWater, float &outSediment)
+		{
+			outWater = src[1][i] + rain;
+			const float dissolved = solubility * outWater;
+			outTerrain = src[0][i] - dissolved;
+			outSediment = src[2][i] + dissolved;
+		};
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const int i = y * width + x;
+				float terrain;
+				float waterAmount;
+				float sedimentAmount;
+				prepare(i, terrain, waterAmount, sedimentAmount);
+
+				//Both cells of a pair compute the same flow from the same values, so water and sediment are
+				//conserved. A quarter of the difference at most, so four neighbours never take more than there is.
+				float newWater = waterAmount;
+				float newSediment = sedimentAmount;
+				auto exchange = [&](int j)
+				{
+					float neighbourTerrain;
+					float neighbourWater;
+					float neighbourSediment;
+					prepare(j, neighbourTerrain, neighbourWater, neighbourSediment);
+					const float diff = (terrain + waterAmount) - (neighbourTerrain + neighbourWater);
+					if (diff > 0 && waterAmount > 0)
+					{
+						const float flow = Math::min(waterAmount, diff) * 0.25f;
+						newWater -= flow;
+						newSediment -= sedimentAmount * flow / waterAmount;
+					}
+					else if (diff < 0 && neighbourWater > 0)
+					{
+						const float flow = Math::min(neighbourWater, -diff) * 0.25f;
+						newWater += flow;
+						newSediment += neighbourSediment * flow / neighbourWater;
+					}
+				};
+				if (x > 0)          exchange(i - 1);
+				if (x < width - 1)  exchange(i + 1);
+				if (y > 0)          exchange(i - width);
+				if (y < height - 1) exchange(i + width);
+
+				newWater *= 1 - evaporation;
+				const float capacity = sedimentCapacity * newWater;
+				if (newSediment > capacity)
+				{
+					terrain += newSediment - capacity;
+					newSediment = capacity;
+				}
+
+				dst[0][i] = terrain;
+				dst[1][i] = newWater;
+				dst[2][i] = newSediment;
+			}
+		}
+	});
+
+	//Whatever is still carried is deposited where it is.
+	ThreadPool::parallelFor(threadPool, 0, size, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			heights[i] += sediment[i];
+		}
+	}, 1024 * 16);
+}
+
+void bbe::Heightfield::setTileSize(int tileSize)
+{
+	if (tileSize < 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_tileSize = tileSize;
+}
+
+void bbe::Heightfield::setThermalIterations(int iterations)
+{
+	if (iterations < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_thermalIterations = iterations;
+}
+
+void bbe::Heightfield::setHydraulicIterations(int iterations)
+{
+	if (iterations < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_hydraulicIterations = iterations;
+}
+
+void bbe::Heightfield::setTalus(float talus)
+{
+	if (talus < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_talus = talus;
+}
+
+void bbe::Heightfield::setThermalStrength(float strength)
+{
+	if (strength <= 0 || strength > 0.25f)
+	{
+		throw IllegalArgumentException();
+	}
+	m_thermalStrength = strength;
+}
+
+void bbe::Heightfield::setRain(float rain)
+{
+	if (rain < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_rain = rain;
+}
+
+void bbe::Heightfield::setSolubility(float solubility)
+{
+	if (solubility < 0 || solubility > 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_solubility = solubility;
+}
+
+void bbe::Heightfield::setEvaporation(float evaporation)
+{
+	if (evaporation < 0 || evaporation > 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_evaporation = evaporation;
+}
+
+void bbe::Heightfield::setSedimentCapacity(float capacity)
+{
+	if (capacity < 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_sedimentCapacity = capacity;
+}
+
+int bbe::Heightfield::getTileSize() const
+{
+	return m_tileSize;
+}
+
+int bbe::Heightfield::getThermalIterations() const
+{
+	return m_thermalIterations;
+}
+
+int bbe::Heightfield::getHydraulicIterations() const
+{
+	return m_hydraulicIterations;
+}
+
+float bbe::Heightfield::getTalus() const
+{
+	return m_talus;
+}
+
+float bbe::Heightfield::getThermalStrength() const
+{
+	return m_thermalStrength;
+}
+
+float bbe::Heightfield::getRain() const
+{
+	return m_rain;
+}
+
+float bbe::Heightfield::getSolubility() const
+{
+	return m_solubility;
+}
+
+float bbe::Heightfield::getEvaporation() const
+{
+	return m_evaporation;
+}
+
+float bbe::Heightfield::getSedimentCapacity() const
+{
+	return m_sedimentCapacity;
+}
@@ -214,3 +214,19 @@ bbe::Matrix4 bbe::IcoSphere::getTransform() const
 	return m_transform;
 }
 
+bbe::BoundingSphere bbe::IcoSphere::getBoundingSphere() const
+{
+	Vector3 scale = getScale();
+	return BoundingSphere(getPos(), Math::max(scale.x, scale.y, scale.z) * 0.5f);
+}
+
+bbe::BoundingBox bbe::IcoSphere::getBoundingBox() const
+{
+	return BoundingBox(Vector3(-0.5f), Vector3(0.5f)).transform(m_transform);
+}
+
+bool bbe::IcoSphere::intersects(const Ray & ray, float & outT, float maxT) const
+{
+	const Ray localRay = ray.transform(m_transform.inverse());
+	return localRay.intersects(BoundingSphere(Vector3(0, 0, 0), 0.5f), outT, maxT);
+}
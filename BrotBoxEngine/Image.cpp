@@ -2,15 +2,16 @@
 #include "BBE\Image.h"
 #include "BBE/Exceptions.h"
 #include "BBE/VulkanDevice.h"
-#include "BBE/VulkanCommandPool.h"
 #include "BBE/VulkanDescriptorPool.h"
 #include "BBE/VulkanDescriptorSetLayout.h"
-#include "BBE/VulkanBuffer.h"
+#include "BBE/VulkanUploadBatcher.h"
+#include "BBE/VulkanManager.h"
+#include "BBE/VulkanObjectCounter.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-void bbe::Image::createAndUpload(const INTERNAL::vulkan::VulkanDevice & device, const INTERNAL::vulkan::VulkanCommandPool & commandPool, const INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout &setLayout) const
+void bbe::Image::createAndUpload(INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher, const INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout &setLayout) const
 {
 	if (wasUploadedToVulkan)
 	{
@@ -22,25 +23,13 @@ void bbe::Image::createAndUpload(const INTERNAL::vulkan::VulkanDevice & device,
 		throw NotInitializedException();
 	}
 
+	const INTERNAL::vulkan::VulkanDevice &device = uploadBatcher.getDevice();
 	m_device = device.getDevice();
 
-
-	VkDeviceSize imageSize = getSizeInBytes();
-
-	INTERNAL::vulkan::VulkanBuffer stagingBuffer;
-	stagingBuffer.create(device, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-	
-	void *data = stagingBuffer.map();
-	memcpy(data, m_pdata, imageSize);
-	stagingBuffer.unmap();
-
 	INTERNAL::vulkan::createImage(m_device, device.getPhysicalDevice(), getWidth(), getHeight(), VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageMemory);
 
-	changeLayout(m_device, commandPool.getCommandPool(), device.getQueue(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	writeBufferToImage(m_device, commandPool.getCommandPool(), device.getQueue(), stagingBuffer.getBuffer());
-	changeLayout(m_device, commandPool.getCommandPool(), device.getQueue(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	stagingBuffer.destroy();
+	uploadBatcher.uploadImage(m_pdata, m_image, getWidth(), 0, getHeight(), m_imageLayout);
+	m_imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 	INTERNAL::vulkan::createImageView(m_device, m_image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, m_imageView);
 
@@ -66,6 +55,7 @@ void bbe::Image::createAndUpload(const INTERNAL::vulkan::VulkanDevice & device,
 
 	VkResult result = vkCreateSampler(m_device, &samplerCreateInfo, nullptr, &m_sampler);
 	ASSERT_VULKAN(result);
+	INTERNAL::vulkan::VulkanObjectCounter::count(INTERNAL::vulkan::VulkanObjectType::SAMPLER);
 
 	m_descriptorSet.addCombinedImageSampler(*this, 0);
 	m_descriptorSet.create(device, descriptorPool, setLayout);
@@ -73,34 +63,6 @@ void bbe::Image::createAndUpload(const INTERNAL::vulkan::VulkanDevice & device,
 	wasUploadedToVulkan = true;
 }
 
-void bbe::Image::changeLayout(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkImageLayout layout) const
-{
-	INTERNAL::vulkan::changeImageLayout(device, commandPool, queue, m_image, VK_FORMAT_R8G8B8A8_UNORM, this->m_imageLayout, layout);
-
-	this->m_imageLayout = layout;
-}
-
-void bbe::Image::writeBufferToImage(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkBuffer buffer) const
-{
-	VkCommandBuffer commandBuffer = INTERNAL::vulkan::startSingleTimeCommandBuffer(device, commandPool);
-
-
-	VkBufferImageCopy bufferImageCopy = {};
-	bufferImageCopy.bufferOffset = 0;
-	bufferImageCopy.bufferRowLength = 0;
-	bufferImageCopy.bufferImageHeight = 0;
-	bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	bufferImageCopy.imageSubresource.mipLevel = 0;
-	bufferImageCopy.imageSubresource.baseArrayLayer = 0;
-	bufferImageCopy.imageSubresource.layerCount = 1;
-	bufferImageCopy.imageOffset = { 0, 0, 0 };
-	bufferImageCopy.imageExtent = { (uint32_t)getWidth(), (uint32_t)getHeight(), 1 };
-
-	vkCmdCopyBufferToImage(commandBuffer, buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
-
-	INTERNAL::vulkan::endSingleTimeCommandBuffer(device, queue, commandPool, commandBuffer);
-}
-
 VkSampler bbe::Image::getSampler() const
 {
 	return m_sampler;
@@ -198,18 +160,27 @@ void bbe::Image::destroy()
 		m_width = 0;
 		m_height = 0;
 		wasUploadedToVulkan = false;
+		m_atlasId = 0;
 	}
 
 	if(m_sampler != VK_NULL_HANDLE)
 	{
-		vkDestroySampler(m_device, m_sampler, nullptr);
-		vkDestroyImageView(m_device, m_imageView, nullptr);
+		if (INTERNAL::vulkan::VulkanManager::s_pinstance != nullptr)
+		{
+			//A frame in flight may still sample the image.
+			INTERNAL::vulkan::VulkanManager::s_pinstance->addPendingDestructionImage(m_image, m_imageView, m_sampler, m_imageMemory);
+		}
+		else
+		{
+			vkDestroySampler(m_device, m_sampler, nullptr);
+			vkDestroyImageView(m_device, m_imageView, nullptr);
 
-		vkDestroyImage(m_device, m_image, nullptr);
-		vkFreeMemory(m_device, m_imageMemory, nullptr);
+			vkDestroyImage(m_device, m_image, nullptr);
+			INTERNAL::vulkan::freeMemory(m_device, m_imageMemory);
+		}
 
 		m_image       = VK_NULL_HANDLE;
-		m_imageMemory = VK_NULL_HANDLE;
+		m_imageMemory = INTERNAL::vulkan::VulkanMemoryAllocation();
 		m_imageView   = VK_NULL_HANDLE;
 		m_imageLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
 		m_device      = VK_NULL_HANDLE;
@@ -3,19 +3,9 @@
 #include "BBE/Vector2.h"
 #include "BBE/Vector3.h"
 #include "BBE/Vector4.h"
-#include <limits>
 #include <cmath>
 
 
-const float bbe::Math::PI = 3.14159265359f;
-const float bbe::Math::TAU = 6.28318530718f;
-const float bbe::Math::E = 2.71828182845f;
-const float bbe::Math::SQRT2 = 1.41421356237f;
-const float bbe::Math::SQRT2INV = 0.70710678118f;
-const float bbe::Math::INFINITY_POSITIVE = std::numeric_limits<float>::infinity();
-const float bbe::Math::INFINITY_NEGATIVE = -std::numeric_limits<float>::infinity();
-const float bbe::Math::NaN = std::numeric_limits<float>::quiet_NaN();;
-
 float bbe::Math::cos(float val)
 {
 	return ::cos(val);
@@ -51,122 +41,72 @@ float bbe::Math::sqrt(float val)
 	return ::sqrt(val);
 }
 
-float bbe::Math::floor(float val)
+uint16_t bbe::Math::floatToHalf(float val)
 {
-	int iVal = (int)val;
-	if (val >= 0)
+	uint32_t bits;
+	memcpy(&bits, &val, sizeof(bits));
+	const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+	const uint32_t absBits = bits & 0x7FFFFFFF;
+
+	if (absBits >= 0x7F800000)
 	{
-		return (float)iVal;
+		//Infinity stays infinity, NaN stays NaN.
+		return sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0);
 	}
-	else
+	if (absBits >= 0x477FF000)
 	{
-		if (iVal == val)
-		{
-			return (float)iVal;
-		}
-		else
-		{
-			return (float)(iVal - 1);
-		}
+		//65520 and above round to infinity.
+		return sign | 0x7C00;
 	}
-}
-
-float bbe::Math::ceil(float val)
-{
-	return -floor(-val);
-}
-
-float bbe::Math::round(float val)
-{
-	return val < 0 ? (float)(int)(val - 0.5) : (float)(int)(val + 0.5);
-}
-
-float bbe::Math::square(float val)
-{
-	return val * val;
-}
-
-float bbe::Math::clamp(float val, float min, float max)
-{
-	return val < min ? min : (val > max ? max : val);
-}
-
-float bbe::Math::minAbs(float val1, float val2)
-{
-	return min(abs(val1), abs(val2));
-}
-
-float bbe::Math::minAbs(float val1, float val2, float val3)
-{
-	//UNTESTED
-	val1 = abs(val1);
-	val2 = abs(val2);
-	val3 = abs(val3);
-
-	if (val2 < val1) val1 = val2;
-	if (val3 < val1) val1 = val3;
-
-	return val1;
-}
-
-float bbe::Math::maxAbsKeepSign(float val1, float val2)
-{
-	if (abs(val1) > abs(val2))
+	if (absBits >= 0x38800000)
 	{
-		return val1;
+		//Normal halves. The carry of the rounding may move into the exponent, which is still correct.
+		const uint32_t rounded = absBits + 0xFFF + ((absBits >> 13) & 1);
+		return sign | (uint16_t)((rounded - (112 << 23)) >> 13);
 	}
-	else
+	if (absBits < 0x33000000)
 	{
-		return val2;
+		return sign;
 	}
-}
 
-float bbe::Math::maxAbsKeepSign(float val1, float val2, float val3)
-{
-	//UNTESTED
-	float aVal1 = abs(val1);
-	float aVal2 = abs(val2);
-	float aVal3 = abs(val3);
-
-	if (aVal2 > aVal1) val1 = val2;
-	if (aVal3 > aVal1) val1 = val3;
-
-	return val1;
+	//Subnormal halves.
+	const uint32_t exponent = absBits >> 23;
+	const uint32_t mantissa = (absBits & 0x7FFFFF) | 0x800000;
+	const uint32_t shift = 126 - exponent;
+	const uint32_t halfway = 1u << (shift - 1);
+	const uint32_t remainder = mantissa & ((1u << shift) - 1);
+	uint32_t result = mantissa >> shift;
+	if (remainder > halfway || (remainder == halfway && (result & 1)))
+	{
+		result++;
+	}
+	return sign | (uint16_t)result;
 }
 
-float bbe::Math::minAbsKeepSign(float val1, float val2)
+float bbe::Math::halfToFloat(uint16_t val)
 {
-	if (abs(val1) < abs(val2))
+	const uint32_t sign = (uint32_t)(val & 0x8000) << 16;
+	const uint32_t exponent = (val >> 10) & 0x1F;
+	const uint32_t mantissa = val & 0x3FF;
+
+	uint32_t bits;
+	if (exponent == 0x1F)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else if (exponent != 0)
 	{
-		return val1;
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
 	}
 	else
 	{
-		return val2;
+		const float subnormal = mantissa * 5.9604644775390625e-8f;
+		return sign ? -subnormal : subnormal;
 	}
-}
-
-float bbe::Math::minAbsKeepSign(float val1, float val2, float val3)
-{
-	//UNTESTED
-	float aVal1 = abs(val1);
-	float aVal2 = abs(val2);
-	float aVal3 = abs(val3);
-
-	if (aVal2 < aVal1) val1 = val2;
-	if (aVal3 < aVal1) val1 = val3;
-
-	return val1;
-}
-
-bool bbe::Math::floatEquals(float val1, float val2, float epsilon)
-{
-	return (val1 - val2) > epsilon ? false : ((val1 - val2) < -epsilon ? false : true);
-}
 
-float bbe::Math::isNaN(float val)
-{
-	return val != val;
+	float retVal;
+	memcpy(&retVal, &bits, sizeof(retVal));
+	return retVal;
 }
 
 float bbe::Math::isInfinity(float val)
@@ -184,21 +124,6 @@ float bbe::Math::isNegativeInfinity(float val)
 	return ::isinf(val) && val < 0;
 }
 
-bool bbe::Math::isOdd(int val)
-{
-	return (val & 1) == 1;
-}
-
-bool bbe::Math::isEven(int val)
-{
-	return (val & 1) == 0;
-}
-
-float bbe::Math::clamp01(float val)
-{
-	return (val < 0) ? 0 : (val > 1 ? 1 : val);
-}
-
 float bbe::Math::mod(float val, float mod)
 {
 	return ::fmod(val, mod);
@@ -217,108 +142,6 @@ float bbe::Math::pingpong(float val, float border)
 	}
 }
 
-bool bbe::Math::isInRange(float val, float min, float max)
-{
-	return val >= min && val <= max;
-}
-
-bool bbe::Math::isInRangeStrict(float val, float min, float max)
-{
-	return val > min && val < max;
-}
-
-bool bbe::Math::isInRange01(float val)
-{
-	return val >= 0 && val <= 1;
-}
-
-bool bbe::Math::isInRange01Strict(float val)
-{
-	return val > 0 && val < 1;
-}
-
-float bbe::Math::abs(const float val)
-{
-	return val < 0 ? -val : val;
-}
-
-float bbe::Math::max(float val1, float val2)
-{
-	return val1 > val2 ? val1 : val2;
-}
-
-float bbe::Math::max(float val1, float val2, float val3)
-{
-	//UNTESTED
-	if (val2 > val1) val1 = val2;
-	if (val3 > val1) val1 = val3;
-	return val3;
-}
-
-float bbe::Math::max(float val1, float val2, float val3, float val4)
-{
-	//UNTESTED
-	if (val2 > val1) val1 = val2;
-	if (val3 > val1) val1 = val3;
-	if (val4 > val1) val1 = val4;
-	return val1;
-}
-
-float bbe::Math::min(float val1, float val2)
-{
-	return val1 < val2 ? val1 : val2;
-}
-
-float bbe::Math::min(float val1, float val2, float val3)
-{
-	//UNTESTED
-	if (val2 < val1) val1 = val2;
-	if (val3 < val1) val1 = val3;
-	return val1;
-}
-
-float bbe::Math::min(float val1, float val2, float val3, float val4)
-{
-	//UNTESTED
-	if (val2 < val1) val1 = val2;
-	if (val3 < val1) val1 = val3;
-	if (val4 < val1) val1 = val4;
-	return val1;
-}
-
-float bbe::Math::maxAbs(float val1, float val2)
-{
-	return max(abs(val1), abs(val2));
-}
-
-float bbe::Math::maxAbs(float val1, float val2, float val3)
-{
-	//UNTESTED
-	val1 = abs(val1);
-	val2 = abs(val2);
-	val3 = abs(val3);
-
-	if (val2 > val1) val1 = val2;
-	if (val3 > val1) val1 = val3;
-	return val1;
-}
-
-
-
-float bbe::Math::interpolateLinear(float a, float b, float t)
-{
-	//UNTESTED
-	if (a == b) return a;
-	return a * (1 - t) + b * t;
-}
-
-float bbe::Math::interpolateBool(float a, float b, float t)
-{
-	//UNTESTED
-	if (t >= 0.5) return b;
-	else return a;
-}
-
 float bbe::Math::interpolateCosine(float a, float b, float t)
 {
 	//UNTESTED
@@ -326,27 +149,6 @@ float bbe::Math::interpolateCosine(float a, float b, float t)
 	return interpolateLinear(a, b, (1 - cos(t * PI)) / 2);
 }
 
-float bbe::Math::interpolateCubic(float preA, float a, float b, float postB, float t)
-{
-	//UNTESTED
-	if (a == preA && a == b && a == postB) return a;
-	float t2 = t * t;
-	float w0 = postB - b - preA + a;
-	float w1 = preA - a - w0;
-	float w2 = b - preA;
-	float w3 = a;
-
-	return (w0*t*t2 + w1*t2 + w2*t + w3);
-}
-
-float bbe::Math::interpolateBezier(float a, float b, float t, float control)
-{
-	//UNTESTED
-	if (a == b && a == control) return a;
-	float t2 = t * t;
-	return b*t2 + 2 * control * t - 2 * control*t2 + a - 2 * a*t + a*t2;
-}
-
 bbe::Vector2 bbe::Math::interpolateLinear(Vector2 a, Vector2 b, float t)
 {
 	return Vector2(
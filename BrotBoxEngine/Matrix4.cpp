@@ -3,44 +3,6 @@
 #include "BBE/Math.h"
 #include "BBE/Exceptions.h"
 
-bbe::Matrix4::Matrix4()
-{
-	static_assert(sizeof(Matrix4) == sizeof(float) * 16, "The size of a Matrix4 must be sizeof(float) * 16!");
-
-
-	for (int i = 0; i < 4; i++)
-	{
-		for (int k = 0; k < 4; k++)
-		{
-			if (i == k)
-			{
-				m_cols[i][k] = 1;
-			}
-			else
-			{
-				m_cols[i][k] = 0;
-			}
-		}
-	}
-}
-
-bbe::Matrix4::Matrix4(const Vector4 & col0, const Vector4 & col1, const Vector4 & col2, const Vector4 & col3)
-{
-	m_cols[0] = col0;
-	m_cols[1] = col1;
-	m_cols[2] = col2;
-	m_cols[3] = col3;
-}
-
-bbe::Matrix4 bbe::Matrix4::createTranslationMatrix(const Vector3 & translation)
-{
-	Matrix4 retVal;
-	retVal.set(0, 3, translation.x);
-	retVal.set(1, 3, translation.y);
-	retVal.set(2, 3, translation.z);
-	return retVal;
-}
-
 bbe::Matrix4 bbe::Matrix4::createRotationMatrix(float radians, const Vector3 & rotationAxis)
 {
 	if (radians == 0)
@@ -62,15 +24,6 @@ bbe::Matrix4 bbe::Matrix4::createRotationMatrix(float radians, const Vector3 & r
 	return retVal;
 }
 
-bbe::Matrix4 bbe::Matrix4::createScaleMatrix(const Vector3 & scale)
-{
-	Matrix4 retVal;
-	retVal.set(0, 0, scale.x);
-	retVal.set(1, 1, scale.y);
-	retVal.set(2, 2, scale.z);
-	return retVal;
-}
-
 bbe::Matrix4 bbe::Matrix4::createPerspectiveMatrix(float fieldOfView, float aspectRatio, float nearClipPlane, float farClipPlane)
 {
 	float tanFoV = Math::tan(fieldOfView / 2.0f);
@@ -120,76 +73,6 @@ bbe::Matrix4 bbe::Matrix4::createTransform(const Vector3 & pos, const Vector3 &
 	return matTranslation * matRotation * matScale;
 }
 
-float bbe::Matrix4::get(int row, int col) const
-{
-	if (row < 0 || row > 3 || col < 0 || col > 3)
-	{
-		throw IllegalIndexException();
-	}
-
-	return operator[](row + col * 4);
-}
-
-void bbe::Matrix4::set(int row, int col, float val)
-{
-	if (row < 0 || row > 3 || col < 0 || col > 3)
-	{
-		throw IllegalIndexException();
-	}
-
-	operator[](row + col * 4) = val;
-}
-
-float & bbe::Matrix4::operator[](int index)
-{
-	if (index < 0 || index > 15)
-	{
-		throw IllegalIndexException();
-	}
-	float* data = reinterpret_cast<float*>(this);
-
-	return data[index];
-}
-
-const float & bbe::Matrix4::operator[](int index) const
-{
-	if (index < 0 || index > 15)
-	{
-		throw IllegalIndexException();
-	}
-	const float* data = reinterpret_cast<const float*>(this);
-
-	return data[index];
-}
-
-bbe::Vector4 bbe::Matrix4::operator*(const Vector4 & other) const
-{
-	return Vector4(
-		get(0, 0) * other.x + get(0, 1) * other.y + get(0, 2) * other.z + get(0, 3) * other.w,
-		get(1, 0) * other.x + get(1, 1) * other.y + get(1, 2) * other.z + get(1, 3) * other.w,
-		get(2, 0) * other.x + get(2, 1) * other.y + get(2, 2) * other.z + get(2, 3) * other.w,
-		get(3, 0) * other.x + get(3, 1) * other.y + get(3, 2) * other.z + get(3, 3) * other.w
-	);
-}
-
-bbe::Vector4 bbe::Matrix4::getColumn(int colIndex) const
-{
-	if (colIndex < 0 || colIndex > 3)
-	{
-		throw IllegalIndexException();
-	}
-	return Vector4(m_cols[colIndex]);
-}
-
-bbe::Vector4 bbe::Matrix4::getRow(int rowIndex) const
-{
-	if (rowIndex < 0 || rowIndex > 3)
-	{
-		throw IllegalIndexException();
-	}
-	return Vector4(m_cols[0][rowIndex], m_cols[1][rowIndex], m_cols[2][rowIndex], m_cols[3][rowIndex]);
-}
-
 bbe::Vector3 bbe::Matrix4::extractTranslation() const
 {
 	return getColumn(3).xyz();
@@ -215,34 +98,39 @@ bbe::Matrix4 bbe::Matrix4::extractRotation() const
 	);
 }
 
-bbe::Matrix4 bbe::Matrix4::operator*(const Matrix4 &other) const
-{
+bbe::Matrix4 bbe::Matrix4::inverse() const
+{
+	const float* m = &m_cols[0][0];
+	float inv[16];
+
+	inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+	inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+	inv[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+	inv[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+	inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+	inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+	inv[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+	inv[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+	inv[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+	inv[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+	inv[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+	inv[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+	inv[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+	inv[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+	inv[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+	inv[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+	const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	if (det == 0)
+	{
+		throw IllegalStateException();
+	}
+
+	const float detInv = 1.0f / det;
 	Matrix4 retVal;
-	retVal.set(0, 0, get(0, 0) * other.get(0, 0) + get(0, 1) * other.get(1, 0) + get(0, 2) * other.get(2, 0) + get(0, 3) * other.get(3, 0));
-	retVal.set(0, 1, get(0, 0) * other.get(0, 1) + get(0, 1) * other.get(1, 1) + get(0, 2) * other.get(2, 1) + get(0, 3) * other.get(3, 1));
-	retVal.set(0, 2, get(0, 0) * other.get(0, 2) + get(0, 1) * other.get(1, 2) + get(0, 2) * other.get(2, 2) + get(0, 3) * other.get(3, 2));
-	retVal.set(0, 3, get(0, 0) * other.get(0, 3) + get(0, 1) * other.get(1, 3) + get(0, 2) * other.get(2, 3) + get(0, 3) * other.get(3, 3));
-
-	retVal.set(1, 0, get(1, 0) * other.get(0, 0) + get(1, 1) * other.get(1, 0) + get(1, 2) * other.get(2, 0) + get(1, 3) * other.get(3, 0));
-	retVal.set(1, 1, get(1, 0) * other.get(0, 1) + get(1, 1) * other.get(1, 1) + get(1, 2) * other.get(2, 1) + get(1, 3) * other.get(3, 1));
-	retVal.set(1, 2, get(1, 0) * other.get(0, 2) + get(1, 1) * other.get(1, 2) + get(1, 2) * other.get(2, 2) + get(1, 3) * other.get(3, 2));
-	retVal.set(1, 3, get(1, 0) * other.get(0, 3) + get(1, 1) * other.get(1, 3) + get(1, 2) * other.get(2, 3) + get(1, 3) * other.get(3, 3));
-
-	retVal.set(2, 0, get(2, 0) * other.get(0, 0) + get(2, 1) * other.get(1, 0) + get(2, 2) * other.get(2, 0) + get(2, 3) * other.get(3, 0));
-	retVal.set(2, 1, get(2, 0) * other.get(0, 1) + get(2, 1) * other.get(1, 1) + get(2, 2) * other.get(2, 1) + get(2, 3) * other.get(3, 1));
-	retVal.set(2, 2, get(2, 0) * other.get(0, 2) + get(2, 1) * other.get(1, 2) + get(2, 2) * other.get(2, 2) + get(2, 3) * other.get(3, 2));
-	retVal.set(2, 3, get(2, 0) * other.get(0, 3) + get(2, 1) * other.get(1, 3) + get(2, 2) * other.get(2, 3) + get(2, 3) * other.get(3, 3));
-
-	retVal.set(3, 0, get(3, 0) * other.get(0, 0) + get(3, 1) * other.get(1, 0) + get(3, 2) * other.get(2, 0) + get(3, 3) * other.get(3, 0));
-	retVal.set(3, 1, get(3, 0) * other.get(0, 1) + get(3, 1) * other.get(1, 1) + get(3, 2) * other.get(2, 1) + get(3, 3) * other.get(3, 1));
-	retVal.set(3, 2, get(3, 0) * other.get(0, 2) + get(3, 1) * other.get(1, 2) + get(3, 2) * other.get(2, 2) + get(3, 3) * other.get(3, 2));
-	retVal.set(3, 3, get(3, 0) * other.get(0, 3) + get(3, 1) * other.get(1, 3) + get(3, 2) * other.get(2, 3) + get(3, 3) * other.get(3, 3));
+	for (int i = 0; i < 16; i++)
+	{
+		retVal[i] = inv[i] * detInv;
+	}
 	return retVal;
 }
-
-bbe::Vector3 bbe::Matrix4::operator*(const Vector3 & other) const
-{
-	Vector4 retVal(other, 1);
-	retVal = operator*(retVal);
-	return Vector3(retVal.x / retVal.w, retVal.y / retVal.w, retVal.z / retVal.w);
-}
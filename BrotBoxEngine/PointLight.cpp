@@ -3,10 +3,8 @@
 #include "BBE/Exceptions.h"
 #include "BBE/EngineSettings.h"
 
-bbe::INTERNAL::vulkan::VulkanBuffer bbe::PointLight::s_bufferVertexData;
-bbe::INTERNAL::PointLightVertexData *bbe::PointLight::s_dataVertex;
-bbe::INTERNAL::vulkan::VulkanBuffer bbe::PointLight::s_bufferFragmentData;
-bbe::INTERNAL::PointLightFragmentData *bbe::PointLight::s_dataFragment;
+bbe::INTERNAL::PointLightVertexData *bbe::PointLight::s_dataVertex = nullptr;
+bbe::INTERNAL::PointLightFragmentData *bbe::PointLight::s_dataFragment = nullptr;
 bbe::Stack<int> bbe::PointLight::s_indexStack;
 bool bbe::PointLight::s_staticIniCalled = false;
 bbe::List<bbe::INTERNAL::PointLightWithPos> bbe::PointLight::s_earlyPointLights;
@@ -31,6 +29,10 @@ void bbe::PointLight::setPosition(Vector3 pos)
 
 void bbe::PointLight::destroy()
 {
+	if (!s_staticIniCalled)
+	{
+		return;
+	}
 	if (s_dataVertex[m_index].m_used == VK_TRUE)
 	{
 		s_dataVertex[m_index].m_used = VK_FALSE;
@@ -58,13 +60,10 @@ bool bbe::PointLight::isOn()
 	return s_dataVertex[m_index].m_used > 0.0f;
 }
 
-void bbe::PointLight::s_init(VkDevice device, VkPhysicalDevice physicalDevice)
+void bbe::PointLight::s_init()
 {
-	s_bufferVertexData.create(device, physicalDevice, sizeof(INTERNAL::PointLightVertexData) * Settings::getAmountOfLightSources(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
-	s_dataVertex = (INTERNAL::PointLightVertexData*)s_bufferVertexData.map();
-
-	s_bufferFragmentData.create(device, physicalDevice, sizeof(INTERNAL::PointLightFragmentData) * Settings::getAmountOfLightSources(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
-	s_dataFragment = (INTERNAL::PointLightFragmentData*)s_bufferFragmentData.map();
+	s_dataVertex = new INTERNAL::PointLightVertexData[Settings::getAmountOfLightSources()];
+	s_dataFragment = new INTERNAL::PointLightFragmentData[Settings::getAmountOfLightSources()];
 
 	memset(s_dataVertex, 0, sizeof(INTERNAL::PointLightVertexData) * Settings::getAmountOfLightSources());
 
@@ -94,11 +93,28 @@ void bbe::PointLight::s_init(VkDevice device, VkPhysicalDevice physicalDevice)
 
 void bbe::PointLight::s_destroy()
 {
-	s_bufferVertexData.unmap();
-	s_bufferFragmentData.unmap();
+	s_staticIniCalled = false;
+
+	delete[] s_dataVertex;
+	delete[] s_dataFragment;
+	s_dataVertex = nullptr;
+	s_dataFragment = nullptr;
+}
+
+void bbe::PointLight::s_writeBuffers(void* vertexData, void* fragmentData)
+{
+	memcpy(vertexData, s_dataVertex, s_getVertexDataSize());
+	memcpy(fragmentData, s_dataFragment, s_getFragmentDataSize());
+}
 
-	s_bufferVertexData.destroy();
-	s_bufferFragmentData.destroy();
+size_t bbe::PointLight::s_getVertexDataSize()
+{
+	return sizeof(INTERNAL::PointLightVertexData) * Settings::getAmountOfLightSources();
+}
+
+size_t bbe::PointLight::s_getFragmentDataSize()
+{
+	return sizeof(INTERNAL::PointLightFragmentData) * Settings::getAmountOfLightSources();
 }
 
 void bbe::PointLight::init(const Vector3 &pos)
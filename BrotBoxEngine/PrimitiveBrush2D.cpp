@@ -5,36 +5,125 @@
 #include "BBE/VulkanManager.h"
 #include "BBE/VulkanPipeline.h"
 #include "BBE/Image.h"
+#include "BBE/TextureAtlas.h"
+
+static void ensureBufferSize(bbe::INTERNAL::vulkan::VulkanBuffer &buffer, const bbe::INTERNAL::vulkan::VulkanDevice &device, VkDeviceSize size, VkBufferUsageFlags usage)
+{
+	if (buffer.getSize() >= size)
+	{
+		return;
+	}
+
+	//Frames in flight may still read the old buffer.
+	VkDeviceSize newSize = buffer.getSize() * 2;
+	if (newSize < size)
+	{
+		newSize = size;
+	}
+	buffer.destroyAtEndOfFrame();
+	buffer.create(device, (size_t)newSize, usage);
+}
 
 void bbe::PrimitiveBrush2D::INTERNAL_beginDraw(
 	INTERNAL::vulkan::VulkanDevice &device,
-	INTERNAL::vulkan::VulkanCommandPool &commandPool,
+	INTERNAL::vulkan::VulkanUploadBatcher &uploadBatcher,
 	INTERNAL::vulkan::VulkanDescriptorPool &descriptorPool,
 	INTERNAL::vulkan::VulkanDescriptorSetLayout &descriptorSetLayout, 
 	VkCommandBuffer commandBuffer,
 	INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive,
 	INTERNAL::vulkan::VulkanPipeline &pipelineImage,
+	INTERNAL::vulkan::VulkanPipeline *pipelineBatched,
+	TextureAtlas &atlas,
+	INTERNAL::vulkan::VulkanBuffer &vertexBuffer,
+	INTERNAL::vulkan::VulkanBuffer &indexBuffer,
 	int width, int height)
 {
 	m_layoutPrimitive = pipelinePrimitive.getLayout();
 	m_pipelinePrimitive = pipelinePrimitive.getPipeline();
 	m_layoutImage = pipelineImage.getLayout();
 	m_pipelineImage = pipelineImage.getPipeline();
+	m_layoutBatched = pipelineBatched != nullptr ? pipelineBatched->getLayout() : VK_NULL_HANDLE;
+	m_pipelineBatched = pipelineBatched != nullptr ? pipelineBatched->getPipeline() : VK_NULL_HANDLE;
 	m_currentCommandBuffer = commandBuffer;
 	m_pdevice = &device;
-	m_pcommandPool = &commandPool;
+	m_puploadBatcher = &uploadBatcher;
 	m_pdescriptorPool = &descriptorPool;
 	m_pdescriptorSetLayout = &descriptorSetLayout;
+	m_patlas = &atlas;
+	m_pvertexBuffer = &vertexBuffer;
+	m_pindexBuffer = &indexBuffer;
 	m_screenWidth = width;
 	m_screenHeight = height;
 
 	m_pipelineRecord = PipelineRecord2D::NONE;
+	m_batch.begin(width, height);
 
 	setColor(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
+VkDescriptorSet bbe::PrimitiveBrush2D::INTERNAL_getTexture(const Image & image)
+{
+	image.createAndUpload(*m_puploadBatcher, *m_pdescriptorPool, *m_pdescriptorSetLayout);
+	return *image.m_descriptorSet.getPDescriptorSet();
+}
+
+VkDescriptorSet bbe::PrimitiveBrush2D::INTERNAL_getAtlasTexture()
+{
+	//The descriptor set stays the same when the atlas grows, pixels added later are uploaded by INTERNAL_flush.
+	if (!m_patlas->isUploaded())
+	{
+		m_patlas->upload(*m_puploadBatcher, *m_pdescriptorPool, *m_pdescriptorSetLayout);
+	}
+	return m_patlas->getDescriptorSet();
+}
+
+void bbe::PrimitiveBrush2D::INTERNAL_flush()
+{
+	if (m_batch.isEmpty())
+	{
+		return;
+	}
+
+	m_patlas->upload(*m_puploadBatcher, *m_pdescriptorPool, *m_pdescriptorSetLayout);
+
+	const List<Vertex2D> &vertices = m_batch.getVertices();
+	const List<uint32_t> &indices = m_batch.getIndices();
+	const List<Batch2D::Draw> &draws = m_batch.getDraws();
+	ensureBufferSize(*m_pvertexBuffer, *m_pdevice, sizeof(Vertex2D) * vertices.getLength(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	ensureBufferSize(*m_pindexBuffer, *m_pdevice, sizeof(uint32_t) * indices.getLength(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+	void* data = m_pvertexBuffer->map();
+	memcpy(data, vertices.getRaw(), sizeof(Vertex2D) * vertices.getLength());
+	m_pvertexBuffer->unmap();
+	data = m_pindexBuffer->map();
+	memcpy(data, indices.getRaw(), sizeof(uint32_t) * indices.getLength());
+	m_pindexBuffer->unmap();
+
+	vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineBatched);
+	m_pipelineRecord = PipelineRecord2D::BATCHED;
+
+	VkDeviceSize offsets[] = { 0 };
+	VkBuffer buffer = m_pvertexBuffer->getBuffer();
+	vkCmdBindVertexBuffers(m_currentCommandBuffer, 0, 1, &buffer, offsets);
+	vkCmdBindIndexBuffer(m_currentCommandBuffer, m_pindexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+	for (size_t i = 0; i < draws.getLength(); i++)
+	{
+		vkCmdBindDescriptorSets(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_layoutBatched, 0, 1, &draws[i].m_texture, 0, nullptr);
+		vkCmdDrawIndexed(m_currentCommandBuffer, draws[i].m_amountOfIndices, 1, draws[i].m_firstIndex, 0, 0);
+	}
+
+	m_batch.begin(m_screenWidth, m_screenHeight);
+}
+
 void bbe::PrimitiveBrush2D::INTERNAL_fillRect(const Rectangle &rect)
 {
+	if (m_pipelineBatched != VK_NULL_HANDLE)
+	{
+		m_batch.addRectangle(rect, m_color, INTERNAL_getAtlasTexture(), m_patlas->getWhiteUvRect());
+		return;
+	}
+
 	if (m_pipelineRecord != PipelineRecord2D::PRIMITIVE)
 	{
 		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelinePrimitive);
@@ -57,13 +146,27 @@ void bbe::PrimitiveBrush2D::INTERNAL_fillRect(const Rectangle &rect)
 
 void bbe::PrimitiveBrush2D::INTERNAL_drawImage(const Rectangle & rect, const Image & image)
 {
+	if (m_pipelineBatched != VK_NULL_HANDLE)
+	{
+		Rectangle uvRect;
+		if (m_patlas->add(image, uvRect))
+		{
+			m_batch.addRectangle(rect, m_color, INTERNAL_getAtlasTexture(), uvRect);
+		}
+		else
+		{
+			m_batch.addRectangle(rect, m_color, INTERNAL_getTexture(image));
+		}
+		return;
+	}
+
 	if (m_pipelineRecord != PipelineRecord2D::IMAGE)
 	{
 		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineImage);
 		m_pipelineRecord = PipelineRecord2D::IMAGE;
 	}
 
-	image.createAndUpload(*m_pdevice, *m_pcommandPool, *m_pdescriptorPool, *m_pdescriptorSetLayout);
+	image.createAndUpload(*m_puploadBatcher, *m_pdescriptorPool, *m_pdescriptorSetLayout);
 
 	vkCmdBindDescriptorSets(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_layoutImage, 0, 1, image.m_descriptorSet.getPDescriptorSet(), 0, nullptr);
 
@@ -83,6 +186,12 @@ void bbe::PrimitiveBrush2D::INTERNAL_drawImage(const Rectangle & rect, const Ima
 
 void bbe::PrimitiveBrush2D::INTERNAL_fillCircle(const Circle & circle)
 {
+	if (m_pipelineBatched != VK_NULL_HANDLE)
+	{
+		m_batch.addCircle(circle, m_color, INTERNAL_getAtlasTexture(), m_patlas->getWhiteUvRect());
+		return;
+	}
+
 	if (m_pipelineRecord != PipelineRecord2D::PRIMITIVE)
 	{
 		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelinePrimitive);
@@ -104,8 +213,11 @@ void bbe::PrimitiveBrush2D::INTERNAL_fillCircle(const Circle & circle)
 
 void bbe::PrimitiveBrush2D::INTERNAL_setColor(float r, float g, float b, float a)
 {
-	Color c(r, g, b, a);
-	vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color), &c);
+	m_color = Color(r, g, b, a);
+	if (m_pipelineBatched == VK_NULL_HANDLE)
+	{
+		vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color), &m_color);
+	}
 }
 
 void bbe::PrimitiveBrush2D::fillRect(const Rectangle & rect)
@@ -6,53 +6,152 @@
 #include "BBE/Math.h"
 #include "BBE/VulkanDescriptorPool.h"
 #include "BBE/VulkanPipeline.h"
+#include "BBE/VulkanDescriptorSet.h"
+#include "BBE/VulkanUniformRing.h"
 #include "BBE/Vector2.h"
 #include "BBE/Matrix4.h"
 #include "BBE/Rectangle.h"
+#include "BBE/List.h"
+#include "BBE/DynamicArray.h"
 
 void bbe::PrimitiveBrush3D::INTERNAL_setColor(float r, float g, float b, float a)
 {
-	Color c(r, g, b, a);
-	vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color), &c);
+	//The color is only pushed once something is actually drawn with it, so culled objects cost no push constants.
+	m_color = Color(r, g, b, a);
+	m_colorDirty = true;
 }
 
-void bbe::PrimitiveBrush3D::INTERNAL_beginDraw(bbe::INTERNAL::vulkan::VulkanDevice & device, VkCommandBuffer commandBuffer, INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive, INTERNAL::vulkan::VulkanPipeline &pipelineTerrain, int width, int height)
+void bbe::PrimitiveBrush3D::INTERNAL_flushColor()
+{
+	if (m_colorDirty)
+	{
+		vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color), &m_color);
+		m_colorDirty = false;
+	}
+}
+
+bool bbe::PrimitiveBrush3D::INTERNAL_isVisible(const BoundingBox & box)
+{
+	if (m_frustumCullingEnabled && !m_frustum.isVisible(box))
+	{
+		m_amountOfCulledObjects++;
+		return false;
+	}
+	m_amountOfDrawnObjects++;
+	return true;
+}
+
+bool bbe::PrimitiveBrush3D::INTERNAL_isVisible(const BoundingSphere & sphere)
+{
+	if (m_frustumCullingEnabled && !m_frustum.isVisible(sphere))
+	{
+		m_amountOfCulledObjects++;
+		return false;
+	}
+	m_amountOfDrawnObjects++;
+	return true;
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_drawInstances(List<InstanceData3D>& instances, const INTERNAL::vulkan::VulkanBuffer & vertexBuffer, const INTERNAL::vulkan::VulkanBuffer & indexBuffer, uint32_t amountOfIndices, DrawRecord drawRecord)
+{
+	if (instances.getLength() == 0)
+	{
+		return;
+	}
+
+	const VkDeviceSize size = sizeof(InstanceData3D) * instances.getLength();
+	if (m_instanceBufferOffset + size > m_pinstanceBuffer->getSize())
+	{
+		//Draws that were already recorded keep using the old buffer until the frame is done.
+		VkDeviceSize newSize = m_pinstanceBuffer->getSize() * 2;
+		if (newSize < size)
+		{
+			newSize = size;
+		}
+		m_pinstanceBuffer->destroyAtEndOfFrame();
+		m_pinstanceBuffer->create(m_device, m_physicalDevice, (size_t)newSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		m_instanceBufferOffset = 0;
+	}
+
+	char* data = (char*)m_pinstanceBuffer->map();
+	memcpy(data + m_instanceBufferOffset, instances.getRaw(), (size_t)size);
+	m_pinstanceBuffer->unmap();
+
+	if (m_pipelineRecord != PipelineRecord3D::INSTANCED)
+	{
+		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineInstanced);
+		m_pipelineRecord = PipelineRecord3D::INSTANCED;
+	}
+
+	VkBuffer buffers[] = { vertexBuffer.getBuffer(), m_pinstanceBuffer->getBuffer() };
+	VkDeviceSize offsets[] = { 0, m_instanceBufferOffset };
+	vkCmdBindVertexBuffers(m_currentCommandBuffer, 0, 2, buffers, offsets);
+	vkCmdBindIndexBuffer(m_currentCommandBuffer, indexBuffer.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+	vkCmdDrawIndexed(m_currentCommandBuffer, amountOfIndices, (uint32_t)instances.getLength(), 0, 0, 0);
+
+	m_instanceBufferOffset += size;
+	m_lastDraw = drawRecord;
+	instances.clear();
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_flushInstances()
+{
+	INTERNAL_drawInstances(m_cubeInstances, Cube::s_vertexBuffer, Cube::s_indexBuffer, 12 * 3, DrawRecord::CUBE);
+	INTERNAL_drawInstances(m_icoSphereInstances, IcoSphere::s_vertexBuffer, IcoSphere::s_indexBuffer, (uint32_t)IcoSphere::amountOfIndices, DrawRecord::ICOSPHERE);
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_bindCamera()
+{
+	vkCmdBindDescriptorSets(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_layoutPrimitive, 1, 1, &m_setViewProjectionMatrix, 1, &m_cameraOffset);
+	m_cameraBound = true;
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_endDraw3D()
+{
+	m_cameraBound = false;
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_beginDraw(bbe::INTERNAL::vulkan::VulkanDevice & device, VkCommandBuffer commandBuffer, INTERNAL::vulkan::VulkanPipeline &pipelinePrimitive, INTERNAL::vulkan::VulkanPipeline &pipelineTerrain, INTERNAL::vulkan::VulkanPipeline *pipelineInstanced, INTERNAL::vulkan::VulkanUniformRing &uniformRing, const INTERNAL::vulkan::VulkanDescriptorSet &setViewProjectionMatrix, INTERNAL::vulkan::VulkanBuffer &instanceBuffer, int width, int height)
 {
 	m_layoutPrimitive = pipelinePrimitive.getLayout();
 	m_pipelinePrimitive = pipelinePrimitive.getPipeline();
 	m_layoutTerrain = pipelineTerrain.getLayout();
 	m_pipelineTerrain = pipelineTerrain.getPipeline();
+	m_pipelineInstanced = pipelineInstanced != nullptr ? pipelineInstanced->getPipeline() : VK_NULL_HANDLE;
 	m_currentCommandBuffer = commandBuffer;
+	m_puniformRing = &uniformRing;
+	m_setViewProjectionMatrix = setViewProjectionMatrix.getDescriptorSet();
+	m_cameraBound = false;
+	m_pinstanceBuffer = &instanceBuffer;
+	m_instanceBufferOffset = 0;
+	m_cubeInstances.clear();
+	m_icoSphereInstances.clear();
 	m_device = device.getDevice();
 	m_physicalDevice = device.getPhysicalDevice();
 	m_screenWidth = width;
 	m_screenHeight = height;
 	m_lastDraw = DrawRecord::NONE;
 	m_pipelineRecord = PipelineRecord3D::NONE;
+	m_amountOfDrawnObjects = 0;
+	m_amountOfCulledObjects = 0;
 
 	setColor(1.0f, 1.0f, 1.0f, 1.0f);
 	setCamera(Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1));
 }
 
-void bbe::PrimitiveBrush3D::create(const INTERNAL::vulkan::VulkanDevice &vulkanDevice)
+void bbe::PrimitiveBrush3D::fillCube(const Cube & cube)
 {
-	Matrix4 mat;
-	m_uboMatrices.create(vulkanDevice, sizeof(Matrix4) * 2, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+	if (!INTERNAL_isVisible(cube.getBoundingBox()))
 	{
-		void* data = m_uboMatrices.map();
-		memcpy(data, &mat, sizeof(Matrix4));
-		memcpy((char*)data + sizeof(Matrix4), &mat, sizeof(Matrix4));
-		m_uboMatrices.unmap();
+		return;
 	}
-}
 
-void bbe::PrimitiveBrush3D::destroy()
-{
-	m_uboMatrices.destroy();
-}
+	if (m_pipelineInstanced != VK_NULL_HANDLE)
+	{
+		m_cubeInstances.add(InstanceData3D(cube.m_transform, m_color));
+		return;
+	}
 
-void bbe::PrimitiveBrush3D::fillCube(const Cube & cube)
-{
 	if (m_pipelineRecord != PipelineRecord3D::PRIMITIVE)
 	{
 		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelinePrimitive);
@@ -73,11 +172,23 @@ void bbe::PrimitiveBrush3D::fillCube(const Cube & cube)
 	}
 	
 
+	INTERNAL_flushColor();
 	vkCmdDrawIndexed(m_currentCommandBuffer, 12 * 3, 1, 0, 0, 0);
 }
 
 void bbe::PrimitiveBrush3D::fillIcoSphere(const IcoSphere & sphere)
 {
+	if (!INTERNAL_isVisible(sphere.getBoundingSphere()))
+	{
+		return;
+	}
+
+	if (m_pipelineInstanced != VK_NULL_HANDLE)
+	{
+		m_icoSphereInstances.add(InstanceData3D(sphere.m_transform, m_color));
+		return;
+	}
+
 	if (m_pipelineRecord != PipelineRecord3D::PRIMITIVE)
 	{
 		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelinePrimitive);
@@ -98,6 +209,7 @@ void bbe::PrimitiveBrush3D::fillIcoSphere(const IcoSphere & sphere)
 	}
 
 
+	INTERNAL_flushColor();
 	vkCmdDrawIndexed(m_currentCommandBuffer, IcoSphere::amountOfIndices, 1, 0, 0, 0);
 }
 
@@ -110,41 +222,131 @@ void bbe::PrimitiveBrush3D::drawTerrain(const Terrain & terrain, int lodLevel)
 {
 	terrain.init();
 
-	if (m_pipelineRecord != PipelineRecord3D::TERRAIN)
+	List<const TerrainPatch*> patches;
+	patches.resizeCapacity(terrain.m_patches.getLength());
+	for (size_t i = 0; i < terrain.m_patches.getLength(); i++)
+	{
+		patches.add(&terrain.m_patches[i]);
+	}
+	INTERNAL_drawTerrainPatches(patches);
+}
+
+void bbe::PrimitiveBrush3D::drawTerrain(StreamingTerrain & terrain)
+{
+	terrain.update(m_cameraPos);
+	terrain.uploadPatches();
+
+	List<const TerrainPatch*> patches;
+	patches.resizeCapacity(terrain.m_residentPatches.getLength());
+	for (size_t i = 0; i < terrain.m_residentPatches.getLength(); i++)
+	{
+		if (terrain.m_residentPatches[i].m_ppatch->m_created)
+		{
+			patches.add(terrain.m_residentPatches[i].m_ppatch);
+		}
+	}
+	INTERNAL_drawTerrainPatches(patches);
+}
+
+void bbe::PrimitiveBrush3D::INTERNAL_drawTerrainPatches(const List<const TerrainPatch*> &patches)
+{
+	const int amountOfPatches = (int)patches.getLength();
+	List<BoundingBox> boundingBoxes;
+	List<float> distances;
+	List<int> patchXs;
+	List<int> patchYs;
+	boundingBoxes.resizeCapacity(amountOfPatches);
+	distances.resizeCapacity(amountOfPatches);
+	patchXs.resizeCapacity(amountOfPatches);
+	patchYs.resizeCapacity(amountOfPatches);
+
+	for (int i = 0; i < amountOfPatches; i++)
+	{
+		const BoundingBox box = patches[i]->getBoundingBox();
+		const Vector3 min = box.getMin();
+		const Vector3 max = box.getMax();
+		const Vector3 closest(
+			Math::clamp(m_cameraPos.x, min.x, max.x),
+			Math::clamp(m_cameraPos.y, min.y, max.y),
+			Math::clamp(m_cameraPos.z, min.z, max.z));
+		boundingBoxes.add(box);
+		distances.add(closest.getDistanceTo(m_cameraPos));
+		patchXs.add(patches[i]->m_patchX);
+		patchYs.add(patches[i]->m_patchY);
+	}
+
+	DynamicArray<int> lodLevels(amountOfPatches);
+	DynamicArray<int> coarserEdges(amountOfPatches);
+	TerrainPatch::selectLodLevels(patchXs.getRaw(), patchYs.getRaw(), distances.getRaw(), amountOfPatches, m_terrainLodDistance, lodLevels.getRaw(), coarserEdges.getRaw());
+
+	//A scale of 0 turns the morph off, for the last level and the edges of the last but one.
+	auto getTerrainMorph = [&](int lodLevel, float &outStart, float &outScale)
+	{
+		outStart = 0;
+		outScale = 0;
+		if (lodLevel < Terrain::AMOUNT_OF_LOD_LEVELS - 1)
+		{
+			float end;
+			TerrainPatch::getMorphRange(lodLevel, m_terrainLodDistance, outStart, end);
+			outScale = 1 / (end - outStart);
+		}
+	};
+
+	DynamicArray<bool> visible(amountOfPatches);
+	if (m_frustumCullingEnabled)
+	{
+		size_t amountVisible = m_frustum.isVisible(boundingBoxes.getRaw(), visible.getRaw(), amountOfPatches);
+		m_amountOfDrawnObjects += (int)amountVisible;
+		m_amountOfCulledObjects += amountOfPatches - (int)amountVisible;
+	}
+	else
 	{
-		vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineTerrain);
-		m_pipelineRecord = PipelineRecord3D::TERRAIN;
+		for (int i = 0; i < amountOfPatches; i++)
+		{
+			visible[i] = true;
+		}
+		m_amountOfDrawnObjects += amountOfPatches;
 	}
-	for (int i = 0; i < terrain.m_patches.getLength(); i++)
+
+	for (int i = 0; i < amountOfPatches; i++)
 	{
-		Rectangle terrainPos2D = Rectangle(terrain.m_patches[i].getTransform().extractTranslation().xy(), 128, 128);
-		float distance = terrainPos2D.getDistanceTo(m_cameraPos.xy());
-		float lodLevelFloat = distance / 128 - 1;
-		lodLevel = (int)lodLevelFloat;
-		if (lodLevel >= Terrain::AMOUNT_OF_LOD_LEVELS)
+		if (!visible[i])
 		{
-			lodLevel = Terrain::AMOUNT_OF_LOD_LEVELS - 1;
+			continue;
 		}
-		else if (lodLevel < 0)
+
+		if (m_pipelineRecord != PipelineRecord3D::TERRAIN)
 		{
-			lodLevel = 0;
+			vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineTerrain);
+			m_pipelineRecord = PipelineRecord3D::TERRAIN;
 		}
-		float translation = lodLevelFloat * 20;
-		if (translation < 0) translation = 0;
-		vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_VERTEX_BIT, sizeof(float) * 4, sizeof(Matrix4), &((terrain.m_patches[i].m_transform) * (Matrix4::createTranslationMatrix(bbe::Vector3(0, 0, -translation)))));
+		INTERNAL_flushColor();
+
+		const int lodLevel = lodLevels[i];
+		const int indexBufferIndex = lodLevel * TerrainPatch::AMOUNT_OF_EDGE_MASKS + coarserEdges[i];
+		TerrainPatch::PushConstants pushConstants;
+		pushConstants.m_transform      = patches[i]->m_transform;
+		pushConstants.m_verticesPerRow = ((patches[i]->m_width - 1) >> lodLevel) + 1;
+		pushConstants.m_vertexDistance = TerrainPatch::VERTEX_DISTANCE * (1 << lodLevel);
+		pushConstants.m_heightScale    = TerrainPatch::HEIGHT_SCALE;
+		pushConstants.m_coarserEdges   = coarserEdges[i];
+		pushConstants.m_cameraPos      = m_cameraPos;
+		pushConstants.m_padding        = 0;
+		getTerrainMorph(lodLevel, pushConstants.m_morphStart, pushConstants.m_morphScale);
+		getTerrainMorph(lodLevel + 1, pushConstants.m_coarserMorphStart, pushConstants.m_coarserMorphScale);
+		vkCmdPushConstants(m_currentCommandBuffer, m_layoutPrimitive, VK_SHADER_STAGE_VERTEX_BIT, sizeof(float) * 4, sizeof(TerrainPatch::PushConstants), &pushConstants);
 		VkDeviceSize offsets[] = { 0 };
-		VkBuffer buffer = terrain.m_patches[i].m_vertexBuffers[lodLevel].getBuffer();
+		VkBuffer buffer = patches[i]->m_vertexBuffers[lodLevel].getBuffer();
 		vkCmdBindVertexBuffers(m_currentCommandBuffer, 0, 1, &buffer, offsets);
 
-		buffer = terrain.m_patches[i].m_indexBuffers[lodLevel].getBuffer();
+		buffer = TerrainPatch::s_indexBuffers[indexBufferIndex].getBuffer();
 		vkCmdBindIndexBuffer(m_currentCommandBuffer, buffer, 0, VK_INDEX_TYPE_UINT32);
 
 
-		vkCmdDrawIndexed(m_currentCommandBuffer, terrain.m_patches[i].m_numberOfVertices[lodLevel], 1, 0, 0, 0);
-	}
+		vkCmdDrawIndexed(m_currentCommandBuffer, TerrainPatch::s_amountOfIndices[indexBufferIndex], 1, 0, 0, 0);
 
-	m_lastDraw = DrawRecord::TERRAIN;
-	
+		m_lastDraw = DrawRecord::TERRAIN;
+	}
 }
 
 void bbe::PrimitiveBrush3D::setColor(float r, float g, float b, float a)
@@ -166,11 +368,72 @@ void bbe::PrimitiveBrush3D::setCamera(const Vector3 & cameraPos, const Vector3 &
 {
 	Matrix4 view = Matrix4::createViewMatrix(cameraPos, cameraTarget, cameraUpVector);
 	Matrix4 projection = Matrix4::createPerspectiveMatrix(Math::toRadians(60.0f), (float)m_screenWidth / (float)m_screenHeight, 0.001f, 10000.0f);
+	m_viewProjectionMatrix = projection * view;
+	m_frustum.set(m_viewProjectionMatrix);
+
+	if (m_cameraBound)
+	{
+		//Collected instances were meant for the old camera.
+		INTERNAL_flushInstances();
+	}
 
-	void *data = m_uboMatrices.map();
-	memcpy((char*)data, &view, sizeof(Matrix4));
-	memcpy((char*)data + sizeof(Matrix4), &projection, sizeof(Matrix4));
-	m_uboMatrices.unmap();
+	char *data = (char*)m_puniformRing->allocate(sizeof(Matrix4) * 2, m_cameraOffset);
+	memcpy(data, &view, sizeof(Matrix4));
+	memcpy(data + sizeof(Matrix4), &projection, sizeof(Matrix4));
+
+	if (m_cameraBound)
+	{
+		INTERNAL_bindCamera();
+	}
 
 	m_cameraPos = cameraPos;
 }
+
+void bbe::PrimitiveBrush3D::setFrustumCullingEnabled(bool enabled)
+{
+	m_frustumCullingEnabled = enabled;
+}
+
+bool bbe::PrimitiveBrush3D::isFrustumCullingEnabled() const
+{
+	return m_frustumCullingEnabled;
+}
+
+void bbe::PrimitiveBrush3D::setTerrainLodDistance(float lodDistance)
+{
+	if (lodDistance <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_terrainLodDistance = lodDistance;
+}
+
+float bbe::PrimitiveBrush3D::getTerrainLodDistance() const
+{
+	return m_terrainLodDistance;
+}
+
+const bbe::Frustum & bbe::PrimitiveBrush3D::getFrustum() const
+{
+	return m_frustum;
+}
+
+bbe::Ray bbe::PrimitiveBrush3D::getScreenRay(float x, float y) const
+{
+	const Matrix4 inverseViewProjection = m_viewProjectionMatrix.inverse();
+	const float ndcX = x / m_screenWidth * 2 - 1;
+	const float ndcY = y / m_screenHeight * 2 - 1;
+	const Vector3 nearPoint = inverseViewProjection * Vector3(ndcX, ndcY, -1);
+	const Vector3 farPoint = inverseViewProjection * Vector3(ndcX, ndcY, 1);
+	return Ray(m_cameraPos, (farPoint - nearPoint).normalize());
+}
+
+int bbe::PrimitiveBrush3D::getAmountOfDrawnObjects() const
+{
+	return m_amountOfDrawnObjects;
+}
+
+int bbe::PrimitiveBrush3D::getAmountOfCulledObjects() const
+{
+	return m_amountOfCulledObjects;
+}
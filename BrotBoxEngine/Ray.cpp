@@ -0,0 +1,149 @@
+#include "stdafx.h"
+#include "BBE/Ray.h"
+
+bbe::Ray::Ray()
+	: m_origin(0, 0, 0), m_direction(1, 0, 0)
+{
+}
+
+bbe::Ray::Ray(const Vector3 & origin, const Vector3 & direction)
+	: m_origin(origin), m_direction(direction)
+{
+}
+
+bbe::Ray bbe::Ray::createFromPoints(const Vector3 & from, const Vector3 & to)
+{
+	return Ray(from, to - from);
+}
+
+bbe::Vector3 bbe::Ray::getOrigin() const
+{
+	return m_origin;
+}
+
+bbe::Vector3 bbe::Ray::getDirection() const
+{
+	return m_direction;
+}
+
+bbe::Vector3 bbe::Ray::getPoint(float t) const
+{
+	return m_origin + m_direction * t;
+}
+
+void bbe::Ray::set(const Vector3 & origin, const Vector3 & direction)
+{
+	m_origin = origin;
+	m_direction = direction;
+}
+
+bbe::Ray bbe::Ray::transform(const Matrix4 & transform) const
+{
+	return Ray(transform * m_origin, (transform * Vector4(m_direction, 0)).xyz());
+}
+
+bool bbe::Ray::intersects(const BoundingBox & box, float & outT, float maxT) const
+{
+	const Vector3 min = box.getMin();
+	const Vector3 max = box.getMax();
+	float tNear = 0;
+	float tFar = maxT;
+	for (int i = 0; i < 3; i++)
+	{
+		if (m_direction[i] == 0)
+		{
+			if (m_origin[i] < min[i] || m_origin[i] > max[i])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const float invDir = 1 / m_direction[i];
+		float t1 = (min[i] - m_origin[i]) * invDir;
+		float t2 = (max[i] - m_origin[i]) * invDir;
+		if (t1 > t2)
+		{
+			const float temp = t1;
+			t1 = t2;
+			t2 = temp;
+		}
+		tNear = Math::max(tNear, t1);
+		tFar = Math::min(tFar, t2);
+		if (tNear > tFar)
+		{
+			return false;
+		}
+	}
+
+	outT = tNear;
+	return true;
+}
+
+bool bbe::Ray::intersects(const BoundingSphere & sphere, float & outT, float maxT) const
+{
+	const Vector3 toOrigin = m_origin - sphere.getCenter();
+	const float a = m_direction.getLengthSq();
+	const float b = toOrigin * m_direction;
+	const float c = toOrigin.getLengthSq() - sphere.getRadius() * sphere.getRadius();
+	if (a == 0)
+	{
+		return false;
+	}
+	if (c <= 0)
+	{
+		//The origin is inside of the sphere.
+		outT = 0;
+		return true;
+	}
+
+	const float discriminant = b * b - a * c;
+	if (b > 0 || discriminant < 0)
+	{
+		return false;
+	}
+
+	const float t = (-b - Math::sqrt(discriminant)) / a;
+	if (t > maxT)
+	{
+		return false;
+	}
+	outT = t;
+	return true;
+}
+
+bool bbe::Ray::intersectsTriangle(const Vector3 & a, const Vector3 & b, const Vector3 & c, float & outT, float maxT) const
+{
+	//Moeller-Trumbore, both sides of the triangle are hit.
+	const Vector3 edge1 = b - a;
+	const Vector3 edge2 = c - a;
+	const Vector3 p = m_direction.cross(edge2);
+	const float det = edge1 * p;
+	if (det == 0)
+	{
+		return false;
+	}
+
+	const float detInv = 1 / det;
+	const Vector3 s = m_origin - a;
+	const float u = (s * p) * detInv;
+	if (u < 0 || u > 1)
+	{
+		return false;
+	}
+
+	const Vector3 q = s.cross(edge1);
+	const float v = (m_direction * q) * detInv;
+	if (v < 0 || u + v > 1)
+	{
+		return false;
+	}
+
+	const float t = (edge2 * q) * detInv;
+	if (t < 0 || t > maxT)
+	{
+		return false;
+	}
+	outT = t;
+	return true;
+}
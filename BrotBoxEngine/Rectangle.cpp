@@ -17,7 +17,7 @@ void bbe::Rectangle::s_initIndexBuffer(VkDevice device, VkPhysicalDevice physica
 {
 	s_indexBuffer.create(device, physicalDevice, sizeof(uint32_t) * 6, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 
-	uint32_t data[] = {
+	static constexpr uint32_t data[] = {
 		0, 1, 2, 0, 2, 3
 	};
 	void* dataBuf = s_indexBuffer.map();
@@ -30,7 +30,7 @@ void bbe::Rectangle::s_initIndexBuffer(VkDevice device, VkPhysicalDevice physica
 void bbe::Rectangle::s_initVertexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool &commandPool, VkQueue queue)
 {
 	s_vertexBuffer.create(device, physicalDevice, sizeof(float) * 8, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-	float data[] = {
+	static constexpr float data[] = {
 		0, 0,
 		1, 0,
 		1, 1,
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "BBE/RingAllocator.h"
+#include "BBE/Exceptions.h"
+
+bbe::RingAllocator::RingAllocator()
+{
+	//DO NOTHING
+}
+
+bbe::RingAllocator::RingAllocator(size_t capacity)
+{
+	reset(capacity);
+}
+
+void bbe::RingAllocator::reset(size_t capacity)
+{
+	if (capacity == 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	m_capacity = capacity;
+	m_allocated = 0;
+	m_freed = 0;
+}
+
+bool bbe::RingAllocator::allocate(size_t size, size_t alignment, size_t & outOffset)
+{
+	if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		throw IllegalArgumentException();
+	}
+	if (size > m_capacity)
+	{
+		return false;
+	}
+
+	size_t offset = (size_t)(m_allocated % m_capacity);
+	size_t skipped = ((offset + alignment - 1) & ~(alignment - 1)) - offset;
+	if (offset + skipped + size > m_capacity)
+	{
+		skipped = m_capacity - offset;
+		if (isEmpty())
+		{
+			//Nothing is in the way, so the skipped space does not have to wait until it is freed.
+			m_allocated += skipped;
+			m_freed = m_allocated;
+			skipped = 0;
+		}
+		offset = 0;
+	}
+	else
+	{
+		offset += skipped;
+	}
+
+	if (m_allocated + skipped + size - m_freed > m_capacity)
+	{
+		return false;
+	}
+
+	m_allocated += skipped + size;
+	outOffset = offset;
+	return true;
+}
+
+uint64_t bbe::RingAllocator::getHead() const
+{
+	return m_allocated;
+}
+
+void bbe::RingAllocator::freeUpTo(uint64_t position)
+{
+	if (position > m_allocated)
+	{
+		throw IllegalArgumentException();
+	}
+	if (position > m_freed)
+	{
+		m_freed = position;
+	}
+}
+
+size_t bbe::RingAllocator::getCapacity() const
+{
+	return m_capacity;
+}
+
+size_t bbe::RingAllocator::getUsed() const
+{
+	return (size_t)(m_allocated - m_freed);
+}
+
+bool bbe::RingAllocator::isEmpty() const
+{
+	return m_allocated == m_freed;
+}
@@ -0,0 +1,13 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec2 inUvCoord;
+layout(location = 1) in vec4 inColor;
+layout(location = 0) out vec4 outColor;
+
+//Rectangles and circles sample a white image.
+layout(binding = 0) uniform sampler2D tex;
+
+void main() {
+	outColor = inColor * texture(tex, inUvCoord);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(constant_id = 0) const int AMOUNT_OF_LIGHTS = 4;
+
+out gl_PerVertex {
+	vec4 gl_Position;
+};
+
+struct Light
+{
+	vec3 pos;
+	float used;
+};
+
+layout(set = 0, binding = 0) uniform UBOLights
+{
+	Light light[AMOUNT_OF_LIGHTS];
+} uboLights;
+
+layout(set = 1, binding = 0) uniform UBOProjection
+{
+	mat4 view;
+	mat4 projection;
+} uboProjection;
+
+layout(push_constant) uniform PushConstants
+{
+	layout(offset = 16)mat4 modelMatrix;
+	int verticesPerRow;
+	float vertexDistance;
+	float heightScale;
+	int coarserEdges;
+	vec3 cameraPos;
+	//Start and scale of the morph range of the lod level, followed by the ones of the next coarser level.
+	vec4 morph;
+} pushConts;
+
+//Only the heights are stored per vertex, the rest of the position follows from the index. The second
+//height is the one of the vertex in the next coarser lod level.
+layout(location = 0) in vec2 inHeights;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec3 outViewVec;
+layout(location = 2) out OutLightVertexInput
+{
+	vec3 outLightVec;
+	float lightUsed;
+}outLightVertexInput[AMOUNT_OF_LIGHTS];
+
+
+void main() 
+{
+	//The vertices of a patch are stored row by row and rows run along x.
+	int row = gl_VertexIndex / pushConts.verticesPerRow;
+	int col = gl_VertexIndex - row * pushConts.verticesPerRow;
+	int last = pushConts.verticesPerRow - 1;
+	vec3 pos = vec3(row * pushConts.vertexDistance, col * pushConts.vertexDistance, inHeights.x * pushConts.heightScale);
+
+	//Odd vertices morph into the next coarser level. Even vertices on an edge with a coarser neighbour morph
+	//like the odd vertices of the neighbour, so the edges stay closed.
+	int edges = 0;
+	if (row == 0)    edges |= 1;
+	if (row == last) edges |= 2;
+	if (col == 0)    edges |= 4;
+	if (col == last) edges |= 8;
+	float dist = length((pushConts.modelMatrix * vec4(pos, 1.0)).xyz - pushConts.cameraPos);
+	float morph = 0.0;
+	if ((edges & pushConts.coarserEdges) != 0)
+	{
+		morph = clamp((dist - pushConts.morph.z) * pushConts.morph.w, 0.0, 1.0);
+	}
+	else if (((row | col) & 1) != 0)
+	{
+		morph = clamp((dist - pushConts.morph.x) * pushConts.morph.y, 0.0, 1.0);
+	}
+	pos.z = mix(inHeights.x, inHeights.y, morph) * pushConts.heightScale;
+
+	vec4 worldPos = pushConts.modelMatrix * vec4(pos, 1.0);
+	gl_Position = uboProjection.projection * uboProjection.view * worldPos;
+	outNormal = mat3(uboProjection.view) * mat3(pushConts.modelMatrix) * inNormal;
+	outViewVec = -(uboProjection.view * worldPos).xyz;
+	for(int i = 0; i<AMOUNT_OF_LIGHTS; i++)
+	{
+		outLightVertexInput[i].lightUsed = uboLights.light[i].used;
+		if(uboLights.light[i].used > 0.0f)
+		{
+			vec3 lightPos = uboLights.light[i].pos;
+			outLightVertexInput[i].outLightVec = mat3(uboProjection.view) * (lightPos - vec3(worldPos));
+		}
+	}
+	
+}
\ No newline at end of file
@@ -1,5 +1,44 @@
 #include "stdafx.h"
 #include "BBE/SimpleFile.h"
+#include "BBE/Exceptions.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+
+static std::string toNarrowPath(const std::wstring &path)
+{
+	std::string narrow(path.length() * MB_CUR_MAX + 1, '\0');
+	const size_t length = wcstombs(&narrow[0], path.c_str(), narrow.length());
+	if (length == (size_t)-1)
+	{
+		return std::string();
+	}
+	narrow.resize(length);
+	return narrow;
+}
+
+static std::wstring toWidePath(const std::string &path)
+{
+	std::wstring wide(path.length() + 1, L'\0');
+	const size_t length = mbstowcs(&wide[0], path.c_str(), wide.length());
+	if (length == (size_t)-1)
+	{
+		return std::wstring();
+	}
+	wide.resize(length);
+	return wide;
+}
+#endif
 
 bbe::List<char> bbe::simpleFile::readBinaryFile(const bbe::String & filepath)
 {
@@ -21,3 +60,227 @@ bbe::List<char> bbe::simpleFile::readBinaryFile(const bbe::String & filepath)
 		throw std::runtime_error("Failed to open file!");
 	}
 }
+
+bool bbe::simpleFile::doesFileExist(const bbe::String & filepath)
+{
+#ifdef _WIN32
+	const DWORD attributes = GetFileAttributesW(filepath.getRaw());
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0;
+#else
+	struct stat fileStat;
+	return stat(toNarrowPath(filepath.getRaw()).c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+#endif
+}
+
+bool bbe::simpleFile::deleteFile(const bbe::String & filepath)
+{
+#ifdef _WIN32
+	return DeleteFileW(filepath.getRaw()) != 0;
+#else
+	return std::remove(toNarrowPath(filepath.getRaw()).c_str()) == 0;
+#endif
+}
+
+bbe::List<bbe::String> bbe::simpleFile::findFilesWithPrefix(const bbe::String & prefix)
+{
+	const std::wstring prefixPath(prefix.getRaw());
+	const size_t separator = prefixPath.find_last_of(L"/\\");
+	const std::wstring directory = separator == std::wstring::npos ? std::wstring() : prefixPath.substr(0, separator + 1);
+
+	bbe::List<bbe::String> files;
+#ifdef _WIN32
+	WIN32_FIND_DATAW findData;
+	HANDLE find = FindFirstFileW((prefixPath + L"*").c_str(), &findData);
+	if (find == INVALID_HANDLE_VALUE)
+	{
+		return files;
+	}
+	do
+	{
+		if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+		{
+			files.add(bbe::String(directory + findData.cFileName));
+		}
+	} while (FindNextFileW(find, &findData));
+	FindClose(find);
+#else
+	DIR* dir = opendir(directory.empty() ? "." : toNarrowPath(directory).c_str());
+	if (dir == nullptr)
+	{
+		return files;
+	}
+	const std::string namePrefix = toNarrowPath(prefixPath.substr(directory.length()));
+	for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+	{
+		const std::string name(entry->d_name);
+		if (name.compare(0, namePrefix.length(), namePrefix) == 0)
+		{
+			const bbe::String path(directory + toWidePath(name));
+			if (doesFileExist(path))
+			{
+				files.add(path);
+			}
+		}
+	}
+	closedir(dir);
+#endif
+	return files;
+}
+
+bbe::simpleFile::BinaryFileWriter::BinaryFileWriter(const bbe::String & filepath)
+	: m_path(filepath.getRaw()), m_tempPath(std::wstring(filepath.getRaw()) + L".tmp")
+{
+#ifdef _WIN32
+	m_file.open(m_tempPath.c_str(), std::ios::binary | std::ios::trunc);
+#else
+	m_file.open(toNarrowPath(m_tempPath), std::ios::binary | std::ios::trunc);
+#endif
+}
+
+bbe::simpleFile::BinaryFileWriter::~BinaryFileWriter()
+{
+	if (!m_committed)
+	{
+		m_file.close();
+#ifdef _WIN32
+		DeleteFileW(m_tempPath.c_str());
+#else
+		std::remove(toNarrowPath(m_tempPath).c_str());
+#endif
+	}
+}
+
+void bbe::simpleFile::BinaryFileWriter::write(const void * data, size_t size)
+{
+	if (m_committed)
+	{
+		throw IllegalStateException();
+	}
+	m_file.write((const char*)data, size);
+}
+
+bool bbe::simpleFile::BinaryFileWriter::commit()
+{
+	if (m_committed)
+	{
+		throw IllegalStateException();
+	}
+	m_file.close();
+	if (m_file.fail())
+	{
+		return false;
+	}
+
+#ifdef _WIN32
+	if (!MoveFileExW(m_tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		return false;
+	}
+#else
+	if (std::rename(toNarrowPath(m_tempPath).c_str(), toNarrowPath(m_path).c_str()) != 0)
+	{
+		return false;
+	}
+#endif
+	m_committed = true;
+	return true;
+}
+
+bbe::simpleFile::MappedFile::MappedFile()
+{
+	//DO NOTHING
+}
+
+bbe::simpleFile::MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool bbe::simpleFile::MappedFile::open(const bbe::String & filepath)
+{
+	if (isOpen())
+	{
+		throw AlreadyCreatedException();
+	}
+
+	//The view keeps the file open, so the handles are not needed afterwards.
+#ifdef _WIN32
+	HANDLE file = CreateFileW(filepath.getRaw(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+	{
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == nullptr)
+	{
+		return false;
+	}
+	m_pdata = (const char*)view;
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	const int file = ::open(toNarrowPath(filepath.getRaw()).c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		::close(file);
+		return false;
+	}
+	void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	m_pdata = (const char*)view;
+	m_size = (size_t)fileStat.st_size;
+#endif
+	return true;
+}
+
+void bbe::simpleFile::MappedFile::close()
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_pdata);
+#else
+	munmap((void*)m_pdata, m_size);
+#endif
+	m_pdata = nullptr;
+	m_size = 0;
+}
+
+bool bbe::simpleFile::MappedFile::isOpen() const
+{
+	return m_pdata != nullptr;
+}
+
+const char * bbe::simpleFile::MappedFile::getData() const
+{
+	return m_pdata;
+}
+
+size_t bbe::simpleFile::MappedFile::getSize() const
+{
+	return m_size;
+}
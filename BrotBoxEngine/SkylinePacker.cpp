@@ -0,0 +1,154 @@
+#include "stdafx.h"
+#include "BBE/SkylinePacker.h"
+#include "BBE/Exceptions.h"
+
+int bbe::SkylinePacker::getFittingY(size_t nodeIndex, int width, int height) const
+{
+	const int x = m_skyline[nodeIndex].m_x;
+	if (x + width > m_width)
+	{
+		return -1;
+	}
+
+	int y = 0;
+	int widthLeft = width;
+	for (size_t i = nodeIndex; widthLeft > 0; i++)
+	{
+		if (m_skyline[i].m_y > y)
+		{
+			y = m_skyline[i].m_y;
+		}
+		widthLeft -= m_skyline[i].m_width;
+	}
+
+	if (y + height > m_height)
+	{
+		return -1;
+	}
+	return y;
+}
+
+void bbe::SkylinePacker::addMerged(List<SkylineNode>& skyline, const SkylineNode & node)
+{
+	if (skyline.getLength() > 0 && skyline.last().m_y == node.m_y)
+	{
+		skyline.last().m_width += node.m_width;
+	}
+	else
+	{
+		skyline.add(node);
+	}
+}
+
+bbe::SkylinePacker::SkylinePacker()
+{
+	//DO NOTHING
+}
+
+bbe::SkylinePacker::SkylinePacker(int width, int height)
+{
+	reset(width, height);
+}
+
+void bbe::SkylinePacker::reset(int width, int height)
+{
+	if (width <= 0 || height <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	m_width = width;
+	m_height = height;
+	m_usedArea = 0;
+	m_skyline.clear();
+	SkylineNode node;
+	node.m_x = 0;
+	node.m_y = 0;
+	node.m_width = width;
+	m_skyline.add(node);
+}
+
+bool bbe::SkylinePacker::insert(int width, int height, int & outX, int & outY)
+{
+	if (width <= 0 || height <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	//Bottom left: the lowest top wins, a narrower segment breaks ties so wide gaps stay free for wide rectangles.
+	int bestIndex = -1;
+	int bestTop = 0;
+	int bestWidth = 0;
+	for (size_t i = 0; i < m_skyline.getLength(); i++)
+	{
+		const int y = getFittingY(i, width, height);
+		if (y < 0)
+		{
+			continue;
+		}
+		const int top = y + height;
+		if (bestIndex < 0 || top < bestTop || (top == bestTop && m_skyline[i].m_width < bestWidth))
+		{
+			bestIndex = (int)i;
+			bestTop = top;
+			bestWidth = m_skyline[i].m_width;
+		}
+	}
+
+	if (bestIndex < 0)
+	{
+		return false;
+	}
+
+	outX = m_skyline[bestIndex].m_x;
+	outY = bestTop - height;
+
+	SkylineNode node;
+	node.m_x = outX;
+	node.m_y = bestTop;
+	node.m_width = width;
+
+	//The new node covers the nodes below it. Neighbours at the same height are merged into one node.
+	const int right = node.m_x + node.m_width;
+	List<SkylineNode> skyline;
+	skyline.resizeCapacity(m_skyline.getLength() + 1);
+	for (size_t i = 0; i < m_skyline.getLength(); i++)
+	{
+		if ((int)i == bestIndex)
+		{
+			addMerged(skyline, node);
+		}
+		SkylineNode current = m_skyline[i];
+		const int currentRight = current.m_x + current.m_width;
+		if (current.m_x < right && currentRight > node.m_x)
+		{
+			if (currentRight <= right)
+			{
+				continue;
+			}
+			current.m_width = currentRight - right;
+			current.m_x = right;
+		}
+		addMerged(skyline, current);
+	}
+	m_skyline.clear();
+	m_skyline = std::move(skyline);
+
+	m_usedArea += width * height;
+	return true;
+}
+
+int bbe::SkylinePacker::getWidth() const
+{
+	return m_width;
+}
+
+int bbe::SkylinePacker::getHeight() const
+{
+	return m_height;
+}
+
+int bbe::SkylinePacker::getUsedArea() const
+{
+	return m_usedArea;
+}
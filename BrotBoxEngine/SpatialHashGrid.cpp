@@ -0,0 +1,247 @@
+#include "stdafx.h"
+#include "BBE/SpatialHashGrid.h"
+#include "BBE/Exceptions.h"
+#include <algorithm>
+
+bbe::SpatialHashGrid::Cell bbe::SpatialHashGrid::getCell(const Vector3 & pos) const
+{
+	Cell cell;
+	cell.x = (int32_t)Math::floor(pos.x * m_cellSizeInv);
+	cell.y = (int32_t)Math::floor(pos.y * m_cellSizeInv);
+	cell.z = (int32_t)Math::floor(pos.z * m_cellSizeInv);
+	return cell;
+}
+
+size_t bbe::SpatialHashGrid::getBucket(const Cell & cell) const
+{
+	const uint32_t hash = ((uint32_t)cell.x * 73856093u) ^ ((uint32_t)cell.y * 19349663u) ^ ((uint32_t)cell.z * 83492791u);
+	return hash & m_bucketMask;
+}
+
+void bbe::SpatialHashGrid::insertIntoBucket(uint32_t index)
+{
+	m_buckets[getBucket(m_cells[index])].add(index);
+}
+
+void bbe::SpatialHashGrid::removeFromBucket(uint32_t index)
+{
+	List<uint32_t> &bucket = m_buckets[getBucket(m_cells[index])];
+	for (size_t i = 0; i < bucket.getLength(); i++)
+	{
+		if (bucket[i] == index)
+		{
+			bucket[i] = bucket.last();
+			bucket.popBack();
+			return;
+		}
+	}
+	throw IllegalStateException();
+}
+
+void bbe::SpatialHashGrid::growBounds(const Vector3 & pos)
+{
+	if (m_positions.getLength() == 1)
+	{
+		m_boundsMin = pos;
+		m_boundsMax = pos;
+		return;
+	}
+	m_boundsMin = Vector3(Math::min(m_boundsMin.x, pos.x), Math::min(m_boundsMin.y, pos.y), Math::min(m_boundsMin.z, pos.z));
+	m_boundsMax = Vector3(Math::max(m_boundsMax.x, pos.x), Math::max(m_boundsMax.y, pos.y), Math::max(m_boundsMax.z, pos.z));
+}
+
+bbe::SpatialHashGrid::SpatialHashGrid(float cellSize, size_t amountOfBuckets)
+{
+	if (cellSize <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+	if (amountOfBuckets == 0 || (amountOfBuckets & (amountOfBuckets - 1)) != 0)
+	{
+		//Must be a power of two so the hash can be masked.
+		throw IllegalArgumentException();
+	}
+
+	m_cellSize = cellSize;
+	m_cellSizeInv = 1.0f / cellSize;
+	m_bucketMask = amountOfBuckets - 1;
+	m_buckets.resizeCapacityAndLength(amountOfBuckets);
+}
+
+void bbe::SpatialHashGrid::clear()
+{
+	for (size_t i = 0; i < m_buckets.getLength(); i++)
+	{
+		m_buckets[i].clear();
+	}
+	m_positions.clear();
+	m_cells.clear();
+}
+
+size_t bbe::SpatialHashGrid::add(const Vector3 & pos)
+{
+	const uint32_t index = (uint32_t)m_positions.getLength();
+	m_positions.add(pos);
+	m_cells.add(getCell(pos));
+	insertIntoBucket(index);
+	growBounds(pos);
+	return index;
+}
+
+void bbe::SpatialHashGrid::addAll(const Vector3 * positions, size_t amount)
+{
+	m_positions.resizeCapacity(m_positions.getLength() + amount);
+	m_cells.resizeCapacity(m_cells.getLength() + amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		add(positions[i]);
+	}
+}
+
+void bbe::SpatialHashGrid::addAll(const float * xs, const float * ys, const float * zs, size_t amount)
+{
+	m_positions.resizeCapacity(m_positions.getLength() + amount);
+	m_cells.resizeCapacity(m_cells.getLength() + amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		add(Vector3(xs[i], ys[i], zs[i]));
+	}
+}
+
+void bbe::SpatialHashGrid::set(size_t index, const Vector3 & pos)
+{
+	if (index >= m_positions.getLength())
+	{
+		throw IllegalIndexException();
+	}
+
+	m_positions[index] = pos;
+	growBounds(pos);
+
+	const Cell cell = getCell(pos);
+	if (cell == m_cells[index])
+	{
+		//Still in the same cell, the buckets do not have to be touched.
+		return;
+	}
+
+	removeFromBucket((uint32_t)index);
+	m_cells[index] = cell;
+	insertIntoBucket((uint32_t)index);
+}
+
+void bbe::SpatialHashGrid::setAll(const Vector3 * positions, size_t amount)
+{
+	if (amount != m_positions.getLength())
+	{
+		throw IllegalArgumentException();
+	}
+	for (size_t i = 0; i < amount; i++)
+	{
+		set(i, positions[i]);
+	}
+}
+
+void bbe::SpatialHashGrid::setAll(const float * xs, const float * ys, const float * zs, size_t amount)
+{
+	if (amount != m_positions.getLength())
+	{
+		throw IllegalArgumentException();
+	}
+	for (size_t i = 0; i < amount; i++)
+	{
+		set(i, Vector3(xs[i], ys[i], zs[i]));
+	}
+}
+
+bbe::Vector3 bbe::SpatialHashGrid::getPosition(size_t index) const
+{
+	if (index >= m_positions.getLength())
+	{
+		throw IllegalIndexException();
+	}
+	return m_positions[index];
+}
+
+size_t bbe::SpatialHashGrid::getLength() const
+{
+	return m_positions.getLength();
+}
+
+float bbe::SpatialHashGrid::getCellSize() const
+{
+	return m_cellSize;
+}
+
+void bbe::SpatialHashGrid::queryRadius(const Vector3 & center, float radius, List<size_t>& outIndices) const
+{
+	outIndices.clear();
+	forEachInRadius(center, radius, [&](size_t index, const Vector3 &pos, float distanceSq)
+	{
+		outIndices.add(index);
+	});
+}
+
+void bbe::SpatialHashGrid::queryKNearest(const Vector3 & pos, size_t k, List<size_t>& outIndices, float maxDistance) const
+{
+	outIndices.clear();
+	if (k == 0 || m_positions.getLength() == 0)
+	{
+		return;
+	}
+
+	struct Candidate
+	{
+		float distanceSq;
+		size_t index;
+		bool operator<(const Candidate &other) const
+		{
+			return distanceSq < other.distanceSq || (distanceSq == other.distanceSq && index < other.index);
+		}
+	};
+
+	//Everything is within this radius of pos, so the search can stop growing once it is reached.
+	const Vector3 farthestCorner(
+		Math::max(Math::abs(pos.x - m_boundsMin.x), Math::abs(pos.x - m_boundsMax.x)),
+		Math::max(Math::abs(pos.y - m_boundsMin.y), Math::abs(pos.y - m_boundsMax.y)),
+		Math::max(Math::abs(pos.z - m_boundsMin.z), Math::abs(pos.z - m_boundsMax.z))
+	);
+	const float limit = Math::min(farthestCorner.getLength(), maxDistance);
+
+	List<Candidate> candidates;
+	float radius = Math::min(m_cellSize, limit);
+	while (true)
+	{
+		candidates.clear();
+		forEachInRadius(pos, radius, [&](size_t index, const Vector3 &p, float distanceSq)
+		{
+			candidates.add(Candidate{ distanceSq, index });
+		});
+
+		//Only once k points were found inside the radius it is guaranteed that there are no closer ones outside of it.
+		if (candidates.getLength() >= k || radius >= limit)
+		{
+			break;
+		}
+		radius = Math::min(radius * 2, limit);
+	}
+
+	const size_t amount = candidates.getLength() < k ? candidates.getLength() : k;
+	std::partial_sort(candidates.begin(), candidates.begin() + amount, candidates.end());
+	outIndices.resizeCapacity(amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		outIndices.add(candidates[i].index);
+	}
+}
+
+int64_t bbe::SpatialHashGrid::queryNearest(const Vector3 & pos, float maxDistance) const
+{
+	List<size_t> indices;
+	queryKNearest(pos, 1, indices, maxDistance);
+	if (indices.getLength() == 0)
+	{
+		return -1;
+	}
+	return (int64_t)indices[0];
+}
@@ -0,0 +1,396 @@
+#include "stdafx.h"
+#include "BBE/StreamingTerrain.h"
+#include "BBE/Random.h"
+#include "BBE/Rectangle.h"
+#include "BBE/Math.h"
+
+const int   bbe::StreamingTerrain::PATCH_RESOLUTION = 257;
+const float bbe::StreamingTerrain::PATCH_SIZE       = 128;
+
+bbe::StreamingTerrain::PatchRequest::PatchRequest(int patchX, int patchY)
+	: m_patchX(patchX), m_patchY(patchY), m_cancelled(false)
+{
+}
+
+float bbe::StreamingTerrain::getDistanceToPatch(const Vector2 & localCameraPos, int patchX, int patchY) const
+{
+	Rectangle patch(patchX * PATCH_SIZE, patchY * PATCH_SIZE, PATCH_SIZE, PATCH_SIZE);
+	return patch.getDistanceTo(localCameraPos);
+}
+
+bbe::Matrix4 bbe::StreamingTerrain::getPatchTransform(int patchX, int patchY) const
+{
+	return Matrix4::createTranslationMatrix(Vector3(patchX * PATCH_SIZE, patchY * PATCH_SIZE, 0)) * m_transform;
+}
+
+void bbe::StreamingTerrain::generate(PatchRequest * request)
+{
+	if (!request->m_cancelled)
+	{
+		//Rows of a patch run along x. The samples are addressed by their global index, so the border rows
+		//and columns of neighbouring patches are identical. One more sample is generated on every side for
+		//the normals on the edges of the patch.
+		const int samplesPerPatch = PATCH_RESOLUTION - 1;
+		const int regionResolution = PATCH_RESOLUTION + 2;
+		List<float> region;
+		region.resizeCapacityAndLength(regionResolution * regionResolution);
+		m_heightNoise.getRegion(region.getRaw(), request->m_patchY * samplesPerPatch - 1, request->m_patchX * samplesPerPatch - 1, regionResolution, regionResolution, 1.0f / samplesPerPatch);
+		for (size_t i = 0; i < region.getLength(); i++)
+		{
+			region[i] = Math::clamp(region[i] * 0.5f + 0.5f, 0, 1);
+		}
+
+		float* data = new float[PATCH_RESOLUTION * PATCH_RESOLUTION];
+		float* borders = new float[TerrainPatch::getAmountOfBorderHeights()];
+		for (int i = 0; i < PATCH_RESOLUTION; i++)
+		{
+			for (int k = 0; k < PATCH_RESOLUTION; k++)
+			{
+				data[i * PATCH_RESOLUTION + k] = region[(i + 1) * regionResolution + k + 1];
+			}
+			borders[i]                        = region[i + 1];
+			borders[PATCH_RESOLUTION + i]     = region[(regionResolution - 1) * regionResolution + i + 1];
+			borders[PATCH_RESOLUTION * 2 + i] = region[(i + 1) * regionResolution];
+			borders[PATCH_RESOLUTION * 3 + i] = region[(i + 1) * regionResolution + regionResolution - 1];
+		}
+		request->m_pdata = data;
+		request->m_pborders = borders;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	request->m_finished = true;
+	m_amountOfRunningRequests--;
+	m_requestFinished.notify_all();
+}
+
+void bbe::StreamingTerrain::request(int patchX, int patchY)
+{
+	PatchRequest* patchRequest = new PatchRequest(patchX, patchY);
+	m_requests.add(patchRequest);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_amountOfRunningRequests++;
+	}
+	m_threadPool.enqueue([this, patchRequest]()
+	{
+		generate(patchRequest);
+	});
+}
+
+void bbe::StreamingTerrain::collectFinishedRequests()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < m_requests.getLength(); i++)
+	{
+		PatchRequest* patchRequest = m_requests[i];
+		if (!patchRequest->m_finished)
+		{
+			continue;
+		}
+
+		if (!patchRequest->m_cancelled && patchRequest->m_pdata != nullptr)
+		{
+			ResidentPatch resident;
+			resident.m_patchX = patchRequest->m_patchX;
+			resident.m_patchY = patchRequest->m_patchY;
+			resident.m_ppatch = new TerrainPatch(PATCH_RESOLUTION, PATCH_RESOLUTION, patchRequest->m_pdata, patchRequest->m_pborders, patchRequest->m_patchX, patchRequest->m_patchY);
+			resident.m_ppatch->setTransform(getPatchTransform(resident.m_patchX, resident.m_patchY));
+			resident.m_lastUsedFrame = m_frame;
+			resident.m_distance = Math::INFINITY_POSITIVE;
+			m_residentPatches.add(resident);
+		}
+
+		delete[] patchRequest->m_pdata;
+		delete[] patchRequest->m_pborders;
+		delete patchRequest;
+		m_requests.removeIndex(i);
+		i--;
+	}
+}
+
+void bbe::StreamingTerrain::evict(size_t index)
+{
+	//The buffers may still be used by the frame that is currently recorded.
+	m_residentPatches[index].m_ppatch->destroyAtEndOfFrame();
+	delete m_residentPatches[index].m_ppatch;
+	m_residentPatches.removeIndex(index);
+}
+
+void bbe::StreamingTerrain::uploadPatches()
+{
+	for (int upload = 0; upload < m_maxUploadsPerFrame; upload++)
+	{
+		ResidentPatch* nearest = nullptr;
+		for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+		{
+			if (!m_residentPatches[i].m_ppatch->m_created && (nearest == nullptr || m_residentPatches[i].m_distance < nearest->m_distance))
+			{
+				nearest = &m_residentPatches[i];
+			}
+		}
+		if (nearest == nullptr)
+		{
+			return;
+		}
+		nearest->m_ppatch->init();
+	}
+}
+
+bbe::StreamingTerrain::StreamingTerrain()
+	: StreamingTerrain(Random().randomUInt())
+{
+}
+
+bbe::StreamingTerrain::StreamingTerrain(uint64_t seed, size_t amountOfThreads)
+	: m_heightNoise(seed), m_threadPool(amountOfThreads)
+{
+	m_heightNoise.setOctaves(6);
+	m_heightNoise.setFrequency(0.5f);
+}
+
+bbe::StreamingTerrain::~StreamingTerrain()
+{
+	for (size_t i = 0; i < m_requests.getLength(); i++)
+	{
+		m_requests[i]->m_cancelled = true;
+	}
+	waitForRequests();
+	for (size_t i = 0; i < m_requests.getLength(); i++)
+	{
+		delete[] m_requests[i]->m_pdata;
+		delete[] m_requests[i]->m_pborders;
+		delete m_requests[i];
+	}
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		delete m_residentPatches[i].m_ppatch;
+	}
+}
+
+void bbe::StreamingTerrain::setLoadRadius(float loadRadius, float unloadRadius)
+{
+	if (loadRadius < 0 || unloadRadius < loadRadius)
+	{
+		throw IllegalArgumentException();
+	}
+	m_loadRadius = loadRadius;
+	m_unloadRadius = unloadRadius;
+}
+
+void bbe::StreamingTerrain::setMaxResidentPatches(size_t maxResidentPatches)
+{
+	if (maxResidentPatches == 0)
+	{
+		throw IllegalArgumentException();
+	}
+	m_maxResidentPatches = maxResidentPatches;
+}
+
+void bbe::StreamingTerrain::setMaxUploadsPerFrame(int maxUploadsPerFrame)
+{
+	if (maxUploadsPerFrame < 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_maxUploadsPerFrame = maxUploadsPerFrame;
+}
+
+float bbe::StreamingTerrain::getLoadRadius() const
+{
+	return m_loadRadius;
+}
+
+float bbe::StreamingTerrain::getUnloadRadius() const
+{
+	return m_unloadRadius;
+}
+
+size_t bbe::StreamingTerrain::getMaxResidentPatches() const
+{
+	return m_maxResidentPatches;
+}
+
+int bbe::StreamingTerrain::getMaxUploadsPerFrame() const
+{
+	return m_maxUploadsPerFrame;
+}
+
+bbe::Matrix4 bbe::StreamingTerrain::getTransform() const
+{
+	return m_transform;
+}
+
+void bbe::StreamingTerrain::setTransform(const Vector3 & pos, const Vector3 & scale, const Vector3 & rotationVector, float radians)
+{
+	setTransform(Matrix4::createTransform(pos, scale, rotationVector, radians));
+}
+
+void bbe::StreamingTerrain::setTransform(const Matrix4 & transform)
+{
+	m_transform = transform;
+	m_inverseTransform = transform.inverse();
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		m_residentPatches[i].m_ppatch->setTransform(getPatchTransform(m_residentPatches[i].m_patchX, m_residentPatches[i].m_patchY));
+	}
+}
+
+void bbe::StreamingTerrain::update(const Vector3 & cameraPos)
+{
+	m_frame++;
+	collectFinishedRequests();
+
+	const Vector3 localCameraPos3D = m_inverseTransform * cameraPos;
+	const Vector2 localCameraPos(localCameraPos3D.x, localCameraPos3D.y);
+
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		m_residentPatches[i].m_distance = getDistanceToPatch(localCameraPos, m_residentPatches[i].m_patchX, m_residentPatches[i].m_patchY);
+	}
+
+	//Requests that left the unload radius are not worth finishing.
+	for (size_t i = 0; i < m_requests.getLength(); i++)
+	{
+		if (getDistanceToPatch(localCameraPos, m_requests[i]->m_patchX, m_requests[i]->m_patchY) > m_unloadRadius)
+		{
+			m_requests[i]->m_cancelled = true;
+		}
+	}
+
+	struct WantedPatch
+	{
+		int   m_patchX;
+		int   m_patchY;
+		float m_distance;
+	};
+	List<WantedPatch> wanted;
+	const int centerX = (int)Math::floor(localCameraPos.x / PATCH_SIZE);
+	const int centerY = (int)Math::floor(localCameraPos.y / PATCH_SIZE);
+	const int reach = (int)(m_loadRadius / PATCH_SIZE) + 1;
+	for (int x = centerX - reach; x <= centerX + reach; x++)
+	{
+		for (int y = centerY - reach; y <= centerY + reach; y++)
+		{
+			const float distance = getDistanceToPatch(localCameraPos, x, y);
+			if (distance <= m_loadRadius)
+			{
+				wanted.add({ x, y, distance });
+			}
+		}
+	}
+	wanted.sort([](const WantedPatch &a, const WantedPatch &b)
+	{
+		return a.m_distance < b.m_distance;
+	});
+	if (wanted.getLength() > m_maxResidentPatches)
+	{
+		wanted.popBack(wanted.getLength() - m_maxResidentPatches);
+	}
+
+	List<WantedPatch> missing;
+	for (size_t i = 0; i < wanted.getLength(); i++)
+	{
+		bool found = false;
+		for (size_t k = 0; k < m_residentPatches.getLength(); k++)
+		{
+			if (m_residentPatches[k].m_patchX == wanted[i].m_patchX && m_residentPatches[k].m_patchY == wanted[i].m_patchY)
+			{
+				m_residentPatches[k].m_lastUsedFrame = m_frame;
+				found = true;
+				break;
+			}
+		}
+		for (size_t k = 0; k < m_requests.getLength() && !found; k++)
+		{
+			if (m_requests[k]->m_patchX == wanted[i].m_patchX && m_requests[k]->m_patchY == wanted[i].m_patchY && !m_requests[k]->m_cancelled)
+			{
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			missing.add(wanted[i]);
+		}
+	}
+	//The pool runs the last enqueued job first, so the nearest patch is enqueued last.
+	for (size_t i = missing.getLength(); i > 0; i--)
+	{
+		request(missing[i - 1].m_patchX, missing[i - 1].m_patchY);
+	}
+
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		if (m_residentPatches[i].m_distance > m_unloadRadius)
+		{
+			evict(i);
+			i--;
+		}
+	}
+	while (m_residentPatches.getLength() > m_maxResidentPatches)
+	{
+		size_t leastRecentlyUsed = 0;
+		for (size_t i = 1; i < m_residentPatches.getLength(); i++)
+		{
+			const ResidentPatch &candidate = m_residentPatches[i];
+			const ResidentPatch &current = m_residentPatches[leastRecentlyUsed];
+			if (candidate.m_lastUsedFrame < current.m_lastUsedFrame
+				|| (candidate.m_lastUsedFrame == current.m_lastUsedFrame && candidate.m_distance > current.m_distance))
+			{
+				leastRecentlyUsed = i;
+			}
+		}
+		evict(leastRecentlyUsed);
+	}
+}
+
+void bbe::StreamingTerrain::waitForRequests()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_requestFinished.wait(lock, [this] { return m_amountOfRunningRequests == 0; });
+}
+
+size_t bbe::StreamingTerrain::getAmountOfResidentPatches() const
+{
+	return m_residentPatches.getLength();
+}
+
+size_t bbe::StreamingTerrain::getAmountOfRequestedPatches() const
+{
+	size_t amount = 0;
+	for (size_t i = 0; i < m_requests.getLength(); i++)
+	{
+		if (!m_requests[i]->m_cancelled)
+		{
+			amount++;
+		}
+	}
+	return amount;
+}
+
+const bbe::TerrainPatch * bbe::StreamingTerrain::getPatch(int patchX, int patchY) const
+{
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		if (m_residentPatches[i].m_patchX == patchX && m_residentPatches[i].m_patchY == patchY)
+		{
+			return m_residentPatches[i].m_ppatch;
+		}
+	}
+	return nullptr;
+}
+
+bool bbe::StreamingTerrain::intersects(const Ray & ray, float & outT, float maxT) const
+{
+	bool hit = false;
+	for (size_t i = 0; i < m_residentPatches.getLength(); i++)
+	{
+		float t;
+		if (m_residentPatches[i].m_ppatch->intersects(ray, t, maxT))
+		{
+			hit = true;
+			maxT = t;
+			outT = t;
+		}
+	}
+	return hit;
+}
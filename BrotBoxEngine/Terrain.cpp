@@ -1,195 +1,597 @@
 #include "stdafx.h"
 #include "BBE/Terrain.h"
-#include "BBE/VertexWithNormal.h"
 #include "BBE/Random.h"
+#include "BBE/SplitMix64.h"
 #include "BBE/Math.h"
 #include "BBE/ValueNoise2D.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/VulkanUploadBatcher.h"
+#include <cstdio>
+#include <mutex>
 
+//Bump TERRAIN_CACHE_VERSION whenever the generation of the heights or the vertices changes.
+static const uint32_t TERRAIN_CACHE_MAGIC   = 0x43544242; //"BBTC"
+static const uint32_t TERRAIN_CACHE_VERSION = 3;
+
+struct TerrainCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	int32_t  patchesWidthAmount;
+	int32_t  patchesHeightAmount;
+	int32_t  verticesPerPatch;
+	int32_t  padding;
+};
+
+//The cache files that are mapped by a terrain of this process. They are never removed as stale files, so a
+//file stays usable on every platform, whether or not it could delete mapped files.
+static std::mutex mappedCacheFilesMutex;
+static bbe::List<bbe::String> mappedCacheFiles;
+
+static bool isCacheKey(const wchar_t* key)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		if (!((key[i] >= L'0' && key[i] <= L'9') || (key[i] >= L'a' && key[i] <= L'f')))
+		{
+			return false;
+		}
+	}
+	return key[16] == L'\0';
+}
+
+static void removeStaleCacheFiles(const bbe::String &cacheFilePath, const bbe::String &keptCacheFilePath)
+{
+	//Every key gets its own file, so the files of old parameters would pile up otherwise. Files that can not
+	//be deleted are left for the next terrain that writes a cache.
+	const bbe::String prefix = cacheFilePath + ".";
+	const bbe::List<bbe::String> files = bbe::simpleFile::findFilesWithPrefix(prefix);
+	std::lock_guard<std::mutex> lock(mappedCacheFilesMutex);
+	for (size_t i = 0; i < files.getLength(); i++)
+	{
+		if (files[i] != keptCacheFilePath && isCacheKey(files[i].getRaw() + prefix.getLength()) && !mappedCacheFiles.contains(files[i]))
+		{
+			bbe::simpleFile::deleteFile(files[i]);
+		}
+	}
+}
+
+static void checkTerrainSize(int width, int height)
+{
+	if (width % 256 != 0)
+	{
+		throw bbe::IllegalArgumentException();
+	}
+	if (height % 256 != 0)
+	{
+		throw bbe::IllegalArgumentException();
+	}
+}
+
+static uint64_t addToCacheKey(uint64_t key, uint64_t value)
+{
+	return bbe::SplitMix64::mix(key ^ value) + key;
+}
+
+static uint64_t addToCacheKey(uint64_t key, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return addToCacheKey(key, (uint64_t)bits);
+}
+
+//Everything that changes the content of the cache file. The tile size of the heightfield is left out,
+//because the result does not depend on it.
+static uint64_t createCacheKey(int width, int height, uint64_t seed, const bbe::Heightfield &heightfield)
+{
+	const bbe::ValueNoise2D valueNoise;
+	uint64_t key = TERRAIN_CACHE_VERSION;
+	key = addToCacheKey(key, (uint64_t)width);
+	key = addToCacheKey(key, (uint64_t)height);
+	key = addToCacheKey(key, seed);
+	key = addToCacheKey(key, (uint64_t)valueNoise.getOctaves());
+	key = addToCacheKey(key, (uint64_t)valueNoise.getStartFrequencyX());
+	key = addToCacheKey(key, (uint64_t)valueNoise.getStartFrequencyY());
+	key = addToCacheKey(key, valueNoise.getStartAlpha());
+	key = addToCacheKey(key, valueNoise.getAlphaChange());
+	key = addToCacheKey(key, (uint64_t)valueNoise.getFrequencyChange());
+	key = addToCacheKey(key, (uint64_t)heightfield.getThermalIterations());
+	key = addToCacheKey(key, (uint64_t)heightfield.getHydraulicIterations());
+	key = addToCacheKey(key, heightfield.getTalus());
+	key = addToCacheKey(key, heightfield.getThermalStrength());
+	key = addToCacheKey(key, heightfield.getRain());
+	key = addToCacheKey(key, heightfield.getSolubility());
+	key = addToCacheKey(key, heightfield.getEvaporation());
+	key = addToCacheKey(key, heightfield.getSedimentCapacity());
+	key = addToCacheKey(key, (uint64_t)bbe::TerrainPatch::PATCH_RESOLUTION);
+	key = addToCacheKey(key, (uint64_t)bbe::Terrain::AMOUNT_OF_LOD_LEVELS);
+	key = addToCacheKey(key, (uint64_t)sizeof(bbe::TerrainVertex));
+	return key;
+}
+
+static int getVerticesPerPatch()
+{
+	int amountOfVertices = 0;
+	for (int lod = 0; lod < bbe::Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
+	{
+		amountOfVertices += bbe::TerrainPatch::getAmountOfLodVertices(lod);
+	}
+	return amountOfVertices;
+}
+
+static size_t getCacheHeightsSize()
+{
+	return sizeof(float) * bbe::TerrainPatch::PATCH_RESOLUTION * bbe::TerrainPatch::PATCH_RESOLUTION;
+}
+
+//The full resolution heights of a patch, its borders and the vertices of all its lod levels.
+static size_t getCachePatchSize()
+{
+	return getCacheHeightsSize() + sizeof(float) * bbe::TerrainPatch::getAmountOfBorderHeights() + sizeof(bbe::TerrainVertex) * getVerticesPerPatch();
+}
 
 VkDevice         bbe::TerrainPatch::s_device         = VK_NULL_HANDLE;
 VkPhysicalDevice bbe::TerrainPatch::s_physicalDevice = VK_NULL_HANDLE;
-VkQueue          bbe::TerrainPatch::s_queue          = VK_NULL_HANDLE;
-bbe::INTERNAL::vulkan::VulkanCommandPool *bbe::TerrainPatch::s_pcommandPool = nullptr;
-const int bbe::Terrain::AMOUNT_OF_LOD_LEVELS = 4;
-static bbe::Random random;
-
-void bbe::TerrainPatch::s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool & commandPool, VkQueue queue)
+bbe::INTERNAL::vulkan::VulkanUploadBatcher *bbe::TerrainPatch::s_puploadBatcher = nullptr;
+bbe::List<bbe::INTERNAL::vulkan::VulkanBuffer> bbe::TerrainPatch::s_indexBuffers;
+bbe::List<int> bbe::TerrainPatch::s_amountOfIndices;
+const int bbe::TerrainPatch::PATCH_RESOLUTION     = 257;
+const int bbe::TerrainPatch::EDGE_NEGATIVE_X      = 1;
+const int bbe::TerrainPatch::EDGE_POSITIVE_X      = 2;
+const int bbe::TerrainPatch::EDGE_NEGATIVE_Y      = 4;
+const int bbe::TerrainPatch::EDGE_POSITIVE_Y      = 8;
+const int bbe::TerrainPatch::AMOUNT_OF_EDGE_MASKS = 16;
+const float bbe::TerrainPatch::HEIGHT_SCALE       = 100;
+const float bbe::TerrainPatch::VERTEX_DISTANCE    = 0.5f;
+const int bbe::Terrain::AMOUNT_OF_LOD_LEVELS = 6;
+
+void bbe::TerrainPatch::s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanUploadBatcher & uploadBatcher)
 {
 	s_device = device;
 	s_physicalDevice = physicalDevice;
-	s_queue = queue;
-	s_pcommandPool = &commandPool;
+	s_puploadBatcher = &uploadBatcher;
+
+	s_initIndexBuffers();
 }
 
-void bbe::TerrainPatch::init() const
+void bbe::TerrainPatch::s_initIndexBuffers()
 {
-	if (m_created)
+	for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
 	{
-		return;
+		for (int coarserEdges = 0; coarserEdges < AMOUNT_OF_EDGE_MASKS; coarserEdges++)
+		{
+			List<uint32_t> indices = createLodIndices(lod, coarserEdges);
+
+			INTERNAL::vulkan::VulkanBuffer indexBuffer;
+			indexBuffer.createAndUpload(*s_puploadBatcher, indices.getRaw(), sizeof(uint32_t) * indices.getLength(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+			s_amountOfIndices.add((int)indices.getLength());
+			s_indexBuffers.add(indexBuffer);
+		}
 	}
+}
 
-	initIndexBuffer();
-	initVertexBuffer();
+void bbe::TerrainPatch::s_destroy()
+{
+	for (size_t i = 0; i < s_indexBuffers.getLength(); i++)
+	{
+		s_indexBuffers[i].destroy();
+	}
+	s_indexBuffers.clear();
+	s_amountOfIndices.clear();
+}
 
-	m_created = true;
+bbe::List<uint32_t> bbe::TerrainPatch::createLodIndices(int lodLevel, int coarserEdges)
+{
+	if (lodLevel < 0 || lodLevel >= Terrain::AMOUNT_OF_LOD_LEVELS)
+	{
+		throw IllegalArgumentException();
+	}
+	if (coarserEdges < 0 || coarserEdges >= AMOUNT_OF_EDGE_MASKS)
+	{
+		throw IllegalArgumentException();
+	}
+
+	const int lodWidth = ((PATCH_RESOLUTION - 1) >> lodLevel) + 1;
+	const int last = lodWidth - 1;
+	auto index = [&](int row, int col) -> uint32_t
+	{
+		//Edges have an odd amount of vertices, so the corners are even and never collapse.
+		if ((row == 0 && (coarserEdges & EDGE_NEGATIVE_X)) || (row == last && (coarserEdges & EDGE_POSITIVE_X)))
+		{
+			col &= ~1;
+		}
+		if ((col == 0 && (coarserEdges & EDGE_NEGATIVE_Y)) || (col == last && (coarserEdges & EDGE_POSITIVE_Y)))
+		{
+			row &= ~1;
+		}
+		return row * lodWidth + col;
+	};
+
+	List<uint32_t> indices;
+	indices.resizeCapacity((lodWidth - 1) * (lodWidth * 2 + 1));
+	for (int col = 0; col < lodWidth - 1; col++)
+	{
+		for (int row = 0; row < lodWidth; row++)
+		{
+			indices.add(index(row, col));
+			indices.add(index(row, col + 1));
+		}
+		indices.add(0xFFFFFFFF);
+	}
+
+	return indices;
 }
 
-void bbe::TerrainPatch::initIndexBuffer() const
+void bbe::TerrainPatch::selectLodLevels(const int * patchXs, const int * patchYs, const float * distances, size_t amount, float lodDistance, int * outLodLevels, int * outCoarserEdges)
 {
-	int lodWidth = m_width;
-	int lodHeight = m_height;
-	for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
+	if (lodDistance <= 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	for (size_t i = 0; i < amount; i++)
 	{
-		List<uint32_t> indices;
+		int lodLevel = 0;
+		float limit = lodDistance;
+		while (lodLevel < Terrain::AMOUNT_OF_LOD_LEVELS - 1 && distances[i] >= limit)
+		{
+			lodLevel++;
+			limit *= 2;
+		}
+		outLodLevels[i] = lodLevel;
+	}
 
-		for (int i = 0; i < lodWidth - 1; i++)
+	//Sorted by position, so the neighbours can be found with a binary search.
+	List<size_t> order;
+	order.resizeCapacity(amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		order.add(i);
+	}
+	auto isBefore = [&](int x, int y, size_t other)
+	{
+		return x < patchXs[other] || (x == patchXs[other] && y < patchYs[other]);
+	};
+	order.sort([&](const size_t &a, const size_t &b) { return isBefore(patchXs[a], patchYs[a], b); });
+	auto find = [&](int x, int y) -> int
+	{
+		size_t low = 0;
+		size_t high = amount;
+		while (low < high)
 		{
-			for (int k = 0; k < lodHeight; k++)
+			const size_t mid = (low + high) / 2;
+			const size_t candidate = order[mid];
+			if (patchXs[candidate] == x && patchYs[candidate] == y)
+			{
+				return (int)candidate;
+			}
+			if (isBefore(x, y, candidate))
+			{
+				high = mid;
+			}
+			else
 			{
-				indices.add(k * lodWidth + i);
-				indices.add(k * lodWidth + i + 1);
+				low = mid + 1;
 			}
-			indices.add(0xFFFFFFFF);
 		}
+		return -1;
+	};
 
-		INTERNAL::vulkan::VulkanBuffer indexBuffer;
-
-		indexBuffer.create(s_device, s_physicalDevice, sizeof(uint32_t) * indices.getLength(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+	static const int neighbourEdges[] = { EDGE_NEGATIVE_X, EDGE_POSITIVE_X, EDGE_NEGATIVE_Y, EDGE_POSITIVE_Y };
+	List<int> neighbours;
+	neighbours.resizeCapacity(amount * 4);
+	for (size_t i = 0; i < amount; i++)
+	{
+		neighbours.add(find(patchXs[i] - 1, patchYs[i]    ));
+		neighbours.add(find(patchXs[i] + 1, patchYs[i]    ));
+		neighbours.add(find(patchXs[i]    , patchYs[i] - 1));
+		neighbours.add(find(patchXs[i]    , patchYs[i] + 1));
+	}
 
-		void *dataBuf = indexBuffer.map();
-		memcpy(dataBuf, indices.getRaw(), sizeof(uint32_t) * indices.getLength());
-		indexBuffer.unmap();
+	//Levels only ever go down, so this terminates after at most AMOUNT_OF_LOD_LEVELS passes.
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (size_t i = 0; i < amount; i++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				const int neighbour = neighbours[i * 4 + k];
+				if (neighbour >= 0 && outLodLevels[i] > outLodLevels[neighbour] + 1)
+				{
+					outLodLevels[i] = outLodLevels[neighbour] + 1;
+					changed = true;
+				}
+			}
+		}
+	}
 
-		indexBuffer.upload(*s_pcommandPool, s_queue);
+	for (size_t i = 0; i < amount; i++)
+	{
+		outCoarserEdges[i] = 0;
+		for (int k = 0; k < 4; k++)
+		{
+			const int neighbour = neighbours[i * 4 + k];
+			if (neighbour >= 0 && outLodLevels[neighbour] > outLodLevels[i])
+			{
+				outCoarserEdges[i] |= neighbourEdges[k];
+			}
+		}
+	}
+}
 
-		m_numberOfVertices.add(indices.getLength());
+void bbe::TerrainPatch::getMorphRange(int lodLevel, float lodDistance, float & outStart, float & outEnd)
+{
+	if (lodLevel < 0 || lodLevel >= Terrain::AMOUNT_OF_LOD_LEVELS)
+	{
+		throw IllegalArgumentException();
+	}
 
-		m_indexBuffers.add(indexBuffer);
+	if (lodLevel == Terrain::AMOUNT_OF_LOD_LEVELS - 1)
+	{
+		outStart = Math::INFINITY_POSITIVE;
+		outEnd = Math::INFINITY_POSITIVE;
+		return;
+	}
 
-		lodWidth /= 2;
-		lodHeight /= 2;
+	outEnd = lodDistance * (float)(1 << lodLevel);
+	outStart = outEnd * 0.75f;
+}
 
-		lodWidth += 1;
-		lodHeight += 1;
+void bbe::TerrainPatch::init() const
+{
+	if (m_created)
+	{
+		return;
 	}
-	
+
+	initVertexBuffer();
+
+	m_created = true;
 }
 
 void bbe::TerrainPatch::initVertexBuffer() const
 {
-	int lodWidth = m_width;
-	int lodHeight = m_height;
-	List<VertexWithNormal> verticesLast;
-	int lodWidthLast = m_width;
-	int lodHeightLast = m_height;
-	float distMultiplier = 0.5f;
-
+	const TerrainVertex* cachedVertices = m_plodVertices;
+	List<Vector3> normals;
+	if (cachedVertices == nullptr)
+	{
+		normals = createNormals();
+	}
 	for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
 	{
-		List<VertexWithNormal> vertices;
-
-		if (lod == 0)
+		List<TerrainVertex> vertices;
+		const TerrainVertex* source;
+		size_t amountOfVertices;
+		if (cachedVertices != nullptr)
 		{
-			
-
-			for (int i = 0; i < lodHeight; i++)
-			{
-				for (int k = 0; k < lodWidth; k++)
-				{
-					float height = m_pdata[i * lodWidth + k];
-					vertices.add(VertexWithNormal(Vector3(i * distMultiplier, k * distMultiplier, height * 100.0f), Vector3(0, 0, 1)));
-				}
-			}
+			source = cachedVertices;
+			amountOfVertices = getAmountOfLodVertices(lod);
+			cachedVertices += amountOfVertices;
 		}
 		else
 		{
-			for (int i = 0; i < lodHeight; i++)
+			vertices = createLodVertices(lod, normals);
+			source = vertices.getRaw();
+			amountOfVertices = vertices.getLength();
+		}
+
+		INTERNAL::vulkan::VulkanBuffer vertexBuffer;
+		vertexBuffer.createAndUpload(*s_puploadBatcher, source, sizeof(TerrainVertex) * amountOfVertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+		m_vertexBuffers.add(vertexBuffer);
+	}
+}
+
+bbe::List<bbe::Vector3> bbe::TerrainPatch::createNormals() const
+{
+	//The patch surrounded by its borders, transposed so that x of the heightfield runs along the rows. The
+	//corners are only used by the one sided differences on the borders, whose normals are dropped.
+	const int borderedWidth = m_height + 2;
+	const int borderedHeight = m_width + 2;
+	List<float> bordered;
+	bordered.resizeCapacityAndLength(borderedWidth * borderedHeight);
+	for (int col = -1; col <= m_width; col++)
+	{
+		for (int row = -1; row <= m_height; row++)
+		{
+			float height = 0;
+			if (row < 0)
 			{
-				for (int k = 0; k < lodWidth; k++)
-				{
-					float height = 0;
-					int parentX = k * 2;
-					int parentY = i * 2;
-
-					if (k == lodWidth - 1)
-					{
-						parentX = (k - 1) * 2;
-					}
-					if (i == lodHeight - 1)
-					{
-						parentY = (i - 1) * 2;
-					}
-
-					float val1 = verticesLast[parentX + parentY * lodHeightLast].m_pos.z;
-					float val2 = verticesLast[parentX + parentY * lodHeightLast + 1].m_pos.z;
-					float val3 = verticesLast[parentX + parentY * lodHeightLast + lodHeightLast].m_pos.z;
-					float val4 = verticesLast[parentX + parentY * lodHeightLast + lodHeightLast + 1].m_pos.z;
-
-					/*if ((i & 1) ^ (k & 1))
-					{
-						height = Math::max(val1, val2, val3, val4);
-					}
-					else
-					{
-						height = Math::min(val1, val2, val3, val4);
-					}*/
-
-					//height = (val1 + val2 + val3 + val4) / 4;
-
-					if (random.randomBool())
-					{
-						height = Math::max(val1, val2, val3, val4);
-					}
-					else
-					{
-						height = Math::min(val1, val2, val3, val4);
-					}
-
-					vertices.add(VertexWithNormal(Vector3(i * distMultiplier, k * distMultiplier, height), Vector3(0, 0, 1)));
-				}
+				if (col >= 0 && col < m_width) height = m_pborders[col];
+			}
+			else if (row >= m_height)
+			{
+				if (col >= 0 && col < m_width) height = m_pborders[m_width + col];
 			}
+			else if (col < 0)
+			{
+				height = m_pborders[m_width * 2 + row];
+			}
+			else if (col >= m_width)
+			{
+				height = m_pborders[m_width * 2 + m_height + row];
+			}
+			else
+			{
+				height = m_pdata[row * m_width + col];
+			}
+			bordered[(col + 1) * borderedWidth + row + 1] = height;
 		}
-		
+	}
 
-		INTERNAL::vulkan::VulkanBuffer vertexBuffer;
+	List<Vector3> borderedNormals;
+	borderedNormals.resizeCapacityAndLength(borderedWidth * borderedHeight);
+	Heightfield::computeNormals(bordered.getRaw(), borderedWidth, borderedHeight, VERTEX_DISTANCE, HEIGHT_SCALE, borderedNormals.getRaw());
 
-		vertexBuffer.create(s_device, s_physicalDevice, sizeof(VertexWithNormal) * vertices.getLength(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	List<Vector3> normals;
+	normals.resizeCapacityAndLength(m_width * m_height);
+	for (int row = 0; row < m_height; row++)
+	{
+		for (int col = 0; col < m_width; col++)
+		{
+			normals[row * m_width + col] = borderedNormals[(col + 1) * borderedWidth + row + 1];
+		}
+	}
+	return normals;
+}
 
-		void* dataBuf = vertexBuffer.map();
-		memcpy(dataBuf, vertices.getRaw(), sizeof(VertexWithNormal) * vertices.getLength());
-		vertexBuffer.unmap();
+bbe::List<bbe::TerrainVertex> bbe::TerrainPatch::createLodVertices(int lodLevel) const
+{
+	return createLodVertices(lodLevel, createNormals());
+}
 
-		vertexBuffer.upload(*s_pcommandPool, s_queue);
+bbe::List<bbe::TerrainVertex> bbe::TerrainPatch::createLodVertices(int lodLevel, const List<Vector3> &normals) const
+{
+	if (lodLevel < 0 || lodLevel >= Terrain::AMOUNT_OF_LOD_LEVELS)
+	{
+		throw IllegalArgumentException();
+	}
 
-		m_vertexBuffers.add(vertexBuffer);
-		lodWidthLast = lodWidth;
-		lodHeightLast = lodHeight;
+	//Every lod level takes every second vertex of the previous one, so the vertices that the levels share
+	//have exactly the same height and switching the level does not move the terrain.
+	const int step = 1 << lodLevel;
+	const int lodWidth = ((m_width - 1) >> lodLevel) + 1;
+	const int lodHeight = ((m_height - 1) >> lodLevel) + 1;
 
-		lodWidth /= 2;
-		lodHeight /= 2;
-		lodWidth += 1;
-		lodHeight += 1;
-		distMultiplier *= 2;
+	auto lodHeightAt = [&](int i, int k)
+	{
+		return m_pdata[i * step * m_width + k * step];
+	};
+	auto morphHeight = [&](int i, int k) -> float
+	{
+		const bool oddRow = (i & 1) != 0;
+		const bool oddCol = (k & 1) != 0;
+		if (oddRow && oddCol)
+		{
+			//The same diagonal as the triangles of createLodIndices.
+			return (lodHeightAt(i - 1, k + 1) + lodHeightAt(i + 1, k - 1)) * 0.5f;
+		}
+		if (oddRow)
+		{
+			return (lodHeightAt(i - 1, k) + lodHeightAt(i + 1, k)) * 0.5f;
+		}
+		if (oddCol)
+		{
+			return (lodHeightAt(i, k - 1) + lodHeightAt(i, k + 1)) * 0.5f;
+		}
+		if ((i == 0 || i == lodHeight - 1) && (k & 2) != 0)
+		{
+			return (lodHeightAt(i, k - 2) + lodHeightAt(i, k + 2)) * 0.5f;
+		}
+		if ((k == 0 || k == lodWidth - 1) && (i & 2) != 0)
+		{
+			return (lodHeightAt(i - 2, k) + lodHeightAt(i + 2, k)) * 0.5f;
+		}
+		return lodHeightAt(i, k);
+	};
 
-		verticesLast = std::move(vertices);
+	List<TerrainVertex> vertices;
+	vertices.resizeCapacity(lodWidth * lodHeight);
+	for (int i = 0; i < lodHeight; i++)
+	{
+		for (int k = 0; k < lodWidth; k++)
+		{
+			vertices.add(TerrainVertex(lodHeightAt(i, k), morphHeight(i, k), normals[i * step * m_width + k * step]));
+		}
 	}
-	
+	return vertices;
+}
+
+int bbe::TerrainPatch::getAmountOfLodVertices(int lodLevel)
+{
+	if (lodLevel < 0 || lodLevel >= Terrain::AMOUNT_OF_LOD_LEVELS)
+	{
+		throw IllegalArgumentException();
+	}
+
+	const int lodWidth = ((PATCH_RESOLUTION - 1) >> lodLevel) + 1;
+	return lodWidth * lodWidth;
+}
+
+void bbe::TerrainPatch::createBorders(const float * data, float * outBorders)
+{
+	//Continues the slope of the last two rows or columns, which gives the same normals on the edges as
+	//one sided differences.
+	const int last = PATCH_RESOLUTION - 1;
+	for (int i = 0; i < PATCH_RESOLUTION; i++)
+	{
+		outBorders[i]                        = 2 * data[i]                           - data[PATCH_RESOLUTION + i];
+		outBorders[PATCH_RESOLUTION + i]     = 2 * data[last * PATCH_RESOLUTION + i] - data[(last - 1) * PATCH_RESOLUTION + i];
+		outBorders[PATCH_RESOLUTION * 2 + i] = 2 * data[i * PATCH_RESOLUTION]        - data[i * PATCH_RESOLUTION + 1];
+		outBorders[PATCH_RESOLUTION * 3 + i] = 2 * data[i * PATCH_RESOLUTION + last] - data[i * PATCH_RESOLUTION + last - 1];
+	}
+}
+
+int bbe::TerrainPatch::getAmountOfBorderHeights()
+{
+	return PATCH_RESOLUTION * 4;
 }
 
 void bbe::TerrainPatch::destroy() const
 {
-	for (int i = 0; i < Terrain::AMOUNT_OF_LOD_LEVELS; i++)
+	//Patches that were never drawn have no buffers. The others may still be drawn by a frame in flight.
+	destroyAtEndOfFrame();
+}
+
+void bbe::TerrainPatch::destroyAtEndOfFrame() const
+{
+	for (size_t i = 0; i < m_vertexBuffers.getLength(); i++)
 	{
-		m_indexBuffers[i].destroy();
-		m_vertexBuffers[i].destroy();
+		m_vertexBuffers[i].destroyAtEndOfFrame();
 	}
 }
 
-bbe::TerrainPatch::TerrainPatch(int width, int height, float* data)
-	: m_width(width), m_height(height)
+bbe::TerrainPatch::TerrainPatch(int width, int height, float* data, int patchX, int patchY)
+	: TerrainPatch(width, height, data, nullptr, patchX, patchY)
 {
-	m_pdata = new float[width * height]; //TODO use allocator
-	memcpy(m_pdata, data, width * height * sizeof(float));
+}
+
+bbe::TerrainPatch::TerrainPatch(int width, int height, float* data, const float* borders, int patchX, int patchY)
+	: m_width(width), m_height(height), m_patchX(patchX), m_patchY(patchY)
+{
+	if (width != PATCH_RESOLUTION || height != PATCH_RESOLUTION)
+	{
+		throw IllegalArgumentException();
+	}
+
+	float* ownData = new float[width * height]; //TODO use allocator
+	memcpy(ownData, data, width * height * sizeof(float));
+	m_pdata = ownData;
+
+	float* ownBorders = new float[getAmountOfBorderHeights()];
+	if (borders != nullptr)
+	{
+		memcpy(ownBorders, borders, getAmountOfBorderHeights() * sizeof(float));
+	}
+	else
+	{
+		createBorders(data, ownBorders);
+	}
+	m_pborders = ownBorders;
+
+	initBoundingBox();
+}
+
+bbe::TerrainPatch::TerrainPatch(const float * data, const float * borders, const TerrainVertex * lodVertices, int patchX, int patchY)
+	: m_width(PATCH_RESOLUTION), m_height(PATCH_RESOLUTION), m_patchX(patchX), m_patchY(patchY), m_ownsData(false), m_pdata(data), m_pborders(borders), m_plodVertices(lodVertices)
+{
+	initBoundingBox();
+}
+
+void bbe::TerrainPatch::initBoundingBox()
+{
+	float minHeight = m_pdata[0];
+	float maxHeight = m_pdata[0];
+	for (int i = 1; i < m_width * m_height; i++)
+	{
+		minHeight = Math::min(minHeight, m_pdata[i]);
+		maxHeight = Math::max(maxHeight, m_pdata[i]);
+	}
+	m_localBoundingBox = BoundingBox(Vector3(0, 0, minHeight * HEIGHT_SCALE), Vector3((m_height - 1) * VERTEX_DISTANCE, (m_width - 1) * VERTEX_DISTANCE, maxHeight * HEIGHT_SCALE));
 }
 
 bbe::TerrainPatch::~TerrainPatch()
@@ -197,24 +599,34 @@ bbe::TerrainPatch::~TerrainPatch()
 	if (m_needsDestruction)
 	{
 		destroy();
-		delete[] m_pdata;
+		if (m_ownsData)
+		{
+			delete[] m_pdata;
+			delete[] m_pborders;
+		}
 	}
 }
 
 bbe::TerrainPatch::TerrainPatch(TerrainPatch && other)
 {
 	m_transform        = other.m_transform;
+	m_inverseTransform = other.m_inverseTransform;
 
-	m_indexBuffers     = other.m_indexBuffers     ;
 	m_vertexBuffers    = other.m_vertexBuffers    ;
-	m_numberOfVertices = other.m_numberOfVertices ;
 
 	m_width            = other.m_width            ;
 	m_height           = other.m_height           ;
+	m_patchX           = other.m_patchX           ;
+	m_patchY           = other.m_patchY           ;
 
 	m_created          = other.m_created          ;
 	m_needsDestruction = other.m_needsDestruction ;
+	m_ownsData         = other.m_ownsData         ;
 	m_pdata            = other.m_pdata            ;
+	m_pborders         = other.m_pborders         ;
+	m_plodVertices     = other.m_plodVertices     ;
+
+	m_localBoundingBox = other.m_localBoundingBox ;
 
 	other.m_needsDestruction = false;
 }
@@ -226,12 +638,90 @@ bbe::Matrix4 bbe::TerrainPatch::getTransform() const
 
 void bbe::TerrainPatch::setTransform(const Vector3 & pos, const Vector3 & scale, const Vector3 & rotationVector, float radians)
 {
-	m_transform = Matrix4::createTransform(pos, scale, rotationVector, radians);
+	setTransform(Matrix4::createTransform(pos, scale, rotationVector, radians));
 }
 
 void bbe::TerrainPatch::setTransform(const Matrix4 & transform)
 {
 	m_transform = transform;
+	m_inverseTransform = transform.inverse();
+}
+
+bbe::BoundingBox bbe::TerrainPatch::getBoundingBox() const
+{
+	return m_localBoundingBox.transform(m_transform);
+}
+
+bool bbe::TerrainPatch::intersects(const Ray & ray, float & outT, float maxT) const
+{
+	const Ray localRay = ray.transform(m_inverseTransform);
+	float tEnter;
+	if (!localRay.intersects(m_localBoundingBox, tEnter, maxT))
+	{
+		return false;
+	}
+
+	//Vertices are 0.5 units apart. Rows run along x, columns along y.
+	const float cellSize = VERTEX_DISTANCE;
+	const Vector3 origin = localRay.getOrigin();
+	const Vector3 direction = localRay.getDirection();
+	const Vector3 entry = localRay.getPoint(tEnter);
+	int row = (int)Math::clamp(Math::floor(entry.x / cellSize), 0, (float)(m_height - 2));
+	int col = (int)Math::clamp(Math::floor(entry.y / cellSize), 0, (float)(m_width - 2));
+
+	const int rowStep = direction.x > 0 ? 1 : -1;
+	const int colStep = direction.y > 0 ? 1 : -1;
+	const float rowDelta = direction.x != 0 ? Math::abs(cellSize / direction.x) : Math::INFINITY_POSITIVE;
+	const float colDelta = direction.y != 0 ? Math::abs(cellSize / direction.y) : Math::INFINITY_POSITIVE;
+	float rowNextT = direction.x != 0 ? ((row + (rowStep > 0 ? 1 : 0)) * cellSize - origin.x) / direction.x : Math::INFINITY_POSITIVE;
+	float colNextT = direction.y != 0 ? ((col + (colStep > 0 ? 1 : 0)) * cellSize - origin.y) / direction.y : Math::INFINITY_POSITIVE;
+
+	auto vertex = [&](int r, int c)
+	{
+		return Vector3(r * cellSize, c * cellSize, m_pdata[r * m_width + c] * HEIGHT_SCALE);
+	};
+
+	while (true)
+	{
+		//Same split into triangles as the index buffer.
+		bool hit = false;
+		float bestT = maxT;
+		float t;
+		if (localRay.intersectsTriangle(vertex(row, col), vertex(row, col + 1), vertex(row + 1, col), t, bestT))
+		{
+			hit = true;
+			bestT = t;
+		}
+		if (localRay.intersectsTriangle(vertex(row, col + 1), vertex(row + 1, col), vertex(row + 1, col + 1), t, bestT))
+		{
+			hit = true;
+			bestT = t;
+		}
+		if (hit)
+		{
+			outT = bestT;
+			return true;
+		}
+
+		float nextT;
+		if (rowNextT < colNextT)
+		{
+			row += rowStep;
+			nextT = rowNextT;
+			rowNextT += rowDelta;
+		}
+		else
+		{
+			col += colStep;
+			nextT = colNextT;
+			colNextT += colDelta;
+		}
+
+		if (row < 0 || row > m_height - 2 || col < 0 || col > m_width - 2 || nextT > maxT)
+		{
+			return false;
+		}
+	}
 }
 
 void bbe::Terrain::init() const
@@ -250,26 +740,72 @@ void bbe::Terrain::destroy() const
 	}
 }
 
-void bbe::Terrain::s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanCommandPool & commandPool, VkQueue queue)
+void bbe::Terrain::s_init(VkDevice device, VkPhysicalDevice physicalDevice, INTERNAL::vulkan::VulkanUploadBatcher & uploadBatcher)
 {
-	TerrainPatch::s_init(device, physicalDevice, commandPool, queue);
+	TerrainPatch::s_init(device, physicalDevice, uploadBatcher);
+}
+
+void bbe::Terrain::s_destroy()
+{
+	TerrainPatch::s_destroy();
 }
 
 bbe::Terrain::Terrain(int width, int height)
+	: Terrain(width, height, Random().randomUInt())
 {
-	if (width % 256 != 0)
+}
+
+bbe::Terrain::Terrain(int width, int height, uint64_t seed)
+	: Terrain(width, height, seed, Heightfield())
+{
+}
+
+bbe::Terrain::Terrain(int width, int height, uint64_t seed, const Heightfield &heightfield)
+{
+	ThreadPool threadPool;
+	createPatches(width, height, seed, heightfield, threadPool);
+
+	setTransform(Matrix4());
+}
+
+bbe::Terrain::Terrain(int width, int height, uint64_t seed, const Heightfield & heightfield, const String & cacheFilePath)
+{
+	checkTerrainSize(width, height);
+	m_patchesWidthAmount = width / 256;
+	m_patchesHeightAmount = height / 256;
+
+	const uint64_t key = createCacheKey(width, height, seed, heightfield);
+	//A mapped file can not be replaced on every platform, so every key gets its own file.
+	const String keyedCacheFilePath = getCacheFilePath(width, height, seed, heightfield, cacheFilePath);
+	if (loadCache(keyedCacheFilePath, key))
 	{
-		throw IllegalArgumentException();
+		m_cacheHit = true;
 	}
-	if (height % 256 != 0)
+	else
 	{
-		throw IllegalArgumentException();
+		ThreadPool threadPool;
+		createPatches(width, height, seed, heightfield, threadPool);
+		//If the cache can not be written the generated patches are simply kept.
+		if (writeCache(keyedCacheFilePath, key, threadPool))
+		{
+			loadCache(keyedCacheFilePath, key);
+			removeStaleCacheFiles(cacheFilePath, keyedCacheFilePath);
+		}
 	}
 
+	setTransform(Matrix4());
+}
+
+void bbe::Terrain::createPatches(int width, int height, uint64_t seed, const Heightfield & heightfield, ThreadPool & threadPool)
+{
+	checkTerrainSize(width, height);
+
 	m_patchesWidthAmount = width / 256;
 	m_patchesHeightAmount = height / 256;
+	SplitMix64 seeds(seed);
 	ValueNoise2D valueNoise;
-	valueNoise.create(width, height);
+	valueNoise.create(width, height, seeds.next(), &threadPool);
+	heightfield.erode(valueNoise.getRaw(), width, height, &threadPool);
 
 	for (int i = 0; i < m_patchesWidthAmount; i++)
 	{
@@ -283,16 +819,138 @@ bbe::Terrain::Terrain(int width, int height)
 					data[x * 257 + y] = valueNoise.get(i * 256 + x, k * 256 + y);
 				}
 			}
-			m_patches.add(TerrainPatch(257, 257, data));
+			//Only the edges of the whole terrain are extrapolated, the others take the heights of the neighbours.
+			float borders[257 * 4];
+			TerrainPatch::createBorders(data, borders);
+			for (int n = 0; n < 257; n++)
+			{
+				if (i > 0)                          borders[n]           = valueNoise.get(i * 256 - 1,   k * 256 + n);
+				if (i < m_patchesWidthAmount - 1)   borders[257 + n]     = valueNoise.get(i * 256 + 257, k * 256 + n);
+				if (k > 0)                          borders[257 * 2 + n] = valueNoise.get(i * 256 + n,   k * 256 - 1);
+				if (k < m_patchesHeightAmount - 1)  borders[257 * 3 + n] = valueNoise.get(i * 256 + n,   k * 256 + 257);
+			}
+			m_patches.add(TerrainPatch(257, 257, data, borders, i, k));
 		}
 	}
+}
+
+bool bbe::Terrain::loadCache(const String & cacheFilePath, uint64_t key)
+{
+	if (!m_cacheFile.open(cacheFilePath))
+	{
+		return false;
+	}
 
-	setTransform(Matrix4());
+	const int amountOfPatches = m_patchesWidthAmount * m_patchesHeightAmount;
+	const int verticesPerPatch = getVerticesPerPatch();
+	const size_t patchSize = getCachePatchSize();
+	const TerrainCacheHeader* header = (const TerrainCacheHeader*)m_cacheFile.getData();
+	if (m_cacheFile.getSize() != sizeof(TerrainCacheHeader) + amountOfPatches * patchSize
+		|| header->magic != TERRAIN_CACHE_MAGIC
+		|| header->version != TERRAIN_CACHE_VERSION
+		|| header->key != key
+		|| header->patchesWidthAmount != m_patchesWidthAmount
+		|| header->patchesHeightAmount != m_patchesHeightAmount
+		|| header->verticesPerPatch != verticesPerPatch)
+	{
+		m_cacheFile.close();
+		return false;
+	}
+
+	List<TerrainPatch> patches;
+	const char* patchData = m_cacheFile.getData() + sizeof(TerrainCacheHeader);
+	for (int i = 0; i < m_patchesWidthAmount; i++)
+	{
+		for (int k = 0; k < m_patchesHeightAmount; k++)
+		{
+			const float* heights = (const float*)patchData;
+			const float* borders = (const float*)(patchData + getCacheHeightsSize());
+			const TerrainVertex* lodVertices = (const TerrainVertex*)(patchData + getCacheHeightsSize() + sizeof(float) * TerrainPatch::getAmountOfBorderHeights());
+			patches.add(TerrainPatch(heights, borders, lodVertices, i, k));
+			patchData += patchSize;
+		}
+	}
+	//Assigning a List does not destroy its old elements.
+	m_patches.clear();
+	m_patches = std::move(patches);
+
+	m_cacheFilePath = cacheFilePath;
+	std::lock_guard<std::mutex> lock(mappedCacheFilesMutex);
+	mappedCacheFiles.add(cacheFilePath);
+	return true;
+}
+
+bool bbe::Terrain::writeCache(const String & cacheFilePath, uint64_t key, ThreadPool & threadPool) const
+{
+	simpleFile::BinaryFileWriter writer(cacheFilePath);
+
+	TerrainCacheHeader header;
+	header.magic = TERRAIN_CACHE_MAGIC;
+	header.version = TERRAIN_CACHE_VERSION;
+	header.key = key;
+	header.patchesWidthAmount = m_patchesWidthAmount;
+	header.patchesHeightAmount = m_patchesHeightAmount;
+	header.verticesPerPatch = getVerticesPerPatch();
+	header.padding = 0;
+	writer.write(&header, sizeof(header));
+
+	//The lod vertices of a few patches at a time are created in parallel, so the whole terrain never has
+	//to be held in memory twice.
+	const size_t patchesPerBatch = threadPool.getAmountOfThreads() + 1;
+	List<List<TerrainVertex>> lodVertices;
+	lodVertices.resizeCapacityAndLength(patchesPerBatch * AMOUNT_OF_LOD_LEVELS);
+	for (size_t batchStart = 0; batchStart < m_patches.getLength(); batchStart += patchesPerBatch)
+	{
+		const size_t batchEnd = batchStart + patchesPerBatch < m_patches.getLength() ? batchStart + patchesPerBatch : m_patches.getLength();
+		threadPool.parallelFor(0, batchEnd - batchStart, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const TerrainPatch &patch = m_patches[batchStart + i];
+				const List<Vector3> normals = patch.createNormals();
+				for (int lod = 0; lod < AMOUNT_OF_LOD_LEVELS; lod++)
+				{
+					lodVertices[i * AMOUNT_OF_LOD_LEVELS + lod] = patch.createLodVertices(lod, normals);
+				}
+			}
+		});
+
+		for (size_t i = batchStart; i < batchEnd; i++)
+		{
+			const TerrainPatch &patch = m_patches[i];
+			writer.write(patch.m_pdata, sizeof(float) * patch.m_width * patch.m_height);
+			writer.write(patch.m_pborders, sizeof(float) * TerrainPatch::getAmountOfBorderHeights());
+			for (int lod = 0; lod < AMOUNT_OF_LOD_LEVELS; lod++)
+			{
+				const List<TerrainVertex> &vertices = lodVertices[(i - batchStart) * AMOUNT_OF_LOD_LEVELS + lod];
+				writer.write(vertices.getRaw(), sizeof(TerrainVertex) * vertices.getLength());
+			}
+		}
+	}
+
+	return writer.commit();
 }
 
 bbe::Terrain::~Terrain()
 {
 	destroy();
+	if (m_cacheFile.isOpen())
+	{
+		std::lock_guard<std::mutex> lock(mappedCacheFilesMutex);
+		mappedCacheFiles.removeSingle(m_cacheFilePath);
+	}
+}
+
+bool bbe::Terrain::wasCacheHit() const
+{
+	return m_cacheHit;
+}
+
+bbe::String bbe::Terrain::getCacheFilePath(int width, int height, uint64_t seed, const Heightfield & heightfield, const String & cacheFilePath)
+{
+	char keyString[17];
+	snprintf(keyString, sizeof(keyString), "%016llx", (unsigned long long)createCacheKey(width, height, seed, heightfield));
+	return cacheFilePath + "." + keyString;
 }
 
 bbe::Matrix4 bbe::Terrain::getTransform() const
@@ -305,16 +963,28 @@ void bbe::Terrain::setTransform(const Vector3 & pos, const Vector3 & scale, cons
 	setTransform(Matrix4::createTransform(pos, scale, rotationVector, radians));
 }
 
+bool bbe::Terrain::intersects(const Ray & ray, float & outT, float maxT) const
+{
+	bool hit = false;
+	for (size_t i = 0; i < m_patches.getLength(); i++)
+	{
+		float t;
+		if (m_patches[i].intersects(ray, t, maxT))
+		{
+			hit = true;
+			maxT = t;
+			outT = t;
+		}
+	}
+	return hit;
+}
+
 void bbe::Terrain::setTransform(const Matrix4 & transform)
 {
 	m_transform = transform;
 
-	for(int i = 0; i<m_patchesHeightAmount; i++)
+	for (size_t i = 0; i < m_patches.getLength(); i++)
 	{
-		for(int k = 0; k<m_patchesWidthAmount; k++)
-		{
-			int index = i * m_patchesWidthAmount + k;
-			m_patches[index].setTransform(Matrix4::createTranslationMatrix(Vector3(i * 128.f, k * 128.f, 0)) * m_transform);
-		}
+		m_patches[i].setTransform(Matrix4::createTranslationMatrix(Vector3(m_patches[i].m_patchX * 128.f, m_patches[i].m_patchY * 128.f, 0)) * m_transform);
 	}
 }
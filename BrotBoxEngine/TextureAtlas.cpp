@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include "BBE/TextureAtlas.h"
+#include "BBE/Exceptions.h"
+#include "BBE/VulkanUploadBatcher.h"
+
+uint64_t bbe::TextureAtlas::s_nextId = 1;
+const int bbe::TextureAtlas::PADDING = 1;
+const int bbe::TextureAtlas::DEFAULT_SIZE = 2048;
+const int bbe::TextureAtlas::MAX_IMAGE_SIZE = 256;
+
+static int clampIndex(int index, int size)
+{
+	return index < 0 ? 0 : (index >= size ? size - 1 : index);
+}
+
+void bbe::TextureAtlas::init()
+{
+	if (m_id != 0)
+	{
+		return;
+	}
+
+	m_id = s_nextId++;
+	m_image.load(m_size, m_size, Color(0, 0, 0, 0));
+	m_packer.reset(m_size, m_size);
+	m_dirtyMinY = m_size;
+	m_dirtyMaxY = 0;
+
+	const ColorByte white(255, 255, 255, 255);
+	Rectangle whitePixel;
+	pack(&white, 1, 1, whitePixel);
+	m_whiteUvRect = Rectangle(whitePixel.getX() + whitePixel.getWidth() / 2, whitePixel.getY() + whitePixel.getHeight() / 2, 0, 0);
+}
+
+bool bbe::TextureAtlas::pack(const ColorByte* data, int width, int height, Rectangle &outUvRect)
+{
+	int x = 0;
+	int y = 0;
+	if (!m_packer.insert(width + 2 * PADDING, height + 2 * PADDING, x, y))
+	{
+		return false;
+	}
+
+	for (int row = -PADDING; row < height + PADDING; row++)
+	{
+		const int srcRow = clampIndex(row, height);
+		ColorByte* dst = m_image.m_pdata + (y + PADDING + row) * m_size + x + PADDING;
+		for (int column = -PADDING; column < width + PADDING; column++)
+		{
+			dst[column] = data[srcRow * width + clampIndex(column, width)];
+		}
+	}
+
+	if (y < m_dirtyMinY)
+	{
+		m_dirtyMinY = y;
+	}
+	if (y + height + 2 * PADDING > m_dirtyMaxY)
+	{
+		m_dirtyMaxY = y + height + 2 * PADDING;
+	}
+
+	outUvRect = Rectangle((float)(x + PADDING) / m_size, (float)(y + PADDING) / m_size, (float)width / m_size, (float)height / m_size);
+	return true;
+}
+
+bbe::TextureAtlas::TextureAtlas()
+	: TextureAtlas(DEFAULT_SIZE)
+{
+}
+
+bbe::TextureAtlas::TextureAtlas(int size)
+	: m_size(size)
+{
+	if (size <= 2 * PADDING + 1)
+	{
+		throw IllegalArgumentException();
+	}
+}
+
+bool bbe::TextureAtlas::add(const Image & image, Rectangle & outUvRect)
+{
+	if (image.m_pdata == nullptr)
+	{
+		throw NotInitializedException();
+	}
+
+	if (m_id == 0 || image.m_atlasId != m_id)
+	{
+		init();
+		image.m_atlasId = m_id;
+		if (image.getWidth() > MAX_IMAGE_SIZE || image.getHeight() > MAX_IMAGE_SIZE || !pack(image.m_pdata, image.getWidth(), image.getHeight(), image.m_atlasUvRect))
+		{
+			image.m_atlasUvRect = Rectangle();
+		}
+	}
+
+	if (image.m_atlasUvRect.getWidth() == 0)
+	{
+		return false;
+	}
+	outUvRect = image.m_atlasUvRect;
+	return true;
+}
+
+bbe::Rectangle bbe::TextureAtlas::getWhiteUvRect()
+{
+	init();
+	return m_whiteUvRect;
+}
+
+void bbe::TextureAtlas::upload(INTERNAL::vulkan::VulkanUploadBatcher & uploadBatcher, const INTERNAL::vulkan::VulkanDescriptorPool & descriptorPool, const INTERNAL::vulkan::VulkanDescriptorSetLayout & setLayout)
+{
+	init();
+
+	if (!m_image.wasUploadedToVulkan)
+	{
+		m_image.createAndUpload(uploadBatcher, descriptorPool, setLayout);
+	}
+	else if (m_dirtyMinY < m_dirtyMaxY)
+	{
+		//Recorded on the graphics queue after the frames that may still sample the atlas.
+		uploadBatcher.uploadImage(m_image.m_pdata + m_dirtyMinY * m_size, m_image.m_image, (uint32_t)m_size, m_dirtyMinY, (uint32_t)(m_dirtyMaxY - m_dirtyMinY), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	m_dirtyMinY = m_size;
+	m_dirtyMaxY = 0;
+}
+
+bool bbe::TextureAtlas::isUploaded() const
+{
+	return m_image.wasUploadedToVulkan;
+}
+
+VkDescriptorSet bbe::TextureAtlas::getDescriptorSet() const
+{
+	return *m_image.m_descriptorSet.getPDescriptorSet();
+}
+
+void bbe::TextureAtlas::destroy()
+{
+	m_image.destroy();
+	m_packer.reset(m_size, m_size);
+	m_id = 0;
+}
+
+int bbe::TextureAtlas::getSize() const
+{
+	return m_size;
+}
+
+const bbe::Image & bbe::TextureAtlas::getImage() const
+{
+	return m_image;
+}
+
+int bbe::TextureAtlas::getUsedArea() const
+{
+	return m_packer.getUsedArea();
+}
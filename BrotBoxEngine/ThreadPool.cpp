@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include "BBE/ThreadPool.h"
+#include <atomic>
+
+void bbe::ThreadPool::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobAvailable.wait(lock, [this] { return m_stopping || m_jobs.getLength() > 0; });
+			if (m_jobs.getLength() == 0)
+			{
+				return;
+			}
+			job = std::move(m_jobs.last());
+			m_jobs.popBack();
+		}
+		job();
+	}
+}
+
+bool bbe::ThreadPool::tryRunJob()
+{
+	std::function<void()> job;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_jobs.getLength() == 0)
+		{
+			return false;
+		}
+		job = std::move(m_jobs.last());
+		m_jobs.popBack();
+	}
+	job();
+	return true;
+}
+
+bbe::ThreadPool::ThreadPool(size_t amountOfThreads)
+{
+	if (amountOfThreads == 0)
+	{
+		const size_t hardwareThreads = std::thread::hardware_concurrency();
+		amountOfThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_threads.resizeCapacity(amountOfThreads);
+	for (size_t i = 0; i < amountOfThreads; i++)
+	{
+		m_threads.add(std::thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+bbe::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_jobAvailable.notify_all();
+	for (std::thread &thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+size_t bbe::ThreadPool::getAmountOfThreads() const
+{
+	return m_threads.getLength();
+}
+
+void bbe::ThreadPool::parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t minChunkSize)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+	if (minChunkSize == 0)
+	{
+		minChunkSize = 1;
+	}
+
+	//A few chunks per thread, so that uneven chunks even out.
+	const size_t amount = end - begin;
+	const size_t maxAmountOfChunks = (m_threads.getLength() + 1) * 4;
+	size_t amountOfChunks = (amount + minChunkSize - 1) / minChunkSize;
+	if (amountOfChunks > maxAmountOfChunks)
+	{
+		amountOfChunks = maxAmountOfChunks;
+	}
+	if (amountOfChunks <= 1)
+	{
+		func(begin, end);
+		return;
+	}
+
+	std::atomic<size_t> chunksLeft(amountOfChunks);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < amountOfChunks; i++)
+		{
+			const size_t chunkBegin = begin + amount * i / amountOfChunks;
+			const size_t chunkEnd = begin + amount * (i + 1) / amountOfChunks;
+			m_jobs.add(std::function<void()>([this, &func, &chunksLeft, chunkBegin, chunkEnd]()
+			{
+				func(chunkBegin, chunkEnd);
+				if (--chunksLeft == 0)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_jobFinished.notify_all();
+				}
+			}));
+		}
+	}
+	m_jobAvailable.notify_all();
+
+	//Help out instead of idling. This also keeps nested parallelFor calls from deadlocking.
+	while (chunksLeft > 0)
+	{
+		if (tryRunJob())
+		{
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_jobFinished.wait(lock, [this, &chunksLeft] { return chunksLeft == 0 || m_jobs.getLength() > 0; });
+	}
+}
+
+void bbe::ThreadPool::parallelFor(ThreadPool * threadPool, size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t minChunkSize)
+{
+	if (threadPool == nullptr)
+	{
+		if (begin < end)
+		{
+			func(begin, end);
+		}
+		return;
+	}
+	threadPool->parallelFor(begin, end, func, minChunkSize);
+}
+
+void bbe::ThreadPool::enqueue(const std::function<void()>& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.add(job);
+	}
+	m_jobAvailable.notify_one();
+}
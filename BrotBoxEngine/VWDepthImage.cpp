@@ -30,11 +30,10 @@ void bbe::INTERNAL::vulkan::VWDepthImage::destroy()
 	{
 		vkDestroyImageView(m_device, m_imageView, nullptr);
 		vkDestroyImage(m_device, m_image, nullptr);
-		vkFreeMemory(m_device, m_imageMemory, nullptr);
+		freeMemory(m_device, m_imageMemory);
 		m_created = false;
 
 		m_image = VK_NULL_HANDLE;
-		m_imageMemory = VK_NULL_HANDLE;
 		m_imageView = VK_NULL_HANDLE;
 		m_device = VK_NULL_HANDLE;
 	}
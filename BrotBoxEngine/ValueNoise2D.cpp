@@ -1,33 +1,54 @@
 #include "stdafx.h"
 #include "BBE/ValueNoise2D.h"
 #include "BBE/Exceptions.h"
-#include "BBE/DynamicArray.h"
+#include "BBE/List.h"
 #include "BBE/Random.h"
+#include "BBE/Philox.h"
 #include "BBE/Math.h"
-#include "BBE\ValueNoise2D.h"
+#include "BBE/ThreadPool.h"
+#include <emmintrin.h>
+#include <mutex>
 
-static int m_octaves = 3;
-static int m_startFrequencyX = 8;
-static int m_startFrequencyY = 8;
-static float m_startAlpha = 1;
-static float m_alphaChange = 0.5f;
-static int m_frequencyChange = 2;
+//Same formula as Math::interpolateCubic, for four samples at once.
+static __m128 interpolateCubic4(__m128 preA, __m128 a, __m128 b, __m128 postB, __m128 t)
+{
+	const __m128 t2 = _mm_mul_ps(t, t);
+	const __m128 w0 = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(postB, b), preA), a);
+	const __m128 w1 = _mm_sub_ps(_mm_sub_ps(preA, a), w0);
+	const __m128 w2 = _mm_sub_ps(b, preA);
+	return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(w0, t), t2), _mm_mul_ps(w1, t2)), _mm_mul_ps(w2, t)), a);
+}
 
-void bbe::ValueNoise2D::standardize()
+void bbe::ValueNoise2D::standardize(ThreadPool* threadPool)
 {
+	const size_t amount = (size_t)m_width * (size_t)m_height;
+	const size_t minChunkSize = 1024 * 16;
+	std::mutex mutex;
 	float min = 100000000.0f;
 	float max = -100000000.0f;
-	for (int i = 0; i < m_width * m_height; i++)
+	ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
 	{
-		float val = m_pdata[i];
-		if (val < min) min = val;
-		if (val > max) max = val;
-	}
+		float chunkMin = 100000000.0f;
+		float chunkMax = -100000000.0f;
+		for (size_t i = begin; i < end; i++)
+		{
+			float val = m_pdata[i];
+			if (val < chunkMin) chunkMin = val;
+			if (val > chunkMax) chunkMax = val;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (chunkMin < min) min = chunkMin;
+		if (chunkMax > max) max = chunkMax;
+	}, minChunkSize);
 
-	for (int i = 0; i < m_width * m_height; i++)
+	ThreadPool::parallelFor(threadPool, 0, amount, [&](size_t begin, size_t end)
 	{
-		m_pdata[i] = (m_pdata[i] - min) / (max - min);
-	}
+		for (size_t i = begin; i < end; i++)
+		{
+			m_pdata[i] = (m_pdata[i] - min) / (max - min);
+		}
+	}, minChunkSize);
 }
 
 bbe::ValueNoise2D::ValueNoise2D()
@@ -43,6 +64,11 @@ bbe::ValueNoise2D::~ValueNoise2D()
 }
 
 void bbe::ValueNoise2D::create(int width, int height)
+{
+	create(width, height, Random().randomUInt());
+}
+
+void bbe::ValueNoise2D::create(int width, int height, uint64_t seed, ThreadPool* threadPool)
 {
 	if (m_wasCreated)
 	{
@@ -50,69 +76,94 @@ void bbe::ValueNoise2D::create(int width, int height)
 	}
 
 	m_pdata = new float[width * height];
-	memset(m_pdata, 0, sizeof(float) * width * height);
 	m_width = width;
 	m_height = height;
 	m_wasCreated = true;
 
-
+	//All pixels of a column share the horizontal position within the node grid. So the horizontal
+	//interpolation is done once per node row and column, which leaves one vertical interpolation per
+	//pixel and octave instead of five.
+	List<float> horizontal;
+	List<size_t> octaveOffsets;
+	List<int> octaveFrequenciesY;
 	float alpha = m_startAlpha;
 	int frequencyX = m_startFrequencyX;
 	int frequencyY = m_startFrequencyY;
-	Random rand;
 
 	for (int octave = 0; octave < m_octaves; octave++)
 	{
-		DynamicArray<float> nodes((frequencyX + 2) * (frequencyY + 3));
+		const Philox4x32 random(seed, octave);
+		List<float> nodes;
+		nodes.resizeCapacityAndLength((frequencyX + 2) * (frequencyY + 3));
 		for (size_t i = 0; i < nodes.getLength(); i++)
 		{
-			nodes[i] = rand.randomFloat() * alpha;
+			nodes[i] = random.getFloat(i) * alpha;
 		}
 
-		for (int i = 0; i < m_width; i++)
+		const int nodeRows = frequencyY + 3;
+		const size_t offset = horizontal.getLength();
+		octaveOffsets.add(offset);
+		octaveFrequenciesY.add(frequencyY);
+		horizontal.resizeCapacityAndLength(offset + nodeRows * m_width);
+
+		ThreadPool::parallelFor(threadPool, 0, nodeRows, [&](size_t begin, size_t end)
 		{
-			for (int k = 0; k < m_height; k++)
+			for (size_t row = begin; row < end; row++)
 			{
-				float percentX = (float)i / (float)m_width;
-				float percentY = (float)k / (float)m_height;
-
-				float currentX = percentX * frequencyX;
-				float currentY = percentY * frequencyY;
-
-				int indexX = (int)currentX;
-				int indexY = (int)currentY;
-
-				/*float preA  = Math::interpolateCubic(nodes[indexX + 0 + (indexY + -1) * (frequencyX + 2)], nodes[indexX + 1 + (indexY + -1) * (frequencyX + 2)], nodes[indexX + 2 + (indexY + -1) * (frequencyX + 2)], nodes[indexX + 3 + (indexY + -1) * (frequencyX + 2)], currentX - indexX);
-				float a     = Math::interpolateCubic(nodes[indexX + 0 + (indexY +  0) * (frequencyX + 2)], nodes[indexX + 1 + (indexY +  0) * (frequencyX + 2)], nodes[indexX + 2 + (indexY +  0) * (frequencyX + 2)], nodes[indexX + 3 + (indexY +  0) * (frequencyX + 2)], currentX - indexX);
-				float b     = Math::interpolateCubic(nodes[indexX + 0 + (indexY +  1) * (frequencyX + 2)], nodes[indexX + 1 + (indexY +  1) * (frequencyX + 2)], nodes[indexX + 2 + (indexY +  1) * (frequencyX + 2)], nodes[indexX + 3 + (indexY +  1) * (frequencyX + 2)], currentX - indexX);
-				float postB = Math::interpolateCubic(nodes[indexX + 0 + (indexY +  2) * (frequencyX + 2)], nodes[indexX + 1 + (indexY +  2) * (frequencyX + 2)], nodes[indexX + 2 + (indexY +  2) * (frequencyX + 2)], nodes[indexX + 3 + (indexY +  2) * (frequencyX + 2)], currentX - indexX);
-				float w  = Math::interpolateCubic(preA, a, b, postB, currentY - indexY);*/
-
-				float preA  = Math::interpolateCubic(nodes[indexX + 0 + (indexY + 0) * (frequencyX + 1)], nodes[indexX + 1 + (indexY + 0) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 0) * (frequencyX + 1)], nodes[indexX + 3 + (indexY + 0) * (frequencyX + 1)], currentX - indexX);
-				float a     = Math::interpolateCubic(nodes[indexX + 0 + (indexY + 1) * (frequencyX + 1)], nodes[indexX + 1 + (indexY + 1) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 1) * (frequencyX + 1)], nodes[indexX + 3 + (indexY + 1) * (frequencyX + 1)], currentX - indexX);
-				float b     = Math::interpolateCubic(nodes[indexX + 0 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 1 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 3 + (indexY + 2) * (frequencyX + 1)], currentX - indexX);
-				float postB = Math::interpolateCubic(nodes[indexX + 0 + (indexY + 3) * (frequencyX + 1)], nodes[indexX + 1 + (indexY + 3) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 3) * (frequencyX + 1)], nodes[indexX + 3 + (indexY + 3) * (frequencyX + 1)], currentX - indexX);
-				/*float a = Math::interpolateLinear(nodes[indexX + 1 + (indexY + 1) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 1) * (frequencyX + 1)], currentX - indexX);
-				float b = Math::interpolateLinear(nodes[indexX + 1 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 2) * (frequencyX + 1)], currentX - indexX);
-				float b = Math::interpolateLinear(nodes[indexX + 1 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 2) * (frequencyX + 1)], currentX - indexX);*/
-				float w = Math::interpolateCubic(preA, a, b, postB, currentY - indexY);
-
-				/*float a = Math::interpolateLinear(nodes[indexX + 1 + (indexY + 1) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 1) * (frequencyX + 1)], currentX - indexX);
-				float b = Math::interpolateLinear(nodes[indexX + 1 + (indexY + 2) * (frequencyX + 1)], nodes[indexX + 2 + (indexY + 2) * (frequencyX + 1)], currentX - indexX);
-				float w = Math::interpolateLinear(a, b, currentY - indexY);*/
-
-				int index = i + k * m_width;
-				m_pdata[index] += w;
+				float* out = &horizontal[offset + row * m_width];
+				for (int i = 0; i < m_width; i++)
+				{
+					float percentX = (float)i / (float)m_width;
+					float currentX = percentX * frequencyX;
+					int indexX = (int)currentX;
+					const float* node = &nodes[indexX + row * (frequencyX + 1)];
+					out[i] = Math::interpolateCubic(node[0], node[1], node[2], node[3], currentX - indexX);
+				}
 			}
-		}
-
+		});
 
 		alpha *= m_alphaChange;
 		frequencyX *= m_frequencyChange;
 		frequencyY *= m_frequencyChange;
 	}
 
-	standardize();
+	ThreadPool::parallelFor(threadPool, 0, m_height, [&](size_t begin, size_t end)
+	{
+		for (size_t k = begin; k < end; k++)
+		{
+			float* out = m_pdata + k * m_width;
+			for (int octave = 0; octave < m_octaves; octave++)
+			{
+				float percentY = (float)k / (float)m_height;
+				float currentY = percentY * octaveFrequenciesY[octave];
+				int indexY = (int)currentY;
+				const float t = currentY - indexY;
+				const float* preA = &horizontal[octaveOffsets[octave] + (indexY + 0) * m_width];
+				const float* a = preA + m_width;
+				const float* b = a + m_width;
+				const float* postB = b + m_width;
+
+				int i = 0;
+				const __m128 t4 = _mm_set1_ps(t);
+				for (; i + 8 <= m_width; i += 8)
+				{
+					__m128 sum0 = octave == 0 ? _mm_setzero_ps() : _mm_loadu_ps(out + i);
+					__m128 sum1 = octave == 0 ? _mm_setzero_ps() : _mm_loadu_ps(out + i + 4);
+					sum0 = _mm_add_ps(sum0, interpolateCubic4(_mm_loadu_ps(preA + i), _mm_loadu_ps(a + i), _mm_loadu_ps(b + i), _mm_loadu_ps(postB + i), t4));
+					sum1 = _mm_add_ps(sum1, interpolateCubic4(_mm_loadu_ps(preA + i + 4), _mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4), _mm_loadu_ps(postB + i + 4), t4));
+					_mm_storeu_ps(out + i, sum0);
+					_mm_storeu_ps(out + i + 4, sum1);
+				}
+				for (; i < m_width; i++)
+				{
+					const float w = Math::interpolateCubic(preA[i], a[i], b[i], postB[i], t);
+					out[i] = octave == 0 ? w : out[i] + w;
+				}
+			}
+		}
+	}, 8);
+
+	standardize(threadPool);
 }
 
 void bbe::ValueNoise2D::destroy()
@@ -153,3 +204,90 @@ void bbe::ValueNoise2D::set(int x, int y, float val)
 	}
 	m_pdata[x + y * m_width] = val;
 }
+
+float * bbe::ValueNoise2D::getRaw()
+{
+	if (!m_wasCreated)
+	{
+		throw NotInitializedException();
+	}
+	return m_pdata;
+}
+
+int bbe::ValueNoise2D::getWidth() const
+{
+	return m_width;
+}
+
+int bbe::ValueNoise2D::getHeight() const
+{
+	return m_height;
+}
+
+void bbe::ValueNoise2D::setOctaves(int octaves)
+{
+	if (octaves < 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_octaves = octaves;
+}
+
+void bbe::ValueNoise2D::setStartFrequency(int frequencyX, int frequencyY)
+{
+	if (frequencyX < 1 || frequencyY < 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_startFrequencyX = frequencyX;
+	m_startFrequencyY = frequencyY;
+}
+
+void bbe::ValueNoise2D::setStartAlpha(float alpha)
+{
+	m_startAlpha = alpha;
+}
+
+void bbe::ValueNoise2D::setAlphaChange(float alphaChange)
+{
+	m_alphaChange = alphaChange;
+}
+
+void bbe::ValueNoise2D::setFrequencyChange(int frequencyChange)
+{
+	if (frequencyChange < 1)
+	{
+		throw IllegalArgumentException();
+	}
+	m_frequencyChange = frequencyChange;
+}
+
+int bbe::ValueNoise2D::getOctaves() const
+{
+	return m_octaves;
+}
+
+int bbe::ValueNoise2D::getStartFrequencyX() const
+{
+	return m_startFrequencyX;
+}
+
+int bbe::ValueNoise2D::getStartFrequencyY() const
+{
+	return m_startFrequencyY;
+}
+
+float bbe::ValueNoise2D::getStartAlpha() const
+{
+	return m_startAlpha;
+}
+
+float bbe::ValueNoise2D::getAlphaChange() const
+{
+	return m_alphaChange;
+}
+
+int bbe::ValueNoise2D::getFrequencyChange() const
+{
+	return m_frequencyChange;
+}
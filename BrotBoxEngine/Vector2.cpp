@@ -4,51 +4,6 @@
 #include "BBE/Math.h"
 #include "BBE/Exceptions.h"
 
-bbe::Vector2::Vector2()
-	: x(0), y(0)
-{
-}
-
-bbe::Vector2::Vector2(float x, float y)
-	: x(x), y(y)
-{
-}
-
-bbe::Vector2::Vector2(float xy)
-	: x(xy), y(xy)
-{
-}
-
-bbe::Vector2 bbe::Vector2::operator*(float scalar) const
-{
-	return Vector2(x * scalar, y * scalar);
-}
-
-float bbe::Vector2::operator*(const Vector2 & other) const
-{
-	return x * other.x + y * other.y;
-}
-
-bbe::Vector2 bbe::Vector2::operator/(float scalar) const
-{
-	return Vector2(x / scalar, y / scalar);
-}
-
-bbe::Vector2 bbe::Vector2::operator+(const Vector2 & other) const
-{
-	return Vector2(x + other.x, y + other.y);
-}
-
-bbe::Vector2 bbe::Vector2::operator-(const Vector2 & other) const
-{
-	return Vector2(x - other.x, y - other.y);
-}
-
-bbe::Vector2 bbe::Vector2::operator-() const
-{
-	return Vector2(-x, -y);
-}
-
 bbe::Vector2 bbe::Vector2::createVector2OnUnitCircle(float radians)
 {
 	float x = Math::cos(radians);
@@ -56,42 +11,6 @@ bbe::Vector2 bbe::Vector2::createVector2OnUnitCircle(float radians)
 	return Vector2(x, y);
 }
 
-float & bbe::Vector2::operator[](int index)
-{
-	switch (index)
-	{
-	case 0:
-		return x;
-	case 1:
-		return y;
-	default:
-		throw IllegalIndexException();
-	}
-}
-
-const float & bbe::Vector2::operator[](int index) const
-{
-	switch (index)
-	{
-	case 0:
-		return x;
-	case 1:
-		return y;
-	default:
-		throw IllegalIndexException();
-	}
-}
-
-bool bbe::Vector2::operator==(const Vector2 & other) const
-{
-	return x == other.x && y == other.y;
-}
-
-bool bbe::Vector2::operator!=(const Vector2 & other) const
-{
-	return !(operator==(other));
-}
-
 bool bbe::Vector2::operator>(const Vector2 & other) const
 {
 	return getLengthSq() > other.getLengthSq();
@@ -164,11 +83,6 @@ bool bbe::Vector2::isCloseTo(const Vector2 & other, float maxDistance) const
 	return (operator-(other)).getLength() <= maxDistance;
 }
 
-bool bbe::Vector2::isZero() const
-{
-	return x == 0 && y == 0;
-}
-
 bbe::Vector2 bbe::Vector2::rotate(float radians) const
 {
 	float sin = Math::sin(radians);
@@ -187,16 +101,6 @@ bbe::Vector2 bbe::Vector2::rotate(float radians, const Vector2 &center) const
 	return rotVec + center;
 }
 
-bbe::Vector2 bbe::Vector2::rotate90Clockwise() const
-{
-	return Vector2(-y, x);
-}
-
-bbe::Vector2 bbe::Vector2::rotate90CounterClockwise() const
-{
-	return Vector2(y, -x);
-}
-
 bbe::Vector2 bbe::Vector2::setLenght(float length) const
 {
 	return normalize()*length;
@@ -240,11 +144,6 @@ float bbe::Vector2::getLength() const
 	return Math::sqrt(getLengthSq());
 }
 
-float bbe::Vector2::getLengthSq() const
-{
-	return x * x + y * y;
-}
-
 float bbe::Vector2::getDistanceTo(const Vector2 & other) const
 {
 	return (operator-(other)).getLength();
@@ -5,114 +5,6 @@
 #include "BBE/Matrix4.h"
 #include "BBE/Exceptions.h"
 
-bbe::Vector3::Vector3()
-	: x(0), y(0), z(0)
-{
-	//UNTESTED
-}
-
-bbe::Vector3::Vector3(float xyz)
-	:x(xyz), y(xyz), z(xyz)
-{
-}
-
-bbe::Vector3::Vector3(float x, float y, float z)
-	: x(x), y(y), z(z)
-{
-	//UNTESTED
-}
-
-bbe::Vector3::Vector3(float x, const Vector2 &yz)
-	: x(x), y(yz.x), z(yz.y)
-{
-	//UNTESTED
-}
-
-bbe::Vector3::Vector3(const Vector2 &xy, float z)
-	: x(xy.x), y(xy.y), z(z)
-{
-	//UNTESTED
-}
-
-bbe::Vector3 bbe::Vector3::operator+(const Vector3 & other) const
-{
-	//UNTESTED
-	return Vector3(x + other.x, y + other.y, z + other.z);
-}
-
-bbe::Vector3 bbe::Vector3::operator-(const Vector3 & other) const
-{
-	//UNTESTED
-	return Vector3(x - other.x, y - other.y, z - other.z);
-}
-
-bbe::Vector3 bbe::Vector3::operator-() const
-{
-	return Vector3(-x, -y, -z);
-}
-
-bbe::Vector3 bbe::Vector3::operator*(float scalar) const
-{
-	//UNTESTED
-	return Vector3(x * scalar, y * scalar, z * scalar);
-}
-
-bbe::Vector3 bbe::Vector3::operator/(float scalar) const
-{
-	//UNTESTED
-	return Vector3(x / scalar, y / scalar, z / scalar);
-}
-
-float bbe::Vector3::operator*(const Vector3 & other) const
-{
-	//UNTESTED
-	return x * other.x + y * other.y + z * other.z;
-}
-
-float & bbe::Vector3::operator[](int index)
-{
-	//UNTESTED
-	switch (index)
-	{
-	case 0:
-		return x;
-	case 1:
-		return y;
-	case 2:
-		return z;
-	default:
-		throw IllegalIndexException();
-	}
-}
-
-const float & bbe::Vector3::operator[](int index) const
-{
-	//UNTESTED
-	switch (index)
-	{
-	case 0:
-		return x;
-	case 1:
-		return y;
-	case 2:
-		return z;
-	default:
-		throw IllegalIndexException();
-	}
-}
-
-bool bbe::Vector3::operator==(const Vector3 & other) const
-{
-	//UNTESTED
-	return x == other.x && y == other.y && z == other.z;
-}
-
-bool bbe::Vector3::operator!=(const Vector3 & other) const
-{
-	//UNTESTED
-	return !operator==(other);
-}
-
 bool bbe::Vector3::operator>(const Vector3 & other) const
 {
 	//UNTESTED
@@ -201,12 +93,6 @@ bool bbe::Vector3::isCloseTo(const Vector3 & other, float maxDistance) const
 	return operator-(other).getLengthSq() <= maxDistance * maxDistance;
 }
 
-bool bbe::Vector3::isZero() const
-{
-	//UNTESTED
-	return x == 0 && y == 0 && z == 0;
-}
-
 bbe::Vector3 bbe::Vector3::rotate(float radians, const Vector3 & axisOfRotation) const
 {
 	return Matrix4::createRotationMatrix(radians, axisOfRotation) * (*this);
@@ -265,27 +151,12 @@ bbe::Vector3 bbe::Vector3::reflect(const Vector3 & normal) const
 	return operator-(normalized * 2 * (operator*(normalized)));
 }
 
-bbe::Vector3 bbe::Vector3::cross(const Vector3 & other) const
-{
-	return Vector3(
-		y * other.z - other.y * z,
-		z * other.x - other.z * x,
-		x * other.y - other.x * y
-	);
-}
-
 float bbe::Vector3::getLength() const
 {
 	//UNTESTED
 	return Math::sqrt(getLengthSq());
 }
 
-float bbe::Vector3::getLengthSq() const
-{
-	//UNTESTED
-	return x * x + y * y + z * z;
-}
-
 float bbe::Vector3::getDistanceTo(const Vector3 & other) const
 {
 	//UNTESTED
@@ -1,7 +0,0 @@
-#include "stdafx.h"
-#include "BBE/VertexWithNormal.h"
-
-bbe::VertexWithNormal::VertexWithNormal(Vector3 pos, Vector3 normal)
-	: m_pos(pos), m_normal(normal)
-{
-}
@@ -5,6 +5,7 @@
 #include "BBE/VulkanHelper.h"
 #include "BBE/VulkanCommandPool.h"
 #include "BBE/VulkanManager.h"
+#include "BBE/VulkanUploadBatcher.h"
 
 void bbe::INTERNAL::vulkan::VulkanBuffer::create(const VulkanDevice &vulkanDevice, size_t sizeInBytes, VkBufferUsageFlags usage, VkSharingMode sharingMode, uint32_t queueFamilyIndexCount, const uint32_t* p_queueFamilyIndices)
 {
@@ -58,14 +59,14 @@ void bbe::INTERNAL::vulkan::VulkanBuffer::upload(const VulkanCommandPool &comman
 	}
 
 	VkBuffer uploadedBuffer = VK_NULL_HANDLE;
-	VkDeviceMemory uploadedMemory = VK_NULL_HANDLE;
+	VulkanMemoryAllocation uploadedMemory;
 
 	createBuffer(m_device, m_physicalDevice, m_bufferSize, m_usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, uploadedBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, uploadedMemory, sharingMode, queueFamilyIndexCount, p_queueFamilyIndices);
 
 	copyBuffer(m_device, commandPool.getCommandPool(), queue, m_buffer, uploadedBuffer, m_bufferSize);
 
 	vkDestroyBuffer(m_device, m_buffer, nullptr);
-	vkFreeMemory(m_device, m_memory, nullptr);
+	freeMemory(m_device, m_memory);
 
 	m_buffer = uploadedBuffer;
 	m_memory = uploadedMemory;
@@ -73,6 +74,32 @@ void bbe::INTERNAL::vulkan::VulkanBuffer::upload(const VulkanCommandPool &comman
 	m_wasUploaded = true;
 }
 
+uint64_t bbe::INTERNAL::vulkan::VulkanBuffer::createAndUpload(VulkanUploadBatcher & uploadBatcher, const void * data, size_t sizeInBytes, VkBufferUsageFlags usage)
+{
+	if (sizeInBytes == 0)
+	{
+		throw bbe::IllegalBufferSize();
+	}
+
+	if (m_wasCreated)
+	{
+		throw bbe::AlreadyCreatedException();
+	}
+
+	const VulkanDevice &device = uploadBatcher.getDevice();
+	m_bufferSize = sizeInBytes;
+	m_device = device.getDevice();
+	m_physicalDevice = device.getPhysicalDevice();
+	m_usage = usage;
+
+	createBuffer(m_device, m_physicalDevice, m_bufferSize, m_usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_memory, VK_SHARING_MODE_EXCLUSIVE, 0, nullptr);
+
+	m_wasCreated = true;
+	m_wasUploaded = true;
+
+	return uploadBatcher.uploadBuffer(data, m_bufferSize, m_buffer);
+}
+
 void bbe::INTERNAL::vulkan::VulkanBuffer::destroy()
 {
 	if (m_wasCreated)
@@ -82,9 +109,8 @@ void bbe::INTERNAL::vulkan::VulkanBuffer::destroy()
 			throw BufferMappedException();
 		}
 		vkDestroyBuffer(m_device, m_buffer, nullptr);
-		vkFreeMemory(m_device, m_memory, nullptr);
+		freeMemory(m_device, m_memory);
 		m_buffer = VK_NULL_HANDLE;
-		m_memory = VK_NULL_HANDLE;
 
 		m_wasCreated = false;
 		m_wasUploaded = false;
@@ -95,9 +121,23 @@ void bbe::INTERNAL::vulkan::VulkanBuffer::destroyAtEndOfFrame()
 {
 	if (m_wasCreated)
 	{
+		if (m_isMapped)
+		{
+			throw BufferMappedException();
+		}
+		if (VulkanManager::s_pinstance == nullptr)
+		{
+			//No frame can still use the buffer once the manager is gone.
+			destroy();
+			return;
+		}
 		VulkanManager::s_pinstance->addPendingDestructionBuffer(m_buffer, m_memory);
+		m_buffer = VK_NULL_HANDLE;
+		m_memory = VulkanMemoryAllocation();
+
+		m_wasCreated = false;
+		m_wasUploaded = false;
 	}
-	
 }
 
 void * bbe::INTERNAL::vulkan::VulkanBuffer::map()
@@ -115,11 +155,9 @@ void * bbe::INTERNAL::vulkan::VulkanBuffer::map()
 		throw BufferMappedException();
 	}
 
-	void* data;
-	vkMapMemory(m_device, m_memory, 0, m_bufferSize, 0, &data);
+	//Host visible memory stays mapped as long as it is allocated.
 	m_isMapped = true;
-
-	return data;
+	return m_memory.m_pmapped;
 }
 
 void bbe::INTERNAL::vulkan::VulkanBuffer::unmap()
@@ -129,7 +167,6 @@ void bbe::INTERNAL::vulkan::VulkanBuffer::unmap()
 		throw BufferIsNotMappedException();
 	}
 
-	vkUnmapMemory(m_device, m_memory);
 	m_isMapped = false;
 }
 
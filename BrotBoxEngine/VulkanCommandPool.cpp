@@ -6,20 +6,26 @@
 #include "BBE/VulkanDevice.h"
 #include "BBE/VulkanSwapchain.h"
 #include "BBE/VulkanPipeline.h"
+#include "BBE/VulkanObjectCounter.h"
 
 bbe::INTERNAL::vulkan::VulkanCommandPool::VulkanCommandPool()
 {
 }
 
-void bbe::INTERNAL::vulkan::VulkanCommandPool::init(const VulkanDevice & device)
+void bbe::INTERNAL::vulkan::VulkanCommandPool::init(const VulkanDevice & device, VkCommandPoolCreateFlags flags)
+{
+	init(device, device.getQueueFamilyIndex(), flags);
+}
+
+void bbe::INTERNAL::vulkan::VulkanCommandPool::init(const VulkanDevice & device, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags)
 {
 	m_device = device.getDevice();
 
 	VkCommandPoolCreateInfo cpci = {};
 	cpci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	cpci.pNext = nullptr;
-	cpci.flags = 0;
-	cpci.queueFamilyIndex = device.getQueueFamilyIndex();
+	cpci.flags = flags;
+	cpci.queueFamilyIndex = queueFamilyIndex;
 
 	VkResult result = vkCreateCommandPool(m_device, &cpci, nullptr, &m_commandPool);
 	ASSERT_VULKAN(result);
@@ -51,6 +57,7 @@ VkCommandBuffer bbe::INTERNAL::vulkan::VulkanCommandPool::getCommandBuffer()
 	VkCommandBuffer commandBuffer;
 	VkResult result = vkAllocateCommandBuffers(m_device, &cbai, &commandBuffer);
 	ASSERT_VULKAN(result);
+	VulkanObjectCounter::count(VulkanObjectType::COMMAND_BUFFER);
 
 	return commandBuffer;
 }
@@ -59,3 +66,9 @@ void bbe::INTERNAL::vulkan::VulkanCommandPool::freeCommandBuffer(VkCommandBuffer
 {
 	vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
 }
+
+void bbe::INTERNAL::vulkan::VulkanCommandPool::reset()
+{
+	VkResult result = vkResetCommandPool(m_device, m_commandPool, 0);
+	ASSERT_VULKAN(result);
+}
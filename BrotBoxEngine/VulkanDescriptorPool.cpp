@@ -18,6 +18,7 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorPool::create(const VulkanDevice & de
 {
 	m_device = device.getDevice();
 	uint32_t amountOfUniformBuffer = 0;
+	uint32_t amountOfUniformBufferDynamic = 0;
 	uint32_t amountOfCombinedImageSampler = 0;
 	uint32_t amountOfSets = 0;
 
@@ -30,6 +31,9 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorPool::create(const VulkanDevice & de
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
 				amountOfUniformBuffer += m_setLayouts[i].m_pvulkanDescriptorSetLayout->m_bindings[k].descriptorCount * m_setLayouts[i].m_amountOfSets;
 				break;
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+				amountOfUniformBufferDynamic += m_setLayouts[i].m_pvulkanDescriptorSetLayout->m_bindings[k].descriptorCount * m_setLayouts[i].m_amountOfSets;
+				break;
 			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
 				amountOfCombinedImageSampler += m_setLayouts[i].m_pvulkanDescriptorSetLayout->m_bindings[k].descriptorCount * m_setLayouts[i].m_amountOfSets;
 				break;
@@ -50,6 +54,14 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorPool::create(const VulkanDevice & de
 		poolSizes.add(dps);
 	}
 
+	if (amountOfUniformBufferDynamic > 0)
+	{
+		VkDescriptorPoolSize dps = {};
+		dps.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		dps.descriptorCount = amountOfUniformBufferDynamic;
+		poolSizes.add(dps);
+	}
+
 	if (amountOfCombinedImageSampler > 0)
 	{
 		VkDescriptorPoolSize dps = {};
@@ -6,6 +6,7 @@
 #include "BBE/VulkanDescriptorSet.h"
 #include "BBE/VulkanBuffer.h"
 #include "BBE/Image.h"
+#include "BBE/VulkanObjectCounter.h"
 
 void bbe::INTERNAL::vulkan::VulkanDescriptorSet::addUniformBuffer(const VulkanBuffer & buffer, VkDeviceSize offset, uint32_t binding)
 {
@@ -19,7 +20,22 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorSet::addUniformBuffer(const VulkanBu
 	dbi.offset = offset;
 	dbi.range = buffer.getSize();
 
-	m_descriptorBufferInfos.add(AdvancedDescriptorBufferInfo(dbi, binding));
+	m_descriptorBufferInfos.add(AdvancedDescriptorBufferInfo(dbi, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER));
+}
+
+void bbe::INTERNAL::vulkan::VulkanDescriptorSet::addDynamicUniformBuffer(const VulkanBuffer & buffer, VkDeviceSize range, uint32_t binding)
+{
+	if (m_descriptorSet != VK_NULL_HANDLE)
+	{
+		throw AlreadyCreatedException();
+	}
+
+	VkDescriptorBufferInfo dbi = {};
+	dbi.buffer = buffer.getBuffer();
+	dbi.offset = 0;
+	dbi.range = range;
+
+	m_descriptorBufferInfos.add(AdvancedDescriptorBufferInfo(dbi, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC));
 }
 
 void bbe::INTERNAL::vulkan::VulkanDescriptorSet::addCombinedImageSampler(const Image& image, uint32_t binding)
@@ -44,6 +60,7 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorSet::create(const VulkanDevice &devi
 	dsai.pSetLayouts = &dsl;
 
 	vkAllocateDescriptorSets(device.getDevice(), &dsai, &m_descriptorSet);
+	VulkanObjectCounter::count(VulkanObjectType::DESCRIPTOR_SET);
 
 
 
@@ -57,7 +74,7 @@ void bbe::INTERNAL::vulkan::VulkanDescriptorSet::create(const VulkanDevice &devi
 		wds.dstBinding = m_descriptorBufferInfos[i].m_binding;
 		wds.dstArrayElement = 0;
 		wds.descriptorCount = 1;
-		wds.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		wds.descriptorType = m_descriptorBufferInfos[i].m_descriptorType;
 		wds.pImageInfo = nullptr;
 		wds.pBufferInfo = &(m_descriptorBufferInfos[i].m_descriptorBufferInfo);
 		wds.pTexelBufferView = nullptr;
@@ -95,10 +112,11 @@ const VkDescriptorSet * bbe::INTERNAL::vulkan::VulkanDescriptorSet::getPDescript
 	return &m_descriptorSet;
 }
 
-bbe::INTERNAL::vulkan::AdvancedDescriptorBufferInfo::AdvancedDescriptorBufferInfo(VkDescriptorBufferInfo descriptorBufferInfo, uint32_t binding)
+bbe::INTERNAL::vulkan::AdvancedDescriptorBufferInfo::AdvancedDescriptorBufferInfo(VkDescriptorBufferInfo descriptorBufferInfo, uint32_t binding, VkDescriptorType descriptorType)
 {
 	m_descriptorBufferInfo = descriptorBufferInfo;
 	m_binding = binding;
+	m_descriptorType = descriptorType;
 }
 
 bbe::INTERNAL::vulkan::AdvancedDescriptorImageInfo::AdvancedDescriptorImageInfo(VkDescriptorImageInfo descriptorImageInfo, uint32_t binding)
@@ -23,19 +23,34 @@ void bbe::INTERNAL::vulkan::VulkanDevice::init(const PhysicalDeviceContainer & p
 	}
 	deviceQueueCreateInfo.pQueuePriorities = queuePriorities.getRaw();
 
+	List<VkDeviceQueueCreateInfo> queueCreateInfos;
+	queueCreateInfos.add(deviceQueueCreateInfo);
+	m_transferQueueFamilyIndex = queueFamilyIndex;
+	uint32_t transferQueueFamilyIndex = 0;
+	if (pd.findDedicatedTransferQueueIndex(transferQueueFamilyIndex) && transferQueueFamilyIndex != queueFamilyIndex)
+	{
+		m_transferQueueFamilyIndex = transferQueueFamilyIndex;
+		VkDeviceQueueCreateInfo transferQueueCreateInfo = deviceQueueCreateInfo;
+		transferQueueCreateInfo.queueFamilyIndex = m_transferQueueFamilyIndex;
+		transferQueueCreateInfo.queueCount = 1;
+		queueCreateInfos.add(transferQueueCreateInfo);
+	}
+
 	VkPhysicalDeviceFeatures usedFeatures = {};
 	usedFeatures.samplerAnisotropy = VK_TRUE;
 
-	const List<const char*> deviceExtensions = {
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME
-	};
+	List<const char*> deviceExtensions;
+	if (surface.getSurface() != VK_NULL_HANDLE)
+	{
+		deviceExtensions.add(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+	}
 
 	VkDeviceCreateInfo deviceCreateInfo;
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	deviceCreateInfo.pNext = nullptr;
 	deviceCreateInfo.flags = 0;
-	deviceCreateInfo.queueCreateInfoCount = 1;
-	deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
+	deviceCreateInfo.queueCreateInfoCount = (uint32_t)queueCreateInfos.getLength();
+	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.getRaw();
 	deviceCreateInfo.enabledLayerCount = 0;
 	deviceCreateInfo.ppEnabledLayerNames = nullptr;
 	deviceCreateInfo.enabledExtensionCount = (uint32_t)deviceExtensions.getLength();
@@ -46,7 +61,12 @@ void bbe::INTERNAL::vulkan::VulkanDevice::init(const PhysicalDeviceContainer & p
 	ASSERT_VULKAN(result);
 
 	vkGetDeviceQueue(m_device, queueFamilyIndex, 0, &m_queue);
+	vkGetDeviceQueue(m_device, m_transferQueueFamilyIndex, 0, &m_transferQueue);
 
+	if (surface.getSurface() == VK_NULL_HANDLE)
+	{
+		return;
+	}
 
 	uint32_t amountOfFormats = 0;
 	vkGetPhysicalDeviceSurfaceFormatsKHR(m_physicalDevice, surface.getSurface(), &amountOfFormats, nullptr);
@@ -122,4 +142,19 @@ VkQueue bbe::INTERNAL::vulkan::VulkanDevice::getQueue() const
 uint32_t bbe::INTERNAL::vulkan::VulkanDevice::getQueueFamilyIndex() const
 {
 	return queueFamilyIndex;
+}
+
+bool bbe::INTERNAL::vulkan::VulkanDevice::hasDedicatedTransferQueue() const
+{
+	return m_transferQueueFamilyIndex != queueFamilyIndex;
+}
+
+VkQueue bbe::INTERNAL::vulkan::VulkanDevice::getTransferQueue() const
+{
+	return m_transferQueue;
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanDevice::getTransferQueueFamilyIndex() const
+{
+	return m_transferQueueFamilyIndex;
 }
\ No newline at end of file
@@ -9,14 +9,14 @@ bbe::INTERNAL::vulkan::VulkanFence::VulkanFence()
 	//DO NOTHING
 }
 
-void bbe::INTERNAL::vulkan::VulkanFence::init(const VulkanDevice & vulkanDevice)
+void bbe::INTERNAL::vulkan::VulkanFence::init(const VulkanDevice & vulkanDevice, bool signaled)
 {
 	m_device = vulkanDevice.getDevice();
 
 	VkFenceCreateInfo fci = {};
 	fci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	fci.pNext = nullptr;
-	fci.flags = 0;
+	fci.flags = signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0;
 	VkResult result = vkCreateFence(m_device, &fci, nullptr, &m_fence);
 	ASSERT_VULKAN(result);
 }
@@ -46,6 +46,17 @@ void bbe::INTERNAL::vulkan::VulkanFence::waitForFence(uint64_t timeout)
 	ASSERT_VULKAN(result);
 }
 
+void bbe::INTERNAL::vulkan::VulkanFence::wait(uint64_t timeout)
+{
+	if (m_fence == VK_NULL_HANDLE)
+	{
+		throw NotInitializedException();
+	}
+
+	VkResult result = vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, timeout);
+	ASSERT_VULKAN(result);
+}
+
 void bbe::INTERNAL::vulkan::VulkanFence::reset()
 {
 	if (m_fence == VK_NULL_HANDLE)
@@ -56,6 +67,16 @@ void bbe::INTERNAL::vulkan::VulkanFence::reset()
 	vkResetFences(m_device, 1, &m_fence);
 }
 
+bool bbe::INTERNAL::vulkan::VulkanFence::isSignaled()
+{
+	if (m_fence == VK_NULL_HANDLE)
+	{
+		throw NotInitializedException();
+	}
+
+	return vkGetFenceStatus(m_device, m_fence) == VK_SUCCESS;
+}
+
 VkFence bbe::INTERNAL::vulkan::VulkanFence::getFence()
 {
 	if (m_fence == VK_NULL_HANDLE)
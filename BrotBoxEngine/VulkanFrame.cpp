@@ -0,0 +1,72 @@
+#include "stdafx.h"
+#include "BBE/VulkanFrame.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/InstanceData3D.h"
+#include "BBE/Batch2D.h"
+
+bbe::INTERNAL::vulkan::VulkanFrame::VulkanFrame()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanFrame::init(const VulkanDevice & device)
+{
+	m_semaphoreImageAvailable.init(device);
+	m_semaphoreRenderingDone.init(device);
+	//Signaled, so the first use of the frame does not wait for a submission that never happened.
+	m_fence.init(device, true);
+	m_commandPool.init(device, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+	m_commandBuffer = m_commandPool.getCommandBuffer();
+
+	m_instanceBuffer.create(device, sizeof(InstanceData3D) * 1024, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	m_vertexBuffer2D.create(device, sizeof(Vertex2D) * 4096, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	m_indexBuffer2D.create(device, sizeof(uint32_t) * 6144, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+void bbe::INTERNAL::vulkan::VulkanFrame::destroy(const VulkanDevice & device)
+{
+	destroyPendingResources(device);
+	//Frees the command buffer as well.
+	m_commandPool.destroy();
+	m_commandBuffer = VK_NULL_HANDLE;
+
+	m_instanceBuffer.destroy();
+	m_vertexBuffer2D.destroy();
+	m_indexBuffer2D.destroy();
+	m_fence.destroy();
+	m_semaphoreRenderingDone.destroy();
+	m_semaphoreImageAvailable.destroy();
+}
+
+void bbe::INTERNAL::vulkan::VulkanFrame::waitUntilReusable(const VulkanDevice & device)
+{
+	m_fence.wait();
+
+	destroyPendingResources(device);
+	m_commandPool.reset();
+}
+
+void bbe::INTERNAL::vulkan::VulkanFrame::destroyPendingResources(const VulkanDevice & device)
+{
+	while (m_pendingDestructionSamplers.hasDataLeft())
+	{
+		vkDestroySampler(device.getDevice(), m_pendingDestructionSamplers.pop(), nullptr);
+	}
+	while (m_pendingDestructionImageViews.hasDataLeft())
+	{
+		vkDestroyImageView(device.getDevice(), m_pendingDestructionImageViews.pop(), nullptr);
+	}
+	while (m_pendingDestructionImages.hasDataLeft())
+	{
+		vkDestroyImage(device.getDevice(), m_pendingDestructionImages.pop(), nullptr);
+	}
+	while (m_pendingDestructionBuffers.hasDataLeft())
+	{
+		vkDestroyBuffer(device.getDevice(), m_pendingDestructionBuffers.pop(), nullptr);
+	}
+	while (m_pendingDestructionMemory.hasDataLeft())
+	{
+		VulkanMemoryAllocation allocation = m_pendingDestructionMemory.pop();
+		freeMemory(device.getDevice(), allocation);
+	}
+}
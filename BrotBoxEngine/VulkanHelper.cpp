@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "BBE/VulkanHelper.h"
+#include "BBE/VulkanObjectCounter.h"
 
 uint32_t bbe::INTERNAL::vulkan::findMemoryTypeIndex(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
 	VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
@@ -53,7 +54,7 @@ bool bbe::INTERNAL::vulkan::isStencilFormat(VkFormat format)
 	return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-void bbe::INTERNAL::vulkan::createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize deviceSize, VkBufferUsageFlags bufferUsageFlags, VkBuffer & buffer, VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceMemory & deviceMemory, VkSharingMode sharingMode, uint32_t queueFamilyIndexCount, const uint32_t* p_queueFamilyIndices)
+void bbe::INTERNAL::vulkan::createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize deviceSize, VkBufferUsageFlags bufferUsageFlags, VkBuffer & buffer, VkMemoryPropertyFlags memoryPropertyFlags, VulkanMemoryAllocation & allocation, VkSharingMode sharingMode, uint32_t queueFamilyIndexCount, const uint32_t* p_queueFamilyIndices)
 {
 	VkBufferCreateInfo bufferCreateInfo;
 	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -71,16 +72,19 @@ void bbe::INTERNAL::vulkan::createBuffer(VkDevice device, VkPhysicalDevice physi
 	VkMemoryRequirements memoryRequirements;
 	vkGetBufferMemoryRequirements(device, buffer, &memoryRequirements);
 
-	VkMemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.pNext = nullptr;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = findMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits, memoryPropertyFlags);
+	if (VulkanMemoryAllocator::s_pinstance != nullptr)
+	{
+		VulkanMemoryAllocator::s_pinstance->allocate(memoryRequirements, memoryPropertyFlags, true, allocation);
+	}
+	else
+	{
+		VulkanMemoryAllocator::allocateDedicated(device, physicalDevice, memoryRequirements, memoryPropertyFlags, allocation);
+	}
 
-	result = vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &deviceMemory);
+	result = vkBindBufferMemory(device, buffer, allocation.m_memory, allocation.m_offset);
 	ASSERT_VULKAN(result);
 
-	vkBindBufferMemory(device, buffer, deviceMemory, 0);
+	VulkanObjectCounter::count(VulkanObjectType::BUFFER);
 }
 
 VkCommandBuffer bbe::INTERNAL::vulkan::startSingleTimeCommandBuffer(VkDevice device, VkCommandPool commandPool)
@@ -95,6 +99,7 @@ VkCommandBuffer bbe::INTERNAL::vulkan::startSingleTimeCommandBuffer(VkDevice dev
 	VkCommandBuffer commandBuffer;
 	VkResult result = vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer);
 	ASSERT_VULKAN(result);
+	VulkanObjectCounter::count(VulkanObjectType::COMMAND_BUFFER);
 
 	VkCommandBufferBeginInfo commandBufferBeginInfo;
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -132,7 +137,7 @@ void bbe::INTERNAL::vulkan::endSingleTimeCommandBuffer(VkDevice device, VkQueue
 	vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
 
-void bbe::INTERNAL::vulkan::createImage(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage & image, VkDeviceMemory & imageMemory)
+void bbe::INTERNAL::vulkan::createImage(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage & image, VulkanMemoryAllocation & allocation)
 {
 	VkImageCreateInfo imageCreateInfo;
 	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -159,16 +164,19 @@ void bbe::INTERNAL::vulkan::createImage(VkDevice device, VkPhysicalDevice physic
 	VkMemoryRequirements memoryRequirements;
 	vkGetImageMemoryRequirements(device, image, &memoryRequirements);
 
-	VkMemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.pNext = nullptr;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = findMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits, propertyFlags);
+	if (VulkanMemoryAllocator::s_pinstance != nullptr)
+	{
+		VulkanMemoryAllocator::s_pinstance->allocate(memoryRequirements, propertyFlags, tiling == VK_IMAGE_TILING_LINEAR, allocation);
+	}
+	else
+	{
+		VulkanMemoryAllocator::allocateDedicated(device, physicalDevice, memoryRequirements, propertyFlags, allocation);
+	}
 
-	result = vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &imageMemory);
+	result = vkBindImageMemory(device, image, allocation.m_memory, allocation.m_offset);
 	ASSERT_VULKAN(result);
 
-	vkBindImageMemory(device, image, imageMemory, 0);
+	VulkanObjectCounter::count(VulkanObjectType::IMAGE);
 }
 
 void bbe::INTERNAL::vulkan::createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView & imageView)
@@ -192,6 +200,7 @@ void bbe::INTERNAL::vulkan::createImageView(VkDevice device, VkImage image, VkFo
 
 	VkResult result = vkCreateImageView(device, &imageViewCreateInfo, nullptr, &imageView);
 	ASSERT_VULKAN(result);
+	VulkanObjectCounter::count(VulkanObjectType::IMAGE_VIEW);
 }
 
 void bbe::INTERNAL::vulkan::copyBuffer(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkBuffer src, VkBuffer dest, VkDeviceSize size)
@@ -224,6 +233,11 @@ void bbe::INTERNAL::vulkan::changeImageLayout(VkDevice device, VkCommandPool com
 		imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+	{
+		imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	}
 	else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
 	{
 		imageMemoryBarrier.srcAccessMask = 0;
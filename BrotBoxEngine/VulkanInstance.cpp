@@ -16,7 +16,7 @@ void bbe::INTERNAL::vulkan::VulkanInstance::destroy()
 	}
 }
 
-void bbe::INTERNAL::vulkan::VulkanInstance::init(const char * appName, uint32_t major, uint32_t minor, uint32_t patch)
+void bbe::INTERNAL::vulkan::VulkanInstance::init(const char * appName, uint32_t major, uint32_t minor, uint32_t patch, bool withWindow)
 {
 	VkApplicationInfo appInfo = {};
 	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -33,7 +33,11 @@ void bbe::INTERNAL::vulkan::VulkanInstance::init(const char * appName, uint32_t
 	};
 
 	uint32_t amountOfGlfwExtensions = 0;
-	auto glfwExtensions = glfwGetRequiredInstanceExtensions(&amountOfGlfwExtensions);
+	const char** glfwExtensions = nullptr;
+	if (withWindow)
+	{
+		glfwExtensions = glfwGetRequiredInstanceExtensions(&amountOfGlfwExtensions);
+	}
 
 	VkInstanceCreateInfo instanceInfo = {};
 	instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
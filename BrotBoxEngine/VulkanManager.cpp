@@ -9,19 +9,38 @@
 #include "BBE/VertexWithNormal.h"
 #include "BBE/Terrain.h"
 #include "BBE/PointLight.h"
+#include "BBE/VulkanObjectCounter.h"
+#include "BBE/InstanceData3D.h"
+#include "BBE/Batch2D.h"
+#include "BBE/StopWatch.h"
 
 bbe::INTERNAL::vulkan::VulkanManager *bbe::INTERNAL::vulkan::VulkanManager::s_pinstance = nullptr;
 
-void bbe::INTERNAL::vulkan::VulkanManager::destroyPendingBuffers()
+void bbe::INTERNAL::vulkan::VulkanManager::resetImagesInFlight()
 {
-	while (m_pendingDestructionBuffers.hasDataLeft())
+	m_imagesInFlight.clear();
+	for (uint32_t i = 0; i < getAmountOfImages(); i++)
 	{
-		vkDestroyBuffer(m_device.getDevice(), m_pendingDestructionBuffers.pop(), nullptr);
+		m_imagesInFlight.add(nullptr);
 	}
-	while (m_pendingDestructionMemory.hasDataLeft())
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanManager::getAmountOfImages() const
+{
+	if (m_headless)
 	{
-		vkFreeMemory(m_device.getDevice(), m_pendingDestructionMemory.pop(), nullptr);
+		return m_offscreenTarget.getAmountOfImages();
 	}
+	return m_swapchain.getAmountOfImages();
+}
+
+VkFramebuffer bbe::INTERNAL::vulkan::VulkanManager::getFrameBuffer(uint32_t imageIndex) const
+{
+	if (m_headless)
+	{
+		return m_offscreenTarget.getFrameBuffer(imageIndex);
+	}
+	return m_swapchain.getFrameBuffer(imageIndex);
 }
 
 bbe::INTERNAL::vulkan::VulkanManager::VulkanManager()
@@ -40,57 +59,95 @@ void bbe::INTERNAL::vulkan::VulkanManager::init(const char * appName, uint32_t m
 	m_screenHeight = initialWindowHeight;
 
 	m_pwindow = window;
-	m_instance.init(appName, major, minor, patch);
-	m_surface.init(m_instance, m_pwindow);
+	m_headless = window == nullptr;
+	m_instance.init(appName, major, minor, patch, !m_headless);
+	if (!m_headless)
+	{
+		m_surface.init(m_instance, m_pwindow);
+	}
 	m_physicalDeviceContainer.init(m_instance, m_surface);
 	m_device.init(m_physicalDeviceContainer, m_surface);
-	m_swapchain.init(m_surface, m_device, initialWindowWidth, initialWindowHeight, nullptr);
-	m_renderPass.init(m_device);
+	m_memoryAllocator.init(m_device);
+	m_pipelineCache.init(m_device, Settings::getPipelineCachePath());
+	if (m_headless)
+	{
+		//One image per frame in flight, so a frame never waits for an image another frame renders into.
+		m_offscreenTarget.init(m_device, initialWindowWidth, initialWindowHeight, (uint32_t)Settings::getAmountOfFramesInFlight());
+		m_renderPass.init(m_device, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	}
+	else
+	{
+		m_swapchain.init(m_surface, m_device, initialWindowWidth, initialWindowHeight, nullptr);
+		m_renderPass.init(m_device);
+	}
 
 	m_commandPool.init(m_device);
+	m_uploadBatcher.init(m_device);
+	m_uniformRing.init(m_device);
 	m_depthImage.create(m_device, m_commandPool, initialWindowWidth, initialWindowHeight);
-	m_swapchain.createFramebuffers(m_depthImage, m_renderPass);
-	m_semaphoreImageAvailable.init(m_device);
-	m_semaphoreRenderingDone.init(m_device);
-	m_presentFence.init(m_device);
+	if (m_headless)
+	{
+		m_offscreenTarget.createFramebuffers(m_depthImage, m_renderPass);
+	}
+	else
+	{
+		m_swapchain.createFramebuffers(m_depthImage, m_renderPass);
+	}
+	resetImagesInFlight();
 
-	m_primitiveBrush3D.create(m_device);
-	bbe::PointLight::s_init(m_device.getDevice(), m_device.getPhysicalDevice());
+	bbe::PointLight::s_init();
 
 
-	m_setLayoutVertexLight.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
+	m_setLayoutVertexLight.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT);
 	m_setLayoutVertexLight.create(m_device);
 
-	m_setLayoutFragmentLight.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+	m_setLayoutFragmentLight.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
 	m_setLayoutFragmentLight.create(m_device);
 
-	m_setLayoutViewProjectionMatrix.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
+	m_setLayoutViewProjectionMatrix.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT);
 	m_setLayoutViewProjectionMatrix.create(m_device);
 
 	m_setLayoutSampler.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
 	m_setLayoutSampler.create(m_device);
 
+	const uint32_t amountOfFrames = (uint32_t)Settings::getAmountOfFramesInFlight();
 	m_descriptorPool.addVulkanDescriptorSetLayout(m_setLayoutVertexLight         , 1);
 	m_descriptorPool.addVulkanDescriptorSetLayout(m_setLayoutFragmentLight       , 1);
 	m_descriptorPool.addVulkanDescriptorSetLayout(m_setLayoutViewProjectionMatrix, 1);
 	m_descriptorPool.addVulkanDescriptorSetLayout(m_setLayoutSampler             , 1024);
 	m_descriptorPool.create(m_device);
 
-	m_setVertexLight              .addUniformBuffer(PointLight::s_bufferVertexData  , 0, 0);
-	m_setFragmentLight            .addUniformBuffer(PointLight::s_bufferFragmentData, 0, 0);
-	m_setViewProjectionMatrixLight.addUniformBuffer(m_primitiveBrush3D.m_uboMatrices, 0, 0);
-	m_setVertexLight              .create(m_device, m_descriptorPool, m_setLayoutVertexLight);
-	m_setFragmentLight            .create(m_device, m_descriptorPool, m_setLayoutFragmentLight);
-	m_setViewProjectionMatrixLight.create(m_device, m_descriptorPool, m_setLayoutViewProjectionMatrix);
+	m_setVertexLight         .addDynamicUniformBuffer(m_uniformRing.getBuffer(), PointLight::s_getVertexDataSize()  , 0);
+	m_setFragmentLight       .addDynamicUniformBuffer(m_uniformRing.getBuffer(), PointLight::s_getFragmentDataSize(), 0);
+	m_setViewProjectionMatrix.addDynamicUniformBuffer(m_uniformRing.getBuffer(), sizeof(Matrix4) * 2             , 0);
+	m_setVertexLight         .create(m_device, m_descriptorPool, m_setLayoutVertexLight);
+	m_setFragmentLight       .create(m_device, m_descriptorPool, m_setLayoutFragmentLight);
+	m_setViewProjectionMatrix.create(m_device, m_descriptorPool, m_setLayoutViewProjectionMatrix);
+
+	m_frames.resizeCapacityAndLength(amountOfFrames);
+	for (size_t i = 0; i < m_frames.getLength(); i++)
+	{
+		m_frames[i].init(m_device);
+	}
 
 	m_vertexShader2DPrimitive.init(m_device, "vert2DPrimitive.spv");
 	m_fragmentShader2DPrimitive.init(m_device, "frag2DPrimitive.spv");
 	m_vertexShader2DImage.init(m_device, "vert2DImage.spv");
 	m_fragmentShader2DImage.init(m_device, "frag2DImage.spv");
+	m_vertexShader2DBatched.init(m_device, "vert2DBatched.spv");
+	m_fragmentShader2DBatched.init(m_device, "frag2DBatched.spv");
 	m_vertexShader3DPrimitive.init(m_device, "vert3DPrimitive.spv");
 	m_fragmentShader3DPrimitive.init(m_device, "frag3DPrimitive.spv");
+	m_vertexShader3DInstanced.init(m_device, "vert3DInstanced.spv");
+	m_fragmentShader3DInstanced.init(m_device, "frag3DInstanced.spv");
+	m_vertexShader3DTerrain.init(m_device, "vert3DTerrain.spv");
 
 	createPipelines();
+	if (!m_pipelineCache.wasLoadedFromFile())
+	{
+		//Written right away, so the next start profits even if this run never shuts down cleanly.
+		m_pipelineCache.save();
+	}
 
 	m_uboMatrixViewProjection.create(m_device, sizeof(Matrix4), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
 	m_uboMatrixModel.create(m_device, sizeof(Matrix4), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
@@ -102,8 +159,9 @@ void bbe::INTERNAL::vulkan::VulkanManager::init(const char * appName, uint32_t m
 	bbe::Rectangle::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_commandPool, m_device.getQueue());
 	bbe::Circle::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_commandPool, m_device.getQueue());
 	bbe::Cube::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_commandPool, m_device.getQueue());
-	bbe::Terrain::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_commandPool, m_device.getQueue());
+	bbe::Terrain::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_uploadBatcher);
 	bbe::IcoSphere::s_init(m_device.getDevice(), m_device.getPhysicalDevice(), m_commandPool, m_device.getQueue());
+	m_uploadBatcher.submit();
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::destroy()
@@ -115,24 +173,36 @@ void bbe::INTERNAL::vulkan::VulkanManager::destroy()
 	bbe::Rectangle::s_destroy();
 	bbe::PointLight::s_destroy();
 	bbe::IcoSphere::s_destroy();
+	bbe::Terrain::s_destroy();
 
 
-	destroyPendingBuffers();
-	m_presentFence.destroy();
-	m_semaphoreRenderingDone.destroy();
-	m_semaphoreImageAvailable.destroy();
+	for (size_t i = 0; i < m_frames.getLength(); i++)
+	{
+		m_frames[i].destroy(m_device);
+	}
+	m_frames.clear();
 	m_depthImage.destroy();
 	m_commandPool.destroy();
+	m_uploadBatcher.destroy();
+	m_uniformRing.destroy();
 
 	m_uboMatrixViewProjection.destroy();
 	m_uboMatrixModel.destroy();
 	m_pipeline3DPrimitive.destroy();
 	m_pipeline3DTerrain.destroy();
+	m_pipeline3DInstanced.destroy();
 	m_fragmentShader3DPrimitive.destroy();
 	m_vertexShader3DPrimitive.destroy();
+	m_fragmentShader3DInstanced.destroy();
+	m_vertexShader3DInstanced.destroy();
+	m_vertexShader3DTerrain.destroy();
 
 	m_pipeline2DPrimitive.destroy();
 	m_pipeline2DImage.destroy();
+	m_pipeline2DBatched.destroy();
+	m_textureAtlas.destroy();
+	m_fragmentShader2DBatched.destroy();
+	m_vertexShader2DBatched.destroy();
 	m_fragmentShader2DPrimitive.destroy();
 	m_vertexShader2DPrimitive.destroy();
 	m_vertexShader2DImage.destroy();
@@ -143,9 +213,12 @@ void bbe::INTERNAL::vulkan::VulkanManager::destroy()
 	m_setLayoutViewProjectionMatrix.destroy();
 	m_setLayoutSampler.destroy();
 	m_descriptorPool.destroy();
-	m_primitiveBrush3D.destroy();
 	m_renderPass.destroy();
 	m_swapchain.destroy();
+	m_offscreenTarget.destroy();
+	m_pipelineCache.save();
+	m_pipelineCache.destroy();
+	m_memoryAllocator.destroy();
 	m_device.destroy();
 	m_surface.destroy();
 	m_instance.destroy();
@@ -153,20 +226,50 @@ void bbe::INTERNAL::vulkan::VulkanManager::destroy()
 
 void bbe::INTERNAL::vulkan::VulkanManager::preDraw2D()
 {
+	m_primitiveBrush3D.INTERNAL_flushInstances();
+	m_primitiveBrush3D.INTERNAL_endDraw3D();
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::preDraw3D()
 {
-	vkCmdBindDescriptorSets(m_currentFrameDrawCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline3DPrimitive.getLayout(), 0, 1, m_setVertexLight              .getPDescriptorSet(), 0, nullptr);
-	vkCmdBindDescriptorSets(m_currentFrameDrawCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline3DPrimitive.getLayout(), 2, 1, m_setFragmentLight            .getPDescriptorSet(), 0, nullptr);
-	vkCmdBindDescriptorSets(m_currentFrameDrawCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline3DPrimitive.getLayout(), 1, 1, m_setViewProjectionMatrixLight.getPDescriptorSet(), 0, nullptr);
+	uint32_t vertexLightOffset = 0;
+	uint32_t fragmentLightOffset = 0;
+	m_pvertexLightData = m_uniformRing.allocate(PointLight::s_getVertexDataSize(), vertexLightOffset);
+	m_pfragmentLightData = m_uniformRing.allocate(PointLight::s_getFragmentDataSize(), fragmentLightOffset);
+
+	vkCmdBindDescriptorSets(m_currentFrameDrawCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline3DPrimitive.getLayout(), 0, 1, m_setVertexLight  .getPDescriptorSet(), 1, &vertexLightOffset);
+	vkCmdBindDescriptorSets(m_currentFrameDrawCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline3DPrimitive.getLayout(), 2, 1, m_setFragmentLight.getPDescriptorSet(), 1, &fragmentLightOffset);
+	m_primitiveBrush3D.INTERNAL_bindCamera();
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::preDraw()
 {
-	vkAcquireNextImageKHR(m_device.getDevice(), m_swapchain.getSwapchain(), std::numeric_limits<uint64_t>::max(), m_semaphoreImageAvailable.getSemaphore(), VK_NULL_HANDLE, &m_imageIndex);
+	//The frame was last submitted amountOfFramesInFlight frames ago. Usually the GPU is done with it already,
+	//so the CPU only waits if it is that far ahead.
+	m_currentFrame = (m_currentFrame + 1) % m_frames.getLength();
+	VulkanFrame &frame = m_frames[m_currentFrame];
+	frame.waitUntilReusable(m_device);
+	m_uniformRing.freeUpTo(frame.m_uniformRingHead);
+	m_uploadBatcher.update();
+	VulkanObjectCounter::endFrame();
+
+	if (m_headless)
+	{
+		m_imageIndex = (uint32_t)m_currentFrame;
+	}
+	else
+	{
+		vkAcquireNextImageKHR(m_device.getDevice(), m_swapchain.getSwapchain(), std::numeric_limits<uint64_t>::max(), frame.m_semaphoreImageAvailable.getSemaphore(), VK_NULL_HANDLE, &m_imageIndex);
+	}
+
+	//With more frames in flight than swapchain images, another frame may still render into the acquired image.
+	if (m_imagesInFlight[m_imageIndex] != nullptr && m_imagesInFlight[m_imageIndex] != &frame.m_fence)
+	{
+		m_imagesInFlight[m_imageIndex]->wait();
+	}
+	m_imagesInFlight[m_imageIndex] = &frame.m_fence;
 
-	m_currentFrameDrawCommandBuffer = m_commandPool.getCommandBuffer();
+	m_currentFrameDrawCommandBuffer = frame.m_commandBuffer;
 
 	VkCommandBufferBeginInfo cbbi;
 	cbbi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -182,7 +285,7 @@ void bbe::INTERNAL::vulkan::VulkanManager::preDraw()
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassBeginInfo.pNext = nullptr;
 	renderPassBeginInfo.renderPass = m_renderPass.getRenderPass();
-	renderPassBeginInfo.framebuffer = m_swapchain.getFrameBuffer(m_imageIndex);
+	renderPassBeginInfo.framebuffer = getFrameBuffer(m_imageIndex);
 	renderPassBeginInfo.renderArea.offset = { 0, 0 };
 	renderPassBeginInfo.renderArea.extent = { m_screenWidth, m_screenHeight };
 	VkClearValue clearValue = { 0.0f, 0.0f, 0.0f, 1.0f };
@@ -214,37 +317,60 @@ void bbe::INTERNAL::vulkan::VulkanManager::preDraw()
 	scissor.extent = { m_screenWidth, m_screenHeight };
 	vkCmdSetScissor(m_currentFrameDrawCommandBuffer, 0, 1, &scissor);
 
-	m_primitiveBrush2D.INTERNAL_beginDraw(m_device, m_commandPool, m_descriptorPool, m_setLayoutSampler, m_currentFrameDrawCommandBuffer, m_pipeline2DPrimitive, m_pipeline2DImage, m_screenWidth, m_screenHeight);
-	m_primitiveBrush3D.INTERNAL_beginDraw(m_device, m_currentFrameDrawCommandBuffer, m_pipeline3DPrimitive, m_pipeline3DTerrain, m_screenWidth, m_screenHeight);
+	m_primitiveBrush2D.INTERNAL_beginDraw(m_device, m_uploadBatcher, m_descriptorPool, m_setLayoutSampler, m_currentFrameDrawCommandBuffer, m_pipeline2DPrimitive, m_pipeline2DImage, &m_pipeline2DBatched, m_textureAtlas, frame.m_vertexBuffer2D, frame.m_indexBuffer2D, m_screenWidth, m_screenHeight);
+	m_primitiveBrush3D.INTERNAL_beginDraw(m_device, m_currentFrameDrawCommandBuffer, m_pipeline3DPrimitive, m_pipeline3DTerrain, &m_pipeline3DInstanced, m_uniformRing, m_setViewProjectionMatrix, frame.m_instanceBuffer, m_screenWidth, m_screenHeight);
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::postDraw()
 {
+	m_primitiveBrush3D.INTERNAL_flushInstances();
+	m_primitiveBrush2D.INTERNAL_flush();
 	vkCmdEndRenderPass(m_currentFrameDrawCommandBuffer);
 
 	VkResult result = vkEndCommandBuffer(m_currentFrameDrawCommandBuffer);
 	ASSERT_VULKAN(result);
 
-	VkSemaphore semImAv = m_semaphoreImageAvailable.getSemaphore();
-	VkSemaphore semReDo = m_semaphoreRenderingDone.getSemaphore();
+	VulkanFrame &frame = m_frames[m_currentFrame];
+	if (m_pvertexLightData != nullptr)
+	{
+		PointLight::s_writeBuffers(m_pvertexLightData, m_pfragmentLightData);
+		m_pvertexLightData = nullptr;
+		m_pfragmentLightData = nullptr;
+	}
+	frame.m_uniformRingHead = m_uniformRing.getHead();
+
+	VkSemaphore semImAv = frame.m_semaphoreImageAvailable.getSemaphore();
+	VkSemaphore semReDo = frame.m_semaphoreRenderingDone.getSemaphore();
 	VkPipelineStageFlags waitStageMask[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	VkSwapchainKHR swapchain = m_swapchain.getSwapchain();
 	VkQueue queue = m_device.getQueue();
 
+	//Offscreen images are not acquired or presented, so there is nothing to wait for or to signal.
 	VkSubmitInfo si = {};
 	si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	si.pNext = nullptr;
-	si.waitSemaphoreCount = 1;
+	si.waitSemaphoreCount = m_headless ? 0 : 1;
 	si.pWaitSemaphores = &(semImAv);
 	si.pWaitDstStageMask = waitStageMask;
 	si.commandBufferCount = 1;
 	si.pCommandBuffers = &m_currentFrameDrawCommandBuffer;
-	si.signalSemaphoreCount = 1;
+	si.signalSemaphoreCount = m_headless ? 0 : 1;
 	si.pSignalSemaphores = &semReDo;
 
-	result = vkQueueSubmit(queue, 1, &si, m_presentFence.getFence());
+	//Everything uploaded while the frame was recorded has to be submitted before the frame that uses it.
+	m_uploadBatcher.submit();
+
+	frame.m_fence.reset();
+	result = vkQueueSubmit(queue, 1, &si, frame.m_fence.getFence());
 	ASSERT_VULKAN(result);
+	m_lastImageIndex = m_imageIndex;
+	m_frameWasSubmitted = true;
 
+	if (m_headless)
+	{
+		return;
+	}
+
+	VkSwapchainKHR swapchain = m_swapchain.getSwapchain();
 	VkPresentInfoKHR pi = {};
 	pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	pi.pNext = nullptr;
@@ -257,9 +383,6 @@ void bbe::INTERNAL::vulkan::VulkanManager::postDraw()
 
 	result = vkQueuePresentKHR(m_device.getQueue(), &pi);
 	ASSERT_VULKAN(result);
-	m_presentFence.waitForFence();
-	m_commandPool.freeCommandBuffer(m_currentFrameDrawCommandBuffer);
-	destroyPendingBuffers();
 }
 
 bbe::PrimitiveBrush2D * bbe::INTERNAL::vulkan::VulkanManager::getBrush2D()
@@ -272,21 +395,34 @@ bbe::PrimitiveBrush3D * bbe::INTERNAL::vulkan::VulkanManager::getBrush3D()
 	return &m_primitiveBrush3D;
 }
 
-void bbe::INTERNAL::vulkan::VulkanManager::addPendingDestructionBuffer(VkBuffer buffer, VkDeviceMemory memory)
+void bbe::INTERNAL::vulkan::VulkanManager::addPendingDestructionBuffer(VkBuffer buffer, const VulkanMemoryAllocation & memory)
 {
-	m_pendingDestructionBuffers.push(buffer);
-	m_pendingDestructionMemory.push(memory);
+	//Between two frames the current frame is the one that was submitted last, so its fence covers every use.
+	VulkanFrame &frame = m_frames[m_currentFrame];
+	frame.m_pendingDestructionBuffers.push(buffer);
+	frame.m_pendingDestructionMemory.push(memory);
+}
+
+void bbe::INTERNAL::vulkan::VulkanManager::addPendingDestructionImage(VkImage image, VkImageView imageView, VkSampler sampler, const VulkanMemoryAllocation & memory)
+{
+	VulkanFrame &frame = m_frames[m_currentFrame];
+	frame.m_pendingDestructionImages.push(image);
+	frame.m_pendingDestructionImageViews.push(imageView);
+	frame.m_pendingDestructionSamplers.push(sampler);
+	frame.m_pendingDestructionMemory.push(memory);
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::createPipelines()
 {
+	StopWatch watch;
+
 	m_pipeline2DPrimitive.init(m_vertexShader2DPrimitive, m_fragmentShader2DPrimitive, m_screenWidth, m_screenHeight);
 	m_pipeline2DPrimitive.addVertexBinding(0, sizeof(Vector2), VK_VERTEX_INPUT_RATE_VERTEX);
 	m_pipeline2DPrimitive.addVertexDescription(0, 0, VK_FORMAT_R32G32_SFLOAT, 0);
 	m_pipeline2DPrimitive.addPushConstantRange(VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color));
 	m_pipeline2DPrimitive.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(float) * 4);
 	m_pipeline2DPrimitive.enableDepthBuffer();
-	m_pipeline2DPrimitive.create(m_device.getDevice(), m_renderPass.getRenderPass());
+	m_pipeline2DPrimitive.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
 
 	m_pipeline2DImage.init(m_vertexShader2DImage, m_fragmentShader2DImage, m_screenWidth, m_screenHeight);
 	m_pipeline2DImage.addVertexBinding(0, sizeof(Vector2), VK_VERTEX_INPUT_RATE_VERTEX);
@@ -295,7 +431,16 @@ void bbe::INTERNAL::vulkan::VulkanManager::createPipelines()
 	m_pipeline2DImage.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(float) * 4);
 	m_pipeline2DImage.enableDepthBuffer();
 	m_pipeline2DImage.addDescriptorSetLayout(m_setLayoutSampler.getDescriptorSetLayout());
-	m_pipeline2DImage.create(m_device.getDevice(), m_renderPass.getRenderPass());
+	m_pipeline2DImage.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
+
+	m_pipeline2DBatched.init(m_vertexShader2DBatched, m_fragmentShader2DBatched, m_screenWidth, m_screenHeight);
+	m_pipeline2DBatched.addVertexBinding(0, sizeof(Vertex2D), VK_VERTEX_INPUT_RATE_VERTEX);
+	m_pipeline2DBatched.addVertexDescription(0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex2D, m_pos));
+	m_pipeline2DBatched.addVertexDescription(1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex2D, m_uvCoord));
+	m_pipeline2DBatched.addVertexDescription(2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex2D, m_color));
+	m_pipeline2DBatched.enableDepthBuffer();
+	m_pipeline2DBatched.addDescriptorSetLayout(m_setLayoutSampler.getDescriptorSetLayout());
+	m_pipeline2DBatched.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
 
 
 	m_pipeline3DPrimitive.init(m_vertexShader3DPrimitive, m_fragmentShader3DPrimitive, m_screenWidth, m_screenHeight);
@@ -303,7 +448,8 @@ void bbe::INTERNAL::vulkan::VulkanManager::createPipelines()
 	m_pipeline3DPrimitive.addVertexDescription(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_pos));
 	m_pipeline3DPrimitive.addVertexDescription(1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_normal));
 	m_pipeline3DPrimitive.addPushConstantRange(VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color));
-	m_pipeline3DPrimitive.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(Matrix4));
+	//All 3D pipelines share the size of the vertex range of the terrain, so their layouts stay compatible.
+	m_pipeline3DPrimitive.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(TerrainPatch::PushConstants));
 	m_pipeline3DPrimitive.addDescriptorSetLayout(m_setLayoutVertexLight.getDescriptorSetLayout());
 	m_pipeline3DPrimitive.addDescriptorSetLayout(m_setLayoutViewProjectionMatrix.getDescriptorSetLayout());
 	m_pipeline3DPrimitive.addDescriptorSetLayout(m_setLayoutFragmentLight.getDescriptorSetLayout());
@@ -311,14 +457,14 @@ void bbe::INTERNAL::vulkan::VulkanManager::createPipelines()
 	m_pipeline3DPrimitive.addSpezializationConstant(0, 0, sizeof(int32_t));
 	int32_t spezialization = Settings::getAmountOfLightSources();
 	m_pipeline3DPrimitive.setSpezializationData(sizeof(int32_t), &spezialization);
-	m_pipeline3DPrimitive.create(m_device.getDevice(), m_renderPass.getRenderPass());
+	m_pipeline3DPrimitive.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
 
-	m_pipeline3DTerrain.init(m_vertexShader3DPrimitive, m_fragmentShader3DPrimitive, m_screenWidth, m_screenHeight);
-	m_pipeline3DTerrain.addVertexBinding(0, sizeof(VertexWithNormal), VK_VERTEX_INPUT_RATE_VERTEX);
-	m_pipeline3DTerrain.addVertexDescription(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_pos));
-	m_pipeline3DTerrain.addVertexDescription(1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_normal));
+	m_pipeline3DTerrain.init(m_vertexShader3DTerrain, m_fragmentShader3DPrimitive, m_screenWidth, m_screenHeight);
+	m_pipeline3DTerrain.addVertexBinding(0, sizeof(TerrainVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+	m_pipeline3DTerrain.addVertexDescription(0, 0, VK_FORMAT_R16G16_UNORM, offsetof(TerrainVertex, m_height));
+	m_pipeline3DTerrain.addVertexDescription(1, 0, VK_FORMAT_R8G8B8A8_SNORM, offsetof(TerrainVertex, m_normal));
 	m_pipeline3DTerrain.addPushConstantRange(VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color));
-	m_pipeline3DTerrain.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(Matrix4));
+	m_pipeline3DTerrain.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(TerrainPatch::PushConstants));
 	m_pipeline3DTerrain.addDescriptorSetLayout(m_setLayoutVertexLight.getDescriptorSetLayout());
 	m_pipeline3DTerrain.addDescriptorSetLayout(m_setLayoutViewProjectionMatrix.getDescriptorSetLayout());
 	m_pipeline3DTerrain.addDescriptorSetLayout(m_setLayoutFragmentLight.getDescriptorSetLayout());
@@ -327,11 +473,43 @@ void bbe::INTERNAL::vulkan::VulkanManager::createPipelines()
 	m_pipeline3DTerrain.setSpezializationData(sizeof(int32_t), &spezialization);
 	m_pipeline3DTerrain.enablePrimitiveRestart(true);
 	m_pipeline3DTerrain.setPrimitiveTopology(VkPrimitiveTopology::VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP);
-	m_pipeline3DTerrain.create(m_device.getDevice(), m_renderPass.getRenderPass());
+	m_pipeline3DTerrain.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
+
+	//Same layout as the primitive pipeline, so the descriptor sets bound in preDraw3D stay valid.
+	m_pipeline3DInstanced.init(m_vertexShader3DInstanced, m_fragmentShader3DInstanced, m_screenWidth, m_screenHeight);
+	m_pipeline3DInstanced.addVertexBinding(0, sizeof(VertexWithNormal), VK_VERTEX_INPUT_RATE_VERTEX);
+	m_pipeline3DInstanced.addVertexBinding(1, sizeof(InstanceData3D), VK_VERTEX_INPUT_RATE_INSTANCE);
+	m_pipeline3DInstanced.addVertexDescription(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_pos));
+	m_pipeline3DInstanced.addVertexDescription(1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexWithNormal, m_normal));
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		m_pipeline3DInstanced.addVertexDescription(2 + i, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData3D, m_transform) + sizeof(Vector4) * i);
+	}
+	m_pipeline3DInstanced.addVertexDescription(6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData3D, m_color));
+	m_pipeline3DInstanced.addPushConstantRange(VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(Color));
+	m_pipeline3DInstanced.addPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(Color), sizeof(TerrainPatch::PushConstants));
+	m_pipeline3DInstanced.addDescriptorSetLayout(m_setLayoutVertexLight.getDescriptorSetLayout());
+	m_pipeline3DInstanced.addDescriptorSetLayout(m_setLayoutViewProjectionMatrix.getDescriptorSetLayout());
+	m_pipeline3DInstanced.addDescriptorSetLayout(m_setLayoutFragmentLight.getDescriptorSetLayout());
+	m_pipeline3DInstanced.enableDepthBuffer();
+	m_pipeline3DInstanced.addSpezializationConstant(0, 0, sizeof(int32_t));
+	m_pipeline3DInstanced.setSpezializationData(sizeof(int32_t), &spezialization);
+	m_pipeline3DInstanced.create(m_device.getDevice(), m_renderPass.getRenderPass(), m_pipelineCache.getPipelineCache());
+
+	m_pipelineCreationMicroseconds = watch.getTimeExpiredMicroseconds();
 }
 
 void bbe::INTERNAL::vulkan::VulkanManager::resize(uint32_t width, uint32_t height)
 {
+	if (m_headless)
+	{
+		if (width == 0 || height == 0) return;
+		m_screenWidth = width;
+		m_screenHeight = height;
+		recreateSwapchain();
+		return;
+	}
+
 	VkSurfaceCapabilitiesKHR surfaceCapabilities;
 	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_device.getPhysicalDevice(), m_surface.getSurface(), &surfaceCapabilities);
 
@@ -349,25 +527,128 @@ void bbe::INTERNAL::vulkan::VulkanManager::resize(uint32_t width, uint32_t heigh
 
 void bbe::INTERNAL::vulkan::VulkanManager::recreateSwapchain()
 {
+	StopWatch watch;
 	m_device.waitIdle();
 
-
-	m_pipeline2DPrimitive.destroy();
-	m_pipeline2DImage.destroy();
-	m_pipeline3DPrimitive.destroy();
-	m_pipeline3DTerrain.destroy();
-	m_renderPass.destroy();
+	//The render pass only depends on the surface format and the pipelines use a dynamic viewport and scissor,
+	//so both are kept.
 	m_depthImage.destroy();
-	//m_swapchain.destroy();
+
+	if (m_headless)
+	{
+		//A frame that was not captured yet is lost.
+		m_offscreenTarget.destroy();
+		m_offscreenTarget.init(m_device, m_screenWidth, m_screenHeight, (uint32_t)m_frames.getLength());
+		m_depthImage.create(m_device, m_commandPool, m_screenWidth, m_screenHeight);
+		m_offscreenTarget.createFramebuffers(m_depthImage, m_renderPass);
+		m_frameWasSubmitted = false;
+		resetImagesInFlight();
+		m_swapchainRecreationMicroseconds = watch.getTimeExpiredMicroseconds();
+		return;
+	}
 
 	VulkanSwapchain newChain;
 	newChain.init(m_surface, m_device, m_screenWidth, m_screenHeight, &m_swapchain);
-	m_renderPass.init(m_device);
 	m_depthImage.create(m_device, m_commandPool, m_screenWidth, m_screenHeight);
 	newChain.createFramebuffers(m_depthImage, m_renderPass);
-	createPipelines();
 
 	m_swapchain.destroy();
 	m_swapchain = newChain;
+	resetImagesInFlight();
+	m_swapchainRecreationMicroseconds = watch.getTimeExpiredMicroseconds();
 }
 
+long long bbe::INTERNAL::vulkan::VulkanManager::getPipelineCreationMicroseconds() const
+{
+	return m_pipelineCreationMicroseconds;
+}
+
+long long bbe::INTERNAL::vulkan::VulkanManager::getSwapchainRecreationMicroseconds() const
+{
+	return m_swapchainRecreationMicroseconds;
+}
+
+bool bbe::INTERNAL::vulkan::VulkanManager::isHeadless() const
+{
+	return m_headless;
+}
+
+void bbe::INTERNAL::vulkan::VulkanManager::captureFrame(Image & outImage)
+{
+	if (!m_headless)
+	{
+		throw IllegalStateException("Frames can only be captured without a window!");
+	}
+	if (!m_frameWasSubmitted)
+	{
+		throw IllegalStateException("No frame was submitted yet!");
+	}
+
+	m_device.waitIdle();
+
+	const uint32_t width = m_offscreenTarget.getWidth();
+	const uint32_t height = m_offscreenTarget.getHeight();
+	VulkanBuffer readbackBuffer;
+	readbackBuffer.create(m_device, (size_t)width * height * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+	VkCommandBuffer commandBuffer = startSingleTimeCommandBuffer(m_device.getDevice(), m_commandPool.getCommandPool());
+
+	//The render pass already left the image in TRANSFER_SRC_OPTIMAL, only the writes have to be made visible.
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.pNext = nullptr;
+	barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = m_offscreenTarget.getImage(m_lastImageIndex);
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkBufferImageCopy region = {};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { width, height, 1 };
+	vkCmdCopyImageToBuffer(commandBuffer, m_offscreenTarget.getImage(m_lastImageIndex), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer.getBuffer(), 1, &region);
+
+	//The copy has to be made visible to the host before the buffer is mapped.
+	VkBufferMemoryBarrier readbackBarrier = {};
+	readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	readbackBarrier.pNext = nullptr;
+	readbackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.buffer = readbackBuffer.getBuffer();
+	readbackBarrier.offset = 0;
+	readbackBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &readbackBarrier, 0, nullptr);
+
+	endSingleTimeCommandBuffer(m_device.getDevice(), m_device.getQueue(), m_commandPool.getCommandPool(), commandBuffer);
+
+	outImage.destroy();
+	outImage.load((int)width, (int)height);
+	const byte *pixels = (const byte*)readbackBuffer.map();
+	for (size_t i = 0; i < (size_t)width * height; i++)
+	{
+		//The device format is B8G8R8A8.
+		outImage.m_pdata[i].r = pixels[i * 4 + 2];
+		outImage.m_pdata[i].g = pixels[i * 4 + 1];
+		outImage.m_pdata[i].b = pixels[i * 4 + 0];
+		outImage.m_pdata[i].a = pixels[i * 4 + 3];
+	}
+	readbackBuffer.unmap();
+	readbackBuffer.destroy();
+}
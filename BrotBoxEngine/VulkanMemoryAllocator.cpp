@@ -0,0 +1,265 @@
+#include "stdafx.h"
+#include "BBE/VulkanMemoryAllocator.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/VulkanHelper.h"
+#include "BBE/VulkanObjectCounter.h"
+#include "BBE/Exceptions.h"
+
+bbe::INTERNAL::vulkan::VulkanMemoryAllocator *bbe::INTERNAL::vulkan::VulkanMemoryAllocator::s_pinstance = nullptr;
+const VkDeviceSize bbe::INTERNAL::vulkan::VulkanMemoryAllocator::BLOCK_SIZE = 64 * 1024 * 1024;
+
+VkDeviceSize bbe::INTERNAL::vulkan::VulkanMemoryAllocator::getBlockSize(uint32_t memoryTypeIndex) const
+{
+	//Small heaps, like the host visible part of the VRAM, would be used up by a few blocks.
+	const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+	if (heapSize / 8 < BLOCK_SIZE)
+	{
+		return heapSize / 8;
+	}
+	return BLOCK_SIZE;
+}
+
+size_t bbe::INTERNAL::vulkan::VulkanMemoryAllocator::findBlock(VkDeviceMemory memory) const
+{
+	for (size_t i = 0; i < m_blocks.getLength(); i++)
+	{
+		if (m_blocks[i].m_memory == memory)
+		{
+			return i;
+		}
+	}
+	throw IllegalArgumentException();
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::releaseBlock(size_t index)
+{
+	//Freeing the memory unmaps it as well.
+	vkFreeMemory(m_device, m_blocks[index].m_memory, nullptr);
+	m_blocks.removeIndex(index);
+}
+
+bbe::INTERNAL::vulkan::VulkanMemoryAllocator::VulkanMemoryAllocator()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::init(const VulkanDevice & device)
+{
+	if (m_device != VK_NULL_HANDLE)
+	{
+		throw AlreadyCreatedException();
+	}
+
+	m_device = device.getDevice();
+	m_physicalDevice = device.getPhysicalDevice();
+	vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+	m_bufferImageGranularity = properties.limits.bufferImageGranularity;
+
+	s_pinstance = this;
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::destroy()
+{
+	if (m_device == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	while (m_blocks.getLength() > 0)
+	{
+		releaseBlock(m_blocks.getLength() - 1);
+	}
+	m_amountOfDedicatedAllocations = 0;
+	m_dedicatedBytes = 0;
+	m_device = VK_NULL_HANDLE;
+	m_physicalDevice = VK_NULL_HANDLE;
+
+	if (s_pinstance == this)
+	{
+		s_pinstance = nullptr;
+	}
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::allocate(const VkMemoryRequirements & requirements, VkMemoryPropertyFlags properties, bool linear, VulkanMemoryAllocation & outAllocation)
+{
+	if (m_device == VK_NULL_HANDLE)
+	{
+		throw NotInitializedException();
+	}
+
+	const uint32_t memoryTypeIndex = findMemoryTypeIndex(m_physicalDevice, requirements.memoryTypeBits, properties);
+	const VkDeviceSize blockSize = getBlockSize(memoryTypeIndex);
+	if (requirements.size > blockSize / 2)
+	{
+		allocateDedicated(m_device, m_physicalDevice, requirements, properties, outAllocation);
+		m_amountOfDedicatedAllocations++;
+		m_dedicatedBytes += outAllocation.m_size;
+		return;
+	}
+
+	if (m_bufferImageGranularity <= 1)
+	{
+		linear = true;
+	}
+
+	size_t blockIndex = m_blocks.getLength();
+	uint64_t offset = 0;
+	for (size_t i = 0; i < m_blocks.getLength(); i++)
+	{
+		if (m_blocks[i].m_memoryTypeIndex == memoryTypeIndex && m_blocks[i].m_linear == linear && m_blocks[i].m_allocator.allocate(requirements.size, requirements.alignment, offset))
+		{
+			blockIndex = i;
+			break;
+		}
+	}
+
+	if (blockIndex == m_blocks.getLength())
+	{
+		Block block;
+		block.m_memoryTypeIndex = memoryTypeIndex;
+		block.m_linear = linear;
+		block.m_allocator.reset(blockSize);
+
+		VkMemoryAllocateInfo memoryAllocateInfo;
+		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocateInfo.pNext = nullptr;
+		memoryAllocateInfo.allocationSize = blockSize;
+		memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkResult result = vkAllocateMemory(m_device, &memoryAllocateInfo, nullptr, &block.m_memory);
+		ASSERT_VULKAN(result);
+		VulkanObjectCounter::count(VulkanObjectType::DEVICE_MEMORY);
+
+		if ((m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+		{
+			result = vkMapMemory(m_device, block.m_memory, 0, VK_WHOLE_SIZE, 0, &block.m_pmapped);
+			ASSERT_VULKAN(result);
+		}
+
+		block.m_allocator.allocate(requirements.size, requirements.alignment, offset);
+		m_blocks.add(block);
+	}
+
+	const Block &block = m_blocks[blockIndex];
+	outAllocation.m_memory = block.m_memory;
+	outAllocation.m_offset = offset;
+	outAllocation.m_size = requirements.size;
+	outAllocation.m_pmapped = block.m_pmapped != nullptr ? (unsigned char*)block.m_pmapped + offset : nullptr;
+	outAllocation.m_dedicated = false;
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::free(VulkanMemoryAllocation & allocation)
+{
+	if (allocation.m_memory == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	if (allocation.m_dedicated)
+	{
+		vkFreeMemory(m_device, allocation.m_memory, nullptr);
+		if (m_amountOfDedicatedAllocations > 0)
+		{
+			m_amountOfDedicatedAllocations--;
+			m_dedicatedBytes -= allocation.m_size;
+		}
+	}
+	else
+	{
+		const size_t index = findBlock(allocation.m_memory);
+		Block &block = m_blocks[index];
+		block.m_allocator.free(allocation.m_offset, allocation.m_size);
+
+		if (block.m_allocator.isEmpty())
+		{
+			//One empty block per kind is kept, so a resource that is recreated every frame does not allocate.
+			for (size_t i = 0; i < m_blocks.getLength(); i++)
+			{
+				if (i != index && m_blocks[i].m_memoryTypeIndex == block.m_memoryTypeIndex && m_blocks[i].m_linear == block.m_linear && m_blocks[i].m_allocator.isEmpty())
+				{
+					releaseBlock(index);
+					break;
+				}
+			}
+		}
+	}
+
+	allocation = VulkanMemoryAllocation();
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::releaseEmptyBlocks()
+{
+	for (size_t i = m_blocks.getLength(); i > 0; i--)
+	{
+		if (m_blocks[i - 1].m_allocator.isEmpty())
+		{
+			releaseBlock(i - 1);
+		}
+	}
+}
+
+bbe::INTERNAL::vulkan::VulkanMemoryStats bbe::INTERNAL::vulkan::VulkanMemoryAllocator::getStats() const
+{
+	VulkanMemoryStats stats;
+	stats.m_amountOfBlocks = m_blocks.getLength();
+	stats.m_amountOfDedicatedAllocations = m_amountOfDedicatedAllocations;
+	stats.m_dedicatedBytes = m_dedicatedBytes;
+	for (size_t i = 0; i < m_blocks.getLength(); i++)
+	{
+		const FreeListAllocator &allocator = m_blocks[i].m_allocator;
+		if (allocator.isEmpty())
+		{
+			stats.m_amountOfEmptyBlocks++;
+		}
+		stats.m_amountOfAllocations += allocator.getAmountOfAllocations();
+		stats.m_blockBytes += allocator.getSize();
+		stats.m_usedBlockBytes += allocator.getUsedSize();
+		if (allocator.getLargestFreeRange() > stats.m_largestFreeRange)
+		{
+			stats.m_largestFreeRange = allocator.getLargestFreeRange();
+		}
+	}
+	return stats;
+}
+
+void bbe::INTERNAL::vulkan::VulkanMemoryAllocator::allocateDedicated(VkDevice device, VkPhysicalDevice physicalDevice, const VkMemoryRequirements & requirements, VkMemoryPropertyFlags properties, VulkanMemoryAllocation & outAllocation)
+{
+	VkMemoryAllocateInfo memoryAllocateInfo;
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.pNext = nullptr;
+	memoryAllocateInfo.allocationSize = requirements.size;
+	memoryAllocateInfo.memoryTypeIndex = findMemoryTypeIndex(physicalDevice, requirements.memoryTypeBits, properties);
+
+	VkResult result = vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &outAllocation.m_memory);
+	ASSERT_VULKAN(result);
+	VulkanObjectCounter::count(VulkanObjectType::DEVICE_MEMORY);
+
+	outAllocation.m_offset = 0;
+	outAllocation.m_size = requirements.size;
+	outAllocation.m_pmapped = nullptr;
+	outAllocation.m_dedicated = true;
+	if ((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+	{
+		result = vkMapMemory(device, outAllocation.m_memory, 0, VK_WHOLE_SIZE, 0, &outAllocation.m_pmapped);
+		ASSERT_VULKAN(result);
+	}
+}
+
+void bbe::INTERNAL::vulkan::freeMemory(VkDevice device, VulkanMemoryAllocation & allocation)
+{
+	if (VulkanMemoryAllocator::s_pinstance != nullptr)
+	{
+		VulkanMemoryAllocator::s_pinstance->free(allocation);
+		return;
+	}
+
+	//Blocks are freed together with their allocator.
+	if (allocation.m_dedicated)
+	{
+		vkFreeMemory(device, allocation.m_memory, nullptr);
+	}
+	allocation = VulkanMemoryAllocation();
+}
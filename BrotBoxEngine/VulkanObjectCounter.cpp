@@ -0,0 +1,52 @@
+#include "stdafx.h"
+#include "BBE/VulkanObjectCounter.h"
+#include "BBE/Exceptions.h"
+
+std::atomic<uint32_t> bbe::INTERNAL::vulkan::VulkanObjectCounter::s_currentFrame[(int)VulkanObjectType::AMOUNT_OF_TYPES] = {};
+uint32_t              bbe::INTERNAL::vulkan::VulkanObjectCounter::s_lastFrame[(int)VulkanObjectType::AMOUNT_OF_TYPES] = {};
+std::atomic<uint64_t> bbe::INTERNAL::vulkan::VulkanObjectCounter::s_total[(int)VulkanObjectType::AMOUNT_OF_TYPES] = {};
+
+static int toIndex(bbe::INTERNAL::vulkan::VulkanObjectType type)
+{
+	const int index = (int)type;
+	if (index < 0 || index >= (int)bbe::INTERNAL::vulkan::VulkanObjectType::AMOUNT_OF_TYPES)
+	{
+		throw bbe::IllegalArgumentException();
+	}
+	return index;
+}
+
+void bbe::INTERNAL::vulkan::VulkanObjectCounter::count(VulkanObjectType type, uint32_t amount)
+{
+	const int index = toIndex(type);
+	s_currentFrame[index] += amount;
+	s_total[index] += amount;
+}
+
+void bbe::INTERNAL::vulkan::VulkanObjectCounter::endFrame()
+{
+	for (int i = 0; i < (int)VulkanObjectType::AMOUNT_OF_TYPES; i++)
+	{
+		s_lastFrame[i] = s_currentFrame[i].exchange(0);
+	}
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanObjectCounter::getAmountLastFrame(VulkanObjectType type)
+{
+	return s_lastFrame[toIndex(type)];
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanObjectCounter::getAmountLastFrame()
+{
+	uint32_t amount = 0;
+	for (int i = 0; i < (int)VulkanObjectType::AMOUNT_OF_TYPES; i++)
+	{
+		amount += s_lastFrame[i];
+	}
+	return amount;
+}
+
+uint64_t bbe::INTERNAL::vulkan::VulkanObjectCounter::getTotalAmount(VulkanObjectType type)
+{
+	return s_total[toIndex(type)];
+}
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "BBE/VulkanOffscreenTarget.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/VulkanRenderPass.h"
+#include "BBE/VWDepthImage.h"
+#include "BBE/VulkanHelper.h"
+#include "BBE/Exceptions.h"
+
+bbe::INTERNAL::vulkan::VulkanOffscreenTarget::VulkanOffscreenTarget()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanOffscreenTarget::init(const VulkanDevice & device, uint32_t width, uint32_t height, uint32_t amountOfImages)
+{
+	if (m_device != VK_NULL_HANDLE)
+	{
+		throw AlreadyCreatedException();
+	}
+	if (width == 0 || height == 0 || amountOfImages == 0)
+	{
+		throw IllegalArgumentException();
+	}
+
+	m_device = device.getDevice();
+	m_width = width;
+	m_height = height;
+
+	m_images.resizeCapacityAndLength(amountOfImages);
+	m_imageMemory.resizeCapacityAndLength(amountOfImages);
+	m_imageViews.resizeCapacityAndLength(amountOfImages);
+	for (uint32_t i = 0; i < amountOfImages; i++)
+	{
+		createImage(m_device, device.getPhysicalDevice(), width, height, device.getFormat(), VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_images[i], m_imageMemory[i]);
+		createImageView(m_device, m_images[i], device.getFormat(), VK_IMAGE_ASPECT_COLOR_BIT, m_imageViews[i]);
+	}
+}
+
+void bbe::INTERNAL::vulkan::VulkanOffscreenTarget::destroy()
+{
+	if (m_device == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < m_frameBuffers.getLength(); i++)
+	{
+		vkDestroyFramebuffer(m_device, m_frameBuffers[i], nullptr);
+	}
+	for (size_t i = 0; i < m_images.getLength(); i++)
+	{
+		vkDestroyImageView(m_device, m_imageViews[i], nullptr);
+		vkDestroyImage(m_device, m_images[i], nullptr);
+		freeMemory(m_device, m_imageMemory[i]);
+	}
+
+	m_frameBuffers.clear();
+	m_imageViews.clear();
+	m_imageMemory.clear();
+	m_images.clear();
+	m_device = VK_NULL_HANDLE;
+	m_width = 0;
+	m_height = 0;
+}
+
+void bbe::INTERNAL::vulkan::VulkanOffscreenTarget::createFramebuffers(const VWDepthImage & depthImage, const VulkanRenderPass & renderPass)
+{
+	for (size_t i = 0; i < m_images.getLength(); i++)
+	{
+		bbe::List<VkImageView> attachmentViews = {
+			m_imageViews[i],
+			depthImage.getImageView()
+		};
+
+		VkFramebufferCreateInfo framebufferCreateInfo;
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.pNext = nullptr;
+		framebufferCreateInfo.flags = 0;
+		framebufferCreateInfo.renderPass = renderPass.getRenderPass();
+		framebufferCreateInfo.attachmentCount = attachmentViews.getLength();
+		framebufferCreateInfo.pAttachments = attachmentViews.getRaw();
+		framebufferCreateInfo.width = m_width;
+		framebufferCreateInfo.height = m_height;
+		framebufferCreateInfo.layers = 1;
+
+		VkFramebuffer frameBuffer;
+		VkResult result = vkCreateFramebuffer(m_device, &framebufferCreateInfo, nullptr, &frameBuffer);
+		ASSERT_VULKAN(result);
+
+		m_frameBuffers.add(frameBuffer);
+	}
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanOffscreenTarget::getAmountOfImages() const
+{
+	return (uint32_t)m_images.getLength();
+}
+
+VkFramebuffer bbe::INTERNAL::vulkan::VulkanOffscreenTarget::getFrameBuffer(size_t index) const
+{
+	return m_frameBuffers[index];
+}
+
+VkImage bbe::INTERNAL::vulkan::VulkanOffscreenTarget::getImage(size_t index) const
+{
+	return m_images[index];
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanOffscreenTarget::getWidth() const
+{
+	return m_width;
+}
+
+uint32_t bbe::INTERNAL::vulkan::VulkanOffscreenTarget::getHeight() const
+{
+	return m_height;
+}
@@ -3,6 +3,7 @@
 #include "BBE/VulkanInstance.h"
 #include "BBE/VulkanSurface.h"
 #include "BBE/List.h"
+#include "BBE/Exceptions.h"
 
 bbe::INTERNAL::vulkan::VulkanPhysicalDevice::VulkanPhysicalDevice(const VkPhysicalDevice & device, const VulkanSurface & surface)
 	: m_device(device)
@@ -10,13 +11,25 @@ bbe::INTERNAL::vulkan::VulkanPhysicalDevice::VulkanPhysicalDevice(const VkPhysic
 	vkGetPhysicalDeviceProperties(device, &m_properties);
 	vkGetPhysicalDeviceFeatures(device, &m_features);
 	vkGetPhysicalDeviceMemoryProperties(device, &m_memoryProperties);
-	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface.getSurface(), &m_surfaceCapabilities);
 
 	uint32_t amountOfQueueFamilyProperties = 0;
 	vkGetPhysicalDeviceQueueFamilyProperties(device, &amountOfQueueFamilyProperties, nullptr);
 	m_queueFamilyProperties.resizeCapacityAndLength(amountOfQueueFamilyProperties);
 	vkGetPhysicalDeviceQueueFamilyProperties(device, &amountOfQueueFamilyProperties, m_queueFamilyProperties.getRaw());
 
+	uint32_t amountOfExtensionProperties = 0;
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &amountOfExtensionProperties, nullptr);
+	m_extensionProperties.resizeCapacityAndLength(amountOfExtensionProperties);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &amountOfExtensionProperties, m_extensionProperties.getRaw());
+
+	if (surface.getSurface() == VK_NULL_HANDLE)
+	{
+		//Rendering without a window.
+		return;
+	}
+
+	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface.getSurface(), &m_surfaceCapabilities);
+
 	uint32_t amountOfSurfaceFormats = 0;
 	vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface.getSurface(), &amountOfSurfaceFormats, nullptr);
 	m_surfaceFormats.resizeCapacityAndLength(amountOfSurfaceFormats);
@@ -26,11 +39,6 @@ bbe::INTERNAL::vulkan::VulkanPhysicalDevice::VulkanPhysicalDevice(const VkPhysic
 	vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface.getSurface(), &amountOfPresentModes, nullptr);
 	m_presentModes.resizeCapacityAndLength(amountOfPresentModes);
 	vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface.getSurface(), &amountOfPresentModes, m_presentModes.getRaw());
-
-	uint32_t amountOfExtensionProperties = 0;
-	vkEnumerateDeviceExtensionProperties(device, nullptr, &amountOfExtensionProperties, nullptr);
-	m_extensionProperties.resizeCapacityAndLength(amountOfExtensionProperties);
-	vkEnumerateDeviceExtensionProperties(device, nullptr, &amountOfExtensionProperties, m_extensionProperties.getRaw());
 }
 
 uint32_t bbe::INTERNAL::vulkan::VulkanPhysicalDevice::findBestCompleteQueueIndex() const
@@ -38,6 +46,20 @@ uint32_t bbe::INTERNAL::vulkan::VulkanPhysicalDevice::findBestCompleteQueueIndex
 	return 0; //TODO find best queue index which is complete
 }
 
+bool bbe::INTERNAL::vulkan::VulkanPhysicalDevice::findDedicatedTransferQueueIndex(uint32_t & outIndex) const
+{
+	for (size_t i = 0; i < m_queueFamilyProperties.getLength(); i++)
+	{
+		const VkQueueFlags flags = m_queueFamilyProperties[i].queueFlags;
+		if ((flags & VK_QUEUE_TRANSFER_BIT) != 0 && (flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0 && m_queueFamilyProperties[i].queueCount > 0)
+		{
+			outIndex = (uint32_t)i;
+			return true;
+		}
+	}
+	return false;
+}
+
 VkPhysicalDevice bbe::INTERNAL::vulkan::VulkanPhysicalDevice::getDevice() const
 {
 	return m_device;
@@ -65,6 +87,16 @@ void bbe::INTERNAL::vulkan::PhysicalDeviceContainer::init(const VulkanInstance &
 
 const bbe::INTERNAL::vulkan::VulkanPhysicalDevice & bbe::INTERNAL::vulkan::PhysicalDeviceContainer::findBestDevice(const VulkanSurface & surface) const
 {
+	if (m_devices.getLength() == 0)
+	{
+		throw IllegalStateException("No Vulkan device found!");
+	}
+	if (surface.getSurface() == VK_NULL_HANDLE)
+	{
+		//Without a window any device can render, for example a software implementation on a machine without GPU.
+		return m_devices[0];
+	}
+
 	for (size_t i = 0; i < m_devices.getLength(); i++)
 	{
 		VkBool32 supported = false;
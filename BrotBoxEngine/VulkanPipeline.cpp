@@ -2,6 +2,7 @@
 #include "BBE/VulkanPipeline.h"
 #include "BBE/VWDepthImage.h"
 #include "BBE/VulkanShader.h"
+#include "BBE/VulkanObjectCounter.h"
 
 bbe::INTERNAL::vulkan::VulkanPipeline::VulkanPipeline()
 {
@@ -108,7 +109,7 @@ void bbe::INTERNAL::vulkan::VulkanPipeline::init(VulkanShader vertexShader, Vulk
 	m_wasInitialized = true;
 }
 
-void bbe::INTERNAL::vulkan::VulkanPipeline::create(VkDevice device, VkRenderPass renderPass)
+void bbe::INTERNAL::vulkan::VulkanPipeline::create(VkDevice device, VkRenderPass renderPass, VkPipelineCache pipelineCache)
 {
 	if (!m_wasInitialized)
 	{
@@ -206,8 +207,9 @@ void bbe::INTERNAL::vulkan::VulkanPipeline::create(VkDevice device, VkRenderPass
 	pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineCreateInfo.basePipelineIndex = -1;
 
-	result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &m_pipeline);
+	result = vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCreateInfo, nullptr, &m_pipeline);
 	ASSERT_VULKAN(result);
+	VulkanObjectCounter::count(VulkanObjectType::PIPELINE);
 
 	m_wasCreated = true;
 }
@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include "BBE/VulkanPipelineCache.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/VulkanHelper.h"
+#include "BBE/SimpleFile.h"
+#include "BBE/List.h"
+#include "BBE/Exceptions.h"
+#include <string.h>
+
+static const uint32_t PIPELINE_CACHE_MAGIC   = 0x43504242; //"BBPC"
+static const uint32_t PIPELINE_CACHE_VERSION = 1;
+
+struct PipelineCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vendorID;
+	uint32_t deviceID;
+	uint32_t driverVersion;
+	uint32_t padding;
+	uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+	uint64_t dataSize;
+};
+
+static bool isHeaderValid(const PipelineCacheHeader &header, const VkPhysicalDeviceProperties &properties, size_t fileSize)
+{
+	//The driver checks its own header in the data as well, but a cache of an other driver version could still
+	//be accepted and lead to broken pipelines on some drivers.
+	return header.magic == PIPELINE_CACHE_MAGIC
+		&& header.version == PIPELINE_CACHE_VERSION
+		&& header.vendorID == properties.vendorID
+		&& header.deviceID == properties.deviceID
+		&& header.driverVersion == properties.driverVersion
+		&& memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0
+		&& header.dataSize == fileSize - sizeof(PipelineCacheHeader);
+}
+
+bbe::INTERNAL::vulkan::VulkanPipelineCache::VulkanPipelineCache()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanPipelineCache::init(const VulkanDevice & device, const String & filePath)
+{
+	if (m_pipelineCache != VK_NULL_HANDLE)
+	{
+		throw AlreadyCreatedException();
+	}
+
+	m_device = device.getDevice();
+	m_filePath = filePath;
+	vkGetPhysicalDeviceProperties(device.getPhysicalDevice(), &m_properties);
+
+	VkPipelineCacheCreateInfo pcci = {};
+	pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pcci.pNext = nullptr;
+	pcci.flags = 0;
+	pcci.initialDataSize = 0;
+	pcci.pInitialData = nullptr;
+
+	simpleFile::MappedFile file;
+	if (m_filePath.getLength() > 0 && file.open(m_filePath) && file.getSize() > sizeof(PipelineCacheHeader))
+	{
+		const PipelineCacheHeader *header = (const PipelineCacheHeader*)file.getData();
+		if (isHeaderValid(*header, m_properties, file.getSize()))
+		{
+			pcci.initialDataSize = (size_t)header->dataSize;
+			pcci.pInitialData = file.getData() + sizeof(PipelineCacheHeader);
+		}
+	}
+
+	VkResult result = vkCreatePipelineCache(m_device, &pcci, nullptr, &m_pipelineCache);
+	if (result != VK_SUCCESS && pcci.pInitialData != nullptr)
+	{
+		//The driver rejected the data, an empty cache is still better than none.
+		pcci.initialDataSize = 0;
+		pcci.pInitialData = nullptr;
+		result = vkCreatePipelineCache(m_device, &pcci, nullptr, &m_pipelineCache);
+	}
+	ASSERT_VULKAN(result);
+	m_loadedFromFile = pcci.pInitialData != nullptr;
+}
+
+void bbe::INTERNAL::vulkan::VulkanPipelineCache::destroy()
+{
+	if (m_pipelineCache != VK_NULL_HANDLE)
+	{
+		vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+		m_pipelineCache = VK_NULL_HANDLE;
+		m_device = VK_NULL_HANDLE;
+		m_loadedFromFile = false;
+	}
+}
+
+bool bbe::INTERNAL::vulkan::VulkanPipelineCache::save() const
+{
+	if (m_pipelineCache == VK_NULL_HANDLE)
+	{
+		throw NotInitializedException();
+	}
+	if (m_filePath.getLength() == 0)
+	{
+		return true;
+	}
+
+	size_t dataSize = 0;
+	VkResult result = vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, nullptr);
+	ASSERT_VULKAN(result);
+	List<char> data;
+	data.resizeCapacityAndLength(dataSize);
+	result = vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, data.getRaw());
+	ASSERT_VULKAN(result);
+
+	PipelineCacheHeader header = {};
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.version = PIPELINE_CACHE_VERSION;
+	header.vendorID = m_properties.vendorID;
+	header.deviceID = m_properties.deviceID;
+	header.driverVersion = m_properties.driverVersion;
+	header.padding = 0;
+	memcpy(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.dataSize = dataSize;
+
+	simpleFile::BinaryFileWriter writer(m_filePath);
+	writer.write(&header, sizeof(header));
+	writer.write(data.getRaw(), dataSize);
+	return writer.commit();
+}
+
+VkPipelineCache bbe::INTERNAL::vulkan::VulkanPipelineCache::getPipelineCache() const
+{
+	return m_pipelineCache;
+}
+
+bool bbe::INTERNAL::vulkan::VulkanPipelineCache::wasLoadedFromFile() const
+{
+	return m_loadedFromFile;
+}
@@ -15,7 +15,7 @@ void bbe::INTERNAL::vulkan::VulkanRenderPass::destroy()
 	}
 }
 
-void bbe::INTERNAL::vulkan::VulkanRenderPass::init(const VulkanDevice & device)
+void bbe::INTERNAL::vulkan::VulkanRenderPass::init(const VulkanDevice & device, VkImageLayout finalLayout)
 {
 	m_device = device.getDevice();
 
@@ -28,7 +28,7 @@ void bbe::INTERNAL::vulkan::VulkanRenderPass::init(const VulkanDevice & device)
 	attachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	attachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	attachmentDescription.finalLayout = finalLayout;
 
 	VkAttachmentReference attachmentReference = {};
 	attachmentReference.attachment = 0;
@@ -55,10 +55,11 @@ void bbe::INTERNAL::vulkan::VulkanRenderPass::init(const VulkanDevice & device)
 	VkSubpassDependency subpassDependency = {};
 	subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
 	subpassDependency.dstSubpass = 0;
-	subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpassDependency.srcAccessMask = 0;
-	subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	//All frames in flight share the depth image, so a frame must not clear it before the previous one finished its depth tests.
+	subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	subpassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 	subpassDependency.dependencyFlags = 0;
 
 	bbe::List<VkAttachmentDescription> attachments;
@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "BBE/VulkanUniformRing.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/Exceptions.h"
+
+const size_t bbe::INTERNAL::vulkan::VulkanUniformRing::BUFFER_SIZE = 1024 * 1024;
+
+bbe::INTERNAL::vulkan::VulkanUniformRing::VulkanUniformRing()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanUniformRing::init(const VulkanDevice & device)
+{
+	if (m_pdata != nullptr)
+	{
+		throw AlreadyCreatedException();
+	}
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(device.getPhysicalDevice(), &properties);
+	m_alignment = (size_t)properties.limits.minUniformBufferOffsetAlignment;
+	if (m_alignment == 0)
+	{
+		m_alignment = 1;
+	}
+
+	m_buffer.create(device, BUFFER_SIZE, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+	m_pdata = (unsigned char*)m_buffer.map();
+	m_ring.reset(BUFFER_SIZE);
+}
+
+void bbe::INTERNAL::vulkan::VulkanUniformRing::destroy()
+{
+	if (m_pdata == nullptr)
+	{
+		return;
+	}
+
+	m_buffer.unmap();
+	m_buffer.destroy();
+	m_pdata = nullptr;
+}
+
+void * bbe::INTERNAL::vulkan::VulkanUniformRing::allocate(size_t size, uint32_t & outOffset)
+{
+	if (m_pdata == nullptr)
+	{
+		throw NotInitializedException();
+	}
+
+	size_t offset = 0;
+	if (!m_ring.allocate(size, m_alignment, offset))
+	{
+		//The slots of the frames in flight fill the whole buffer.
+		throw AllocatorOutOfMemoryException();
+	}
+
+	outOffset = (uint32_t)offset;
+	return m_pdata + offset;
+}
+
+uint64_t bbe::INTERNAL::vulkan::VulkanUniformRing::getHead() const
+{
+	return m_ring.getHead();
+}
+
+void bbe::INTERNAL::vulkan::VulkanUniformRing::freeUpTo(uint64_t position)
+{
+	m_ring.freeUpTo(position);
+}
+
+const bbe::INTERNAL::vulkan::VulkanBuffer & bbe::INTERNAL::vulkan::VulkanUniformRing::getBuffer() const
+{
+	return m_buffer;
+}
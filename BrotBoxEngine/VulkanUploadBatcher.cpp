@@ -0,0 +1,446 @@
+#include "stdafx.h"
+#include "BBE/VulkanUploadBatcher.h"
+#include "BBE/VulkanDevice.h"
+#include "BBE/VulkanHelper.h"
+#include "BBE/Exceptions.h"
+#include <string.h>
+
+const size_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::STAGING_BUFFER_SIZE = 16 * 1024 * 1024;
+const size_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::AMOUNT_OF_BATCHES   = 4;
+const size_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::ALIGNMENT           = 16;
+
+bbe::INTERNAL::vulkan::VulkanUploadBatcher::Batch & bbe::INTERNAL::vulkan::VulkanUploadBatcher::getRecordingBatch()
+{
+	if (m_precording != nullptr)
+	{
+		return *m_precording;
+	}
+
+	if (m_pdevice == nullptr)
+	{
+		throw NotInitializedException();
+	}
+
+	update();
+	Batch *batch = nullptr;
+	while (batch == nullptr)
+	{
+		for (size_t i = 0; i < m_batches.getLength(); i++)
+		{
+			if (m_batches[i].m_state == BatchState::FREE)
+			{
+				batch = &m_batches[i];
+				break;
+			}
+		}
+		if (batch == nullptr)
+		{
+			waitForOldestBatch();
+		}
+	}
+
+	VkCommandBufferBeginInfo cbbi = {};
+	cbbi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	cbbi.pNext = nullptr;
+	cbbi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	cbbi.pInheritanceInfo = nullptr;
+
+	VkResult result = vkBeginCommandBuffer(batch->m_commandBuffer, &cbbi);
+	ASSERT_VULKAN(result);
+	if (batch->m_transferCommandBuffer != VK_NULL_HANDLE)
+	{
+		result = vkBeginCommandBuffer(batch->m_transferCommandBuffer, &cbbi);
+		ASSERT_VULKAN(result);
+	}
+
+	batch->m_state = BatchState::RECORDING;
+	batch->m_id = m_nextId++;
+	batch->m_usesTransferQueue = false;
+	m_precording = batch;
+	return *batch;
+}
+
+bbe::INTERNAL::vulkan::VulkanUploadBatcher::Batch * bbe::INTERNAL::vulkan::VulkanUploadBatcher::getOldestSubmittedBatch()
+{
+	Batch *oldest = nullptr;
+	for (size_t i = 0; i < m_batches.getLength(); i++)
+	{
+		if (m_batches[i].m_state == BatchState::SUBMITTED && (oldest == nullptr || m_batches[i].m_id < oldest->m_id))
+		{
+			oldest = &m_batches[i];
+		}
+	}
+	return oldest;
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::retire(Batch & batch)
+{
+	//Batches finish in the order they were submitted, so everything before the batch is done as well.
+	m_ring.freeUpTo(batch.m_ringHead);
+	m_completedId = batch.m_id;
+	batch.m_state = BatchState::FREE;
+}
+
+bool bbe::INTERNAL::vulkan::VulkanUploadBatcher::waitForOldestBatch()
+{
+	Batch *oldest = getOldestSubmittedBatch();
+	if (oldest == nullptr)
+	{
+		return false;
+	}
+
+	oldest->m_fence.wait();
+	retire(*oldest);
+	return true;
+}
+
+size_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::allocateStaging(size_t size)
+{
+	size_t offset = 0;
+	while (!m_ring.allocate(size, ALIGNMENT, offset))
+	{
+		if (m_precording != nullptr)
+		{
+			submit();
+		}
+		if (!waitForOldestBatch())
+		{
+			throw BufferTooSmallException();
+		}
+	}
+	return offset;
+}
+
+VkCommandBuffer bbe::INTERNAL::vulkan::VulkanUploadBatcher::getCopyCommandBuffer(Batch & batch)
+{
+	if (batch.m_transferCommandBuffer != VK_NULL_HANDLE)
+	{
+		batch.m_usesTransferQueue = true;
+		return batch.m_transferCommandBuffer;
+	}
+	return batch.m_commandBuffer;
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::recordOwnershipTransfer(Batch & batch, const VkBufferMemoryBarrier * bufferBarrier, const VkImageMemoryBarrier * imageBarrier)
+{
+	//The release on the transfer queue and the acquire on the graphics queue must describe the same transfer.
+	//Only the access masks differ.
+	VkBufferMemoryBarrier bufferRelease;
+	VkImageMemoryBarrier imageRelease;
+	if (bufferBarrier != nullptr)
+	{
+		bufferRelease = *bufferBarrier;
+		bufferRelease.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferRelease.dstAccessMask = 0;
+	}
+	if (imageBarrier != nullptr)
+	{
+		imageRelease = *imageBarrier;
+		imageRelease.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		imageRelease.dstAccessMask = 0;
+	}
+	vkCmdPipelineBarrier(batch.m_transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, bufferBarrier != nullptr ? 1 : 0, &bufferRelease, imageBarrier != nullptr ? 1 : 0, &imageRelease);
+	vkCmdPipelineBarrier(batch.m_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, bufferBarrier != nullptr ? 1 : 0, bufferBarrier, imageBarrier != nullptr ? 1 : 0, imageBarrier);
+}
+
+bbe::INTERNAL::vulkan::VulkanUploadBatcher::VulkanUploadBatcher()
+{
+	//DO NOTHING
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::init(const VulkanDevice & device)
+{
+	if (m_pdevice != nullptr)
+	{
+		throw AlreadyCreatedException();
+	}
+
+	m_pdevice = &device;
+	m_stagingBuffer.create(device, STAGING_BUFFER_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+	m_pstagingData = (unsigned char*)m_stagingBuffer.map();
+	m_ring.reset(STAGING_BUFFER_SIZE);
+
+	m_commandPool.init(device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+	if (device.hasDedicatedTransferQueue())
+	{
+		m_transferCommandPool.init(device, device.getTransferQueueFamilyIndex(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+	}
+
+	m_batches.resizeCapacityAndLength(AMOUNT_OF_BATCHES);
+	for (size_t i = 0; i < m_batches.getLength(); i++)
+	{
+		m_batches[i].m_commandBuffer = m_commandPool.getCommandBuffer();
+		m_batches[i].m_fence.init(device);
+		if (device.hasDedicatedTransferQueue())
+		{
+			m_batches[i].m_transferCommandBuffer = m_transferCommandPool.getCommandBuffer();
+			m_batches[i].m_transferDone.init(device);
+		}
+	}
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::destroy()
+{
+	if (m_pdevice == nullptr)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < m_batches.getLength(); i++)
+	{
+		m_batches[i].m_fence.destroy();
+		m_batches[i].m_transferDone.destroy();
+	}
+	m_batches.clear();
+	m_precording = nullptr;
+
+	m_transferCommandPool.destroy();
+	m_commandPool.destroy();
+
+	m_stagingBuffer.unmap();
+	m_stagingBuffer.destroy();
+	m_pstagingData = nullptr;
+	m_pdevice = nullptr;
+}
+
+uint64_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::uploadBuffer(const void * data, VkDeviceSize size, VkBuffer dest)
+{
+	if (size == 0 || data == nullptr)
+	{
+		throw IllegalArgumentException();
+	}
+
+	const unsigned char *bytes = (const unsigned char*)data;
+	const VkDeviceSize maxChunkSize = STAGING_BUFFER_SIZE / 2;
+	VkDeviceSize uploaded = 0;
+	uint64_t id = 0;
+	while (uploaded < size)
+	{
+		const VkDeviceSize chunkSize = size - uploaded < maxChunkSize ? size - uploaded : maxChunkSize;
+		const size_t offset = allocateStaging((size_t)chunkSize);
+		memcpy(m_pstagingData + offset, bytes + uploaded, (size_t)chunkSize);
+
+		Batch &batch = getRecordingBatch();
+		VkBufferCopy bufferCopy;
+		bufferCopy.srcOffset = offset;
+		bufferCopy.dstOffset = uploaded;
+		bufferCopy.size = chunkSize;
+		vkCmdCopyBuffer(getCopyCommandBuffer(batch), m_stagingBuffer.getBuffer(), dest, 1, &bufferCopy);
+
+		if (batch.m_usesTransferQueue)
+		{
+			VkBufferMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.pNext = nullptr;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+			barrier.srcQueueFamilyIndex = m_pdevice->getTransferQueueFamilyIndex();
+			barrier.dstQueueFamilyIndex = m_pdevice->getQueueFamilyIndex();
+			barrier.buffer = dest;
+			barrier.offset = uploaded;
+			barrier.size = chunkSize;
+			recordOwnershipTransfer(batch, &barrier, nullptr);
+		}
+
+		uploaded += chunkSize;
+		id = batch.m_id;
+	}
+	return id;
+}
+
+uint64_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::uploadImage(const void * data, VkImage image, uint32_t width, int32_t y, uint32_t height, VkImageLayout oldLayout)
+{
+	const size_t rowSize = (size_t)width * 4;
+	if (data == nullptr || width == 0 || height == 0 || y < 0 || rowSize > STAGING_BUFFER_SIZE / 2)
+	{
+		throw IllegalArgumentException();
+	}
+
+	//Images that may already be sampled belong to the graphics queue.
+	const bool onGraphicsQueue = oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL || !m_pdevice->hasDedicatedTransferQueue();
+	const uint32_t rowsPerChunk = (uint32_t)(STAGING_BUFFER_SIZE / 2 / rowSize);
+
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.pNext = nullptr;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	const unsigned char *bytes = (const unsigned char*)data;
+	uint32_t uploadedRows = 0;
+	uint64_t id = 0;
+	while (uploadedRows < height)
+	{
+		const uint32_t rows = height - uploadedRows < rowsPerChunk ? height - uploadedRows : rowsPerChunk;
+		const size_t offset = allocateStaging(rows * rowSize);
+		memcpy(m_pstagingData + offset, bytes + uploadedRows * rowSize, rows * rowSize);
+
+		Batch &batch = getRecordingBatch();
+		const VkCommandBuffer commandBuffer = onGraphicsQueue ? batch.m_commandBuffer : getCopyCommandBuffer(batch);
+		if (uploadedRows == 0)
+		{
+			barrier.oldLayout = oldLayout;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcAccessMask = oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL ? VK_ACCESS_SHADER_READ_BIT : 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			const VkPipelineStageFlags srcStage = oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		VkBufferImageCopy bufferImageCopy = {};
+		bufferImageCopy.bufferOffset = offset;
+		bufferImageCopy.bufferRowLength = 0;
+		bufferImageCopy.bufferImageHeight = 0;
+		bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		bufferImageCopy.imageSubresource.mipLevel = 0;
+		bufferImageCopy.imageSubresource.baseArrayLayer = 0;
+		bufferImageCopy.imageSubresource.layerCount = 1;
+		bufferImageCopy.imageOffset = { 0, y + (int32_t)uploadedRows, 0 };
+		bufferImageCopy.imageExtent = { width, rows, 1 };
+		vkCmdCopyBufferToImage(commandBuffer, m_stagingBuffer.getBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+		uploadedRows += rows;
+		id = batch.m_id;
+
+		if (uploadedRows == height)
+		{
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			if (onGraphicsQueue)
+			{
+				vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+			}
+			else
+			{
+				barrier.srcAccessMask = 0;
+				barrier.srcQueueFamilyIndex = m_pdevice->getTransferQueueFamilyIndex();
+				barrier.dstQueueFamilyIndex = m_pdevice->getQueueFamilyIndex();
+				recordOwnershipTransfer(batch, nullptr, &barrier);
+			}
+		}
+	}
+	return id;
+}
+
+uint64_t bbe::INTERNAL::vulkan::VulkanUploadBatcher::submit()
+{
+	if (m_precording == nullptr)
+	{
+		return m_nextId - 1;
+	}
+
+	Batch &batch = *m_precording;
+	m_precording = nullptr;
+
+	//Makes the copies visible to everything that is submitted to the graphics queue afterwards.
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = nullptr;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+	vkCmdPipelineBarrier(batch.m_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+	VkResult result = vkEndCommandBuffer(batch.m_commandBuffer);
+	ASSERT_VULKAN(result);
+	if (batch.m_transferCommandBuffer != VK_NULL_HANDLE)
+	{
+		result = vkEndCommandBuffer(batch.m_transferCommandBuffer);
+		ASSERT_VULKAN(result);
+	}
+
+	VkSemaphore transferDone = VK_NULL_HANDLE;
+	if (batch.m_usesTransferQueue)
+	{
+		transferDone = batch.m_transferDone.getSemaphore();
+
+		VkSubmitInfo si = {};
+		si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		si.pNext = nullptr;
+		si.waitSemaphoreCount = 0;
+		si.pWaitSemaphores = nullptr;
+		si.pWaitDstStageMask = nullptr;
+		si.commandBufferCount = 1;
+		si.pCommandBuffers = &batch.m_transferCommandBuffer;
+		si.signalSemaphoreCount = 1;
+		si.pSignalSemaphores = &transferDone;
+
+		result = vkQueueSubmit(m_pdevice->getTransferQueue(), 1, &si, VK_NULL_HANDLE);
+		ASSERT_VULKAN(result);
+	}
+
+	VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	VkSubmitInfo si = {};
+	si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	si.pNext = nullptr;
+	si.waitSemaphoreCount = batch.m_usesTransferQueue ? 1 : 0;
+	si.pWaitSemaphores = &transferDone;
+	si.pWaitDstStageMask = &waitStageMask;
+	si.commandBufferCount = 1;
+	si.pCommandBuffers = &batch.m_commandBuffer;
+	si.signalSemaphoreCount = 0;
+	si.pSignalSemaphores = nullptr;
+
+	batch.m_fence.reset();
+	result = vkQueueSubmit(m_pdevice->getQueue(), 1, &si, batch.m_fence.getFence());
+	ASSERT_VULKAN(result);
+
+	batch.m_ringHead = m_ring.getHead();
+	batch.m_state = BatchState::SUBMITTED;
+	return batch.m_id;
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::update()
+{
+	Batch *oldest = getOldestSubmittedBatch();
+	while (oldest != nullptr && oldest->m_fence.isSignaled())
+	{
+		retire(*oldest);
+		oldest = getOldestSubmittedBatch();
+	}
+}
+
+bool bbe::INTERNAL::vulkan::VulkanUploadBatcher::isComplete(uint64_t id)
+{
+	if (id >= m_nextId)
+	{
+		throw IllegalArgumentException();
+	}
+
+	update();
+	return id <= m_completedId;
+}
+
+void bbe::INTERNAL::vulkan::VulkanUploadBatcher::wait(uint64_t id)
+{
+	if (id >= m_nextId)
+	{
+		throw IllegalArgumentException();
+	}
+
+	if (m_precording != nullptr && id >= m_precording->m_id)
+	{
+		submit();
+	}
+	while (id > m_completedId && waitForOldestBatch())
+	{
+		//DO NOTHING
+	}
+}
+
+const bbe::INTERNAL::vulkan::VulkanDevice & bbe::INTERNAL::vulkan::VulkanUploadBatcher::getDevice() const
+{
+	if (m_pdevice == nullptr)
+	{
+		throw NotInitializedException();
+	}
+
+	return *m_pdevice;
+}
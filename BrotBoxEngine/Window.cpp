@@ -4,6 +4,7 @@
 #include "BBE/PrimitiveBrush3D.h"
 #include <iostream>
 #include "BBE/MouseButtons.h"
+#include "BBE/EngineSettings.h"
 
 
 size_t bbe::Window::windowsAliveCounter = 0;
@@ -11,12 +12,17 @@ bbe::Window* bbe::Window::INTERNAL_firstInstance = nullptr;
 
 
 bbe::Window::Window(int width, int height, const char * title, uint32_t major, uint32_t minor, uint32_t patch)
-	: m_width(width), m_height(height)
+	: m_width(width), m_height(height), m_headless(Settings::isHeadless())
 {
 	if(bbe::Window::INTERNAL_firstInstance == nullptr)
 	{
 		bbe::Window::INTERNAL_firstInstance = this;
 	}
+	if (m_headless)
+	{
+		m_vulkanManager.init(title, major, minor, patch, nullptr, width, height);
+		return;
+	}
 	if (windowsAliveCounter == 0)
 	{
 		glfwInit();
@@ -55,6 +61,10 @@ void bbe::Window::preDraw()
 
 bool bbe::Window::keepAlive()
 {
+	if (m_headless)
+	{
+		return !m_closeRequested;
+	}
 	if (glfwWindowShouldClose(m_pwindow))
 	{
 		return false;
@@ -69,8 +79,24 @@ void bbe::Window::postDraw()
 	m_vulkanManager.postDraw();
 }
 
+void bbe::Window::close()
+{
+	if (m_headless)
+	{
+		m_closeRequested = true;
+	}
+	else
+	{
+		glfwSetWindowShouldClose(m_pwindow, GLFW_TRUE);
+	}
+}
+
 void bbe::Window::setCursorMode(bbe::CursorMode cursorMode)
 {
+	if (m_headless)
+	{
+		return;
+	}
 	switch (cursorMode)
 	{
 	case bbe::CursorMode::DISABLED:
@@ -87,6 +113,16 @@ void bbe::Window::setCursorMode(bbe::CursorMode cursorMode)
 	}
 }
 
+bool bbe::Window::isHeadless() const
+{
+	return m_headless;
+}
+
+void bbe::Window::captureFrame(Image & outImage)
+{
+	m_vulkanManager.captureFrame(outImage);
+}
+
 GLFWwindow * bbe::Window::getRaw()
 {
 	return m_pwindow;
@@ -95,13 +131,16 @@ GLFWwindow * bbe::Window::getRaw()
 bbe::Window::~Window()
 {
 	m_vulkanManager.destroy();
-	glfwDestroyWindow(m_pwindow);
-	if (windowsAliveCounter == 1)
+	if (!m_headless)
 	{
-		glfwTerminate();
-	}
+		glfwDestroyWindow(m_pwindow);
+		if (windowsAliveCounter == 1)
+		{
+			glfwTerminate();
+		}
 
-	windowsAliveCounter--;
+		windowsAliveCounter--;
+	}
 
 	if(this == bbe::Window::INTERNAL_firstInstance)
 	{
@@ -4,5 +4,13 @@ glslangvalidator -V Shader2DPrimitive.frag -o frag2DPrimitive.spv
 glslangvalidator -V Shader2DImage.vert -o vert2DImage.spv
 glslangvalidator -V Shader2DImage.frag -o frag2DImage.spv
 
+glslangvalidator -V Shader2DBatched.vert -o vert2DBatched.spv
+glslangvalidator -V Shader2DBatched.frag -o frag2DBatched.spv
+
 glslangvalidator -V Shader3DPrimitive.vert -o vert3DPrimitive.spv
-glslangvalidator -V Shader3DPrimitive.frag -o frag3DPrimitive.spv
\ No newline at end of file
+glslangvalidator -V Shader3DPrimitive.frag -o frag3DPrimitive.spv
+
+glslangvalidator -V Shader3DInstanced.vert -o vert3DInstanced.spv
+glslangvalidator -V Shader3DInstanced.frag -o frag3DInstanced.spv
+
+glslangvalidator -V Shader3DTerrain.vert -o vert3DTerrain.spv
\ No newline at end of file
@@ -18,6 +18,26 @@
 #include "Vector2Test.h"
 #include "LinearCongruentialGeneratorTest.h"
 #include "ImageTest.h"
+#include "FrustumTest.h"
+#include "DataStructures/SpatialHashGridTest.h"
+#include "ThreadPoolTest.h"
+#include "BarnesHutTreeTest.h"
+#include "BoundingVolumeHierarchyTest.h"
+#include "MersenneTwisterTest.h"
+#include "RandomTest.h"
+#include "PhiloxTest.h"
+#include "ValueNoise2DTest.h"
+#include "GradientNoiseTest.h"
+#include "StreamingTerrainTest.h"
+#include "TerrainTest.h"
+#include "HeightfieldTest.h"
+#include "VulkanObjectCounterTest.h"
+#include "Batch2DTest.h"
+#include "SkylinePackerTest.h"
+#include "TextureAtlasTest.h"
+#include "RingAllocatorTest.h"
+#include "FreeListAllocatorTest.h"
+#include "HeadlessTest.h"
 
 namespace bbe {
 	namespace test {
@@ -55,6 +75,46 @@ namespace bbe {
 			Person::checkIfAllPersonsWereDestroyed();
 			bbe::test::testImage();
 			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testFrustum();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testSpatialHashGrid();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testThreadPool();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testBarnesHutTree();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testBoundingVolumeHierarchy();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testMersenneTwister();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testRandom();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testPhilox();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testValueNoise2D();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testGradientNoise();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testStreamingTerrain();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testTerrain();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testHeightfield();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testVulkanObjectCounter();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testBatch2D();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testSkylinePacker();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testTextureAtlas();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testRingAllocator();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testFreeListAllocator();
+			Person::checkIfAllPersonsWereDestroyed();
+			bbe::test::testHeadless();
+			Person::checkIfAllPersonsWereDestroyed();
 		}
 	}
 }
\ No newline at end of file
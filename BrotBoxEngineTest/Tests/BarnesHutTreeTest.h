@@ -0,0 +1,128 @@
+#pragma once
+
+#include "BBE/BarnesHutTree.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/LinearCongruentialGenerator.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testBarnesHutTree()
+		{
+			LCG32 lcg;
+			lcg.setSeed((uint64_t)42);
+			auto randomFloat = [&](float range) { return (lcg.next() % 100000) / 100000.0f * range - range / 2; };
+
+			auto gravity = [](const Vector3 &dir, float distanceSq, float mass)
+			{
+				return dir * (mass / (distanceSq * Math::sqrt(distanceSq)));
+			};
+
+			const size_t amount = 5000;
+			List<Vector3> positions;
+			List<float> masses;
+			double totalMass = 0;
+			double weightedPositions[3] = { 0, 0, 0 };
+			for (size_t i = 0; i < amount; i++)
+			{
+				//Two clusters, so the tree is not uniform.
+				const Vector3 offset = i % 2 == 0 ? Vector3(-30, 0, 0) : Vector3(40, 10, 0);
+				positions.add(offset + Vector3(randomFloat(50), randomFloat(50), randomFloat(50)));
+				if (i == 1 || i == 3)
+				{
+					//Duplicates must neither break the build nor attract themselves.
+					positions.last() = positions[0];
+				}
+				masses.add(1 + (lcg.next() % 100) / 10.0f);
+				totalMass += masses.last();
+				for (int k = 0; k < 3; k++)
+				{
+					weightedPositions[k] += positions.last()[k] * masses.last();
+				}
+			}
+
+			List<Vector3> exact;
+			for (size_t i = 0; i < amount; i++)
+			{
+				Vector3 force;
+				for (size_t k = 0; k < amount; k++)
+				{
+					const Vector3 dir = positions[k] - positions[i];
+					const float distanceSq = dir.getLengthSq();
+					if (distanceSq != 0)
+					{
+						force = force + gravity(dir, distanceSq, masses[k]);
+					}
+				}
+				exact.add(force);
+			}
+
+			auto relativeError = [&](const List<Vector3> &forces)
+			{
+				double errorSq = 0;
+				double exactSq = 0;
+				for (size_t i = 0; i < amount; i++)
+				{
+					errorSq += (forces[i] - exact[i]).getLengthSq();
+					exactSq += exact[i].getLengthSq();
+				}
+				return (float)Math::sqrt((float)(errorSq / exactSq));
+			};
+
+			BarnesHutTree tree(0.0f);
+			assertEquals(tree.getAmountOfNodes(), 0);
+			assertEquals(tree.getTotalMass(), 0);
+			tree.build(positions.getRaw(), masses.getRaw(), amount);
+			assertEquals(tree.getAmountOfBodies(), amount);
+			assertEqualsFloat(tree.getTotalMass(), (float)totalMass, 0.5f);
+			const Vector3 centerOfMass((float)(weightedPositions[0] / totalMass), (float)(weightedPositions[1] / totalMass), (float)(weightedPositions[2] / totalMass));
+			assertEquals((tree.getCenterOfMass() - centerOfMass).getLength() < 0.01f, true);
+
+			List<Vector3> forces;
+			forces.resizeCapacityAndLength(amount);
+			tree.calculateForces(positions.getRaw(), forces.getRaw(), amount, gravity);
+			assertEquals(relativeError(forces) < 0.0001f, true);
+
+			tree.setTheta(0.5f);
+			assertEquals(tree.getTheta(), 0.5f);
+			tree.calculateForces(positions.getRaw(), forces.getRaw(), amount, gravity);
+			const float serialError = relativeError(forces);
+			assertEquals(serialError < 0.01f, true);
+
+			ThreadPool pool(3);
+			List<float> xs;
+			List<float> ys;
+			List<float> zs;
+			for (size_t i = 0; i < amount; i++)
+			{
+				xs.add(positions[i].x);
+				ys.add(positions[i].y);
+				zs.add(positions[i].z);
+			}
+			BarnesHutTree parallelTree(0.5f);
+			parallelTree.build(xs.getRaw(), ys.getRaw(), zs.getRaw(), masses.getRaw(), amount, &pool);
+			assertEquals(parallelTree.getAmountOfNodes(), tree.getAmountOfNodes());
+			List<Vector3> parallelForces;
+			parallelForces.resizeCapacityAndLength(amount);
+			parallelTree.calculateForces(positions.getRaw(), parallelForces.getRaw(), amount, gravity, &pool);
+			for (size_t i = 0; i < amount; i++)
+			{
+				assertEquals((parallelForces[i] - forces[i]).getLength() <= forces[i].getLength() * 0.0001f, true);
+			}
+
+			tree.build(positions.getRaw(), nullptr, amount);
+			assertEqualsFloat(tree.getTotalMass(), (float)amount);
+
+			tree.build(positions.getRaw(), nullptr, 1);
+			assertEquals(tree.getAmountOfNodes(), 1);
+			assertEquals(tree.calculateForce(positions[0], gravity) == Vector3(0, 0, 0), true);
+
+			tree.clear();
+			assertEquals(tree.getAmountOfBodies(), 0);
+			assertEquals(tree.calculateForce(positions[0], gravity) == Vector3(0, 0, 0), true);
+		}
+	}
+}
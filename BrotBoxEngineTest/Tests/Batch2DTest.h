@@ -0,0 +1,106 @@
+#pragma once
+
+#include "BBE/Batch2D.h"
+#include "BBE/Rectangle.h"
+#include "BBE/Circle.h"
+#include "BBE/Color.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testBatch2D()
+		{
+			//Only compared, never used as real descriptor sets.
+			const VkDescriptorSet white = (VkDescriptorSet)1;
+			const VkDescriptorSet image = (VkDescriptorSet)2;
+
+			{
+				Batch2D batch;
+				batch.begin(200, 100);
+				assertEquals(batch.isEmpty(), true);
+
+				batch.addRectangle(Rectangle(50, 25, 100, 50), Color(1, 0, 0, 1), white);
+				assertEquals(batch.isEmpty(), false);
+				assertEquals(batch.getVertices().getLength(), 4);
+				assertEquals(batch.getIndices().getLength(), 6);
+				assertEquals(batch.getDraws().getLength(), 1);
+
+				//Pixels become normalized device coordinates.
+				const Vertex2D &topLeft = batch.getVertices()[0];
+				const Vertex2D &bottomRight = batch.getVertices()[2];
+				assertEqualsFloat(topLeft.m_pos.x, -0.5f);
+				assertEqualsFloat(topLeft.m_pos.y, -0.5f);
+				assertEqualsFloat(bottomRight.m_pos.x, 0.5f);
+				assertEqualsFloat(bottomRight.m_pos.y, 0.5f);
+				assertEqualsFloat(topLeft.m_uvCoord.x, 0);
+				assertEqualsFloat(bottomRight.m_uvCoord.y, 1);
+				assertEqualsFloat(topLeft.m_color.r, 1);
+				assertEqualsFloat(topLeft.m_color.g, 0);
+
+				//Same texture, same draw. The indices continue after the vertices of the first rectangle.
+				batch.addRectangle(Rectangle(0, 0, 10, 10), Color(0, 1, 0, 1), white);
+				assertEquals(batch.getDraws().getLength(), 1);
+				assertEquals(batch.getDraws()[0].m_amountOfIndices, 12u);
+				assertEquals(batch.getIndices()[6], 4u);
+				assertEquals(batch.getIndices()[11], 7u);
+
+				const size_t verticesBeforeCircle = batch.getVertices().getLength();
+				batch.addCircle(Circle(0, 0, 10, 10), Color(0, 0, 1, 1), white);
+				const uint32_t circleIndices = batch.getDraws()[0].m_amountOfIndices - 12;
+				assertEquals(batch.getDraws().getLength(), 1);
+				assertEquals(circleIndices, (uint32_t)(batch.getVertices().getLength() - verticesBeforeCircle - 2) * 3);
+
+				//A new texture starts a new draw, switching back starts another one.
+				batch.addRectangle(Rectangle(0, 0, 10, 10), Color(1, 1, 1, 1), image);
+				batch.addRectangle(Rectangle(0, 0, 10, 10), Color(1, 1, 1, 1), image);
+				batch.addRectangle(Rectangle(0, 0, 10, 10), Color(1, 1, 1, 1), white);
+				assertEquals(batch.getDraws().getLength(), 3);
+				assertEquals(batch.getDraws()[1].m_texture == image, true);
+				assertEquals(batch.getDraws()[1].m_firstIndex, 12 + circleIndices);
+				assertEquals(batch.getDraws()[1].m_amountOfIndices, 12u);
+				assertEquals(batch.getDraws()[2].m_texture == white, true);
+				assertEquals(batch.getDraws()[2].m_firstIndex + batch.getDraws()[2].m_amountOfIndices, (uint32_t)batch.getIndices().getLength());
+
+				batch.begin(200, 100);
+				assertEquals(batch.isEmpty(), true);
+				assertEquals(batch.getVertices().getLength(), 0);
+				assertEquals(batch.getIndices().getLength(), 0);
+			}
+
+			{
+				//The uv rect selects a part of the texture, like the place of an image in an atlas.
+				Batch2D batch;
+				batch.begin(200, 100);
+				batch.addRectangle(Rectangle(0, 0, 10, 10), Color(1, 1, 1, 1), white, Rectangle(0.25f, 0.5f, 0.125f, 0.25f));
+				assertEqualsFloat(batch.getVertices()[0].m_uvCoord.x, 0.25f);
+				assertEqualsFloat(batch.getVertices()[0].m_uvCoord.y, 0.5f);
+				assertEqualsFloat(batch.getVertices()[2].m_uvCoord.x, 0.375f);
+				assertEqualsFloat(batch.getVertices()[2].m_uvCoord.y, 0.75f);
+
+				batch.addCircle(Circle(0, 0, 10, 10), Color(1, 1, 1, 1), white, Rectangle(0.5f, 0.5f, 0, 0));
+				for (size_t i = 4; i < batch.getVertices().getLength(); i++)
+				{
+					assertEqualsFloat(batch.getVertices()[i].m_uvCoord.x, 0.5f);
+					assertEqualsFloat(batch.getVertices()[i].m_uvCoord.y, 0.5f);
+				}
+			}
+
+			{
+				Batch2D batch;
+				bool exceptionThrown = false;
+				try
+				{
+					batch.begin(0, 100);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
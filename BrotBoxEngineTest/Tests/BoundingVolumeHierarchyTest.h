@@ -0,0 +1,185 @@
+#pragma once
+
+#include "BBE/BoundingVolumeHierarchy.h"
+#include "BBE/Ray.h"
+#include "BBE/LinearCongruentialGenerator.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+#include <algorithm>
+
+namespace bbe
+{
+	namespace test
+	{
+		void testBoundingVolumeHierarchy()
+		{
+			{
+				Ray ray(Vector3(-5, 0, 0), Vector3(2, 0, 0));
+				float t = 0;
+				assertEquals(ray.intersects(BoundingBox(Vector3(-1), Vector3(1)), t), true);
+				assertEqualsFloat(t, 2.0f);
+				assertEquals(ray.intersects(BoundingBox(Vector3(-1), Vector3(1)), t, 1.5f), false);
+				assertEquals(ray.intersects(BoundingBox(Vector3(-1, 2, -1), Vector3(1, 3, 1)), t), false);
+				assertEquals(ray.intersects(BoundingBox(Vector3(-10, -1, -1), Vector3(-9, 1, 1)), t), false);
+				assertEquals(Ray(Vector3(0, 0, 0), Vector3(1, 0, 0)).intersects(BoundingBox(Vector3(-1), Vector3(1)), t), true);
+				assertEqualsFloat(t, 0.0f);
+
+				assertEquals(ray.intersects(BoundingSphere(Vector3(0, 0, 0), 1), t), true);
+				assertEqualsFloat(t, 2.0f);
+				assertEquals(ray.intersects(BoundingSphere(Vector3(0, 2, 0), 1), t), false);
+				assertEquals(ray.intersects(BoundingSphere(Vector3(-10, 0, 0), 1), t), false);
+
+				assertEquals(ray.intersectsTriangle(Vector3(0, -1, -1), Vector3(0, 1, -1), Vector3(0, 0, 1), t), true);
+				assertEqualsFloat(t, 2.5f);
+				assertEquals(ray.intersectsTriangle(Vector3(0, 1, -1), Vector3(0, 2, -1), Vector3(0, 2, 1), t), false);
+
+				Ray transformed = ray.transform(Matrix4::createTranslationMatrix(Vector3(1, 2, 3)) * Matrix4::createScaleMatrix(Vector3(2)));
+				assertEquals(transformed.getPoint(1.5f) == Vector3(-3, 2, 3), true);
+			}
+
+			LCG32 lcg;
+			lcg.setSeed((uint64_t)7);
+			auto randomFloat = [&](float range) { return (lcg.next() % 100000) / 100000.0f * range - range / 2; };
+
+			const size_t amount = 3000;
+			List<BoundingBox> boxes;
+			for (size_t i = 0; i < amount; i++)
+			{
+				const Vector3 center(randomFloat(200), randomFloat(200), randomFloat(200));
+				const Vector3 extents(Math::abs(randomFloat(4)), Math::abs(randomFloat(4)), Math::abs(randomFloat(4)));
+				boxes.add(BoundingBox::createFromCenterAndExtents(center, extents));
+			}
+
+			BoundingVolumeHierarchy bvh;
+			assertEquals(bvh.getAmountOfNodes(), 0);
+			size_t index = 0;
+			float t = 0;
+			assertEquals(bvh.raycast(Ray(), index, t), false);
+
+			auto checkQueries = [&]()
+			{
+				for (int q = 0; q < 200; q++)
+				{
+					const Vector3 from(randomFloat(300), randomFloat(300), randomFloat(300));
+					const Vector3 to(randomFloat(300), randomFloat(300), randomFloat(300));
+					const Ray ray(from, (to - from).normalize());
+
+					bool expectedHit = false;
+					float expectedT = Math::INFINITY_POSITIVE;
+					bool segmentHit = false;
+					for (size_t i = 0; i < amount; i++)
+					{
+						float boxT;
+						if (ray.intersects(boxes[i], boxT) && boxT < expectedT)
+						{
+							expectedHit = true;
+							expectedT = boxT;
+						}
+						if (Ray::createFromPoints(from, to).intersects(boxes[i], boxT, 1))
+						{
+							segmentHit = true;
+						}
+					}
+
+					assertEquals(bvh.raycast(ray, index, t), expectedHit);
+					if (expectedHit)
+					{
+						assertEqualsFloat(t, expectedT, 0.001f);
+						float boxT;
+						assertEquals(ray.intersects(boxes[index], boxT), true);
+						assertEqualsFloat(boxT, expectedT, 0.001f);
+					}
+					assertEquals(bvh.intersectsSegment(from, to), segmentHit);
+
+					const BoundingSphere sphere(from / 2, Math::abs(randomFloat(40)));
+					List<size_t> found;
+					bvh.querySphere(sphere, found);
+					List<size_t> expected;
+					for (size_t i = 0; i < amount; i++)
+					{
+						if (sphere.intersects(boxes[i]))
+						{
+							expected.add(i);
+						}
+					}
+					std::sort(found.begin(), found.end());
+					assertEquals(found.getLength(), expected.getLength());
+					for (size_t i = 0; i < expected.getLength(); i++)
+					{
+						assertEquals(found[i], expected[i]);
+					}
+				}
+			};
+
+			bvh.build(boxes.getRaw(), amount);
+			assertEquals(bvh.getAmountOfPrimitives(), amount);
+			checkQueries();
+
+			//Custom intersection: only primitives with an even index count as hits.
+			{
+				const Ray ray(Vector3(-200, 0, 0), Vector3(1, 0, 0));
+				size_t evenIndex = 1;
+				float evenT = 0;
+				if (bvh.raycast(ray, [&](size_t i, float maxT, float &outT) { return i % 2 == 0 && ray.intersects(boxes[i], outT, maxT); }, evenIndex, evenT))
+				{
+					assertEquals(evenIndex % 2, 0);
+				}
+			}
+
+			for (size_t i = 0; i < amount; i++)
+			{
+				const Vector3 offset(randomFloat(10), randomFloat(10), randomFloat(10));
+				boxes[i] = BoundingBox(boxes[i].getMin() + offset, boxes[i].getMax() + offset);
+			}
+			bvh.refit(boxes.getRaw(), amount);
+			const BoundingBox bounds = bvh.getBoundingBox();
+			for (size_t i = 0; i < amount; i++)
+			{
+				assertEquals(bounds.contains(boxes[i].getMin()) && bounds.contains(boxes[i].getMax()), true);
+			}
+			checkQueries();
+
+			bool exceptionThrown = false;
+			try
+			{
+				bvh.refit(boxes.getRaw(), amount - 1);
+			}
+			catch (IllegalArgumentException e)
+			{
+				exceptionThrown = true;
+			}
+			assertEquals(exceptionThrown, true);
+
+			{
+				//Every box is larger than all the boxes before it, so the SAH build degenerates into a long chain.
+				//Deep trees must not fail the queries.
+				List<BoundingBox> chain;
+				float x = 1e-24f;
+				for (int i = 0; i < 800; i++)
+				{
+					chain.add(BoundingBox(Vector3(x), Vector3(x * 1.5f)));
+					x *= 1.15f;
+				}
+				BoundingVolumeHierarchy chainBvh(1);
+				chainBvh.build(chain.getRaw(), chain.getLength());
+				for (size_t i = 0; i < chain.getLength(); i += 7)
+				{
+					const Vector3 center = chain[i].getCenter();
+					assertEquals(chainBvh.raycast(Ray(center - Vector3(0, 0, center.z * 0.001f), Vector3(0, 0, 1)), index, t), true);
+					List<size_t> found;
+					chainBvh.querySphere(BoundingSphere(center, 0), found);
+					assertEquals(found.contains(i), true);
+				}
+			}
+
+			bvh.build(boxes.getRaw(), 1);
+			assertEquals(bvh.getAmountOfNodes(), 1);
+			assertEquals(bvh.raycast(Ray(boxes[0].getCenter() - Vector3(50, 0, 0), Vector3(1, 0, 0)), index, t), true);
+			assertEquals(index, 0);
+
+			bvh.clear();
+			assertEquals(bvh.getAmountOfPrimitives(), 0);
+			assertEquals(bvh.intersectsSegment(Vector3(-1000), Vector3(1000)), false);
+		}
+	}
+}
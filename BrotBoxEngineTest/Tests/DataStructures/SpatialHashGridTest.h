@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BBE/SpatialHashGrid.h"
+#include "BBE/LinearCongruentialGenerator.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+#include <algorithm>
+
+namespace bbe
+{
+	namespace test
+	{
+		void testSpatialHashGrid()
+		{
+			LCG32 lcg;
+			lcg.setSeed((uint64_t)1337);
+			auto randomFloat = [&](float range) { return (lcg.next() % 100000) / 100000.0f * range - range / 2; };
+
+			const size_t amount = 2000;
+			List<float> xs;
+			List<float> ys;
+			List<float> zs;
+			for (size_t i = 0; i < amount; i++)
+			{
+				xs.add(randomFloat(100));
+				ys.add(randomFloat(100));
+				zs.add(randomFloat(100));
+			}
+
+			//Small bucket count on purpose, so that different cells share buckets.
+			SpatialHashGrid grid(5.0f, 64);
+			grid.addAll(xs.getRaw(), ys.getRaw(), zs.getRaw(), amount);
+			assertEquals(grid.getLength(), amount);
+
+			auto bruteForceRadius = [&](const Vector3 &center, float radius)
+			{
+				List<size_t> result;
+				for (size_t i = 0; i < grid.getLength(); i++)
+				{
+					if ((grid.getPosition(i) - center).getLength() <= radius)
+					{
+						result.add(i);
+					}
+				}
+				return result;
+			};
+
+			auto checkQueries = [&]()
+			{
+				List<size_t> found;
+				for (int q = 0; q < 50; q++)
+				{
+					Vector3 center(randomFloat(120), randomFloat(120), randomFloat(120));
+					float radius = (lcg.next() % 1000) / 100.0f;
+					grid.queryRadius(center, radius, found);
+					List<size_t> expected = bruteForceRadius(center, radius);
+					assertEquals(found.getLength(), expected.getLength());
+					std::sort(found.begin(), found.end());
+					for (size_t i = 0; i < expected.getLength(); i++)
+					{
+						assertEquals(found[i], expected[i]);
+					}
+
+					const size_t k = 1 + lcg.next() % 8;
+					grid.queryKNearest(center, k, found);
+					assertEquals(found.getLength(), k);
+					List<float> distances;
+					for (size_t i = 0; i < grid.getLength(); i++)
+					{
+						distances.add((grid.getPosition(i) - center).getLengthSq());
+					}
+					std::sort(distances.begin(), distances.end());
+					for (size_t i = 0; i < k; i++)
+					{
+						assertEquals((grid.getPosition(found[i]) - center).getLengthSq(), distances[i]);
+					}
+				}
+			};
+
+			checkQueries();
+
+			//Move every point a bit, some of them change their cell.
+			for (size_t i = 0; i < amount; i++)
+			{
+				xs[i] += randomFloat(4);
+				ys[i] += randomFloat(4);
+				zs[i] += randomFloat(4);
+			}
+			grid.setAll(xs.getRaw(), ys.getRaw(), zs.getRaw(), amount);
+			for (size_t i = 0; i < amount; i++)
+			{
+				assertEquals(grid.getPosition(i) == Vector3(xs[i], ys[i], zs[i]), true);
+			}
+			checkQueries();
+
+			grid.set(7, Vector3(1000, 1000, 1000));
+			assertEquals(grid.queryNearest(Vector3(999, 999, 999)), 7);
+			assertEquals(grid.queryNearest(Vector3(999, 999, 999), 10.0f), 7);
+			assertEquals(grid.queryNearest(Vector3(500, 500, 500), 10.0f), -1);
+
+			grid.clear();
+			assertEquals(grid.getLength(), 0);
+			assertEquals(grid.queryNearest(Vector3(0, 0, 0)), -1);
+			assertEquals(grid.add(Vector3(1, 2, 3)), 0);
+			assertEquals(grid.queryNearest(Vector3(0, 0, 0)), 0);
+		}
+	}
+}
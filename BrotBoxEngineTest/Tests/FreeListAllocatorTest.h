@@ -0,0 +1,125 @@
+#pragma once
+
+#include "BBE/FreeListAllocator.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testFreeListAllocator()
+		{
+			{
+				FreeListAllocator allocator(1024);
+				assertEquals(allocator.getSize(), 1024);
+				assertEquals(allocator.getFreeSize(), 1024);
+				assertEquals(allocator.isEmpty(), true);
+
+				uint64_t a = 1000;
+				uint64_t b = 1000;
+				assertEquals(allocator.allocate(10, 1, a), true);
+				assertEquals(a, 0);
+				assertEquals(allocator.allocate(100, 256, b), true);
+				assertEquals(b, 256);
+				//The space in front of b stays free.
+				assertEquals(allocator.getAmountOfFreeRanges(), 2);
+				assertEquals(allocator.getUsedSize(), 110);
+				assertEquals(allocator.getAmountOfAllocations(), 2);
+
+				uint64_t c = 0;
+				assertEquals(allocator.allocate(200, 4, c), true);
+				assertEquals(c, 12);
+				assertEquals(allocator.getLargestFreeRange(), 1024 - 356);
+
+				allocator.free(b, 100);
+				allocator.free(a, 10);
+				allocator.free(c, 200);
+				assertEquals(allocator.isEmpty(), true);
+				assertEquals(allocator.getAmountOfFreeRanges(), 1);
+				assertEquals(allocator.getLargestFreeRange(), 1024);
+			}
+
+			{
+				//Allocations take the smallest range they fit in, and freed neighbours are merged again.
+				FreeListAllocator allocator(100);
+				uint64_t offsets[5];
+				for (int i = 0; i < 5; i++)
+				{
+					assertEquals(allocator.allocate(20, 1, offsets[i]), true);
+					assertEquals(offsets[i], i * 20);
+				}
+				uint64_t offset = 0;
+				assertEquals(allocator.allocate(1, 1, offset), false);
+
+				allocator.free(offsets[0], 20);
+				allocator.free(offsets[2], 20);
+				allocator.free(offsets[3], 20);
+				assertEquals(allocator.getAmountOfFreeRanges(), 2);
+				assertEquals(allocator.getLargestFreeRange(), 40);
+				assertEquals(allocator.allocate(41, 1, offset), false);
+
+				assertEquals(allocator.allocate(15, 1, offset), true);
+				assertEquals(offset, 0);
+				assertEquals(allocator.allocate(30, 1, offset), true);
+				assertEquals(offset, 40);
+
+				allocator.free(0, 15);
+				allocator.free(offsets[1], 20);
+				assertEquals(allocator.getAmountOfFreeRanges(), 2);
+				assertEquals(allocator.getLargestFreeRange(), 40);
+			}
+
+			{
+				FreeListAllocator allocator(64);
+				uint64_t offset = 0;
+				allocator.allocate(16, 1, offset);
+
+				bool exceptionThrown = false;
+				try
+				{
+					allocator.allocate(8, 12, offset);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					//Overlaps the free part of the allocator.
+					allocator.free(8, 16);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					allocator.free(60, 8);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					allocator.reset(0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
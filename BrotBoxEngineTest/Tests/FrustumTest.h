@@ -0,0 +1,84 @@
+#pragma once
+
+#include "BBE/Frustum.h"
+#include "BBE/BoundingBox.h"
+#include "BBE/BoundingSphere.h"
+#include "BBE/Matrix4.h"
+#include "BBE/Math.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testFrustum()
+		{
+			{
+				BoundingBox box(Vector3(-1, -2, -3), Vector3(1, 2, 3));
+				assertEquals(box.getCenter() == Vector3(0, 0, 0), true);
+				assertEquals(box.getExtents() == Vector3(1, 2, 3), true);
+				assertEquals(box.contains(Vector3(0.5f, -1.5f, 2.5f)), true);
+				assertEquals(box.contains(Vector3(1.5f, 0, 0)), false);
+				assertEquals(box.intersects(BoundingBox(Vector3(0.5f, 0, 0), Vector3(4, 4, 4))), true);
+				assertEquals(box.intersects(BoundingBox(Vector3(1.5f, 0, 0), Vector3(4, 4, 4))), false);
+
+				BoundingBox transformed = box.transform(Matrix4::createTranslationMatrix(Vector3(10, 0, 0)) * Matrix4::createRotationMatrix(Math::PI / 2, Vector3(0, 0, 1)));
+				assertEquals(transformed.getMin().equals(Vector3(8, -1, -3)), true);
+				assertEquals(transformed.getMax().equals(Vector3(12, 1, 3)), true);
+
+				BoundingBox merged = box.merge(Vector3(5, 0, 0));
+				assertEquals(merged.getMax() == Vector3(5, 2, 3), true);
+				assertEquals(merged.getMin() == Vector3(-1, -2, -3), true);
+			}
+
+			{
+				BoundingSphere sphere(Vector3(0, 0, 0), 1);
+				assertEquals(sphere.contains(Vector3(0.5f, 0.5f, 0.5f)), true);
+				assertEquals(sphere.contains(Vector3(1, 1, 0)), false);
+				assertEquals(sphere.intersects(BoundingSphere(Vector3(1.5f, 0, 0), 0.6f)), true);
+				assertEquals(sphere.intersects(BoundingBox(Vector3(0.9f, 0, 0), Vector3(2, 2, 2))), true);
+				assertEquals(sphere.intersects(BoundingBox(Vector3(0.8f, 0.8f, 0), Vector3(2, 2, 2))), false);
+			}
+
+			{
+				Matrix4 view = Matrix4::createViewMatrix(Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1));
+				Matrix4 projection = Matrix4::createPerspectiveMatrix(Math::toRadians(60.0f), 1.0f, 0.1f, 100.0f);
+				Frustum frustum(projection * view);
+
+				assertEquals(frustum.isVisible(Vector3(10, 0, 0)), true);
+				assertEquals(frustum.isVisible(Vector3(-10, 0, 0)), false);
+				assertEquals(frustum.isVisible(Vector3(10, 10, 0)), false);
+				assertEquals(frustum.isVisible(Vector3(10, 0, 10)), false);
+				assertEquals(frustum.isVisible(Vector3(200, 0, 0)), false);
+
+				assertEquals(frustum.isVisible(BoundingSphere(Vector3(10, 10, 0), 5)), true);
+				assertEquals(frustum.isVisible(BoundingSphere(Vector3(10, 10, 0), 1)), false);
+
+				BoundingBox boxes[] = {
+					BoundingBox::createFromCenterAndExtents(Vector3(  10,   0,  0), Vector3(1)),
+					BoundingBox::createFromCenterAndExtents(Vector3( -10,   0,  0), Vector3(1)),
+					BoundingBox::createFromCenterAndExtents(Vector3(  10,  50,  0), Vector3(1)),
+					BoundingBox::createFromCenterAndExtents(Vector3(  10,  10,  0), Vector3(5)),
+					BoundingBox::createFromCenterAndExtents(Vector3( 200,   0,  0), Vector3(1)),
+					BoundingBox::createFromCenterAndExtents(Vector3(  50, -20, 20), Vector3(1)),
+					BoundingBox::createFromCenterAndExtents(Vector3(   0,   0,  0), Vector3(1)),
+				};
+				const bool expected[] = { true, false, false, true, false, true, true };
+
+				bool visible[7];
+				size_t amountVisible = frustum.isVisible(boxes, visible, 7);
+				assertEquals(amountVisible, 4);
+				for (int i = 0; i < 7; i++)
+				{
+					assertEquals(visible[i], expected[i]);
+					assertEquals(frustum.isVisible(boxes[i]), expected[i]);
+				}
+			}
+
+			{
+				Frustum everything;
+				assertEquals(everything.isVisible(Vector3(12345, -12345, 0)), true);
+			}
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "BBE/GradientNoise.h"
+#include "BBE/FractalNoise.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		template <typename Noise>
+		void testGradientNoiseBatch(const Noise &noise)
+		{
+			const size_t amount = 1003;
+			List<float> x;
+			List<float> y;
+			List<float> z;
+			List<float> out2D;
+			List<float> out3D;
+			x.resizeCapacityAndLength(amount);
+			y.resizeCapacityAndLength(amount);
+			z.resizeCapacityAndLength(amount);
+			out2D.resizeCapacityAndLength(amount);
+			out3D.resizeCapacityAndLength(amount);
+			for (size_t i = 0; i < amount; i++)
+			{
+				//Crosses negative coordinates, cell borders and the wrap around of the permutation.
+				x[i] = -300.0f + i * 0.61f;
+				y[i] = 200.0f - i * 0.37f;
+				z[i] = (float)(i % 17) - 8.5f + i * 0.01f;
+			}
+			noise.get(x.getRaw(), y.getRaw(), out2D.getRaw(), amount);
+			noise.get(x.getRaw(), y.getRaw(), z.getRaw(), out3D.getRaw(), amount);
+			for (size_t i = 0; i < amount; i++)
+			{
+				assertEqualsFloat(out2D[i], noise.get(x[i], y[i]), 0.00001f);
+				assertEqualsFloat(out3D[i], noise.get(x[i], y[i], z[i]), 0.00001f);
+				assertEquals(out2D[i] >= -1.5f && out2D[i] <= 1.5f, true);
+				assertEquals(out3D[i] >= -1.5f && out3D[i] <= 1.5f, true);
+			}
+		}
+
+		void testGradientNoise()
+		{
+			{
+				PerlinNoise perlin(1);
+				PerlinNoise sameSeed(1);
+				PerlinNoise otherSeed(2);
+				assertEquals(perlin.get(3, -7), 0.0f);
+				assertEquals(perlin.get(3, -7, 12), 0.0f);
+				bool seedsDiffer = false;
+				for (int i = 0; i < 100; i++)
+				{
+					const float x = i * 0.173f;
+					const float y = i * -0.311f;
+					assertEquals(perlin.get(x, y), sameSeed.get(x, y));
+					if (perlin.get(x, y) != otherSeed.get(x, y))
+					{
+						seedsDiffer = true;
+					}
+					//Continuous: a tiny step gives a tiny change.
+					assertEqualsFloat(perlin.get(x, y), perlin.get(x + 0.0001f, y), 0.001f);
+				}
+				assertEquals(seedsDiffer, true);
+				testGradientNoiseBatch(perlin);
+			}
+
+			{
+				SimplexNoise simplex(3);
+				bool nonZero = false;
+				for (int i = 0; i < 100; i++)
+				{
+					const float x = i * 0.173f;
+					const float y = i * -0.311f;
+					assertEqualsFloat(simplex.get(x, y), simplex.get(x + 0.0001f, y), 0.001f);
+					assertEqualsFloat(simplex.get(x, y, 1.5f), simplex.get(x, y + 0.0001f, 1.5f), 0.001f);
+					if (simplex.get(x, y) != 0)
+					{
+						nonZero = true;
+					}
+				}
+				assertEquals(nonZero, true);
+				testGradientNoiseBatch(simplex);
+			}
+
+			{
+				const FractalType types[] = { FractalType::FBM, FractalType::RIDGED, FractalType::WARPED };
+				for (FractalType type : types)
+				{
+					FractalNoise<PerlinNoise> noise(4);
+					noise.setType(type);
+					noise.setOctaves(4);
+					noise.setFrequency(0.05f);
+					noise.setWarpStrength(8);
+					testGradientNoiseBatch(noise);
+
+					const int width = 37;
+					const int height = 23;
+					List<float> region;
+					region.resizeCapacityAndLength(width * height);
+					List<float> neighbour;
+					neighbour.resizeCapacityAndLength(width * height);
+					ThreadPool threadPool(3);
+					noise.getRegion(region.getRaw(), -10, 5, width, height, 0.5f);
+					noise.getRegion(neighbour.getRaw(), -10 + width - 1, 5, width, height, 0.5f, &threadPool);
+					for (int row = 0; row < height; row++)
+					{
+						for (int column = 0; column < width; column++)
+						{
+							const float value = region[row * width + column];
+							assertEqualsFloat(value, noise.get((-10 + column) * 0.5f, (5 + row) * 0.5f), 0.00001f);
+							if (type == FractalType::RIDGED)
+							{
+								assertEquals(value >= 0 && value <= 1, true);
+							}
+						}
+						//The last column of a region is the first column of its neighbour.
+						assertEquals(region[row * width + width - 1], neighbour[row * width]);
+					}
+				}
+
+				FractalNoise<SimplexNoise> simplex(5);
+				simplex.setType(FractalType::WARPED);
+				testGradientNoiseBatch(simplex);
+
+				bool exceptionThrown = false;
+				try
+				{
+					simplex.setOctaves(0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
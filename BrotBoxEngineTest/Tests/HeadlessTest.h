@@ -0,0 +1,86 @@
+#pragma once
+
+#include "BBE/Game.h"
+#include "BBE/EngineSettings.h"
+#include "BBE/PrimitiveBrush2D.h"
+#include "BBE/PrimitiveBrush3D.h"
+#include "BBE/Image.h"
+#include "BBE/Color.h"
+#include "BBE/String.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		//Fills the left half red, the right half stays in the black clear color.
+		class HeadlessTestGame : public Game
+		{
+		public:
+			Image m_capture;
+			int m_frame = 0;
+
+			virtual void onStart() override
+			{
+			}
+
+			virtual void update(float timeSinceLastFrame) override
+			{
+				//The first frame was submitted during the previous iteration.
+				if (m_frame == 1)
+				{
+					captureFrame(m_capture);
+					closeWindow();
+				}
+				m_frame++;
+			}
+
+			virtual void draw3D(PrimitiveBrush3D &brush) override
+			{
+			}
+
+			virtual void draw2D(PrimitiveBrush2D &brush) override
+			{
+				brush.setColor(1, 0, 0);
+				brush.fillRect(0, 0, 32, 32);
+			}
+
+			virtual void onEnd() override
+			{
+			}
+		};
+
+		//Needs a Vulkan device, a software implementation such as lavapipe is enough.
+		void testHeadless()
+		{
+			const bool wasHeadless = Settings::isHeadless();
+			const String pipelineCachePath = Settings::getPipelineCachePath();
+			Settings::setHeadless(true);
+			Settings::setPipelineCachePath("");
+
+			{
+				HeadlessTestGame game;
+				game.start(64, 32, "HeadlessTest");
+
+				assertEquals(game.m_capture.getWidth(), 64);
+				assertEquals(game.m_capture.getHeight(), 32);
+
+				//Red instead of blue proves that the BGRA device format was swizzled.
+				Color c = game.m_capture.getPixel(16, 16);
+				assertEquals(c.r, 1);
+				assertEquals(c.g, 0);
+				assertEquals(c.b, 0);
+				assertEquals(c.a, 1);
+
+				c = game.m_capture.getPixel(48, 16);
+				assertEquals(c.r, 0);
+				assertEquals(c.g, 0);
+				assertEquals(c.b, 0);
+				assertEquals(c.a, 1);
+			}
+
+			Settings::setHeadless(wasHeadless);
+			Settings::setPipelineCachePath(pipelineCachePath);
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "BBE/Heightfield.h"
+#include "BBE/ValueNoise2D.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/Vector3.h"
+#include "BBE/Math.h"
+#include "BBE/List.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testHeightfield()
+		{
+			{
+				//A plane has the same normal everywhere, the borders included.
+				const int width = 9;
+				const int height = 6;
+				List<float> heights;
+				List<Vector3> normals;
+				heights.resizeCapacityAndLength(width * height);
+				normals.resizeCapacityAndLength(width * height);
+				for (int y = 0; y < height; y++)
+				{
+					for (int x = 0; x < width; x++)
+					{
+						heights[y * width + x] = 0.5f * x + 0.25f * y;
+					}
+				}
+				ThreadPool threadPool(2);
+				Heightfield::computeNormals(heights.getRaw(), width, height, 2, 4, normals.getRaw(), &threadPool);
+				const Vector3 expected = Vector3(-1, -0.5f, 1).normalize();
+				for (int i = 0; i < width * height; i++)
+				{
+					assertEqualsFloat(normals[i].x, expected.x, 0.0001f);
+					assertEqualsFloat(normals[i].y, expected.y, 0.0001f);
+					assertEqualsFloat(normals[i].z, expected.z, 0.0001f);
+				}
+			}
+
+			{
+				//A spike collapses into a heap that is no steeper than the talus.
+				const int width = 37;
+				const int height = 29;
+				List<float> heights;
+				heights.resizeCapacityAndLength(width * height);
+				for (int i = 0; i < width * height; i++)
+				{
+					heights[i] = 0;
+				}
+				heights[14 * width + 18] = 10;
+
+				Heightfield heightfield;
+				heightfield.setTalus(0.1f);
+				heightfield.erodeThermal(heights.getRaw(), width, height, 500);
+				float sum = 0;
+				float maxDiff = 0;
+				for (int y = 0; y < height; y++)
+				{
+					for (int x = 0; x < width; x++)
+					{
+						sum += heights[y * width + x];
+						if (x > 0) maxDiff = Math::max(maxDiff, Math::abs(heights[y * width + x] - heights[y * width + x - 1]));
+						if (y > 0) maxDiff = Math::max(maxDiff, Math::abs(heights[y * width + x] - heights[(y - 1) * width + x]));
+					}
+				}
+				assertEqualsFloat(sum, 10.0f, 0.001f);
+				assertEquals(heights[14 * width + 18] < 2, true);
+				assertEquals(maxDiff < 0.15f, true);
+			}
+
+			{
+				//Tiles, threads and the amount of border exchanges do not change the result.
+				ValueNoise2D valueNoise;
+				valueNoise.create(61, 47, 5);
+				const int size = valueNoise.getWidth() * valueNoise.getHeight();
+				List<float> reference;
+				List<float> tiled;
+				reference.resizeCapacityAndLength(size);
+				tiled.resizeCapacityAndLength(size);
+				float sumBefore = 0;
+				for (int i = 0; i < size; i++)
+				{
+					reference[i] = valueNoise.getRaw()[i];
+					tiled[i] = valueNoise.getRaw()[i];
+					sumBefore += reference[i];
+				}
+
+				Heightfield serial;
+				serial.setTileSize(1000);
+				serial.setHydraulicIterations(21);
+				serial.setThermalIterations(13);
+				serial.erode(reference.getRaw(), 61, 47);
+
+				Heightfield parallel;
+				parallel.setTileSize(5);
+				parallel.setHydraulicIterations(21);
+				parallel.setThermalIterations(13);
+				ThreadPool threadPool(3);
+				parallel.erode(tiled.getRaw(), 61, 47, &threadPool);
+
+				float sumAfter = 0;
+				bool changed = false;
+				for (int i = 0; i < size; i++)
+				{
+					assertEquals(reference[i], tiled[i]);
+					sumAfter += reference[i];
+					if (reference[i] != valueNoise.getRaw()[i])
+					{
+						changed = true;
+					}
+				}
+				assertEquals(changed, true);
+				//Dissolved material is deposited again, the water itself adds nothing.
+				assertEqualsFloat(sumAfter, sumBefore, 0.01f);
+			}
+
+			{
+				Heightfield heightfield;
+				bool exceptionThrown = false;
+				try
+				{
+					heightfield.setThermalStrength(0.5f);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					heightfield.setTileSize(0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
@@ -158,8 +158,13 @@ namespace bbe
 			assertEqualsFloat(Math::max(1.0, 0.0), 1.0);
 			assertEqualsFloat(Math::max(0.0, 4.0), 4.0);
 
+			assertEqualsFloat(Math::max(1.0, 5.0, 3.0), 5.0);
+			assertEqualsFloat(Math::max(1.0, 3.0, 5.0, 2.0), 5.0);
+
 			assertEqualsFloat(Math::min(1.0, 0.0), 0.0);
 			assertEqualsFloat(Math::min(1.0, 4.0), 1.0);
+			assertEqualsFloat(Math::min(5.0, 1.0, 3.0), 1.0);
+			assertEqualsFloat(Math::min(5.0, 3.0, 1.0, 2.0), 1.0);
 
 			assertEqualsFloat(Math::maxAbs(-3.0, 2.0), 3.0);
 			assertEqualsFloat(Math::maxAbs(-2.0, 3.0), 3.0);
@@ -173,6 +178,14 @@ namespace bbe
 			assertEqualsFloat(Math::minAbsKeepSign(-3.0, 2.0), 2.0);
 			assertEqualsFloat(Math::minAbsKeepSign(-2.0, 3.0), -2.0);
 
+			assertEqualsFloat(Math::maxAbsKeepSign(1.0, -5.0, 3.0), -5.0);
+			assertEqualsFloat(Math::minAbsKeepSign(5.0, -1.0, 3.0), -1.0);
+
+			static_assert(Math::max(1.0f, 5.0f, 3.0f) == 5.0f, "Math::max must be usable in constant expressions");
+			static_assert(Math::clamp(7.0f, 0.0f, 5.0f) == 5.0f, "Math::clamp must be usable in constant expressions");
+			static_assert(Math::floor(-1.5f) == -2.0f, "Math::floor must be usable in constant expressions");
+			static_assert(Math::interpolateLinear(0.0f, 10.0f, 0.5f) == 5.0f, "Math::interpolateLinear must be usable in constant expressions");
+
 			assertEquals(Math::floatEquals(3, 3.0001f, 0.1f), true);
 			assertEquals(Math::floatEquals(3, 3.1001f, 0.1f), false);
 
@@ -230,6 +243,38 @@ namespace bbe
 			assertEquals(Math::isEven(2 ), true);
 			assertEquals(Math::isEven(-3), false);
 			assertEquals(Math::isEven(3 ), false);
+
+			assertEquals(Math::floatToHalf(0), (uint16_t)0x0000);
+			assertEquals(Math::floatToHalf(-0.0f), (uint16_t)0x8000);
+			assertEquals(Math::floatToHalf(1), (uint16_t)0x3C00);
+			assertEquals(Math::floatToHalf(0.5f), (uint16_t)0x3800);
+			assertEquals(Math::floatToHalf(-2), (uint16_t)0xC000);
+			assertEquals(Math::floatToHalf(65504), (uint16_t)0x7BFF);
+			assertEquals(Math::floatToHalf(65519), (uint16_t)0x7BFF);
+			assertEquals(Math::floatToHalf(65520), (uint16_t)0x7C00);
+			assertEquals(Math::floatToHalf(-1e9f), (uint16_t)0xFC00);
+			assertEquals(Math::floatToHalf(Math::INFINITY_POSITIVE), (uint16_t)0x7C00);
+			assertEquals(Math::floatToHalf(0.00006103515625f), (uint16_t)0x0400);
+			assertEquals(Math::floatToHalf(0.000000059604644775390625f), (uint16_t)0x0001);
+			assertEquals(Math::floatToHalf(0.0000000298023223876953125f), (uint16_t)0x0000);
+			assertEquals(Math::floatToHalf(1 + 1.0f / 2048), (uint16_t)0x3C00);
+			assertEquals(Math::floatToHalf(1 + 3.0f / 2048), (uint16_t)0x3C02);
+			assertEquals(Math::isNaN(Math::halfToFloat(Math::floatToHalf(Math::NaN))), true);
+			assertEquals(Math::halfToFloat(0x3555), 0.333251953125f);
+			assertEquals(Math::halfToFloat(0x8001), -0.000000059604644775390625f);
+			for (uint32_t i = 0; i < 0x10000; i++)
+			{
+				const uint16_t half = (uint16_t)i;
+				if ((half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0)
+				{
+					continue;
+				}
+				assertEquals(Math::floatToHalf(Math::halfToFloat(half)), half);
+			}
+			for (int i = 0; i <= 256; i++)
+			{
+				assertEquals(Math::halfToFloat(Math::floatToHalf(i * 0.5f)), i * 0.5f);
+			}
 		}
 	}
 }
\ No newline at end of file
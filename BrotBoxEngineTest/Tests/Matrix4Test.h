@@ -222,6 +222,45 @@ namespace bbe
 				assertEquals(m4.get(2, 3), 4);
 				assertEquals(m4.get(3, 3), 1);
 			}
+
+			{
+				constexpr Matrix4 translation = Matrix4::createTranslationMatrix(Vector3(1, 2, 3));
+				constexpr Matrix4 scale = Matrix4::createScaleMatrix(Vector3(2, 3, 4));
+				constexpr Matrix4 transform = translation * scale;
+				constexpr Vector3 transformed = transform * Vector3(1, 1, 1);
+				static_assert(transform.get(0, 0) == 2 && transform.get(1, 1) == 3 && transform.get(2, 2) == 4, "Matrix4 multiplication must be usable in constant expressions");
+				static_assert(transform[12] == 1 && transform[13] == 2 && transform[14] == 3, "Matrix4::operator[] must be usable in constant expressions");
+				static_assert(transformed == Vector3(3, 5, 7), "Matrix4 * Vector3 must be usable in constant expressions");
+				assertEquals(transform.getRow(0).w, 1);
+				assertEquals(transform.getColumn(3).y, 2);
+			}
+
+			{
+				Matrix4 transform = Matrix4::createTransform(Vector3(1, -2, 3), Vector3(2, 3, 0.5f), Vector3(1, 1, 0), 0.7f);
+				Matrix4 identity = transform * transform.inverse();
+				for (int row = 0; row < 4; row++)
+				{
+					for (int col = 0; col < 4; col++)
+					{
+						assertEqualsFloat(identity.get(row, col), row == col ? 1.0f : 0.0f, 0.0001f);
+					}
+				}
+				Vector3 point = transform.inverse() * (transform * Vector3(4, 5, 6));
+				assertEqualsFloat(point.x, 4.0f, 0.0001f);
+				assertEqualsFloat(point.y, 5.0f, 0.0001f);
+				assertEqualsFloat(point.z, 6.0f, 0.0001f);
+
+				bool exceptionThrown = false;
+				try
+				{
+					Matrix4::createScaleMatrix(Vector3(1, 0, 1)).inverse();
+				}
+				catch (IllegalStateException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BBE/MersenneTwister.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+#include <random>
+
+namespace bbe
+{
+	namespace test
+	{
+		void testMersenneTwister()
+		{
+			{
+				mt19937 mt(5489);
+				std::mt19937 reference(5489);
+				for (int i = 0; i < 10000; i++)
+				{
+					assertEquals(mt.next(), reference());
+				}
+			}
+
+			{
+				const uint32_t seeds[] = { 1, 2, 3, 0xBBEBBEBB };
+				mt19937 mt;
+				mt.setSeed(seeds, 4);
+				std::seed_seq sequence = { 1u, 2u, 3u, 0xBBEBBEBBu };
+				std::mt19937 reference(sequence);
+				for (int i = 0; i < 2000; i++)
+				{
+					assertEquals(mt.next(), reference());
+				}
+			}
+
+			{
+				mt19937 mt(17);
+				std::mt19937 reference(17);
+				List<uint32_t> values;
+				values.resizeCapacityAndLength(5000);
+				const size_t amounts[] = { 0, 1, 3, 623, 624, 625, 5000, 7 };
+				for (size_t amount : amounts)
+				{
+					mt.fill(values.getRaw(), amount);
+					for (size_t i = 0; i < amount; i++)
+					{
+						assertEquals(values[i], reference());
+					}
+					assertEquals(mt.next(), reference());
+				}
+			}
+
+			{
+				mt19937 mt(42);
+				std::mt19937 reference(42);
+				const uint64_t distances[] = { 0, 1, 100, 624, 625, 10000, 1000000 };
+				for (uint64_t distance : distances)
+				{
+					mt.discard(distance);
+					reference.discard(distance);
+					for (int i = 0; i < 700; i++)
+					{
+						assertEquals(mt.next(), reference());
+					}
+				}
+			}
+
+			{
+				//The same distance once jumped and once stepped.
+				mt19937 a(3);
+				mt19937 b(3);
+				a.discard((1ull << 28) + 5);
+				b.discard((1ull << 28) - 1);
+				b.discard(6);
+				for (int i = 0; i < 1000; i++)
+				{
+					assertEquals(a.next(), b.next());
+				}
+			}
+
+			{
+				//Far jumps: two jumps must land on the same state as a single one over the whole distance.
+				mt19937 a(7);
+				mt19937 b(7);
+				a.discard(1ull << 40);
+				a.discard((1ull << 40) + 3);
+				b.discard((1ull << 41) + 3);
+				for (int i = 0; i < 1000; i++)
+				{
+					assertEquals(a.next(), b.next());
+				}
+			}
+		}
+	}
+}
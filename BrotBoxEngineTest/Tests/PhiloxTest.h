@@ -0,0 +1,91 @@
+#pragma once
+
+#include "BBE/Philox.h"
+#include "BBE/Random.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testPhilox()
+		{
+			{
+				//Known answers from the Random123 distribution.
+				uint32_t out[4];
+				const uint32_t zeroKey[2] = { 0, 0 };
+				const uint32_t zeroCounter[4] = { 0, 0, 0, 0 };
+				Philox4x32::generate(zeroKey, zeroCounter, out);
+				assertEquals(out[0], 0x6627e8d5u);
+				assertEquals(out[1], 0xe169c58du);
+				assertEquals(out[2], 0xbc57ac4cu);
+				assertEquals(out[3], 0x9b00dbd8u);
+
+				const uint32_t fullKey[2] = { 0xffffffff, 0xffffffff };
+				const uint32_t fullCounter[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+				Philox4x32::generate(fullKey, fullCounter, out);
+				assertEquals(out[0], 0x408f276du);
+				assertEquals(out[1], 0x41c83b0eu);
+				assertEquals(out[2], 0xa20bc7c6u);
+				assertEquals(out[3], 0x6d5451fdu);
+
+				const uint32_t piKey[2] = { 0xa4093822, 0x299f31d0 };
+				const uint32_t piCounter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+				Philox4x32::generate(piKey, piCounter, out);
+				assertEquals(out[0], 0xd16cfe09u);
+				assertEquals(out[1], 0x94fdccebu);
+				assertEquals(out[2], 0x5001e420u);
+				assertEquals(out[3], 0x24126ea1u);
+			}
+
+			{
+				Philox4x32 philox(0x123456789ull, 77);
+				Philox4x32 reference(0x123456789ull, 77);
+				List<uint32_t> values;
+				values.resizeCapacityAndLength(1000);
+				philox.next();
+				philox.fill(values.getRaw(), 3);
+				philox.fill(values.getRaw() + 3, 997);
+				for (size_t i = 0; i < values.getLength(); i++)
+				{
+					assertEquals(values[i], reference.getUInt(i + 1));
+				}
+				assertEquals(philox.next(), reference.getUInt(1001));
+
+				reference.seek(555);
+				assertEquals(reference.next(), values[554]);
+				assertEquals(reference.next(), values[555]);
+			}
+
+			{
+				//Every element derives its values from its index alone, so the result does not depend on the
+				//amount of threads or the order in which the elements are processed.
+				const size_t amount = 5000;
+				List<Vector3> serial;
+				serial.resizeCapacityAndLength(amount);
+				List<Vector3> parallel;
+				parallel.resizeCapacityAndLength(amount);
+				auto generate = [](List<Vector3> &out, size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						RandomPhilox rand(42, i);
+						out[i] = rand.randomVector3InUnitSphere();
+					}
+				};
+
+				generate(serial, 0, amount);
+				ThreadPool pool(3);
+				pool.parallelFor(0, amount, [&](size_t begin, size_t end) { generate(parallel, begin, end); });
+				for (size_t i = 0; i < amount; i++)
+				{
+					assertEquals(serial[i], parallel[i]);
+					assertEquals(serial[i].getLength() <= 1, true);
+				}
+				assertEquals(serial[0] != serial[1], true);
+			}
+		}
+	}
+}
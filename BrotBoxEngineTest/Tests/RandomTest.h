@@ -0,0 +1,171 @@
+#pragma once
+
+#include "BBE/Random.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testRandom()
+		{
+			{
+				SplitMix64 splitMix(1234567);
+				assertEquals(splitMix.next(), 6457827717110365317ull);
+				assertEquals(splitMix.next(), 3203168211198807973ull);
+				assertEquals(splitMix.next(), 9817491932198370423ull);
+				assertEquals(splitMix.next(), 4593380528125082431ull);
+				assertEquals(splitMix.next(), 16408922859458223821ull);
+			}
+
+			{
+				PCG32 pcg(42, 54);
+				assertEquals(pcg.next(), 0xa15c02b7u);
+				assertEquals(pcg.next(), 0x7b47f409u);
+				assertEquals(pcg.next(), 0xba1d3330u);
+				assertEquals(pcg.next(), 0x83d2f293u);
+				assertEquals(pcg.next(), 0xbfa4784bu);
+				assertEquals(pcg.next(), 0xcbed606eu);
+			}
+
+			{
+				Xoshiro256StarStar a(99);
+				Xoshiro256StarStar b(99);
+				Xoshiro256StarStar stream1(99, 1);
+				Xoshiro256StarStar stream2(99, 2);
+				b.jump();
+				bool streamsDiffer = false;
+				for (int i = 0; i < 100; i++)
+				{
+					const uint64_t value = b.next();
+					assertEquals(value, stream1.next());
+					if (value != stream2.next() || value != a.next())
+					{
+						streamsDiffer = true;
+					}
+				}
+				assertEquals(streamsDiffer, true);
+
+				//The first lane of fill starts one long jump after the scalar state.
+				Xoshiro256StarStar filled(5);
+				Xoshiro256StarStar lane0(5);
+				Xoshiro256StarStar lane1(5);
+				lane0.longJump();
+				lane1.longJump();
+				lane1.longJump();
+				List<uint32_t> values;
+				values.resizeCapacityAndLength(80);
+				filled.fill(values.getRaw(), 80);
+				for (size_t i = 0; i < 80; i += 8)
+				{
+					const uint64_t expected0 = lane0.next();
+					const uint64_t expected1 = lane1.next();
+					assertEquals(values[i], (uint32_t)expected0);
+					assertEquals(values[i + 1], (uint32_t)(expected0 >> 32));
+					assertEquals(values[i + 2], (uint32_t)expected1);
+					assertEquals(values[i + 3], (uint32_t)(expected1 >> 32));
+				}
+			}
+
+			{
+				Random rand(7);
+				Random sameSeed(7);
+				Random otherStream(7, 1);
+				bool streamsDiffer = false;
+				int buckets[10] = {};
+				const int amount = 100000;
+				for (int i = 0; i < amount; i++)
+				{
+					const float value = rand.randomFloat();
+					assertEquals(value >= 0 && value < 1, true);
+					assertEquals(value, sameSeed.randomFloat());
+					if (value != otherStream.randomFloat())
+					{
+						streamsDiffer = true;
+					}
+
+					const int integer = rand.randomInt(10);
+					sameSeed.randomInt(10);
+					otherStream.randomInt(10);
+					assertEquals(integer >= 0 && integer < 10, true);
+					buckets[integer]++;
+				}
+				assertEquals(streamsDiffer, true);
+				for (int i = 0; i < 10; i++)
+				{
+					assertEquals(buckets[i] > amount / 10 * 95 / 100 && buckets[i] < amount / 10 * 105 / 100, true);
+				}
+
+				bool exceptionThrown = false;
+				try
+				{
+					rand.randomInt(0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				const double value = rand.randomDouble();
+				assertEquals(value >= 0 && value < 1, true);
+			}
+
+			{
+				RandomPCG32 pcg(3);
+				RandomSplitMix64 splitMix(3);
+				for (int i = 0; i < 1000; i++)
+				{
+					assertEquals(pcg.randomUInt(1000) < 1000, true);
+					assertEquals(splitMix.randomUInt(1000) < 1000, true);
+				}
+			}
+
+			{
+				Random rand(11);
+				Random sameSeed(11);
+				const size_t amount = 10007;
+				List<float> floats;
+				floats.resizeCapacityAndLength(amount);
+				List<float> sameFloats;
+				sameFloats.resizeCapacityAndLength(amount);
+				rand.fillFloat(floats.getRaw(), amount, 4);
+				sameSeed.fillFloat(sameFloats.getRaw(), amount, 4);
+				double sum = 0;
+				for (size_t i = 0; i < amount; i++)
+				{
+					assertEquals(floats[i] >= 0 && floats[i] < 4, true);
+					assertEquals(floats[i], sameFloats[i]);
+					sum += floats[i];
+				}
+				assertEqualsFloat((float)(sum / amount), 2.0f, 0.05f);
+
+				List<uint32_t> integers;
+				integers.resizeCapacityAndLength(amount);
+				rand.fillUInt(integers.getRaw(), amount, 6);
+				int buckets[6] = {};
+				for (size_t i = 0; i < amount; i++)
+				{
+					assertEquals(integers[i] < 6, true);
+					buckets[integers[i]]++;
+				}
+				for (int i = 0; i < 6; i++)
+				{
+					assertEquals(buckets[i] > 0, true);
+				}
+
+				List<Vector3> vectors;
+				vectors.resizeCapacityAndLength(333);
+				rand.fillVector3(vectors.getRaw(), vectors.getLength(), 2);
+				for (size_t i = 0; i < vectors.getLength(); i++)
+				{
+					for (int k = 0; k < 3; k++)
+					{
+						assertEquals(vectors[i][k] >= 0 && vectors[i][k] < 2, true);
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "BBE/RingAllocator.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testRingAllocator()
+		{
+			{
+				RingAllocator ring(100);
+				assertEquals(ring.getCapacity(), 100);
+				assertEquals(ring.isEmpty(), true);
+
+				size_t offset = 1000;
+				assertEquals(ring.allocate(10, 1, offset), true);
+				assertEquals(offset, 0);
+				assertEquals(ring.allocate(10, 16, offset), true);
+				assertEquals(offset, 16);
+				assertEquals(ring.getUsed(), 26);
+				assertEquals(ring.getHead(), 26);
+				assertEquals(ring.isEmpty(), false);
+			}
+
+			{
+				//Allocations never wrap, the end of the area is skipped and stays used until it is freed.
+				RingAllocator ring(100);
+				size_t offset = 0;
+				assertEquals(ring.allocate(40, 1, offset), true);
+				const uint64_t firstEnd = ring.getHead();
+				assertEquals(ring.allocate(40, 1, offset), true);
+				assertEquals(offset, 40);
+				assertEquals(ring.allocate(30, 1, offset), false);
+				assertEquals(ring.getUsed(), 80);
+
+				ring.freeUpTo(firstEnd);
+				assertEquals(ring.getUsed(), 40);
+				assertEquals(ring.allocate(30, 1, offset), true);
+				assertEquals(offset, 0);
+				assertEquals(ring.getUsed(), 90);
+				assertEquals(ring.allocate(11, 1, offset), false);
+
+				ring.freeUpTo(ring.getHead());
+				assertEquals(ring.isEmpty(), true);
+				//Freeing an older position again changes nothing.
+				ring.freeUpTo(firstEnd);
+				assertEquals(ring.isEmpty(), true);
+			}
+
+			{
+				//An empty ring may use the whole area, even if the last allocation ended close to its end.
+				RingAllocator ring(64);
+				size_t offset = 0;
+				assertEquals(ring.allocate(60, 4, offset), true);
+				ring.freeUpTo(ring.getHead());
+				assertEquals(ring.allocate(64, 4, offset), true);
+				assertEquals(offset, 0);
+				assertEquals(ring.getUsed(), 64);
+				assertEquals(ring.allocate(1, 1, offset), false);
+				assertEquals(ring.allocate(65, 1, offset), false);
+			}
+
+			{
+				RingAllocator ring(64);
+				size_t offset = 0;
+				bool exceptionThrown = false;
+				try
+				{
+					ring.allocate(8, 3, offset);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					ring.freeUpTo(ring.getHead() + 1);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					ring.reset(0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "BBE/SkylinePacker.h"
+#include "BBE/List.h"
+#include "BBE/Random.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testSkylinePacker()
+		{
+			{
+				SkylinePacker packer(64, 32);
+				int x = -1;
+				int y = -1;
+				assertEquals(packer.insert(32, 16, x, y), true);
+				assertEquals(x, 0);
+				assertEquals(y, 0);
+				assertEquals(packer.insert(32, 8, x, y), true);
+				assertEquals(x, 32);
+				assertEquals(y, 0);
+				//Rests on the lower of the two.
+				assertEquals(packer.insert(32, 8, x, y), true);
+				assertEquals(x, 32);
+				assertEquals(y, 8);
+				assertEquals(packer.insert(64, 16, x, y), true);
+				assertEquals(x, 0);
+				assertEquals(y, 16);
+				assertEquals(packer.getUsedArea(), 64 * 32);
+				assertEquals(packer.insert(1, 1, x, y), false);
+
+				packer.reset(16, 16);
+				assertEquals(packer.getUsedArea(), 0);
+				assertEquals(packer.insert(16, 16, x, y), true);
+				assertEquals(x, 0);
+				assertEquals(y, 0);
+			}
+
+			{
+				//Random rectangles never overlap and never leave the area.
+				const int width = 128;
+				const int height = 96;
+				SkylinePacker packer(width, height);
+				List<int> used;
+				used.resizeCapacityAndLength(width * height);
+				for (int i = 0; i < width * height; i++)
+				{
+					used[i] = 0;
+				}
+				Random rand;
+				int inserted = 0;
+				for (int i = 0; i < 300; i++)
+				{
+					const int w = rand.randomInt(20) + 1;
+					const int h = rand.randomInt(20) + 1;
+					int x = 0;
+					int y = 0;
+					if (!packer.insert(w, h, x, y))
+					{
+						continue;
+					}
+					inserted++;
+					assertEquals(x >= 0 && y >= 0 && x + w <= width && y + h <= height, true);
+					for (int k = y; k < y + h; k++)
+					{
+						for (int m = x; m < x + w; m++)
+						{
+							assertEquals(used[k * width + m], 0);
+							used[k * width + m] = 1;
+						}
+					}
+				}
+				assertEquals(inserted > 20, true);
+			}
+
+			{
+				bool exceptionThrown = false;
+				try
+				{
+					SkylinePacker packer(0, 16);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					SkylinePacker packer(16, 16);
+					int x = 0;
+					int y = 0;
+					packer.insert(4, -1, x, y);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "BBE/StreamingTerrain.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testStreamingTerrain()
+		{
+			{
+				StreamingTerrain terrain(7, 2);
+				terrain.setLoadRadius(100, 250);
+
+				//Camera in the middle of patch (0, 0): the patch itself and its eight neighbours are within reach.
+				terrain.update(Vector3(64, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 0);
+				assertEquals(terrain.getAmountOfRequestedPatches(), 9);
+				terrain.waitForRequests();
+				terrain.update(Vector3(64, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 9);
+				assertEquals(terrain.getAmountOfRequestedPatches(), 0);
+				assertEquals(terrain.getPatch(-1, -1) != nullptr, true);
+				assertEquals(terrain.getPatch(2, 0) == nullptr, true);
+
+				//Neighbouring patches share their border vertices, so there is no step between them.
+				const Ray downBefore(Vector3(127.99f, 37.25f, 1000), Vector3(0, 0, -1));
+				const Ray down(Vector3(128.01f, 37.25f, 1000), Vector3(0, 0, -1));
+				float t0;
+				float t1;
+				assertEquals(terrain.getPatch(0, 0)->intersects(downBefore, t0), true);
+				assertEquals(terrain.getPatch(1, 0)->intersects(down, t1), true);
+				assertEqualsFloat(t0, t1, 0.05f);
+
+				StreamingTerrain sameSeed(7, 1);
+				sameSeed.setLoadRadius(10, 10);
+				sameSeed.update(Vector3(200, 64, 0));
+				sameSeed.waitForRequests();
+				sameSeed.update(Vector3(200, 64, 0));
+				assertEquals(sameSeed.getAmountOfResidentPatches(), 1);
+				float t2;
+				assertEquals(sameSeed.getPatch(1, 0)->intersects(down, t2), true);
+				assertEquals(t1, t2);
+
+				//Moving by one patch keeps everything within the unload radius resident.
+				terrain.update(Vector3(192, 64, 0));
+				assertEquals(terrain.getPatch(-1, 0) != nullptr, true);
+				assertEquals(terrain.getAmountOfRequestedPatches(), 3);
+				terrain.waitForRequests();
+				terrain.update(Vector3(192, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 12);
+
+				//Moving far away evicts the old patches and cancels nothing that is still wanted.
+				terrain.update(Vector3(5056, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 0);
+				assertEquals(terrain.getAmountOfRequestedPatches(), 9);
+
+				//Requests that leave the unload radius before they are done never become resident.
+				terrain.update(Vector3(-5056, 64, 0));
+				terrain.waitForRequests();
+				terrain.update(Vector3(-5056, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 9);
+				assertEquals(terrain.getPatch(39, 0) == nullptr, true);
+			}
+
+			{
+				StreamingTerrain terrain(8, 1);
+				terrain.setLoadRadius(300, 400);
+				terrain.setMaxResidentPatches(5);
+				terrain.update(Vector3(64, 64, 0));
+				assertEquals(terrain.getAmountOfRequestedPatches(), 5);
+				terrain.waitForRequests();
+				terrain.update(Vector3(64, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 5);
+				assertEquals(terrain.getPatch(0, 0) != nullptr, true);
+
+				//The patches that are no longer among the nearest ones are evicted first.
+				terrain.update(Vector3(64 + 3 * 128, 64, 0));
+				terrain.waitForRequests();
+				terrain.update(Vector3(64 + 3 * 128, 64, 0));
+				assertEquals(terrain.getAmountOfResidentPatches(), 5);
+				assertEquals(terrain.getPatch(3, 0) != nullptr, true);
+				assertEquals(terrain.getPatch(0, 0) == nullptr, true);
+
+				bool exceptionThrown = false;
+				try
+				{
+					terrain.setLoadRadius(100, 50);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+
+			{
+				//Destroying the terrain while requests are in flight must not crash.
+				StreamingTerrain terrain(9, 2);
+				terrain.update(Vector3(0, 0, 0));
+			}
+		}
+	}
+}
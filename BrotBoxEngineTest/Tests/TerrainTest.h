@@ -0,0 +1,425 @@
+#pragma once
+
+#include "BBE/Terrain.h"
+#include "BBE/Heightfield.h"
+#include "BBE/SimpleFile.h"
+#include "BBE/Ray.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		//The edges on one side of a patch in vertices of lod level 0. Degenerated triangles are skipped.
+		List<int> getTerrainSideEdges(const List<uint32_t> &indices, int lodLevel, bool negativeX)
+		{
+			const int step = 1 << lodLevel;
+			const int lodWidth = ((TerrainPatch::PATCH_RESOLUTION - 1) >> lodLevel) + 1;
+			const int row = negativeX ? 0 : lodWidth - 1;
+			List<int> edges;
+			size_t stripStart = 0;
+			for (size_t i = 0; i < indices.getLength(); i++)
+			{
+				if (indices[i] == 0xFFFFFFFF)
+				{
+					stripStart = i + 1;
+					continue;
+				}
+				if (i < stripStart + 2)
+				{
+					continue;
+				}
+				const uint32_t triangle[] = { indices[i - 2], indices[i - 1], indices[i] };
+				if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+				{
+					continue;
+				}
+				for (int k = 0; k < 3; k++)
+				{
+					const uint32_t a = triangle[k];
+					const uint32_t b = triangle[(k + 1) % 3];
+					if ((int)a / lodWidth == row && (int)b / lodWidth == row)
+					{
+						const int colA = (int)a % lodWidth * step;
+						const int colB = (int)b % lodWidth * step;
+						edges.add(colA < colB ? colA * 1000 + colB : colB * 1000 + colA);
+					}
+				}
+			}
+			edges.sort();
+			return edges;
+		}
+
+		//The area covered by the triangles, with the area of flipped triangles counting negative.
+		float getTerrainArea(const List<uint32_t> &indices, int lodLevel, bool &outFlipped)
+		{
+			const int lodWidth = ((TerrainPatch::PATCH_RESOLUTION - 1) >> lodLevel) + 1;
+			float area = 0;
+			outFlipped = false;
+			size_t stripStart = 0;
+			for (size_t i = 0; i < indices.getLength(); i++)
+			{
+				if (indices[i] == 0xFFFFFFFF)
+				{
+					stripStart = i + 1;
+					continue;
+				}
+				if (i < stripStart + 2)
+				{
+					continue;
+				}
+				float x[3];
+				float y[3];
+				for (int k = 0; k < 3; k++)
+				{
+					x[k] = (float)(indices[i - 2 + k] / lodWidth);
+					y[k] = (float)(indices[i - 2 + k] % lodWidth);
+				}
+				float signedArea = ((x[2] - x[0]) * (y[1] - y[0]) - (x[1] - x[0]) * (y[2] - y[0])) / 2;
+				if ((i - stripStart) % 2 == 1)
+				{
+					signedArea = -signedArea;
+				}
+				if (signedArea < 0)
+				{
+					outFlipped = true;
+				}
+				area += signedArea;
+			}
+			return area;
+		}
+
+		void testTerrain()
+		{
+			{
+				const int lodWidth = TerrainPatch::PATCH_RESOLUTION;
+				assertEquals(TerrainPatch::createLodIndices(0, 0).getLength(), (lodWidth - 1) * (lodWidth * 2 + 1));
+				const size_t coarsestLength = TerrainPatch::createLodIndices(Terrain::AMOUNT_OF_LOD_LEVELS - 1, 0).getLength();
+				assertEquals(coarsestLength < TerrainPatch::createLodIndices(0, 0).getLength() / 500, true);
+
+				for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
+				{
+					const float cells = (float)((TerrainPatch::PATCH_RESOLUTION - 1) >> lod);
+					for (int coarserEdges = 0; coarserEdges < TerrainPatch::AMOUNT_OF_EDGE_MASKS; coarserEdges++)
+					{
+						bool flipped;
+						const float area = getTerrainArea(TerrainPatch::createLodIndices(lod, coarserEdges), lod, flipped);
+						assertEquals(flipped, false);
+						assertEquals(area, cells * cells);
+					}
+				}
+
+				//A stitched edge has exactly the edges of its coarser neighbour, an unstitched one has more.
+				for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS - 1; lod++)
+				{
+					const List<int> fine = getTerrainSideEdges(TerrainPatch::createLodIndices(lod, TerrainPatch::EDGE_POSITIVE_X | TerrainPatch::EDGE_NEGATIVE_Y), lod, false);
+					const List<int> coarse = getTerrainSideEdges(TerrainPatch::createLodIndices(lod + 1, 0), lod + 1, true);
+					const List<int> unstitched = getTerrainSideEdges(TerrainPatch::createLodIndices(lod, TerrainPatch::EDGE_NEGATIVE_X), lod, false);
+					assertEquals(fine.getLength(), coarse.getLength());
+					for (size_t i = 0; i < fine.getLength(); i++)
+					{
+						assertEquals(fine[i], coarse[i]);
+					}
+					assertEquals(unstitched.getLength(), coarse.getLength() * 2);
+				}
+
+				bool exceptionThrown = false;
+				try
+				{
+					TerrainPatch::createLodIndices(Terrain::AMOUNT_OF_LOD_LEVELS, 0);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+
+			{
+				//A slope along x, and a second patch continuing it. Both get the heights behind their edges.
+				const int resolution = TerrainPatch::PATCH_RESOLUTION;
+				auto height = [](int row, int col)
+				{
+					return 0.1f + row / 1024.0f + Math::sin(col * 0.1f) * 0.01f;
+				};
+				List<float> data;
+				List<float> nextData;
+				List<float> borders;
+				List<float> nextBorders;
+				data.resizeCapacityAndLength(resolution * resolution);
+				nextData.resizeCapacityAndLength(resolution * resolution);
+				borders.resizeCapacityAndLength(TerrainPatch::getAmountOfBorderHeights());
+				nextBorders.resizeCapacityAndLength(TerrainPatch::getAmountOfBorderHeights());
+				for (int row = 0; row < resolution; row++)
+				{
+					for (int col = 0; col < resolution; col++)
+					{
+						data[row * resolution + col] = height(row, col);
+						nextData[row * resolution + col] = height(row + resolution - 1, col);
+					}
+				}
+				for (int i = 0; i < resolution; i++)
+				{
+					borders[i]                      = height(-1, i);
+					borders[resolution + i]         = height(resolution, i);
+					borders[resolution * 2 + i]     = height(i, -1);
+					borders[resolution * 3 + i]     = height(i, resolution);
+					nextBorders[i]                  = height(resolution - 2, i);
+					nextBorders[resolution + i]     = height(resolution * 2 - 1, i);
+					nextBorders[resolution * 2 + i] = height(i + resolution - 1, -1);
+					nextBorders[resolution * 3 + i] = height(i + resolution - 1, resolution);
+				}
+				TerrainPatch patch(resolution, resolution, data.getRaw(), borders.getRaw(), 0, 0);
+				TerrainPatch nextPatch(resolution, resolution, nextData.getRaw(), nextBorders.getRaw(), 1, 0);
+
+				//Along x the heights are linear, so extrapolating them gives the real ones.
+				List<float> extrapolatedBorders;
+				extrapolatedBorders.resizeCapacityAndLength(TerrainPatch::getAmountOfBorderHeights());
+				TerrainPatch::createBorders(data.getRaw(), extrapolatedBorders.getRaw());
+				for (int i = 0; i < resolution * 2; i++)
+				{
+					assertEqualsFloat(extrapolatedBorders[i], borders[i], 0.0001f);
+				}
+
+				for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
+				{
+					const int step = 1 << lod;
+					const int lodWidth = ((resolution - 1) >> lod) + 1;
+					const List<TerrainVertex> vertices = patch.createLodVertices(lod);
+					const List<TerrainVertex> nextVertices = nextPatch.createLodVertices(lod);
+					assertEquals(vertices.getLength(), lodWidth * lodWidth);
+					assertEquals(sizeof(TerrainVertex), 8);
+					for (int row = 0; row < lodWidth; row += 7)
+					{
+						for (int col = 0; col < lodWidth; col += 5)
+						{
+							assertEqualsFloat(vertices[row * lodWidth + col].getHeight(), data[row * step * resolution + col * step], 0.0001f);
+						}
+					}
+
+					//The heights rise by 100 / 1024 for every 0.5 units along x. Along y the slope is the central
+					//difference of the full resolution, no matter the level. The edges use the borders.
+					const int centers[] = { 0, lodWidth / 2, lodWidth - 1 };
+					for (int i = 0; i < 3; i++)
+					{
+						const int center = centers[i] * step;
+						const Vector3 normal = vertices[centers[i] * lodWidth + centers[i]].getNormal();
+						const float slopeY = (Math::sin((center + 1) * 0.1f) - Math::sin((center - 1) * 0.1f)) / 1.0f;
+						const Vector3 expected = Vector3(-0.1953125f, -slopeY, 1).normalize();
+						assertEqualsFloat(normal.x, expected.x, 0.02f);
+						assertEqualsFloat(normal.y, expected.y, 0.02f);
+						assertEqualsFloat(normal.z, expected.z, 0.02f);
+					}
+
+					//The shared border has bit identical heights and normals in both patches.
+					for (int col = 0; col < lodWidth; col++)
+					{
+						const TerrainVertex &border = vertices[(lodWidth - 1) * lodWidth + col];
+						const TerrainVertex &nextBorder = nextVertices[col];
+						assertEquals(border.m_height, nextBorder.m_height);
+						assertEquals(memcmp(border.m_normal, nextBorder.m_normal, sizeof(border.m_normal)), 0);
+					}
+				}
+
+				for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS - 1; lod++)
+				{
+					const int lodWidth = ((resolution - 1) >> lod) + 1;
+					const List<TerrainVertex> vertices = patch.createLodVertices(lod);
+					auto lodHeight = [&](int row, int col)
+					{
+						return vertices[row * lodWidth + col].getHeight();
+					};
+					auto morphHeight = [&](int row, int col)
+					{
+						return vertices[row * lodWidth + col].getMorphHeight();
+					};
+
+					//Vertices that the next level drops morph onto the coarser triangles, the others stay.
+					assertEqualsFloat(morphHeight(3, 4), (lodHeight(2, 4) + lodHeight(4, 4)) * 0.5f, 0.0001f);
+					assertEqualsFloat(morphHeight(4, 3), (lodHeight(4, 2) + lodHeight(4, 4)) * 0.5f, 0.0001f);
+					assertEqualsFloat(morphHeight(3, 3), (lodHeight(2, 4) + lodHeight(4, 2)) * 0.5f, 0.0001f);
+					assertEquals(vertices[4 * lodWidth + 4].m_morphHeight, vertices[4 * lodWidth + 4].m_height);
+					assertEquals(vertices[0].m_morphHeight, vertices[0].m_height);
+
+					//An even vertex on an edge morphs like the vertex at the same position in a neighbour that is
+					//one level coarser, if the neighbour drops it in its next level.
+					const List<TerrainVertex> coarserNextVertices = nextPatch.createLodVertices(lod + 1);
+					for (int col = 0; col < lodWidth; col += 2)
+					{
+						const TerrainVertex &border = vertices[(lodWidth - 1) * lodWidth + col];
+						const TerrainVertex &coarserBorder = coarserNextVertices[col / 2];
+						assertEquals(border.m_height, coarserBorder.m_height);
+						if ((col / 2) % 2 == 1)
+						{
+							assertEquals(border.m_morphHeight, coarserBorder.m_morphHeight);
+						}
+					}
+				}
+			}
+
+			{
+				//The morph ends where selectLodLevels switches to the next level.
+				float start;
+				float end;
+				TerrainPatch::getMorphRange(0, 128, start, end);
+				assertEquals(start, 96.0f);
+				assertEquals(end, 128.0f);
+				TerrainPatch::getMorphRange(2, 128, start, end);
+				assertEquals(start, 384.0f);
+				assertEquals(end, 512.0f);
+				TerrainPatch::getMorphRange(Terrain::AMOUNT_OF_LOD_LEVELS - 1, 128, start, end);
+				assertEquals(start, Math::INFINITY_POSITIVE);
+				assertEquals(end, Math::INFINITY_POSITIVE);
+
+				bool exceptionThrown = false;
+				try
+				{
+					TerrainPatch::getMorphRange(Terrain::AMOUNT_OF_LOD_LEVELS, 128, start, end);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+
+			{
+				//Every doubling of the distance adds a level.
+				const int   patchXs[]   = { 0,   10,  20,  30,  40,  50,  60     };
+				const int   patchYs[]   = { 0,   0,   0,   0,   0,   0,   0      };
+				const float distances[] = { 127, 128, 255, 256, 600, 1100, 1e9f  };
+				int lodLevels[7];
+				int coarserEdges[7];
+				TerrainPatch::selectLodLevels(patchXs, patchYs, distances, 7, 128, lodLevels, coarserEdges);
+				assertEquals(lodLevels[0], 0);
+				assertEquals(lodLevels[1], 1);
+				assertEquals(lodLevels[2], 1);
+				assertEquals(lodLevels[3], 2);
+				assertEquals(lodLevels[4], 3);
+				assertEquals(lodLevels[5], 4);
+				assertEquals(lodLevels[6], Terrain::AMOUNT_OF_LOD_LEVELS - 1);
+				for (int i = 0; i < 7; i++)
+				{
+					assertEquals(coarserEdges[i], 0);
+				}
+			}
+
+			{
+				//Neighbours of a fine patch are refined until they differ by at most one level.
+				const int   patchXs[]   = { 3, 4,    5,    6,    7,    4    };
+				const int   patchYs[]   = { 0, 0,    0,    0,    0,    1    };
+				const float distances[] = { 0, 0,    1e9f, 1e9f, 1e9f, 1e9f };
+				int lodLevels[6];
+				int coarserEdges[6];
+				TerrainPatch::selectLodLevels(patchXs, patchYs, distances, 6, 128, lodLevels, coarserEdges);
+				assertEquals(lodLevels[0], 0);
+				assertEquals(lodLevels[1], 0);
+				assertEquals(lodLevels[2], 1);
+				assertEquals(lodLevels[3], 2);
+				assertEquals(lodLevels[4], 3);
+				assertEquals(lodLevels[5], 1);
+				assertEquals(coarserEdges[0], 0);
+				assertEquals(coarserEdges[1], TerrainPatch::EDGE_POSITIVE_X | TerrainPatch::EDGE_POSITIVE_Y);
+				assertEquals(coarserEdges[2], TerrainPatch::EDGE_POSITIVE_X);
+				assertEquals(coarserEdges[3], TerrainPatch::EDGE_POSITIVE_X);
+				assertEquals(coarserEdges[4], 0);
+				assertEquals(coarserEdges[5], 0);
+			}
+
+			{
+				//A cache file is only used for the terrain it was written for and contains the same terrain.
+				const char* cacheFilePath = "TerrainTestCache";
+				Heightfield heightfield;
+				heightfield.setThermalIterations(3);
+				Heightfield otherHeightfield;
+				otherHeightfield.setThermalIterations(4);
+				const String firstFile = Terrain::getCacheFilePath(512, 256, 17, heightfield, cacheFilePath);
+				const String otherHeightfieldFile = Terrain::getCacheFilePath(512, 256, 17, otherHeightfield, cacheFilePath);
+				const String otherSeedFile = Terrain::getCacheFilePath(512, 256, 18, otherHeightfield, cacheFilePath);
+				const String otherSizeFile = Terrain::getCacheFilePath(256, 256, 18, otherHeightfield, cacheFilePath);
+				assertEquals(firstFile == otherHeightfieldFile, false);
+				assertEquals(otherHeightfieldFile == otherSeedFile, false);
+				assertEquals(otherSeedFile == otherSizeFile, false);
+				//Left behind if an earlier run failed.
+				simpleFile::deleteFile(firstFile);
+				simpleFile::deleteFile(otherHeightfieldFile);
+				simpleFile::deleteFile(otherSeedFile);
+				simpleFile::deleteFile(otherSizeFile);
+				//Starts like a cache file but has no key, so it is never removed as a stale cache file.
+				const String unrelatedFile = String(cacheFilePath) + ".keep";
+				{
+					simpleFile::BinaryFileWriter writer(unrelatedFile);
+					writer.write("keep", 4);
+					assertEquals(writer.commit(), true);
+				}
+
+				//Every terrain maps its file until it is destroyed, and a mapped file can not be replaced or
+				//deleted on every platform. So the terrains are scoped to end before their files are touched.
+				{
+					const Terrain generated(512, 256, 17, heightfield);
+					assertEquals(simpleFile::doesFileExist(firstFile), false);
+					const Terrain cold(512, 256, 17, heightfield, cacheFilePath);
+					assertEquals(cold.wasCacheHit(), false);
+					assertEquals(simpleFile::doesFileExist(firstFile), true);
+					const Terrain warm(512, 256, 17, heightfield, cacheFilePath);
+					assertEquals(warm.wasCacheHit(), true);
+
+					for (int i = 0; i < 16; i++)
+					{
+						const Ray ray(Vector3(i * 13.f, i * 7.f, 1000), Vector3(0.3f, 0.1f, -1));
+						float tGenerated = 0;
+						float tCold = 0;
+						float tWarm = 0;
+						const bool hitGenerated = generated.intersects(ray, tGenerated);
+						assertEquals(cold.intersects(ray, tCold), hitGenerated);
+						assertEquals(warm.intersects(ray, tWarm), hitGenerated);
+						assertEquals(tCold, tGenerated);
+						assertEquals(tWarm, tGenerated);
+					}
+
+					{
+						const Terrain otherHeightfieldTerrain(512, 256, 17, otherHeightfield, cacheFilePath);
+						assertEquals(otherHeightfieldTerrain.wasCacheHit(), false);
+						const Terrain otherSeed(512, 256, 18, otherHeightfield, cacheFilePath);
+						assertEquals(otherSeed.wasCacheHit(), false);
+						const Terrain sameAgain(512, 256, 18, otherHeightfield, cacheFilePath);
+						assertEquals(sameAgain.wasCacheHit(), true);
+					}
+					//The file of cold and warm is still mapped and was left alone by the other terrains.
+					const Terrain third(512, 256, 17, heightfield, cacheFilePath);
+					assertEquals(third.wasCacheHit(), true);
+					const Terrain otherSize(256, 256, 18, otherHeightfield, cacheFilePath);
+					assertEquals(otherSize.wasCacheHit(), false);
+					//Writing the file of otherSize removed the files that no terrain maps anymore.
+					assertEquals(simpleFile::doesFileExist(firstFile), true);
+					assertEquals(simpleFile::doesFileExist(otherHeightfieldFile), false);
+					assertEquals(simpleFile::doesFileExist(otherSeedFile), false);
+					assertEquals(simpleFile::doesFileExist(otherSizeFile), true);
+					assertEquals(simpleFile::doesFileExist(unrelatedFile), true);
+				}
+
+				{
+					simpleFile::MappedFile mappedFile;
+					assertEquals(mappedFile.open(otherSizeFile), true);
+					const size_t patchSize = sizeof(float) * (TerrainPatch::PATCH_RESOLUTION * TerrainPatch::PATCH_RESOLUTION + TerrainPatch::PATCH_RESOLUTION * 4) + sizeof(TerrainVertex) * (257 * 257 + 129 * 129 + 65 * 65 + 33 * 33 + 17 * 17 + 9 * 9);
+					assertEquals(mappedFile.getSize(), 32 + patchSize);
+					const float* heights = (const float*)(mappedFile.getData() + 32);
+					const float* borders = heights + TerrainPatch::PATCH_RESOLUTION * TerrainPatch::PATCH_RESOLUTION;
+					const TerrainVertex* cachedVertices = (const TerrainVertex*)(borders + TerrainPatch::PATCH_RESOLUTION * 4);
+					TerrainPatch patch(TerrainPatch::PATCH_RESOLUTION, TerrainPatch::PATCH_RESOLUTION, (float*)heights, borders, 0, 0);
+					for (int lod = 0; lod < Terrain::AMOUNT_OF_LOD_LEVELS; lod++)
+					{
+						const List<TerrainVertex> vertices = patch.createLodVertices(lod);
+						assertEquals((int)vertices.getLength(), TerrainPatch::getAmountOfLodVertices(lod));
+						assertEquals(memcmp(vertices.getRaw(), cachedVertices, sizeof(TerrainVertex) * vertices.getLength()), 0);
+						cachedVertices += vertices.getLength();
+					}
+				}
+
+				assertEquals(simpleFile::deleteFile(firstFile), true);
+				assertEquals(simpleFile::deleteFile(otherSizeFile), true);
+				assertEquals(simpleFile::deleteFile(unrelatedFile), true);
+			}
+		}
+	}
+}
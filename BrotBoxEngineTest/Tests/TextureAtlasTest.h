@@ -0,0 +1,92 @@
+#pragma once
+
+#include "BBE/TextureAtlas.h"
+#include "BBE/Image.h"
+#include "BBE/Rectangle.h"
+#include "BBE/Color.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testTextureAtlas()
+		{
+			{
+				TextureAtlas atlas(64);
+				const Rectangle white = atlas.getWhiteUvRect();
+				assertEqualsFloat(atlas.getImage().getPixel((int)(white.getX() * 64), (int)(white.getY() * 64)).r, 1);
+				assertEqualsFloat(atlas.getImage().getPixel((int)(white.getX() * 64), (int)(white.getY() * 64)).a, 1);
+
+				Image image(4, 2, Color(1, 0, 0, 1));
+				Rectangle uvRect;
+				assertEquals(atlas.add(image, uvRect), true);
+				assertEqualsFloat(uvRect.getWidth(), 4.f / 64);
+				assertEqualsFloat(uvRect.getHeight(), 2.f / 64);
+				const int x = (int)(uvRect.getX() * 64 + 0.5f);
+				const int y = (int)(uvRect.getY() * 64 + 0.5f);
+				assertEqualsFloat(atlas.getImage().getPixel(x, y).r, 1);
+				assertEqualsFloat(atlas.getImage().getPixel(x + 3, y + 1).r, 1);
+				//The edges are extruded into the padding.
+				assertEqualsFloat(atlas.getImage().getPixel(x - 1, y - 1).r, 1);
+				assertEqualsFloat(atlas.getImage().getPixel(x + 4, y + 2).r, 1);
+
+				//The second add finds the place of the first one.
+				const int usedArea = atlas.getUsedArea();
+				Rectangle again;
+				assertEquals(atlas.add(image, again), true);
+				assertEqualsFloat(again.getX(), uvRect.getX());
+				assertEqualsFloat(again.getY(), uvRect.getY());
+				assertEquals(atlas.getUsedArea(), usedArea);
+
+				Image other(4, 2, Color(0, 1, 0, 1));
+				Rectangle otherUvRect;
+				assertEquals(atlas.add(other, otherUvRect), true);
+				assertEquals(otherUvRect.getX() != uvRect.getX() || otherUvRect.getY() != uvRect.getY(), true);
+
+				Image tooBig(TextureAtlas::MAX_IMAGE_SIZE + 1, 1, Color(1, 1, 1, 1));
+				assertEquals(atlas.add(tooBig, otherUvRect), false);
+
+				Image full(60, 60, Color(1, 1, 1, 1));
+				assertEquals(atlas.add(full, otherUvRect), false);
+				assertEquals(atlas.add(full, otherUvRect), false);
+
+				//A destroyed atlas starts empty and forgets the places of all images.
+				atlas.destroy();
+				assertEquals(atlas.getUsedArea(), 0);
+				Image big(56, 56, Color(1, 1, 1, 1));
+				assertEquals(atlas.add(big, otherUvRect), true);
+				assertEquals(atlas.add(image, uvRect), true);
+				assertEqualsFloat(uvRect.getY(), 59.f / 64);
+			}
+
+			{
+				bool exceptionThrown = false;
+				try
+				{
+					TextureAtlas atlas(2);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+
+				exceptionThrown = false;
+				try
+				{
+					TextureAtlas atlas(16);
+					Image image;
+					Rectangle uvRect;
+					atlas.add(image, uvRect);
+				}
+				catch (NotInitializedException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "BBE/ThreadPool.h"
+#include "BBE/UtilTest.h"
+#include "BBE/List.h"
+#include <atomic>
+
+namespace bbe
+{
+	namespace test
+	{
+		void testThreadPool()
+		{
+			{
+				ThreadPool pool(3);
+				assertEquals(pool.getAmountOfThreads(), 3);
+
+				List<int> visited;
+				visited.resizeCapacityAndLength(10000);
+				pool.parallelFor(0, visited.getLength(), [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						visited[i]++;
+					}
+				});
+				for (size_t i = 0; i < visited.getLength(); i++)
+				{
+					assertEquals(visited[i], 1);
+				}
+
+				std::atomic<size_t> calls(0);
+				pool.parallelFor(5, 5, [&](size_t begin, size_t end) { calls++; });
+				assertEquals(calls.load(), 0);
+				pool.parallelFor(0, 100, [&](size_t begin, size_t end) { calls++; }, 1000);
+				assertEquals(calls.load(), 1);
+
+				std::atomic<size_t> sum(0);
+				pool.parallelFor(0, 64, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						pool.parallelFor(0, 100, [&](size_t innerBegin, size_t innerEnd)
+						{
+							sum += innerEnd - innerBegin;
+						});
+					}
+				});
+				assertEquals(sum.load(), 6400);
+			}
+
+			{
+				std::atomic<int> calls(0);
+				{
+					ThreadPool pool(2);
+					for (int i = 0; i < 100; i++)
+					{
+						pool.enqueue([&calls]() { calls++; });
+					}
+				}
+				assertEquals(calls.load(), 100);
+			}
+
+			{
+				size_t sum = 0;
+				ThreadPool::parallelFor(nullptr, 10, 20, [&](size_t begin, size_t end)
+				{
+					assertEquals(begin, 10);
+					assertEquals(end, 20);
+					sum += end - begin;
+				});
+				assertEquals(sum, 10);
+			}
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "BBE/ValueNoise2D.h"
+#include "BBE/ThreadPool.h"
+#include "BBE/Philox.h"
+#include "BBE/Math.h"
+#include "BBE/List.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testValueNoise2D()
+		{
+			const int width = 203;
+			const int height = 77;
+			const uint64_t seed = 12;
+
+			//Straight forward evaluation with five cubic interpolations per pixel.
+			List<float> expected;
+			expected.resizeCapacityAndLength(width * height);
+			{
+				float alpha = 1.5f;
+				int frequencyX = 4;
+				int frequencyY = 6;
+				for (int octave = 0; octave < 4; octave++)
+				{
+					const Philox4x32 random(seed, octave);
+					List<float> nodes;
+					nodes.resizeCapacityAndLength((frequencyX + 2) * (frequencyY + 3));
+					for (size_t i = 0; i < nodes.getLength(); i++)
+					{
+						nodes[i] = random.getFloat(i) * alpha;
+					}
+					auto node = [&](int x, int y) { return nodes[x + y * (frequencyX + 1)]; };
+
+					for (int i = 0; i < width; i++)
+					{
+						for (int k = 0; k < height; k++)
+						{
+							float currentX = (float)i / (float)width * frequencyX;
+							float currentY = (float)k / (float)height * frequencyY;
+							int x = (int)currentX;
+							int y = (int)currentY;
+							float rows[4];
+							for (int r = 0; r < 4; r++)
+							{
+								rows[r] = Math::interpolateCubic(node(x, y + r), node(x + 1, y + r), node(x + 2, y + r), node(x + 3, y + r), currentX - x);
+							}
+							expected[i + k * width] += Math::interpolateCubic(rows[0], rows[1], rows[2], rows[3], currentY - y);
+						}
+					}
+
+					alpha *= 0.25f;
+					frequencyX *= 3;
+					frequencyY *= 3;
+				}
+
+				float min = expected[0];
+				float max = expected[0];
+				for (size_t i = 0; i < expected.getLength(); i++)
+				{
+					min = Math::min(min, expected[i]);
+					max = Math::max(max, expected[i]);
+				}
+				for (size_t i = 0; i < expected.getLength(); i++)
+				{
+					expected[i] = (expected[i] - min) / (max - min);
+				}
+			}
+
+			ThreadPool pool(3);
+			ThreadPool* pools[] = { nullptr, &pool };
+			for (ThreadPool* threadPool : pools)
+			{
+				ValueNoise2D noise;
+				noise.setOctaves(4);
+				noise.setStartFrequency(4, 6);
+				noise.setStartAlpha(1.5f);
+				noise.setAlphaChange(0.25f);
+				noise.setFrequencyChange(3);
+				noise.create(width, height, seed, threadPool);
+				for (int i = 0; i < width; i++)
+				{
+					for (int k = 0; k < height; k++)
+					{
+						assertEqualsFloat(noise.get(i, k), expected[i + k * width], 0.00001f);
+					}
+				}
+			}
+
+			ValueNoise2D noise;
+			assertEquals(noise.getOctaves(), 3);
+			bool exceptionThrown = false;
+			try
+			{
+				noise.setOctaves(0);
+			}
+			catch (IllegalArgumentException e)
+			{
+				exceptionThrown = true;
+			}
+			assertEquals(exceptionThrown, true);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BBE/VulkanObjectCounter.h"
+#include "BBE/Exceptions.h"
+#include "BBE/UtilTest.h"
+
+namespace bbe
+{
+	namespace test
+	{
+		void testVulkanObjectCounter()
+		{
+			using namespace INTERNAL::vulkan;
+			{
+				VulkanObjectCounter::endFrame();
+				const uint64_t totalBuffers = VulkanObjectCounter::getTotalAmount(VulkanObjectType::BUFFER);
+				const uint64_t totalSets = VulkanObjectCounter::getTotalAmount(VulkanObjectType::DESCRIPTOR_SET);
+
+				VulkanObjectCounter::count(VulkanObjectType::BUFFER);
+				VulkanObjectCounter::count(VulkanObjectType::BUFFER, 2);
+				VulkanObjectCounter::count(VulkanObjectType::DESCRIPTOR_SET);
+				//Nothing is visible before the frame ended.
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(), 0u);
+
+				VulkanObjectCounter::endFrame();
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(VulkanObjectType::BUFFER), 3u);
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(VulkanObjectType::DESCRIPTOR_SET), 1u);
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(VulkanObjectType::PIPELINE), 0u);
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(), 4u);
+
+				VulkanObjectCounter::endFrame();
+				assertEquals(VulkanObjectCounter::getAmountLastFrame(), 0u);
+				assertEquals(VulkanObjectCounter::getTotalAmount(VulkanObjectType::BUFFER), totalBuffers + 3);
+				assertEquals(VulkanObjectCounter::getTotalAmount(VulkanObjectType::DESCRIPTOR_SET), totalSets + 1);
+			}
+
+			{
+				bool exceptionThrown = false;
+				try
+				{
+					VulkanObjectCounter::count(VulkanObjectType::AMOUNT_OF_TYPES);
+				}
+				catch (IllegalArgumentException e)
+				{
+					exceptionThrown = true;
+				}
+				assertEquals(exceptionThrown, true);
+			}
+		}
+	}
+}
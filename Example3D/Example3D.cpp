@@ -31,6 +31,10 @@ public:
 	
 	bbe::Color colors[AMOUNTOFCUBES];
 
+	bbe::BoundingBox cubeBoxes[AMOUNTOFCUBES];
+	bbe::BoundingVolumeHierarchy bvh;
+	int pickedCube = -1;
+
 	bbe::Image image;
 	bbe::Image image2;
 
@@ -59,7 +63,9 @@ public:
 			rotationSpeeds[i] = rand.randomFloat() * bbe::Math::PI * 2 * 0.25f;
 			cubes[i].set(positions[i] , bbe::Vector3(1), rotationAxis[i], rotations[i]);
 			colors[i] = bbe::Color(rand.randomFloat(), rand.randomFloat(), rand.randomFloat(), 1.0f);
+			cubeBoxes[i] = cubes[i].getBoundingBox();
 		}
+		bvh.build(cubeBoxes, AMOUNTOFCUBES);
 
 		image.load("images/TestImage.png");
 		image2.load("images/TestImage2.png");
@@ -82,6 +88,22 @@ public:
 				rotations[i] -= bbe::Math::PI * 2;
 			}
 			cubes[i].set(positions[i], bbe::Vector3(1), rotationAxis[i], rotations[i]);
+			cubeBoxes[i] = cubes[i].getBoundingBox();
+		}
+		bvh.refit(cubeBoxes, AMOUNTOFCUBES);
+
+		//Highlights the cube in the center of the screen, unless the terrain is in front of it.
+		pickedCube = -1;
+		bbe::Ray ray = ccnc.getCameraRay();
+		size_t hitIndex;
+		float hitT;
+		if (bvh.raycast(ray, [&](size_t index, float maxT, float &outT) { return cubes[index].intersects(ray, outT, maxT); }, hitIndex, hitT))
+		{
+			float terrainT;
+			if (!terrain.intersects(ray, terrainT, hitT))
+			{
+				pickedCube = (int)hitIndex;
+			}
 		}
 
 		light.setPosition(bbe::Vector3(bbe::Math::sin(timePassed / 2) * 1000, 0, 0));
@@ -106,7 +128,14 @@ public:
 		brush.setCamera(ccnc.getCameraPos(), ccnc.getCameraTarget());
 		for (int i = 0; i < AMOUNTOFCUBES; i++)
 		{
-			brush.setColor(colors[i]);
+			if (i == pickedCube)
+			{
+				brush.setColor(1, 1, 1);
+			}
+			else
+			{
+				brush.setColor(colors[i]);
+			}
 			brush.fillCube(cubes[i]);
 		}
 
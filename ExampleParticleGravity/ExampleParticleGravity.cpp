@@ -6,7 +6,6 @@
 
 class Particle;
 
-static bbe::Random random;
 static bbe::List<Particle> particles;
 
 static float size = 1;
@@ -18,8 +17,10 @@ public:
 	bbe::Vector3 speed;
 	bbe::IcoSphere m_sphere;
 
-	Particle()
+	//The position only depends on the seed and the index of the particle.
+	Particle(uint64_t seed, size_t index)
 	{
+		bbe::RandomPhilox random(seed, index);
 		pos = random.randomVector3InUnitSphere() * 100.0f;
 	}
 
@@ -29,25 +30,9 @@ public:
 		//do nothing
 	}
 
-	void updateSpeed(float timeSinceLastFrame)
+	void applyForce(const bbe::Vector3 &force)
 	{
-		for (Particle &p : particles)
-		{
-			if (this == &p)
-			{
-				continue;
-			}
-			bbe::Vector3 dir = p.pos - pos;
-			float length = dir.getLength();
-			if (length != 0)
-			{
-				bbe::Vector3 gravity = dir.normalize() / length / length / 10;
-				bbe::Vector3 antiTouch = dir.normalize() / length / length / length / 10;
-				speed = speed + gravity - antiTouch;
-			}
-		}
-
-		speed = speed * 0.99f;
+		speed = (speed + force) * 0.99f;
 	}
 
 	void updatePos(float timeSinceLastFrame)
@@ -74,15 +59,48 @@ class MyGame : public bbe::Game
 	float maxSpeed = 0;
 	float minSpeed = 0;
 
+	bbe::ThreadPool threadPool;
+	bbe::BarnesHutTree tree;
+	bbe::List<bbe::Vector3> positions;
+	bbe::List<bbe::Vector3> forces;
+
+	void updateSpeeds()
+	{
+		const size_t amount = particles.getLength();
+		positions.clear();
+		positions.resizeCapacity(amount);
+		for (Particle &p : particles)
+		{
+			positions.add(p.pos);
+		}
+		forces.clear();
+		forces.resizeCapacityAndLength(amount);
+
+		tree.build(positions.getRaw(), nullptr, amount, &threadPool);
+		tree.calculateForces(positions.getRaw(), forces.getRaw(), amount, [](const bbe::Vector3 &dir, float distanceSq, float mass)
+		{
+			const float length = bbe::Math::sqrt(distanceSq);
+			const float gravity = 1 / (distanceSq * length);
+			const float antiTouch = 1 / (distanceSq * distanceSq);
+			return dir * (mass * (gravity - antiTouch) / 10);
+		}, &threadPool);
+
+		for (size_t i = 0; i < amount; i++)
+		{
+			particles[i].applyForce(forces[i]);
+		}
+	}
+
 	// Geerbt ber Game
 	virtual void onStart() override
 	{
 		light.setFalloffMode(bbe::LightFalloffMode::LIGHT_FALLOFF_NONE);
 		light.setLightStrength(1);
 		light.setPosition(bbe::Vector3(100, 100, 100));
+		const uint64_t seed = bbe::Random().randomUInt();
 		for (int i = 0; i < 100; i++)
 		{
-			particles.add(Particle());
+			particles.add(Particle(seed, i));
 		}
 	}
 	virtual void update(float timeSinceLastFrame) override
@@ -118,10 +136,7 @@ class MyGame : public bbe::Game
 
 		for (int iterations = 0; iterations < 20; iterations++)
 		{
-			for (Particle &p : particles)
-			{
-				p.updateSpeed(timeSinceLastFrame);
-			}
+			updateSpeeds();
 			for (Particle &p : particles)
 			{
 				p.updatePos(timeSinceLastFrame);